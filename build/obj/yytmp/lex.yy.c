@@ -0,0 +1,858 @@
+/* Test-harness replacement for the flex-generated scanner (not part of the repo). */
+#include <regex.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+FILE *yyin = NULL;
+char *yytext = NULL;
+int yyleng = 0;
+
+#define INITIAL 0
+#define COMMENT 1
+#define SHELL 2
+#define BINARY 3
+#define STRING 4
+#define REGEX 5
+static int yy_start = INITIAL;
+#define BEGIN yy_start =
+#define yyterminate() return 0
+static char *yy_buf = NULL;
+static size_t yy_len = 0, yy_pos = 0, yy_text_start = 0;
+static int yy_loaded = 0, yy_more = 0;
+#define YY_FLUSH_BUFFER do { free(yy_buf); yy_buf = NULL; yy_len = yy_pos = 0; yy_loaded = 0; yy_more = 0; } while (0)
+static void yy_settext(void) {
+    size_t n = yy_pos - yy_text_start;
+    static size_t cap = 0;
+    if (cap < n + 1) { cap = n + 256; yytext = realloc(yytext, cap); }
+    memcpy(yytext, yy_buf + yy_text_start, n); yytext[n] = 0; yyleng = (int)n;
+}
+#define yymore() (yy_more = 1)
+#define yyless(n) do { yy_pos = yy_text_start + (n); yy_settext(); } while (0)
+#define unput(c) (yy_pos--)
+
+/* ヘッダファイル */
+#include <string.h>
+
+#include "NewtErrs.h"
+#include "NewtObj.h"
+#include "NewtEnv.h"
+#include "NewtParser.h"
+#include "NewtPrint.h"
+#include "NewtIO.h"
+
+#include "lookup_words.h"
+#include "yacc.h"
+#include "y.tab.h"
+
+
+/* 関数プロトタイプ */
+static int			lex_update_tokenpos(int op);
+static void			lex_newline(void);
+
+static char *		lex_truncstr(char *s);
+static char *		lex_escapestr(char *s);
+static char			lex_escapechar(char c);
+static intptr_t		lex_htoi(char *s, ssize_t len);
+static uint32_t		lex_getop(char *s);
+static int			lex_op(char *s, int op);
+static int			lex_reserveword(int tokn, char *s);
+
+static int			lex_makesymbol(char *s, bool trunc);
+static int			lex_makestring(char *s, bool trunc);
+static int			lex_makeregex(char *s, bool trunc);
+static int			lex_makechar(intptr_t c);
+static int			lex_makeinteger(intptr_t n);
+static int			lex_makereal(double n);
+
+static int			lex_makemagicpointer(intptr_t n);
+static int			lex_makenamedmp(char *s, bool trunc);
+
+static void			lex_debug(int type);
+
+
+/* マクロ */
+#undef YY_INPUT
+#define YY_INPUT(b, r, ms) (r=nps_yyinput(yyin, b, ms))
+
+#define WORN_NOS2(msg)		if (NEWT_MODE_NOS2) NPSErrorStr('W', msg);
+
+static char *yy_bracket(int (*pred)(int)) {
+    static char bufs[64][800]; static int bi = 0; char *b = bufs[bi++ % 64]; int n = 0, c;
+    b[n++] = '[';
+    if (pred(']')) b[n++] = ']';
+    for (c = 1; c < 256; c++) if (c != ']' && c != '-' && c != '[' && c != '^' && pred(c)) b[n++] = (char)c;
+    if (pred('^')) b[n++] = '^';
+    if (pred('[')) b[n++] = '[';
+    if (pred('-')) b[n++] = '-';
+    b[n++] = ']'; b[n] = 0;
+    return b;
+}
+static int p_strchar(int c) { return (c >= 0x20 && c <= 0x21) || (c >= 0x23 && c <= 0x5b) || (c >= 0x5d && c <= 0x7f); }
+static int p_symchar(int c) { return (c >= 0x20 && c <= 0x5b) || (c >= 0x5d && c <= 0x7b) || (c >= 0x7d && c <= 0x7f); }
+static int p_nonesc(int c) { return (c >= 0x20 && c <= 0x5b) || (c >= 0x5d && c <= 0x7f); }
+static int p_regexchar(int c) { return p_strchar(c) || c == '"'; }
+static int p_notstarslash(int c) { return c != '*' && c != '/'; }
+static int p_escchar(int c) { return c == '"' || c == '\\' || c == 'n' || c == 'r' || c == 't' || c == '/'; }
+static int p_hex(int c) { return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F'); }
+static int p_notnl(int c) { return c != '\n'; }
+
+enum { S_I = 1 << INITIAL, S_C = 1 << COMMENT, S_SH = 1 << SHELL, S_B = 1 << BINARY, S_S = 1 << STRING, S_R = 1 << REGEX };
+#define S_INCL (S_I | S_B)
+typedef struct { int states; const char *pat; int id; regex_t re; } yy_rule;
+static yy_rule yy_rules[64]; static int yy_nrules = 0;
+static void yy_add(int states, const char *pat, int id) {
+    char full[4096];
+    snprintf(full, sizeof(full), "^(%s)", pat);
+    yy_rules[yy_nrules].states = states; yy_rules[yy_nrules].id = id;
+    if (regcomp(&yy_rules[yy_nrules].re, full, REG_EXTENDED) != 0) { fprintf(stderr, "bad re %s\n", full); exit(2); }
+    yy_nrules++;
+}
+static void yy_init_rules(void) {
+    static char esc[512], escseq[1024], trunc[256], charseq[2048], symseq[1024], regexseq[2048], t[4096];
+    const char *hex4;
+    if (yy_nrules) return;
+    hex4 = "[0-9A-Fa-f][0-9A-Fa-f][0-9A-Fa-f][0-9A-Fa-f]";
+    snprintf(esc, sizeof esc, "%s", yy_bracket(p_escchar));
+    snprintf(escseq, sizeof escseq, "(\\\\%s|\\\\u(%s)*\\\\u)", esc, hex4);
+    snprintf(trunc, sizeof trunc, "\\\\u(%s)*", hex4);
+    snprintf(charseq, sizeof charseq, "(%s|%s)*(%s)?", yy_bracket(p_strchar), escseq, trunc);
+    snprintf(symseq, sizeof symseq, "(\\\\[|\\\\]|%s)*", yy_bracket(p_symchar));
+    snprintf(regexseq, sizeof regexseq, "(%s|%s)(%s|%s)*(%s)?", yy_bracket(p_notstarslash), escseq, yy_bracket(p_regexchar), escseq, trunc);
+
+    snprintf(t, sizeof t, "//%s*", yy_bracket(p_notnl)); yy_add(S_INCL, t, 1);
+    yy_add(S_INCL, "/\\*", 2);
+    yy_add(S_C, "\\*/", 3);
+    yy_add(S_C, "\r\n|\r|\n", 4);
+    snprintf(t, sizeof t, "%s", yy_bracket(p_notnl)); yy_add(S_C, t, 5);
+    yy_add(S_INCL, "<#", 6);
+    yy_add(S_B, "\r\n|\r|\n", 7);
+    yy_add(S_B, ">", 8);
+    yy_add(S_S, "\r\n|\r|\n", 9);
+    yy_add(S_S, charseq, 10);
+    yy_add(S_S, "\"", 11);
+    yy_add(S_R, "[A-Za-z]+", 12);
+    snprintf(t, sizeof t, "%s", yy_bracket(p_notnl)); yy_add(S_R, t, 13);
+    yy_add(S_INCL, "\r\n|\r|\n", 14);
+    yy_add(S_INCL, "[ \t]+", 15);
+    yy_add(S_INCL, "__FILE__", 16);
+    yy_add(S_INCL, "__LINE__", 17);
+    yy_add(S_INCL, "[-+]", 18);
+    yy_add(S_INCL, "[*/]", 19);
+    yy_add(S_INCL, "&|&&", 20);
+    yy_add(S_INCL, "<<|>>", 21);
+    yy_add(S_INCL, "[<>]=?|=|<>|==", 22);
+    yy_add(S_INCL, "\\.\\.\\.", 23);
+    yy_add(S_INCL, ":=", 24);
+    yy_add(S_INCL, ":\\?", 25);
+    snprintf(t, sizeof t, "\"%s\"", charseq); yy_add(S_INCL, t, 26);
+    yy_add(S_INCL, "\"", 27);
+    yy_add(S_INCL, "[A-Za-z_][A-Za-z0-9_]*", 28);
+    snprintf(t, sizeof t, "\\|%s\\|", symseq); yy_add(S_INCL, t, 29);
+    snprintf(t, sizeof t, "/%s/", regexseq); yy_add(S_INCL, t, 30);
+    snprintf(t, sizeof t, "\\$\\\\%s", esc); yy_add(S_INCL, t, 31);
+    yy_add(S_INCL, "\\$\\\\[0-9A-Fa-f][0-9A-Fa-f]", 32);
+    snprintf(t, sizeof t, "\\$\\\\u%s", hex4); yy_add(S_INCL, t, 33);
+    snprintf(t, sizeof t, "\\$%s", yy_bracket(p_nonesc)); yy_add(S_INCL, t, 34);
+    yy_add(S_INCL, "@[0-9]+", 35);
+    yy_add(S_INCL, "@[A-Za-z_][A-Za-z0-9_]*", 36);
+    snprintf(t, sizeof t, "@\\|%s\\|", symseq); yy_add(S_INCL, t, 37);
+    yy_add(S_INCL, "[0-9]+", 38);
+    yy_add(S_INCL, "0x[0-9A-Fa-f]+", 39);
+    yy_add(S_INCL, "[0-9]+\\.[0-9]*([eE]-?[0-9]+)?", 40);
+    yy_add(S_INCL, ";(\r\n|\r|\n|[ \t])*[Ee][Ll][Ss][Ee]", 41);
+    snprintf(t, sizeof t, "%s", yy_bracket(p_notnl)); yy_add(S_INCL, t, 42);
+    snprintf(t, sizeof t, "#%s*", yy_bracket(p_notnl)); yy_add(S_SH, t, 43);
+    yy_add(S_SH, "\r\n|\r|\n", 44);
+    snprintf(t, sizeof t, "%s", yy_bracket(p_notnl)); yy_add(S_SH, t, 45);
+}
+static void yy_load(void) {
+    size_t cap = 8192, r;
+    if (yyin == NULL) yyin = stdin;
+    yy_buf = malloc(cap); yy_len = 0;
+    for (;;) {
+        if (cap - yy_len < 4096) { cap *= 2; yy_buf = realloc(yy_buf, cap); }
+        YY_INPUT(yy_buf + yy_len, r, cap - yy_len - 1);
+        if (r == 0 || r == (size_t)-1) break;
+        yy_len += r;
+    }
+    yy_buf[yy_len] = 0; yy_pos = 0; yy_loaded = 1;
+}
+int yylex(void) {
+    if (nps_env.first_time) { nps_env.first_time = false; BEGIN SHELL; }
+    yy_init_rules();
+    if (!yy_loaded) yy_load();
+    for (;;) {
+        int i, best = -1, nl = 0; size_t bestlen = 0, win;
+        regmatch_t m[1];
+        if (yy_pos >= yy_len) return 0;
+        for (win = yy_pos; win < yy_len && nl < 2; win++) if (yy_buf[win] == '\n') nl++;
+        for (i = 0; i < yy_nrules; i++) {
+            if (!(yy_rules[i].states & (1 << yy_start))) continue;
+            if (yy_rules[i].id == 43 && yy_pos != 0 && yy_buf[yy_pos - 1] != '\n') continue;
+            m[0].rm_so = 0; m[0].rm_eo = (regoff_t)(win - yy_pos);
+            if (regexec(&yy_rules[i].re, yy_buf + yy_pos, 1, m, REG_STARTEND) == 0 && m[0].rm_so == 0) {
+                size_t l = (size_t)m[0].rm_eo;
+                if (l > bestlen) { bestlen = l; best = yy_rules[i].id; }
+            }
+        }
+        if (!yy_more) yy_text_start = yy_pos;
+        yy_more = 0;
+        if (best < 0) { fputc(yy_buf[yy_pos], stdout); yy_pos++; continue; }
+        yy_pos += bestlen;
+        yy_settext();
+        switch (best) {
+        case 1: break;
+        case 2: BEGIN COMMENT; lex_update_tokenpos(0); break;
+        case 3: BEGIN INITIAL; lex_update_tokenpos(0); break;
+        case 4: lex_newline(); break;
+        case 5: lex_update_tokenpos(0); break;
+        case 6: BEGIN BINARY; return lex_update_tokenpos(kBINBG);
+        case 7: lex_newline(); break;
+        case 8: BEGIN INITIAL; return lex_update_tokenpos(kBINED);
+        case 9: nps_env.lineno++; yymore(); break;
+        case 10: yymore(); break;
+        case 11: BEGIN INITIAL; return lex_makestring(yytext, true);
+        case 12: return lex_makestring(yytext, false);
+        case 13: unput(*yytext); BEGIN INITIAL; break;
+        case 14: lex_newline(); break;
+        case 15: lex_update_tokenpos(0); break;
+        case 16: return lex_makestring((char *)(nps_env.fname?nps_env.fname:"-"), false);
+        case 17: return lex_makeinteger(nps_env.lineno);
+        case 18: return lex_op(yytext, kADDOP);
+        case 19: return lex_op(yytext, kMULOP);
+        case 20: return lex_op(yytext, kSTROP);
+        case 21: return lex_op(yytext, kSFTOP);
+        case 22: return lex_op(yytext, kRELOP);
+        case 23: return lex_update_tokenpos(k3READER);
+        case 24: return lex_update_tokenpos(kASNOP);
+        case 25: return lex_update_tokenpos(kSNDOP);
+        case 26: return lex_makestring(yytext, true);
+        case 27: BEGIN STRING; yymore(); break;
+        case 28: return lex_makesymbol(yytext, false);
+        case 29: return lex_makesymbol(yytext, true);
+        case 30: BEGIN REGEX; return lex_makeregex(yytext, true);
+        case 31: return lex_makechar(lex_escapechar(yytext[2]));
+        case 32: return lex_makechar(lex_htoi(yytext + 2, -1));
+        case 33: return lex_makechar(lex_htoi(yytext + 3, -1));
+        case 34: return lex_makechar(yytext[1]);
+        case 35: return lex_makemagicpointer(atoll(yytext + 1));
+        case 36: return lex_makenamedmp(yytext + 1, false);
+        case 37: return lex_makenamedmp(yytext + 1, true);
+        case 38: return lex_makeinteger(atoll(yytext));
+        case 39: return lex_makeinteger(lex_htoi(yytext + 2, -1));
+        case 40: return lex_makereal(atof(yytext));
+        case 41: return lex_update_tokenpos(kELSE);
+        case 42: return lex_update_tokenpos(yytext[0]);
+        case 43: BEGIN INITIAL; break;
+        case 44: lex_newline(); break;
+        case 45: unput(*yytext); BEGIN INITIAL; break;
+        }
+    }
+}
+
+
+/// 一部の lex で YY_FLUSH_BUFFER が undef されてしまう問題に対応
+#ifndef YY_FLUSH_BUFFER
+	#define YY_FLUSH_BUFFER yy_flush_buffer(YY_CURRENT_BUFFER )
+#endif
+
+
+/// 予約語
+static keyword_t	reserved_words[] = {
+		// アルファベット順にソートしておくこと
+		{"AND",			kANDOP},		// 予約語
+        {"BEGIN",		kBEGIN},		// 予約語
+        {"BREAK",		kBREAK},		// 予約語
+        {"BY",			kBY},			// 予約語
+        {"CALL",		kCALL},			// 予約語
+//		{"COLLECT",		kCOLLECT},
+        {"CONSTANT",	kCONSTANT},		// 予約語
+//		{"DEEPLY",		kDEEPLY},
+        {"DIV",			kMULOP},		// 予約語
+        {"DO",			kDO},			// 予約語
+        {"ELSE",		kELSE},			// 予約語
+        {"END",			kEND},			// 予約語
+        {"EXISTS",		kEXISTS},		// 予約語
+        {"FOR",			kFOR},			// 予約語
+        {"FOREACH",		kFOREACH},		// 予約語
+        {"FUNC",		kFUNC},			// 予約語
+        {"GLOBAL",		kGLOBAL},		// 予約語
+        {"IF",			kIF},			// 予約語
+        {"IN",			kIN},			// 予約語
+        {"INHERITED",	kINHERITED},	// 予約語
+        {"LOCAL",		kLOCAL},		// 予約語
+        {"LOOP",		kLOOP},			// 予約語
+        {"MOD",			kMULOP},		// 予約語
+        {"NATIVE",		kNATIVE},		// 予約語
+        {"NIL",			kNIL},
+        {"NOT",			kNOTOP},		// 予約語
+        {"ONEXCEPTION",	kONEXCEPTION},	// 予約語
+        {"OR",			kOROP},			// 予約語
+        {"REPEAT",		kREPEAT},		// 予約語
+        {"RETURN",		kRETURN},		// 予約語
+        {"SELF",		kSELF},			// 予約語
+        {"THEN",		kTHEN},			// 予約語
+        {"TO",			kTO},			// 予約語
+        {"TRUE",		kTRUE},
+        {"TRY",			kTRY},			// 予約語
+        {"UNTIL",		kUNTIL},		// 予約語
+        {"WHILE",		kWHILE},		// 予約語
+        {"WITH",		kWITH},			// 予約語
+    };
+
+/// オペレータ
+static keyword_t	operator_words[] = {
+		// アルファベット順にソートしておくこと
+        {"&&",			kNPS_CONCAT2},
+        {"<<",			kNPS_SHIFT_LEFT},
+        {"<=",			kNPS_LESS_EQUAL},
+        {"<>",			kNPS_NOT_EQUAL},
+        {"==",			kNPS_OBJECT_EQUAL},
+        {">=",			kNPS_GREATER_EQUAL},
+        {">>",			kNPS_SHIFT_RIGHT},
+	};
+
+
+/*------------------------------------------------------------------------*/
+/** トークンの位置を更新
+ *
+ * @param op		[in] オペレータ
+ *
+ * @return			オペレータをそのまま返す
+ */
+
+int lex_update_tokenpos(int op)
+{
+	strncat(nps_env.linebuf, yytext, sizeof(nps_env.linebuf));
+
+	nps_env.tokenpos += yyleng;
+	nps_env.yyleng = yyleng;
+	return op;
+}
+
+
+/*------------------------------------------------------------------------*/
+/** 新しい行の初期化
+ *
+ * @return			なし
+ *
+ * @note			エラー箇所を適切に表示するために入力行を保持する
+ */
+
+void lex_newline(void)
+{
+	uint32_t	n = 1;
+
+	if (yytext[0] == '\r' && yytext[1] == '\n')
+		n++;
+
+	nps_env.linebuf[0] = '\0';
+	nps_env.tokenpos = 0;
+	nps_env.yyleng = 0;
+	nps_env.lineno++;
+	yyless(n);
+}
+
+
+/*------------------------------------------------------------------------*/
+/** 文字列の前後１文字を切り詰める
+ *
+ * @param s			[in] 文字列
+ *
+ * @return			切り詰めたられた文字列
+ */
+
+char * lex_truncstr(char *s)
+{
+    s[strlen(s) - 1] = '\0';
+
+    return s + 1;
+}
+
+
+/*------------------------------------------------------------------------*/
+/** エスケープされた文字列を処理する
+ *
+ * @param s			[in] エスケープされた文字列
+ *
+ * @return			文字列
+ */
+
+char * lex_escapestr(char *s)
+{
+    int		uni = 0;
+    char *	src;
+    char *	dst;
+
+    dst = src = s;
+
+    while (*src)
+    {
+        if (*src =='\\')
+        {
+            src++;
+
+            if (*src == 'u')
+            {
+                uni = ! uni;
+            }
+            else
+            {
+              	*dst = lex_escapechar(*src);
+                dst++;
+            }
+
+            src++;
+        }
+        else if (uni)
+        {
+/*
+            *dst = lex_htoi(src, 4);
+            src += 4;
+            dst++;
+*/
+            *dst = lex_htoi(src, 2);
+            src += 2;
+            dst++;
+
+            *dst = lex_htoi(src, 2);
+            src += 2;
+            dst++;
+        }
+        else
+        {
+            if (dst != src)
+                *dst = *src;
+
+            dst++;
+            src++;
+        }
+    }
+
+    *dst = '\0';
+
+    return s;
+}
+
+
+/*------------------------------------------------------------------------*/
+/** エスケープ文字を処理する
+ *
+ * @param c			[in] エスケープ文字
+ *
+ * @return			文字
+ */
+
+char lex_escapechar(char c)
+{
+    switch (c)
+    {
+        case 'n':
+            c = '\n';
+            break;
+
+        case 'r':
+            c = '\r';
+            break;
+
+        case 't':
+            c = '\t';
+            break;
+    }
+
+    return c;
+}
+
+
+/*------------------------------------------------------------------------*/
+/** 16進数文字列を整数に変換
+ *
+ * @param s			[in] 16進数文字列
+ * @param len		[in] 16進数文字列の長さ
+ *
+ * @return			整数
+ */
+
+intptr_t lex_htoi(char *s, ssize_t len)
+{
+    intptr_t	n = 0;
+
+    if (len < 0)
+        len = strlen(s) + 1 + len;
+
+    while (0 < len)
+    {
+        n *= 16;
+
+        if ('A' <= *s && *s <= 'F')
+            n += *s - 'A' + 10;
+        else if ('a' <= *s && *s <= 'f')
+            n += *s - 'a' + 10;
+        else
+            n += *s - '0';
+
+        s++;
+        len--;
+    }
+
+    return n;
+}
+
+
+/*------------------------------------------------------------------------*/
+/** オペレータ文字列からオペレータIDを求める
+ *
+ * @param s			[in] オペレータ文字列
+ *
+ * @return			オペレータID
+ */
+
+uint32_t lex_getop(char *s)
+{
+    uint32_t	op;
+    size_t	len;
+
+	len = strlen(s);
+
+    if (len == 1)
+    {
+        op = s[0];
+    }
+    else
+    {
+        int	wlen;
+
+        wlen = sizeof(operator_words) / sizeof(keyword_t);
+        op = lookup_words(operator_words, wlen, s);
+    }
+
+    return op;
+}
+
+
+/*------------------------------------------------------------------------*/
+/** オペレータトークンの作成
+ *
+ * @param s			[in] オペレータ文字列
+ *
+ * @return			トークンID
+ */
+
+int lex_op(char *s, int op)
+{
+    yylval.op = lex_getop(yytext);
+	return lex_update_tokenpos(op);
+}
+
+
+/*------------------------------------------------------------------------*/
+/** 予約語のトークンを作成
+ *
+ * @param tokn		[in] トークンID
+ * @param s			[in] オペレータ文字列
+ *
+ * @return			トークンID
+ */
+
+int lex_reserveword(int tokn, char *s)
+{
+    switch (tokn)
+    {
+        case kMULOP:
+            if (strcasecmp(s, "div") == 0)
+                yylval.op = kNPS_DIV;
+            else if (strcasecmp(s, "mod") == 0)
+                yylval.op = kNPS_MOD;
+            break;
+
+        case kNOTOP:
+            yylval.op = kNPS_NOT;
+            break;
+    }
+
+    return tokn;
+}
+
+
+/*------------------------------------------------------------------------*/
+/** シンボルトークンの作成
+ *
+ * @param s			[in] 文字列
+ * @param trunc		[in] 前後の切り詰め
+ *
+ * @return			トークンID
+ */
+
+int lex_makesymbol(char *s, bool trunc)
+{
+    if (trunc)
+    {
+        s = lex_escapestr(lex_truncstr(s));
+    }
+    else
+    {
+        int	tokn;
+        int	wlen;
+
+        wlen = sizeof(reserved_words) / sizeof(keyword_t);
+        tokn = lookup_words(reserved_words, wlen, s);
+
+        if (tokn != -1)
+            return lex_update_tokenpos(lex_reserveword(tokn, s));
+    }
+
+    yylval.obj = NewtMakeSymbol(s);
+    lex_debug(kSYMBOL);
+
+	return lex_update_tokenpos(kSYMBOL);
+}
+
+
+/*------------------------------------------------------------------------*/
+/** 文字列トークンの作成
+ *
+ * @param s			[in] 文字列
+ * @param trunc		[in] 前後の切り詰め
+ *
+ * @return			トークンID
+ */
+
+int lex_makestring(char *s, bool trunc)
+{
+    if (trunc)
+        s = lex_escapestr(lex_truncstr(s));
+
+    yylval.obj = NewtMakeString(s, true);
+    lex_debug(kSTRING);
+
+	return lex_update_tokenpos(kSTRING);
+}
+
+
+/*------------------------------------------------------------------------*/
+/** 正規表現トークンの作成
+ *
+ * @param s			[in] 文字列
+ * @param trunc		[in] 前後の切り詰め
+ *
+ * @return			トークンID
+ */
+
+int lex_makeregex(char *s, bool trunc)
+{
+    if (trunc)
+        s = lex_escapestr(lex_truncstr(s));
+
+    yylval.obj = NewtMakeString(s, true);
+    lex_debug(kREGEX);
+
+	return lex_update_tokenpos(kREGEX);
+}
+
+
+/*------------------------------------------------------------------------*/
+/** 文字トークンの作成
+ *
+ * @param c			[in] 文字
+ *
+ * @return			トークンID
+ */
+
+int lex_makechar(intptr_t c)
+{
+    yylval.obj = NewtMakeCharacter(c);
+    lex_debug(kCHARACTER);
+
+	return lex_update_tokenpos(kCHARACTER);
+}
+
+
+/*------------------------------------------------------------------------*/
+/** 整数トークンの作成
+ *
+ * @param n			[in] 整数
+ *
+ * @return			トークンID
+ */
+
+int lex_makeinteger(intptr_t n)
+{
+    yylval.obj = NewtMakeInteger(n);
+    lex_debug(kINTEGER);
+
+	return lex_update_tokenpos(kINTEGER);
+}
+
+
+/*------------------------------------------------------------------------*/
+/** 浮動小数点トークンの作成
+ *
+ * @param n			[in] 浮動小数点
+ *
+ * @return			トークンID
+ */
+
+int lex_makereal(double n)
+{
+    yylval.obj = NewtMakeReal(n);
+    lex_debug(kREAL);
+
+	return lex_update_tokenpos(kREAL);
+}
+
+
+#ifdef __NAMED_MAGIC_POINTER__
+
+/*------------------------------------------------------------------------*/
+/** 名前付マジックポインタの作成
+ *
+ * @param s			[in] 文字列
+ * @param trunc		[in] 前後の切り詰め
+ *
+ * @return			トークンID
+ */
+
+int lex_makenamedmp(char *s, bool trunc)
+{
+	int		pos;
+
+    if (trunc)
+    {
+        s = lex_escapestr(lex_truncstr(s));
+    }
+
+    yylval.obj = NewtMakeNamedMP(s);
+    lex_debug(kMAGICPOINTER);
+
+	pos = lex_update_tokenpos(kMAGICPOINTER);
+
+	// NOS2 非互換
+	WORN_NOS2("Named Magic Pinter");
+
+	return pos;
+}
+
+#else
+
+/*------------------------------------------------------------------------*/
+/** 名前付マジックポインタの作成
+ *
+ * @param s			[in] 文字列
+ * @param trunc		[in] 前後の切り詰め
+ *
+ * @return			トークンID
+ */
+
+int lex_makenamedmp(char *s, bool trunc)
+{
+	return lex_update_tokenpos(kERROR);
+}
+
+#endif
+
+
+/*------------------------------------------------------------------------*/
+/** マジックポインタトークンの作成
+ *
+ * @param n			[in] マジックポインタ番号
+ *
+ * @return			トークンID
+ */
+
+int lex_makemagicpointer(intptr_t n)
+{
+	if (0x03ff < n)
+	{	// 数値が範囲外
+		return lex_update_tokenpos(kERROR);
+	}
+
+	yylval.obj = NewtMakeMagicPointer(0, n);
+    lex_debug(kMAGICPOINTER);
+
+	return lex_update_tokenpos(kMAGICPOINTER);
+}
+
+
+#if 0
+#pragma mark -
+#endif
+/*------------------------------------------------------------------------*/
+/** デバッグ表示
+ *
+ * @param type		[in] トークンID
+ *
+ * @return			なし
+ */
+
+void lex_debug(int type)
+{
+    char *	name = "unknown";
+
+    if (! NEWT_DUMPLEX)
+        return;
+
+    switch (type)
+    {
+        case kSYMBOL:
+            name = "symbol";
+            break;
+
+        case kSTRING:
+            name = "string";
+            break;
+
+        case kINTEGER:
+            name = "integer";
+            break;
+
+        case kREAL:
+            name = "real";
+            break;
+
+		case kMAGICPOINTER:
+            name = "magic pointer";
+			break;
+    }
+
+    NewtFprintf(stderr, "  %s\t==> ", name);
+    NewtPrintObject(stderr, yylval.obj);
+}
+
+
+#if 0
+#pragma mark -
+#endif
+//--------------------------------------------------------------------------
+/** 字句解析のための初期化
+ *
+ * @return			なし
+ */
+
+void nps_yyinit(void)
+{
+	static bool inited = 0; // was "false"
+
+	if (! inited)
+	{   //単語テーブルのソート
+		lookup_sorttable(reserved_words, sizeof(reserved_words) / sizeof(keyword_t));
+		lookup_sorttable(operator_words, sizeof(operator_words) / sizeof(keyword_t));
+
+		inited = true;
+	}
+}
+
+
+//--------------------------------------------------------------------------
+/** 字句解析の後始末
+ *
+ * @return			なし
+ */
+
+int nps_yycleanup(void)
+{
+	BEGIN INITIAL;
+	YY_FLUSH_BUFFER;
+  memset(nps_env.linebuf, '\0', sizeof(nps_env.linebuf));
+	yyterminate();
+}
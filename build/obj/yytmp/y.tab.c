@@ -0,0 +1,2390 @@
+/* A Bison parser, made by GNU Bison 3.8.2.  */
+
+/* Bison implementation for Yacc-like parsers in C
+
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
+   Inc.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
+
+/* As a special exception, you may create a larger work that contains
+   part or all of the Bison parser skeleton and distribute that work
+   under terms of your choice, so long as that work isn't itself a
+   parser generator using the skeleton or a modified version thereof
+   as a parser skeleton.  Alternatively, if you modify or redistribute
+   the parser skeleton itself, you may (at your option) remove this
+   special exception, which will cause the skeleton and the resulting
+   Bison output files to be licensed under the GNU General Public
+   License without this special exception.
+
+   This special exception was added by the Free Software Foundation in
+   version 2.2 of Bison.  */
+
+/* C LALR(1) parser skeleton written by Richard Stallman, by
+   simplifying the original so-called "semantic" parser.  */
+
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
+
+/* All symbols defined below should begin with yy or YY, to avoid
+   infringing on user name space.  This should be done even for local
+   variables, as they might otherwise be expanded by user macros.
+   There are some unavoidable exceptions within include files to
+   define necessary library symbols; they are noted "INFRINGES ON
+   USER NAME SPACE" below.  */
+
+/* Identify Bison output, and Bison version.  */
+#define YYBISON 30802
+
+/* Bison version string.  */
+#define YYBISON_VERSION "3.8.2"
+
+/* Skeleton name.  */
+#define YYSKELETON_NAME "yacc.c"
+
+/* Pure parsers.  */
+#define YYPURE 0
+
+/* Push parsers.  */
+#define YYPUSH 0
+
+/* Pull parsers.  */
+#define YYPULL 1
+
+
+
+
+/* First part of user prologue.  */
+#line 12 "./src/parser/newt.y"
+
+
+/* ヘッダファイル */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "yacc.h"
+
+#include "NewtCore.h"
+#include "NewtParser.h"
+
+
+/* マクロ */
+#define SYMCHECK(v, sym)	if (v != sym) NPSError(kNErrSyntaxError);
+#define TYPECHECK(v)		if (! (v == NS_INT || v == NSSYM0(array))) NPSError(kNErrSyntaxError);
+#define ERR_NOS2C(msg)		if (NEWT_MODE_NOS2) yyerror(msg);
+
+
+
+#line 92 "build/obj/yytmp/y.tab.c"
+
+# ifndef YY_CAST
+#  ifdef __cplusplus
+#   define YY_CAST(Type, Val) static_cast<Type> (Val)
+#   define YY_REINTERPRET_CAST(Type, Val) reinterpret_cast<Type> (Val)
+#  else
+#   define YY_CAST(Type, Val) ((Type) (Val))
+#   define YY_REINTERPRET_CAST(Type, Val) ((Type) (Val))
+#  endif
+# endif
+# ifndef YY_NULLPTR
+#  if defined __cplusplus
+#   if 201103L <= __cplusplus
+#    define YY_NULLPTR nullptr
+#   else
+#    define YY_NULLPTR 0
+#   endif
+#  else
+#   define YY_NULLPTR ((void*)0)
+#  endif
+# endif
+
+#include "y.tab.h"
+/* Symbol kind.  */
+enum yysymbol_kind_t
+{
+  YYSYMBOL_YYEMPTY = -2,
+  YYSYMBOL_YYEOF = 0,                      /* "end of file"  */
+  YYSYMBOL_YYerror = 1,                    /* error  */
+  YYSYMBOL_YYUNDEF = 2,                    /* "invalid token"  */
+  YYSYMBOL_kBINBG = 3,                     /* kBINBG  */
+  YYSYMBOL_kBINED = 4,                     /* kBINED  */
+  YYSYMBOL_kBEGIN = 5,                     /* kBEGIN  */
+  YYSYMBOL_kEND = 6,                       /* kEND  */
+  YYSYMBOL_kFUNC = 7,                      /* kFUNC  */
+  YYSYMBOL_kNATIVE = 8,                    /* kNATIVE  */
+  YYSYMBOL_kCALL = 9,                      /* kCALL  */
+  YYSYMBOL_kWITH = 10,                     /* kWITH  */
+  YYSYMBOL_kFOR = 11,                      /* kFOR  */
+  YYSYMBOL_kFOREACH = 12,                  /* kFOREACH  */
+  YYSYMBOL_kTO = 13,                       /* kTO  */
+  YYSYMBOL_kBY = 14,                       /* kBY  */
+  YYSYMBOL_kSELF = 15,                     /* kSELF  */
+  YYSYMBOL_kINHERITED = 16,                /* kINHERITED  */
+  YYSYMBOL_kIF = 17,                       /* kIF  */
+  YYSYMBOL_kTRY = 18,                      /* kTRY  */
+  YYSYMBOL_kONEXCEPTION = 19,              /* kONEXCEPTION  */
+  YYSYMBOL_kLOOP = 20,                     /* kLOOP  */
+  YYSYMBOL_kWHILE = 21,                    /* kWHILE  */
+  YYSYMBOL_kREPEAT = 22,                   /* kREPEAT  */
+  YYSYMBOL_kUNTIL = 23,                    /* kUNTIL  */
+  YYSYMBOL_kDO = 24,                       /* kDO  */
+  YYSYMBOL_kIN = 25,                       /* kIN  */
+  YYSYMBOL_kGLOBAL = 26,                   /* kGLOBAL  */
+  YYSYMBOL_kLOCAL = 27,                    /* kLOCAL  */
+  YYSYMBOL_kCONSTANT = 28,                 /* kCONSTANT  */
+  YYSYMBOL_k3READER = 29,                  /* k3READER  */
+  YYSYMBOL_kERROR = 30,                    /* kERROR  */
+  YYSYMBOL_kSYMBOL = 31,                   /* kSYMBOL  */
+  YYSYMBOL_kSTRING = 32,                   /* kSTRING  */
+  YYSYMBOL_kREGEX = 33,                    /* kREGEX  */
+  YYSYMBOL_kINTEGER = 34,                  /* kINTEGER  */
+  YYSYMBOL_kREAL = 35,                     /* kREAL  */
+  YYSYMBOL_kCHARACTER = 36,                /* kCHARACTER  */
+  YYSYMBOL_kMAGICPOINTER = 37,             /* kMAGICPOINTER  */
+  YYSYMBOL_kTRUE = 38,                     /* kTRUE  */
+  YYSYMBOL_kNIL = 39,                      /* kNIL  */
+  YYSYMBOL_kUNBIND = 40,                   /* kUNBIND  */
+  YYSYMBOL_kEXPR2 = 41,                    /* kEXPR2  */
+  YYSYMBOL_kBREAK = 42,                    /* kBREAK  */
+  YYSYMBOL_kRETURN = 43,                   /* kRETURN  */
+  YYSYMBOL_44_ = 44,                       /* ','  */
+  YYSYMBOL_kTHEN = 45,                     /* kTHEN  */
+  YYSYMBOL_kELSE = 46,                     /* kELSE  */
+  YYSYMBOL_kASNOP = 47,                    /* kASNOP  */
+  YYSYMBOL_kANDOP = 48,                    /* kANDOP  */
+  YYSYMBOL_kOROP = 49,                     /* kOROP  */
+  YYSYMBOL_kNOTOP = 50,                    /* kNOTOP  */
+  YYSYMBOL_kRELOP = 51,                    /* kRELOP  */
+  YYSYMBOL_kEXISTS = 52,                   /* kEXISTS  */
+  YYSYMBOL_kSTROP = 53,                    /* kSTROP  */
+  YYSYMBOL_kADDOP = 54,                    /* kADDOP  */
+  YYSYMBOL_kMULOP = 55,                    /* kMULOP  */
+  YYSYMBOL_kSFTOP = 56,                    /* kSFTOP  */
+  YYSYMBOL_kUMINUS = 57,                   /* kUMINUS  */
+  YYSYMBOL_58_ = 58,                       /* '['  */
+  YYSYMBOL_59_ = 59,                       /* ']'  */
+  YYSYMBOL_kSNDOP = 60,                    /* kSNDOP  */
+  YYSYMBOL_61_ = 61,                       /* ':'  */
+  YYSYMBOL_62_ = 62,                       /* '.'  */
+  YYSYMBOL_63_ = 63,                       /* '('  */
+  YYSYMBOL_64_ = 64,                       /* ')'  */
+  YYSYMBOL_65_ = 65,                       /* ';'  */
+  YYSYMBOL_66_ = 66,                       /* '\''  */
+  YYSYMBOL_67_ = 67,                       /* '{'  */
+  YYSYMBOL_68_ = 68,                       /* '}'  */
+  YYSYMBOL_YYACCEPT = 69,                  /* $accept  */
+  YYSYMBOL_input = 70,                     /* input  */
+  YYSYMBOL_constituent_list = 71,          /* constituent_list  */
+  YYSYMBOL_constituent = 72,               /* constituent  */
+  YYSYMBOL_expr = 73,                      /* expr  */
+  YYSYMBOL_lvalue = 74,                    /* lvalue  */
+  YYSYMBOL_simple_expr = 75,               /* simple_expr  */
+  YYSYMBOL_compound_expr = 76,             /* compound_expr  */
+  YYSYMBOL_expr_sequence = 77,             /* expr_sequence  */
+  YYSYMBOL_literal = 78,                   /* literal  */
+  YYSYMBOL_simple_literal = 79,            /* simple_literal  */
+  YYSYMBOL_object = 80,                    /* object  */
+  YYSYMBOL_path_expr = 81,                 /* path_expr  */
+  YYSYMBOL_array = 82,                     /* array  */
+  YYSYMBOL_array_item_list = 83,           /* array_item_list  */
+  YYSYMBOL_frame = 84,                     /* frame  */
+  YYSYMBOL_frame_slot_list = 85,           /* frame_slot_list  */
+  YYSYMBOL_binary = 86,                    /* binary  */
+  YYSYMBOL_binary_item_list = 87,          /* binary_item_list  */
+  YYSYMBOL_constructor = 88,               /* constructor  */
+  YYSYMBOL_expr_list = 89,                 /* expr_list  */
+  YYSYMBOL_frame_constructor_list = 90,    /* frame_constructor_list  */
+  YYSYMBOL_frame_slot_value = 91,          /* frame_slot_value  */
+  YYSYMBOL_func_keyword = 92,              /* func_keyword  */
+  YYSYMBOL_formal_argument_list = 93,      /* formal_argument_list  */
+  YYSYMBOL_formal_argument_list2 = 94,     /* formal_argument_list2  */
+  YYSYMBOL_formal_argument = 95,           /* formal_argument  */
+  YYSYMBOL_indefinite_argument = 96,       /* indefinite_argument  */
+  YYSYMBOL_type = 97,                      /* type  */
+  YYSYMBOL_frame_accessor = 98,            /* frame_accessor  */
+  YYSYMBOL_array_accessor = 99,            /* array_accessor  */
+  YYSYMBOL_exists_expr = 100,              /* exists_expr  */
+  YYSYMBOL_function_call = 101,            /* function_call  */
+  YYSYMBOL_actual_argument_list = 102,     /* actual_argument_list  */
+  YYSYMBOL_message_send = 103,             /* message_send  */
+  YYSYMBOL_if_expr = 104,                  /* if_expr  */
+  YYSYMBOL_iteration = 105,                /* iteration  */
+  YYSYMBOL_by_expr = 106,                  /* by_expr  */
+  YYSYMBOL_foreach_operator = 107,         /* foreach_operator  */
+  YYSYMBOL_deeply = 108,                   /* deeply  */
+  YYSYMBOL_onexcp_list = 109,              /* onexcp_list  */
+  YYSYMBOL_onexcp = 110,                   /* onexcp  */
+  YYSYMBOL_local_declaration = 111,        /* local_declaration  */
+  YYSYMBOL_l_init_clause_list = 112,       /* l_init_clause_list  */
+  YYSYMBOL_init_clause = 113,              /* init_clause  */
+  YYSYMBOL_c_init_clause_list = 114,       /* c_init_clause_list  */
+  YYSYMBOL_c_init_clause = 115,            /* c_init_clause  */
+  YYSYMBOL_global_declaration = 116,       /* global_declaration  */
+  YYSYMBOL_global_function_decl = 117,     /* global_function_decl  */
+  YYSYMBOL_function_decl = 118             /* function_decl  */
+};
+typedef enum yysymbol_kind_t yysymbol_kind_t;
+
+
+
+
+#ifdef short
+# undef short
+#endif
+
+/* On compilers that do not define __PTRDIFF_MAX__ etc., make sure
+   <limits.h> and (if available) <stdint.h> are included
+   so that the code can choose integer types of a good width.  */
+
+#ifndef __PTRDIFF_MAX__
+# include <limits.h> /* INFRINGES ON USER NAME SPACE */
+# if defined __STDC_VERSION__ && 199901 <= __STDC_VERSION__
+#  include <stdint.h> /* INFRINGES ON USER NAME SPACE */
+#  define YY_STDINT_H
+# endif
+#endif
+
+/* Narrow types that promote to a signed type and that can represent a
+   signed or unsigned integer of at least N bits.  In tables they can
+   save space and decrease cache pressure.  Promoting to a signed type
+   helps avoid bugs in integer arithmetic.  */
+
+#ifdef __INT_LEAST8_MAX__
+typedef __INT_LEAST8_TYPE__ yytype_int8;
+#elif defined YY_STDINT_H
+typedef int_least8_t yytype_int8;
+#else
+typedef signed char yytype_int8;
+#endif
+
+#ifdef __INT_LEAST16_MAX__
+typedef __INT_LEAST16_TYPE__ yytype_int16;
+#elif defined YY_STDINT_H
+typedef int_least16_t yytype_int16;
+#else
+typedef short yytype_int16;
+#endif
+
+/* Work around bug in HP-UX 11.23, which defines these macros
+   incorrectly for preprocessor constants.  This workaround can likely
+   be removed in 2023, as HPE has promised support for HP-UX 11.23
+   (aka HP-UX 11i v2) only through the end of 2022; see Table 2 of
+   <https://h20195.www2.hpe.com/V2/getpdf.aspx/4AA4-7673ENW.pdf>.  */
+#ifdef __hpux
+# undef UINT_LEAST8_MAX
+# undef UINT_LEAST16_MAX
+# define UINT_LEAST8_MAX 255
+# define UINT_LEAST16_MAX 65535
+#endif
+
+#if defined __UINT_LEAST8_MAX__ && __UINT_LEAST8_MAX__ <= __INT_MAX__
+typedef __UINT_LEAST8_TYPE__ yytype_uint8;
+#elif (!defined __UINT_LEAST8_MAX__ && defined YY_STDINT_H \
+       && UINT_LEAST8_MAX <= INT_MAX)
+typedef uint_least8_t yytype_uint8;
+#elif !defined __UINT_LEAST8_MAX__ && UCHAR_MAX <= INT_MAX
+typedef unsigned char yytype_uint8;
+#else
+typedef short yytype_uint8;
+#endif
+
+#if defined __UINT_LEAST16_MAX__ && __UINT_LEAST16_MAX__ <= __INT_MAX__
+typedef __UINT_LEAST16_TYPE__ yytype_uint16;
+#elif (!defined __UINT_LEAST16_MAX__ && defined YY_STDINT_H \
+       && UINT_LEAST16_MAX <= INT_MAX)
+typedef uint_least16_t yytype_uint16;
+#elif !defined __UINT_LEAST16_MAX__ && USHRT_MAX <= INT_MAX
+typedef unsigned short yytype_uint16;
+#else
+typedef int yytype_uint16;
+#endif
+
+#ifndef YYPTRDIFF_T
+# if defined __PTRDIFF_TYPE__ && defined __PTRDIFF_MAX__
+#  define YYPTRDIFF_T __PTRDIFF_TYPE__
+#  define YYPTRDIFF_MAXIMUM __PTRDIFF_MAX__
+# elif defined PTRDIFF_MAX
+#  ifndef ptrdiff_t
+#   include <stddef.h> /* INFRINGES ON USER NAME SPACE */
+#  endif
+#  define YYPTRDIFF_T ptrdiff_t
+#  define YYPTRDIFF_MAXIMUM PTRDIFF_MAX
+# else
+#  define YYPTRDIFF_T long
+#  define YYPTRDIFF_MAXIMUM LONG_MAX
+# endif
+#endif
+
+#ifndef YYSIZE_T
+# ifdef __SIZE_TYPE__
+#  define YYSIZE_T __SIZE_TYPE__
+# elif defined size_t
+#  define YYSIZE_T size_t
+# elif defined __STDC_VERSION__ && 199901 <= __STDC_VERSION__
+#  include <stddef.h> /* INFRINGES ON USER NAME SPACE */
+#  define YYSIZE_T size_t
+# else
+#  define YYSIZE_T unsigned
+# endif
+#endif
+
+#define YYSIZE_MAXIMUM                                  \
+  YY_CAST (YYPTRDIFF_T,                                 \
+           (YYPTRDIFF_MAXIMUM < YY_CAST (YYSIZE_T, -1)  \
+            ? YYPTRDIFF_MAXIMUM                         \
+            : YY_CAST (YYSIZE_T, -1)))
+
+#define YYSIZEOF(X) YY_CAST (YYPTRDIFF_T, sizeof (X))
+
+
+/* Stored state numbers (used for stacks). */
+typedef yytype_int16 yy_state_t;
+
+/* State numbers in computations.  */
+typedef int yy_state_fast_t;
+
+#ifndef YY_
+# if defined YYENABLE_NLS && YYENABLE_NLS
+#  if ENABLE_NLS
+#   include <libintl.h> /* INFRINGES ON USER NAME SPACE */
+#   define YY_(Msgid) dgettext ("bison-runtime", Msgid)
+#  endif
+# endif
+# ifndef YY_
+#  define YY_(Msgid) Msgid
+# endif
+#endif
+
+
+#ifndef YY_ATTRIBUTE_PURE
+# if defined __GNUC__ && 2 < __GNUC__ + (96 <= __GNUC_MINOR__)
+#  define YY_ATTRIBUTE_PURE __attribute__ ((__pure__))
+# else
+#  define YY_ATTRIBUTE_PURE
+# endif
+#endif
+
+#ifndef YY_ATTRIBUTE_UNUSED
+# if defined __GNUC__ && 2 < __GNUC__ + (7 <= __GNUC_MINOR__)
+#  define YY_ATTRIBUTE_UNUSED __attribute__ ((__unused__))
+# else
+#  define YY_ATTRIBUTE_UNUSED
+# endif
+#endif
+
+/* Suppress unused-variable warnings by "using" E.  */
+#if ! defined lint || defined __GNUC__
+# define YY_USE(E) ((void) (E))
+#else
+# define YY_USE(E) /* empty */
+#endif
+
+/* Suppress an incorrect diagnostic about yylval being uninitialized.  */
+#if defined __GNUC__ && ! defined __ICC && 406 <= __GNUC__ * 100 + __GNUC_MINOR__
+# if __GNUC__ * 100 + __GNUC_MINOR__ < 407
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")
+# else
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")              \
+    _Pragma ("GCC diagnostic ignored \"-Wmaybe-uninitialized\"")
+# endif
+# define YY_IGNORE_MAYBE_UNINITIALIZED_END      \
+    _Pragma ("GCC diagnostic pop")
+#else
+# define YY_INITIAL_VALUE(Value) Value
+#endif
+#ifndef YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+# define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+# define YY_IGNORE_MAYBE_UNINITIALIZED_END
+#endif
+#ifndef YY_INITIAL_VALUE
+# define YY_INITIAL_VALUE(Value) /* Nothing. */
+#endif
+
+#if defined __cplusplus && defined __GNUC__ && ! defined __ICC && 6 <= __GNUC__
+# define YY_IGNORE_USELESS_CAST_BEGIN                          \
+    _Pragma ("GCC diagnostic push")                            \
+    _Pragma ("GCC diagnostic ignored \"-Wuseless-cast\"")
+# define YY_IGNORE_USELESS_CAST_END            \
+    _Pragma ("GCC diagnostic pop")
+#endif
+#ifndef YY_IGNORE_USELESS_CAST_BEGIN
+# define YY_IGNORE_USELESS_CAST_BEGIN
+# define YY_IGNORE_USELESS_CAST_END
+#endif
+
+
+#define YY_ASSERT(E) ((void) (0 && (E)))
+
+#if !defined yyoverflow
+
+/* The parser invokes alloca or malloc; define the necessary symbols.  */
+
+# ifdef YYSTACK_USE_ALLOCA
+#  if YYSTACK_USE_ALLOCA
+#   ifdef __GNUC__
+#    define YYSTACK_ALLOC __builtin_alloca
+#   elif defined __BUILTIN_VA_ARG_INCR
+#    include <alloca.h> /* INFRINGES ON USER NAME SPACE */
+#   elif defined _AIX
+#    define YYSTACK_ALLOC __alloca
+#   elif defined _MSC_VER
+#    include <malloc.h> /* INFRINGES ON USER NAME SPACE */
+#    define alloca _alloca
+#   else
+#    define YYSTACK_ALLOC alloca
+#    if ! defined _ALLOCA_H && ! defined EXIT_SUCCESS
+#     include <stdlib.h> /* INFRINGES ON USER NAME SPACE */
+      /* Use EXIT_SUCCESS as a witness for stdlib.h.  */
+#     ifndef EXIT_SUCCESS
+#      define EXIT_SUCCESS 0
+#     endif
+#    endif
+#   endif
+#  endif
+# endif
+
+# ifdef YYSTACK_ALLOC
+   /* Pacify GCC's 'empty if-body' warning.  */
+#  define YYSTACK_FREE(Ptr) do { /* empty */; } while (0)
+#  ifndef YYSTACK_ALLOC_MAXIMUM
+    /* The OS might guarantee only one guard page at the bottom of the stack,
+       and a page size can be as small as 4096 bytes.  So we cannot safely
+       invoke alloca (N) if N exceeds 4096.  Use a slightly smaller number
+       to allow for a few compiler-allocated temporary stack slots.  */
+#   define YYSTACK_ALLOC_MAXIMUM 4032 /* reasonable circa 2006 */
+#  endif
+# else
+#  define YYSTACK_ALLOC YYMALLOC
+#  define YYSTACK_FREE YYFREE
+#  ifndef YYSTACK_ALLOC_MAXIMUM
+#   define YYSTACK_ALLOC_MAXIMUM YYSIZE_MAXIMUM
+#  endif
+#  if (defined __cplusplus && ! defined EXIT_SUCCESS \
+       && ! ((defined YYMALLOC || defined malloc) \
+             && (defined YYFREE || defined free)))
+#   include <stdlib.h> /* INFRINGES ON USER NAME SPACE */
+#   ifndef EXIT_SUCCESS
+#    define EXIT_SUCCESS 0
+#   endif
+#  endif
+#  ifndef YYMALLOC
+#   define YYMALLOC malloc
+#   if ! defined malloc && ! defined EXIT_SUCCESS
+void *malloc (YYSIZE_T); /* INFRINGES ON USER NAME SPACE */
+#   endif
+#  endif
+#  ifndef YYFREE
+#   define YYFREE free
+#   if ! defined free && ! defined EXIT_SUCCESS
+void free (void *); /* INFRINGES ON USER NAME SPACE */
+#   endif
+#  endif
+# endif
+#endif /* !defined yyoverflow */
+
+#if (! defined yyoverflow \
+     && (! defined __cplusplus \
+         || (defined YYSTYPE_IS_TRIVIAL && YYSTYPE_IS_TRIVIAL)))
+
+/* A type that is properly aligned for any stack member.  */
+union yyalloc
+{
+  yy_state_t yyss_alloc;
+  YYSTYPE yyvs_alloc;
+};
+
+/* The size of the maximum gap between one aligned stack and the next.  */
+# define YYSTACK_GAP_MAXIMUM (YYSIZEOF (union yyalloc) - 1)
+
+/* The size of an array large to enough to hold all stacks, each with
+   N elements.  */
+# define YYSTACK_BYTES(N) \
+     ((N) * (YYSIZEOF (yy_state_t) + YYSIZEOF (YYSTYPE)) \
+      + YYSTACK_GAP_MAXIMUM)
+
+# define YYCOPY_NEEDED 1
+
+/* Relocate STACK from its old location to the new one.  The
+   local variables YYSIZE and YYSTACKSIZE give the old and new number of
+   elements in the stack, and YYPTR gives the new location of the
+   stack.  Advance YYPTR to a properly aligned location for the next
+   stack.  */
+# define YYSTACK_RELOCATE(Stack_alloc, Stack)                           \
+    do                                                                  \
+      {                                                                 \
+        YYPTRDIFF_T yynewbytes;                                         \
+        YYCOPY (&yyptr->Stack_alloc, Stack, yysize);                    \
+        Stack = &yyptr->Stack_alloc;                                    \
+        yynewbytes = yystacksize * YYSIZEOF (*Stack) + YYSTACK_GAP_MAXIMUM; \
+        yyptr += yynewbytes / YYSIZEOF (*yyptr);                        \
+      }                                                                 \
+    while (0)
+
+#endif
+
+#if defined YYCOPY_NEEDED && YYCOPY_NEEDED
+/* Copy COUNT objects from SRC to DST.  The source and destination do
+   not overlap.  */
+# ifndef YYCOPY
+#  if defined __GNUC__ && 1 < __GNUC__
+#   define YYCOPY(Dst, Src, Count) \
+      __builtin_memcpy (Dst, Src, YY_CAST (YYSIZE_T, (Count)) * sizeof (*(Src)))
+#  else
+#   define YYCOPY(Dst, Src, Count)              \
+      do                                        \
+        {                                       \
+          YYPTRDIFF_T yyi;                      \
+          for (yyi = 0; yyi < (Count); yyi++)   \
+            (Dst)[yyi] = (Src)[yyi];            \
+        }                                       \
+      while (0)
+#  endif
+# endif
+#endif /* !YYCOPY_NEEDED */
+
+/* YYFINAL -- State number of the termination state.  */
+#define YYFINAL  115
+/* YYLAST -- Last index in YYTABLE.  */
+#define YYLAST   633
+
+/* YYNTOKENS -- Number of terminals.  */
+#define YYNTOKENS  69
+/* YYNNTS -- Number of nonterminals.  */
+#define YYNNTS  50
+/* YYNRULES -- Number of rules.  */
+#define YYNRULES  159
+/* YYNSTATES -- Number of states.  */
+#define YYNSTATES  292
+
+/* YYMAXUTOK -- Last valid token kind.  */
+#define YYMAXUTOK   312
+
+
+/* YYTRANSLATE(TOKEN-NUM) -- Symbol number corresponding to TOKEN-NUM
+   as returned by yylex, with out-of-bounds checking.  */
+#define YYTRANSLATE(YYX)                                \
+  (0 <= (YYX) && (YYX) <= YYMAXUTOK                     \
+   ? YY_CAST (yysymbol_kind_t, yytranslate[YYX])        \
+   : YYSYMBOL_YYUNDEF)
+
+/* YYTRANSLATE[TOKEN-NUM] -- Symbol number corresponding to TOKEN-NUM
+   as returned by yylex.  */
+static const yytype_int8 yytranslate[] =
+{
+       0,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,    66,
+      63,    64,     2,     2,    44,     2,    62,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,    61,    65,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,    58,     2,    59,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,    67,     2,    68,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     1,     2,     3,     4,
+       5,     6,     7,     8,     9,    10,    11,    12,    13,    14,
+      15,    16,    17,    18,    19,    20,    21,    22,    23,    24,
+      25,    26,    27,    28,    29,    30,    31,    32,    33,    34,
+      35,    36,    37,    38,    39,    40,    41,    42,    43,    45,
+      46,    47,    48,    49,    50,    51,    52,    53,    54,    55,
+      56,    57,    60
+};
+
+#if YYDEBUG
+/* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
+static const yytype_int16 yyrline[] =
+{
+       0,   161,   161,   165,   166,   167,   169,   171,   175,   176,
+     180,   181,   182,   183,   184,   185,   186,   190,   191,   192,
+     193,   194,   197,   198,   201,   204,   205,   208,   209,   213,
+     214,   215,   220,   221,   222,   223,   224,   225,   226,   229,
+     244,   246,   247,   251,   255,   256,   257,   259,   261,   265,
+     266,   267,   271,   276,   277,   278,   279,   280,   281,   282,
+     290,   291,   292,   293,   294,   295,   296,   300,   301,   305,
+     306,   310,   311,   312,   313,   317,   321,   322,   323,   324,
+     329,   330,   334,   335,   336,   341,   342,   345,   348,   352,
+     353,   357,   358,   359,   360,   365,   366,   367,   368,   373,
+     377,   378,   382,   383,   384,   389,   390,   395,   396,   400,
+     407,   411,   412,   416,   420,   421,   422,   423,   427,   428,
+     433,   434,   435,   439,   441,   444,   446,   449,   451,   456,
+     457,   462,   463,   465,   467,   469,   470,   474,   475,   479,
+     480,   484,   485,   489,   495,   499,   503,   504,   517,   519,
+     524,   525,   529,   530,   535,   539,   540,   544,   545,   549
+};
+#endif
+
+/** Accessing symbol of state STATE.  */
+#define YY_ACCESSING_SYMBOL(State) YY_CAST (yysymbol_kind_t, yystos[State])
+
+#if YYDEBUG || 0
+/* The user-facing name of the symbol whose (internal) number is
+   YYSYMBOL.  No bounds checking.  */
+static const char *yysymbol_name (yysymbol_kind_t yysymbol) YY_ATTRIBUTE_UNUSED;
+
+/* YYTNAME[SYMBOL-NUM] -- String name of the symbol SYMBOL-NUM.
+   First, the terminals, then, starting at YYNTOKENS, nonterminals.  */
+static const char *const yytname[] =
+{
+  "\"end of file\"", "error", "\"invalid token\"", "kBINBG", "kBINED",
+  "kBEGIN", "kEND", "kFUNC", "kNATIVE", "kCALL", "kWITH", "kFOR",
+  "kFOREACH", "kTO", "kBY", "kSELF", "kINHERITED", "kIF", "kTRY",
+  "kONEXCEPTION", "kLOOP", "kWHILE", "kREPEAT", "kUNTIL", "kDO", "kIN",
+  "kGLOBAL", "kLOCAL", "kCONSTANT", "k3READER", "kERROR", "kSYMBOL",
+  "kSTRING", "kREGEX", "kINTEGER", "kREAL", "kCHARACTER", "kMAGICPOINTER",
+  "kTRUE", "kNIL", "kUNBIND", "kEXPR2", "kBREAK", "kRETURN", "','",
+  "kTHEN", "kELSE", "kASNOP", "kANDOP", "kOROP", "kNOTOP", "kRELOP",
+  "kEXISTS", "kSTROP", "kADDOP", "kMULOP", "kSFTOP", "kUMINUS", "'['",
+  "']'", "kSNDOP", "':'", "'.'", "'('", "')'", "';'", "'\\''", "'{'",
+  "'}'", "$accept", "input", "constituent_list", "constituent", "expr",
+  "lvalue", "simple_expr", "compound_expr", "expr_sequence", "literal",
+  "simple_literal", "object", "path_expr", "array", "array_item_list",
+  "frame", "frame_slot_list", "binary", "binary_item_list", "constructor",
+  "expr_list", "frame_constructor_list", "frame_slot_value",
+  "func_keyword", "formal_argument_list", "formal_argument_list2",
+  "formal_argument", "indefinite_argument", "type", "frame_accessor",
+  "array_accessor", "exists_expr", "function_call", "actual_argument_list",
+  "message_send", "if_expr", "iteration", "by_expr", "foreach_operator",
+  "deeply", "onexcp_list", "onexcp", "local_declaration",
+  "l_init_clause_list", "init_clause", "c_init_clause_list",
+  "c_init_clause", "global_declaration", "global_function_decl",
+  "function_decl", YY_NULLPTR
+};
+
+static const char *
+yysymbol_name (yysymbol_kind_t yysymbol)
+{
+  return yytname[yysymbol];
+}
+#endif
+
+#define YYPACT_NINF (-157)
+
+#define yypact_value_is_default(Yyn) \
+  ((Yyn) == YYPACT_NINF)
+
+#define YYTABLE_NINF (-111)
+
+#define yytable_value_is_error(Yyn) \
+  0
+
+/* YYPACT[STATE-NUM] -- Index in YYTABLE of the portion describing
+   STATE-NUM.  */
+static const yytype_int16 yypact[] =
+{
+     275,    37,   340,    31,   340,    13,    25,  -157,    36,   340,
+     340,   340,   340,   340,    67,    75,   101,   -27,  -157,   103,
+    -157,  -157,  -157,   108,  -157,  -157,  -157,   340,   340,   340,
+     340,   405,   118,   128,   340,    76,   129,   164,    17,  -157,
+     564,   114,  -157,  -157,  -157,  -157,  -157,  -157,   117,  -157,
+    -157,  -157,  -157,  -157,  -157,  -157,  -157,  -157,    -1,  -157,
+    -157,   141,   135,  -157,  -157,  -157,  -157,  -157,  -157,     1,
+     162,   564,    18,  -157,   121,   123,  -157,   161,   140,    21,
+     157,   158,   485,    19,   564,   467,    20,   -12,  -157,  -157,
+     145,   149,  -157,   147,   151,  -157,  -157,   340,  -157,   340,
+     564,   564,   206,    78,   102,   564,    -2,   133,    29,   500,
+     143,  -157,   142,   -36,  -157,  -157,   146,   275,   340,   340,
+     340,   340,   340,   340,   340,   340,   175,   176,   -30,   340,
+    -157,    76,   187,    39,  -157,     5,   159,   -21,  -157,    76,
+     163,  -157,   340,   193,   193,   167,   340,  -157,   204,   212,
+     179,   181,   340,   210,   226,  -157,   340,   340,   340,   145,
+     149,   216,   340,   101,   564,   -18,   564,   340,   340,  -157,
+     340,  -157,   340,  -157,   340,   129,  -157,  -157,  -157,   206,
+     206,   266,   331,   396,   571,    78,   549,   186,    42,  -157,
+     340,   564,    11,   143,  -157,    76,    76,  -157,    76,   220,
+    -157,  -157,  -157,   564,   221,   191,   214,  -157,   225,   199,
+     340,   178,   239,   340,   340,   340,   517,   248,  -157,   564,
+     564,   564,  -157,   564,  -157,   340,  -157,    43,   564,    22,
+      26,   564,  -157,  -157,   340,  -157,   340,   532,  -157,    44,
+    -157,  -157,   215,   340,   242,  -157,   340,    45,   340,   250,
+     451,    83,    84,   340,   340,   564,  -157,  -157,  -157,    86,
+      87,  -157,  -157,    76,   564,    62,  -157,  -157,   564,  -157,
+     432,   340,  -157,  -157,   340,  -157,  -157,   564,   564,  -157,
+    -157,  -157,  -157,   340,   253,   451,   564,   564,   340,   340,
+     564,   564
+};
+
+/* YYDEFACT[STATE-NUM] -- Default reduction number in state STATE-NUM.
+   Performed when YYTABLE does not specify something else to do.  Zero
+   means the default is an error.  */
+static const yytype_uint8 yydefact[] =
+{
+       3,    82,    44,   100,     0,     0,     0,    42,     0,     0,
+      44,     0,     0,    44,     0,     0,     0,    29,    50,    90,
+      53,    54,    55,    56,    57,    58,    59,    22,    27,     0,
+       0,    91,     0,     0,     0,     0,    95,     0,     0,     4,
+       8,    14,    10,    11,    12,    49,    51,    13,    30,    31,
+      17,    18,    19,    20,    21,    25,     9,   156,    62,    61,
+      56,    71,    76,    60,    83,    63,    64,    65,    66,     0,
+     100,    45,     0,   101,     0,     0,   158,     0,     0,   141,
+       0,     0,     0,     0,   131,     0,     0,   150,   155,   157,
+     150,   146,   148,     0,    26,   152,   114,   120,    89,     0,
+      23,    28,    40,    39,    29,    92,     0,     0,     0,     0,
+      62,    52,     0,     0,    96,     1,     0,     5,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+     115,    82,     0,    62,    72,     0,     0,     0,    81,     0,
+       0,    43,    46,   102,   102,     0,     0,   142,     0,     0,
+       0,     0,     0,     0,    24,   143,     0,     0,     0,   150,
+     147,     0,     0,     0,   121,     0,    16,    91,    93,    86,
+     120,   116,   120,    41,     0,    97,    87,     7,     6,    36,
+      37,    35,    38,    32,    33,    34,     0,     0,     0,   111,
+       0,    15,     0,    67,    68,    71,    73,    70,     0,    78,
+      75,    84,    48,    47,   107,     0,   103,   105,     0,     0,
+     120,     0,   141,     0,   120,   120,   129,     0,   144,   135,
+     136,   151,   149,   154,   153,     0,   118,     0,    94,     0,
+       0,    99,    98,   113,   120,   117,   120,     0,    80,     0,
+      74,    77,     0,     0,     0,   108,     0,     0,     0,     0,
+       0,     0,     0,     0,     0,   122,    85,   124,   123,     0,
+       0,   112,    69,     0,   159,   107,   106,   104,    88,   119,
+     137,     0,   139,   140,     0,   128,   127,   130,   145,   126,
+     125,    79,   109,     0,     0,     0,   133,   138,     0,     0,
+     132,   134
+};
+
+/* YYPGOTO[NTERM-NUM].  */
+static const yytype_int16 yypgoto[] =
+{
+    -157,  -157,  -157,   168,     0,  -157,  -157,  -157,    40,  -157,
+       2,   -13,   166,  -157,    99,  -157,  -157,     6,   148,  -157,
+     132,  -157,   106,  -157,   156,  -157,    60,  -157,  -157,  -157,
+    -157,  -157,  -157,  -156,  -157,  -157,  -157,  -157,    38,    93,
+    -157,   177,  -157,   240,    -8,  -157,   153,  -157,  -157,   318
+};
+
+/* YYDEFGOTO[NTERM-NUM].  */
+static const yytype_int16 yydefgoto[] =
+{
+       0,    37,    38,    39,   164,    41,    42,    43,    72,    44,
+      45,    64,    65,    66,   135,    67,   137,    46,    69,    47,
+     106,   113,   114,    75,   205,   206,   207,   267,   208,    48,
+      49,    50,    51,   165,    52,    53,    54,   284,   274,   149,
+     154,   155,    55,    91,    92,    94,    95,    56,    57,    76
+};
+
+/* YYTABLE[YYPACT[STATE-NUM]] -- What to do in state STATE-NUM.  If
+   positive, shift that token.  If negative, reduce the rule whose
+   number is the opposite.  If YYTABLE_NINF, syntax error.  */
+static const yytype_int16 yytable[] =
+{
+      40,   189,    71,    63,    77,   138,    88,    68,   175,    82,
+      71,    84,    85,    71,   229,   238,   230,    -2,   116,   140,
+     140,   140,   111,   199,   141,    96,   225,   100,   101,   102,
+     103,   105,   176,   190,   109,   158,    97,    63,   153,    73,
+       1,    68,   168,   157,    78,   139,   226,   200,   134,   196,
+      83,   143,   147,    86,   247,   139,    79,   169,   251,   252,
+     131,   132,    74,    63,   197,   148,   225,    68,    58,    59,
+     225,    20,    21,    22,    60,    24,    25,    26,   259,     1,
+     260,   171,   117,   142,   142,   142,   257,   168,   196,   225,
+     258,   282,   172,  -110,   235,    61,    80,    81,    87,   166,
+     195,   132,   256,   262,    62,   236,    90,   110,    59,   269,
+      20,    21,    22,    60,    24,    25,    26,    40,   179,   180,
+     181,   182,   183,   184,   185,   186,   201,   225,   225,   191,
+     225,   225,    93,    63,    61,    98,   125,    68,   126,   127,
+     128,    63,   203,    62,     1,    68,   211,   275,   276,   107,
+     279,   280,   216,   222,    96,    99,   219,   220,   221,   108,
+     112,   129,   223,   167,   115,    97,   136,   105,   228,   130,
+      73,   145,   133,    59,   231,    20,    21,    22,    60,    24,
+      25,    26,   134,   240,   143,   241,   144,   146,   150,   151,
+     237,   248,   158,   161,   162,   163,   170,    63,    63,    61,
+      63,    68,    68,   174,    68,   132,   187,   188,    62,   118,
+     119,   177,   120,   250,   121,   122,   123,   124,   193,   125,
+     198,   126,   127,   128,   204,   255,   118,   119,   202,   120,
+     210,   121,   122,   123,   124,   212,   125,   213,   126,   127,
+     128,   217,   214,   264,   215,   153,   268,   159,   270,   234,
+     281,   242,  -110,   277,   278,   243,   245,   120,   244,   121,
+     122,   123,   124,   246,   125,    63,   126,   127,   128,    68,
+     147,   285,   254,   265,   286,   271,   263,   288,     1,   192,
+       2,   232,     3,   287,     4,   178,     5,     6,   290,   291,
+       7,     8,     9,    10,   239,    11,    12,    13,   194,   227,
+     209,    14,    15,    16,   266,   249,    17,    18,    19,    20,
+      21,    22,    23,    24,    25,    26,   224,    27,    28,   121,
+     122,   123,   124,   289,   125,    29,   126,   127,   128,    30,
+     160,   218,    89,    31,     0,    32,    33,     0,    34,     0,
+       0,    35,    36,     1,     0,     2,     0,    70,     0,     4,
+       0,     5,     6,     0,     0,     7,     8,     9,    10,     0,
+      11,    12,    13,     0,     0,     0,     0,    15,    16,     0,
+       0,    17,    18,    19,    20,    21,    22,    23,    24,    25,
+      26,     0,    27,    28,     0,   122,   123,   124,     0,   125,
+      29,   126,   127,   128,    30,     0,     0,     0,    31,     0,
+      32,    33,     0,    34,     0,     0,    35,    36,     1,     0,
+       2,     0,    70,     0,     4,     0,     5,     6,     0,     0,
+       7,     8,     9,    10,     0,    11,    12,    13,     0,     0,
+       0,     0,    15,    16,     0,     0,   104,    18,    19,    20,
+      21,    22,    23,    24,    25,    26,   283,    27,    28,     0,
+       0,   123,   124,     0,   125,    29,   126,   127,   128,    30,
+       0,     0,     0,    31,     0,    32,    33,     0,    34,     0,
+       0,    35,    36,     0,     0,   272,     0,     0,     0,     0,
+     118,   119,   273,   120,     0,   121,   122,   123,   124,     0,
+     125,   156,   126,   127,   128,     0,     0,     0,     0,   118,
+     119,     0,   120,     0,   121,   122,   123,   124,     0,   125,
+       0,   126,   127,   128,     0,   118,   119,     0,   120,     0,
+     121,   122,   123,   124,     0,   125,     0,   126,   127,   128,
+     152,     0,     0,   118,   119,     0,   120,     0,   121,   122,
+     123,   124,     0,   125,     0,   126,   127,   128,   118,   119,
+       0,   120,     0,   121,   122,   123,   124,     0,   125,     0,
+     126,   127,   128,   253,   173,   118,   119,     0,   120,     0,
+     121,   122,   123,   124,     0,   125,     0,   126,   127,   128,
+     118,   119,     0,   120,     0,   121,   122,   123,   124,     0,
+     125,     0,   126,   127,   128,     0,   261,   118,   119,     0,
+     120,     0,   121,   122,   123,   124,     0,   125,   233,   126,
+     127,   128,   118,   119,     0,   120,     0,   121,   122,   123,
+     124,     0,   125,     0,   126,   127,   128,   124,     0,   125,
+       0,   126,   127,   128
+};
+
+static const yytype_int16 yycheck[] =
+{
+       0,    31,     2,     1,     4,     4,    14,     1,    44,     9,
+      10,    11,    12,    13,   170,     4,   172,     0,     1,     1,
+       1,     1,    35,    44,     6,    52,    44,    27,    28,    29,
+      30,    31,    68,    63,    34,    47,    63,    35,    19,     8,
+       3,    35,    44,    23,    31,    44,    64,    68,    61,    44,
+      10,    63,    31,    13,   210,    44,    31,    59,   214,   215,
+      61,    62,    31,    61,    59,    44,    44,    61,    31,    32,
+      44,    34,    35,    36,    37,    38,    39,    40,   234,     3,
+     236,    52,    65,    65,    65,    65,    64,    44,    44,    44,
+      64,    29,    63,    31,    52,    58,    60,    61,    31,    99,
+      61,    62,    59,    59,    67,    63,    31,    31,    32,    64,
+      34,    35,    36,    37,    38,    39,    40,   117,   118,   119,
+     120,   121,   122,   123,   124,   125,   139,    44,    44,   129,
+      44,    44,    31,   131,    58,    32,    58,   131,    60,    61,
+      62,   139,   142,    67,     3,   139,   146,    64,    64,    31,
+      64,    64,   152,   161,    52,    47,   156,   157,   158,    31,
+      31,    47,   162,    61,     0,    63,    31,   167,   168,    52,
+       8,    10,    31,    32,   174,    34,    35,    36,    37,    38,
+      39,    40,   195,   196,    63,   198,    63,    47,    31,    31,
+     190,    13,    47,    44,    47,    44,    63,   195,   196,    58,
+     198,   195,   196,    61,   198,    62,    31,    31,    67,    48,
+      49,    65,    51,   213,    53,    54,    55,    56,    31,    58,
+      61,    60,    61,    62,    31,   225,    48,    49,    65,    51,
+      63,    53,    54,    55,    56,    31,    58,    25,    60,    61,
+      62,    31,    63,   243,    63,    19,   246,    31,   248,    63,
+     263,    31,    31,   253,   254,    64,    31,    51,    44,    53,
+      54,    55,    56,    64,    58,   263,    60,    61,    62,   263,
+      31,   271,    24,    31,   274,    25,    61,    24,     3,   131,
+       5,   175,     7,   283,     9,   117,    11,    12,   288,   289,
+      15,    16,    17,    18,   195,    20,    21,    22,   132,   167,
+     144,    26,    27,    28,   244,   212,    31,    32,    33,    34,
+      35,    36,    37,    38,    39,    40,   163,    42,    43,    53,
+      54,    55,    56,   285,    58,    50,    60,    61,    62,    54,
+      90,   154,    14,    58,    -1,    60,    61,    -1,    63,    -1,
+      -1,    66,    67,     3,    -1,     5,    -1,     7,    -1,     9,
+      -1,    11,    12,    -1,    -1,    15,    16,    17,    18,    -1,
+      20,    21,    22,    -1,    -1,    -1,    -1,    27,    28,    -1,
+      -1,    31,    32,    33,    34,    35,    36,    37,    38,    39,
+      40,    -1,    42,    43,    -1,    54,    55,    56,    -1,    58,
+      50,    60,    61,    62,    54,    -1,    -1,    -1,    58,    -1,
+      60,    61,    -1,    63,    -1,    -1,    66,    67,     3,    -1,
+       5,    -1,     7,    -1,     9,    -1,    11,    12,    -1,    -1,
+      15,    16,    17,    18,    -1,    20,    21,    22,    -1,    -1,
+      -1,    -1,    27,    28,    -1,    -1,    31,    32,    33,    34,
+      35,    36,    37,    38,    39,    40,    14,    42,    43,    -1,
+      -1,    55,    56,    -1,    58,    50,    60,    61,    62,    54,
+      -1,    -1,    -1,    58,    -1,    60,    61,    -1,    63,    -1,
+      -1,    66,    67,    -1,    -1,    24,    -1,    -1,    -1,    -1,
+      48,    49,    31,    51,    -1,    53,    54,    55,    56,    -1,
+      58,    24,    60,    61,    62,    -1,    -1,    -1,    -1,    48,
+      49,    -1,    51,    -1,    53,    54,    55,    56,    -1,    58,
+      -1,    60,    61,    62,    -1,    48,    49,    -1,    51,    -1,
+      53,    54,    55,    56,    -1,    58,    -1,    60,    61,    62,
+      45,    -1,    -1,    48,    49,    -1,    51,    -1,    53,    54,
+      55,    56,    -1,    58,    -1,    60,    61,    62,    48,    49,
+      -1,    51,    -1,    53,    54,    55,    56,    -1,    58,    -1,
+      60,    61,    62,    46,    64,    48,    49,    -1,    51,    -1,
+      53,    54,    55,    56,    -1,    58,    -1,    60,    61,    62,
+      48,    49,    -1,    51,    -1,    53,    54,    55,    56,    -1,
+      58,    -1,    60,    61,    62,    -1,    64,    48,    49,    -1,
+      51,    -1,    53,    54,    55,    56,    -1,    58,    59,    60,
+      61,    62,    48,    49,    -1,    51,    -1,    53,    54,    55,
+      56,    -1,    58,    -1,    60,    61,    62,    56,    -1,    58,
+      -1,    60,    61,    62
+};
+
+/* YYSTOS[STATE-NUM] -- The symbol kind of the accessing symbol of
+   state STATE-NUM.  */
+static const yytype_int8 yystos[] =
+{
+       0,     3,     5,     7,     9,    11,    12,    15,    16,    17,
+      18,    20,    21,    22,    26,    27,    28,    31,    32,    33,
+      34,    35,    36,    37,    38,    39,    40,    42,    43,    50,
+      54,    58,    60,    61,    63,    66,    67,    70,    71,    72,
+      73,    74,    75,    76,    78,    79,    86,    88,    98,    99,
+     100,   101,   103,   104,   105,   111,   116,   117,    31,    32,
+      37,    58,    67,    79,    80,    81,    82,    84,    86,    87,
+       7,    73,    77,     8,    31,    92,   118,    73,    31,    31,
+      60,    61,    73,    77,    73,    73,    77,    31,   113,   118,
+      31,   112,   113,    31,   114,   115,    52,    63,    32,    47,
+      73,    73,    73,    73,    31,    73,    89,    31,    31,    73,
+      31,    80,    31,    90,    91,     0,     1,    65,    48,    49,
+      51,    53,    54,    55,    56,    58,    60,    61,    62,    47,
+      52,    61,    62,    31,    80,    83,    31,    85,     4,    44,
+       1,     6,    65,    63,    63,    10,    47,    31,    44,   108,
+      31,    31,    45,    19,   109,   110,    24,    23,    47,    31,
+     112,    44,    47,    44,    73,   102,    73,    61,    44,    59,
+      63,    52,    63,    64,    61,    44,    68,    65,    72,    73,
+      73,    73,    73,    73,    73,    73,    73,    31,    31,    31,
+      63,    73,    87,    31,    81,    61,    44,    59,    61,    44,
+      68,    80,    65,    73,    31,    93,    94,    95,    97,    93,
+      63,    73,    31,    25,    63,    63,    73,    31,   110,    73,
+      73,    73,   113,    73,   115,    44,    64,    89,    73,   102,
+     102,    73,    91,    59,    63,    52,    63,    73,     4,    83,
+      80,    80,    31,    64,    44,    31,    64,   102,    13,   108,
+      73,   102,   102,    46,    24,    73,    59,    64,    64,   102,
+     102,    64,    59,    61,    73,    31,    95,    96,    73,    64,
+      73,    25,    24,    31,   107,    64,    64,    73,    73,    64,
+      64,    80,    29,    14,   106,    73,    73,    73,    24,   107,
+      73,    73
+};
+
+/* YYR1[RULE-NUM] -- Symbol kind of the left-hand side of rule RULE-NUM.  */
+static const yytype_int8 yyr1[] =
+{
+       0,    69,    70,    71,    71,    71,    71,    71,    72,    72,
+      73,    73,    73,    73,    73,    73,    73,    73,    73,    73,
+      73,    73,    73,    73,    73,    73,    73,    73,    73,    74,
+      74,    74,    75,    75,    75,    75,    75,    75,    75,    75,
+      75,    75,    75,    76,    77,    77,    77,    77,    77,    78,
+      78,    78,    78,    79,    79,    79,    79,    79,    79,    79,
+      80,    80,    80,    80,    80,    80,    80,    81,    81,    82,
+      82,    83,    83,    83,    83,    84,    85,    85,    85,    85,
+      86,    86,    87,    87,    87,    88,    88,    88,    88,    88,
+      88,    89,    89,    89,    89,    90,    90,    90,    90,    91,
+      92,    92,    93,    93,    93,    94,    94,    95,    95,    96,
+      97,    98,    98,    99,   100,   100,   100,   100,   101,   101,
+     102,   102,   102,   103,   103,   103,   103,   103,   103,   104,
+     104,   105,   105,   105,   105,   105,   105,   106,   106,   107,
+     107,   108,   108,   109,   109,   110,   111,   111,   112,   112,
+     113,   113,   114,   114,   115,   116,   116,   117,   117,   118
+};
+
+/* YYR2[RULE-NUM] -- Number of symbols on the right-hand side of rule RULE-NUM.  */
+static const yytype_int8 yyr2[] =
+{
+       0,     2,     1,     0,     1,     2,     3,     3,     1,     1,
+       1,     1,     1,     1,     1,     3,     3,     1,     1,     1,
+       1,     1,     1,     2,     3,     1,     2,     1,     2,     1,
+       1,     1,     3,     3,     3,     3,     3,     3,     3,     2,
+       2,     3,     1,     3,     0,     1,     2,     3,     3,     1,
+       1,     1,     2,     1,     1,     1,     1,     1,     1,     1,
+       1,     1,     1,     1,     1,     1,     1,     3,     3,     5,
+       3,     0,     1,     2,     3,     3,     0,     3,     2,     5,
+       5,     3,     0,     1,     3,     5,     3,     3,     6,     2,
+       1,     0,     1,     2,     3,     0,     1,     2,     3,     3,
+       0,     1,     0,     1,     3,     1,     3,     1,     2,     2,
+       1,     3,     5,     4,     2,     2,     3,     4,     4,     6,
+       0,     1,     3,     5,     5,     6,     6,     6,     6,     4,
+       6,     2,     9,     7,     9,     4,     4,     0,     2,     1,
+       1,     0,     1,     1,     2,     4,     2,     3,     1,     3,
+       1,     3,     1,     3,     3,     2,     1,     2,     2,     5
+};
+
+
+enum { YYENOMEM = -2 };
+
+#define yyerrok         (yyerrstatus = 0)
+#define yyclearin       (yychar = YYEMPTY)
+
+#define YYACCEPT        goto yyacceptlab
+#define YYABORT         goto yyabortlab
+#define YYERROR         goto yyerrorlab
+#define YYNOMEM         goto yyexhaustedlab
+
+
+#define YYRECOVERING()  (!!yyerrstatus)
+
+#define YYBACKUP(Token, Value)                                    \
+  do                                                              \
+    if (yychar == YYEMPTY)                                        \
+      {                                                           \
+        yychar = (Token);                                         \
+        yylval = (Value);                                         \
+        YYPOPSTACK (yylen);                                       \
+        yystate = *yyssp;                                         \
+        goto yybackup;                                            \
+      }                                                           \
+    else                                                          \
+      {                                                           \
+        yyerror (YY_("syntax error: cannot back up")); \
+        YYERROR;                                                  \
+      }                                                           \
+  while (0)
+
+/* Backward compatibility with an undocumented macro.
+   Use YYerror or YYUNDEF. */
+#define YYERRCODE YYUNDEF
+
+
+/* Enable debugging if requested.  */
+#if YYDEBUG
+
+# ifndef YYFPRINTF
+#  include <stdio.h> /* INFRINGES ON USER NAME SPACE */
+#  define YYFPRINTF fprintf
+# endif
+
+# define YYDPRINTF(Args)                        \
+do {                                            \
+  if (yydebug)                                  \
+    YYFPRINTF Args;                             \
+} while (0)
+
+
+
+
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)                    \
+do {                                                                      \
+  if (yydebug)                                                            \
+    {                                                                     \
+      YYFPRINTF (stderr, "%s ", Title);                                   \
+      yy_symbol_print (stderr,                                            \
+                  Kind, Value); \
+      YYFPRINTF (stderr, "\n");                                           \
+    }                                                                     \
+} while (0)
+
+
+/*-----------------------------------.
+| Print this symbol's value on YYO.  |
+`-----------------------------------*/
+
+static void
+yy_symbol_value_print (FILE *yyo,
+                       yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep)
+{
+  FILE *yyoutput = yyo;
+  YY_USE (yyoutput);
+  if (!yyvaluep)
+    return;
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  YY_USE (yykind);
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
+}
+
+
+/*---------------------------.
+| Print this symbol on YYO.  |
+`---------------------------*/
+
+static void
+yy_symbol_print (FILE *yyo,
+                 yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep)
+{
+  YYFPRINTF (yyo, "%s %s (",
+             yykind < YYNTOKENS ? "token" : "nterm", yysymbol_name (yykind));
+
+  yy_symbol_value_print (yyo, yykind, yyvaluep);
+  YYFPRINTF (yyo, ")");
+}
+
+/*------------------------------------------------------------------.
+| yy_stack_print -- Print the state stack from its BOTTOM up to its |
+| TOP (included).                                                   |
+`------------------------------------------------------------------*/
+
+static void
+yy_stack_print (yy_state_t *yybottom, yy_state_t *yytop)
+{
+  YYFPRINTF (stderr, "Stack now");
+  for (; yybottom <= yytop; yybottom++)
+    {
+      int yybot = *yybottom;
+      YYFPRINTF (stderr, " %d", yybot);
+    }
+  YYFPRINTF (stderr, "\n");
+}
+
+# define YY_STACK_PRINT(Bottom, Top)                            \
+do {                                                            \
+  if (yydebug)                                                  \
+    yy_stack_print ((Bottom), (Top));                           \
+} while (0)
+
+
+/*------------------------------------------------.
+| Report that the YYRULE is going to be reduced.  |
+`------------------------------------------------*/
+
+static void
+yy_reduce_print (yy_state_t *yyssp, YYSTYPE *yyvsp,
+                 int yyrule)
+{
+  int yylno = yyrline[yyrule];
+  int yynrhs = yyr2[yyrule];
+  int yyi;
+  YYFPRINTF (stderr, "Reducing stack by rule %d (line %d):\n",
+             yyrule - 1, yylno);
+  /* The symbols being reduced.  */
+  for (yyi = 0; yyi < yynrhs; yyi++)
+    {
+      YYFPRINTF (stderr, "   $%d = ", yyi + 1);
+      yy_symbol_print (stderr,
+                       YY_ACCESSING_SYMBOL (+yyssp[yyi + 1 - yynrhs]),
+                       &yyvsp[(yyi + 1) - (yynrhs)]);
+      YYFPRINTF (stderr, "\n");
+    }
+}
+
+# define YY_REDUCE_PRINT(Rule)          \
+do {                                    \
+  if (yydebug)                          \
+    yy_reduce_print (yyssp, yyvsp, Rule); \
+} while (0)
+
+/* Nonzero means print parse trace.  It is left uninitialized so that
+   multiple parsers can coexist.  */
+int yydebug;
+#else /* !YYDEBUG */
+# define YYDPRINTF(Args) ((void) 0)
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)
+# define YY_STACK_PRINT(Bottom, Top)
+# define YY_REDUCE_PRINT(Rule)
+#endif /* !YYDEBUG */
+
+
+/* YYINITDEPTH -- initial size of the parser's stacks.  */
+#ifndef YYINITDEPTH
+# define YYINITDEPTH 200
+#endif
+
+/* YYMAXDEPTH -- maximum size the stacks can grow to (effective only
+   if the built-in stack extension method is used).
+
+   Do not make this value too large; the results are undefined if
+   YYSTACK_ALLOC_MAXIMUM < YYSTACK_BYTES (YYMAXDEPTH)
+   evaluated with infinite-precision integer arithmetic.  */
+
+#ifndef YYMAXDEPTH
+# define YYMAXDEPTH 10000
+#endif
+
+
+
+
+
+
+/*-----------------------------------------------.
+| Release the memory associated to this symbol.  |
+`-----------------------------------------------*/
+
+static void
+yydestruct (const char *yymsg,
+            yysymbol_kind_t yykind, YYSTYPE *yyvaluep)
+{
+  YY_USE (yyvaluep);
+  if (!yymsg)
+    yymsg = "Deleting";
+  YY_SYMBOL_PRINT (yymsg, yykind, yyvaluep, yylocationp);
+
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  YY_USE (yykind);
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
+}
+
+
+/* Lookahead token kind.  */
+int yychar;
+
+/* The semantic value of the lookahead symbol.  */
+YYSTYPE yylval;
+/* Number of syntax errors so far.  */
+int yynerrs;
+
+
+
+
+/*----------.
+| yyparse.  |
+`----------*/
+
+int
+yyparse (void)
+{
+    yy_state_fast_t yystate = 0;
+    /* Number of tokens to shift before error messages enabled.  */
+    int yyerrstatus = 0;
+
+    /* Refer to the stacks through separate pointers, to allow yyoverflow
+       to reallocate them elsewhere.  */
+
+    /* Their size.  */
+    YYPTRDIFF_T yystacksize = YYINITDEPTH;
+
+    /* The state stack: array, bottom, top.  */
+    yy_state_t yyssa[YYINITDEPTH];
+    yy_state_t *yyss = yyssa;
+    yy_state_t *yyssp = yyss;
+
+    /* The semantic value stack: array, bottom, top.  */
+    YYSTYPE yyvsa[YYINITDEPTH];
+    YYSTYPE *yyvs = yyvsa;
+    YYSTYPE *yyvsp = yyvs;
+
+  int yyn;
+  /* The return value of yyparse.  */
+  int yyresult;
+  /* Lookahead symbol kind.  */
+  yysymbol_kind_t yytoken = YYSYMBOL_YYEMPTY;
+  /* The variables used to return semantic value and location from the
+     action routines.  */
+  YYSTYPE yyval;
+
+
+
+#define YYPOPSTACK(N)   (yyvsp -= (N), yyssp -= (N))
+
+  /* The number of symbols on the RHS of the reduced rule.
+     Keep to zero when no symbol should be popped.  */
+  int yylen = 0;
+
+  YYDPRINTF ((stderr, "Starting parse\n"));
+
+  yychar = YYEMPTY; /* Cause a token to be read.  */
+
+  goto yysetstate;
+
+
+/*------------------------------------------------------------.
+| yynewstate -- push a new state, which is found in yystate.  |
+`------------------------------------------------------------*/
+yynewstate:
+  /* In all cases, when you get here, the value and location stacks
+     have just been pushed.  So pushing a state here evens the stacks.  */
+  yyssp++;
+
+
+/*--------------------------------------------------------------------.
+| yysetstate -- set current state (the top of the stack) to yystate.  |
+`--------------------------------------------------------------------*/
+yysetstate:
+  YYDPRINTF ((stderr, "Entering state %d\n", yystate));
+  YY_ASSERT (0 <= yystate && yystate < YYNSTATES);
+  YY_IGNORE_USELESS_CAST_BEGIN
+  *yyssp = YY_CAST (yy_state_t, yystate);
+  YY_IGNORE_USELESS_CAST_END
+  YY_STACK_PRINT (yyss, yyssp);
+
+  if (yyss + yystacksize - 1 <= yyssp)
+#if !defined yyoverflow && !defined YYSTACK_RELOCATE
+    YYNOMEM;
+#else
+    {
+      /* Get the current used size of the three stacks, in elements.  */
+      YYPTRDIFF_T yysize = yyssp - yyss + 1;
+
+# if defined yyoverflow
+      {
+        /* Give user a chance to reallocate the stack.  Use copies of
+           these so that the &'s don't force the real ones into
+           memory.  */
+        yy_state_t *yyss1 = yyss;
+        YYSTYPE *yyvs1 = yyvs;
+
+        /* Each stack pointer address is followed by the size of the
+           data in use in that stack, in bytes.  This used to be a
+           conditional around just the two extra args, but that might
+           be undefined if yyoverflow is a macro.  */
+        yyoverflow (YY_("memory exhausted"),
+                    &yyss1, yysize * YYSIZEOF (*yyssp),
+                    &yyvs1, yysize * YYSIZEOF (*yyvsp),
+                    &yystacksize);
+        yyss = yyss1;
+        yyvs = yyvs1;
+      }
+# else /* defined YYSTACK_RELOCATE */
+      /* Extend the stack our own way.  */
+      if (YYMAXDEPTH <= yystacksize)
+        YYNOMEM;
+      yystacksize *= 2;
+      if (YYMAXDEPTH < yystacksize)
+        yystacksize = YYMAXDEPTH;
+
+      {
+        yy_state_t *yyss1 = yyss;
+        union yyalloc *yyptr =
+          YY_CAST (union yyalloc *,
+                   YYSTACK_ALLOC (YY_CAST (YYSIZE_T, YYSTACK_BYTES (yystacksize))));
+        if (! yyptr)
+          YYNOMEM;
+        YYSTACK_RELOCATE (yyss_alloc, yyss);
+        YYSTACK_RELOCATE (yyvs_alloc, yyvs);
+#  undef YYSTACK_RELOCATE
+        if (yyss1 != yyssa)
+          YYSTACK_FREE (yyss1);
+      }
+# endif
+
+      yyssp = yyss + yysize - 1;
+      yyvsp = yyvs + yysize - 1;
+
+      YY_IGNORE_USELESS_CAST_BEGIN
+      YYDPRINTF ((stderr, "Stack size increased to %ld\n",
+                  YY_CAST (long, yystacksize)));
+      YY_IGNORE_USELESS_CAST_END
+
+      if (yyss + yystacksize - 1 <= yyssp)
+        YYABORT;
+    }
+#endif /* !defined yyoverflow && !defined YYSTACK_RELOCATE */
+
+
+  if (yystate == YYFINAL)
+    YYACCEPT;
+
+  goto yybackup;
+
+
+/*-----------.
+| yybackup.  |
+`-----------*/
+yybackup:
+  /* Do appropriate processing given the current state.  Read a
+     lookahead token if we need one and don't already have one.  */
+
+  /* First try to decide what to do without reference to lookahead token.  */
+  yyn = yypact[yystate];
+  if (yypact_value_is_default (yyn))
+    goto yydefault;
+
+  /* Not known => get a lookahead token if don't already have one.  */
+
+  /* YYCHAR is either empty, or end-of-input, or a valid lookahead.  */
+  if (yychar == YYEMPTY)
+    {
+      YYDPRINTF ((stderr, "Reading a token\n"));
+      yychar = yylex ();
+    }
+
+  if (yychar <= YYEOF)
+    {
+      yychar = YYEOF;
+      yytoken = YYSYMBOL_YYEOF;
+      YYDPRINTF ((stderr, "Now at end of input.\n"));
+    }
+  else if (yychar == YYerror)
+    {
+      /* The scanner already issued an error message, process directly
+         to error recovery.  But do not keep the error token as
+         lookahead, it is too special and may lead us to an endless
+         loop in error recovery. */
+      yychar = YYUNDEF;
+      yytoken = YYSYMBOL_YYerror;
+      goto yyerrlab1;
+    }
+  else
+    {
+      yytoken = YYTRANSLATE (yychar);
+      YY_SYMBOL_PRINT ("Next token is", yytoken, &yylval, &yylloc);
+    }
+
+  /* If the proper action on seeing token YYTOKEN is to reduce or to
+     detect an error, take that action.  */
+  yyn += yytoken;
+  if (yyn < 0 || YYLAST < yyn || yycheck[yyn] != yytoken)
+    goto yydefault;
+  yyn = yytable[yyn];
+  if (yyn <= 0)
+    {
+      if (yytable_value_is_error (yyn))
+        goto yyerrlab;
+      yyn = -yyn;
+      goto yyreduce;
+    }
+
+  /* Count tokens shifted since error; after three, turn off error
+     status.  */
+  if (yyerrstatus)
+    yyerrstatus--;
+
+  /* Shift the lookahead token.  */
+  YY_SYMBOL_PRINT ("Shifting", yytoken, &yylval, &yylloc);
+  yystate = yyn;
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  *++yyvsp = yylval;
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
+
+  /* Discard the shifted token.  */
+  yychar = YYEMPTY;
+  goto yynewstate;
+
+
+/*-----------------------------------------------------------.
+| yydefault -- do the default action for the current state.  |
+`-----------------------------------------------------------*/
+yydefault:
+  yyn = yydefact[yystate];
+  if (yyn == 0)
+    goto yyerrlab;
+  goto yyreduce;
+
+
+/*-----------------------------.
+| yyreduce -- do a reduction.  |
+`-----------------------------*/
+yyreduce:
+  /* yyn is the number of a rule to reduce with.  */
+  yylen = yyr2[yyn];
+
+  /* If YYLEN is nonzero, implement the default value of the action:
+     '$$ = $1'.
+
+     Otherwise, the following line sets YYVAL to garbage.
+     This behavior is undocumented and Bison
+     users should not rely upon it.  Assigning to YYVAL
+     unconditionally makes the parser a bit smaller, and it avoids a
+     GCC warning that YYVAL may be used uninitialized.  */
+  yyval = yyvsp[1-yylen];
+
+
+  YY_REDUCE_PRINT (yyn);
+  switch (yyn)
+    {
+  case 2: /* input: constituent_list  */
+#line 161 "./src/parser/newt.y"
+                                    {}
+#line 1476 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 3: /* constituent_list: %empty  */
+#line 165 "./src/parser/newt.y"
+                                                                { (yyval.node) = kNewtRefUnbind; }
+#line 1482 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 4: /* constituent_list: constituent  */
+#line 166 "./src/parser/newt.y"
+                                                                { (yyval.node) = NPSGenNode1(kNPSConstituentList, (yyvsp[0].node)); }
+#line 1488 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 6: /* constituent_list: constituent_list ';' constituent  */
+#line 170 "./src/parser/newt.y"
+                                                                                { (yyval.node) = NPSGenNode2(kNPSConstituentList, (yyvsp[-2].node), (yyvsp[0].node)); }
+#line 1494 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 7: /* constituent_list: constituent_list error ';'  */
+#line 171 "./src/parser/newt.y"
+                                                { yyerrok; }
+#line 1500 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 12: /* expr: literal  */
+#line 182 "./src/parser/newt.y"
+                                                                        { (yyval.node) = (yyvsp[0].obj); }
+#line 1506 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 14: /* expr: lvalue  */
+#line 184 "./src/parser/newt.y"
+                                                                        { (yyval.node) = NPSGenNode1(kNPSLvalue, (yyvsp[0].node)); }
+#line 1512 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 15: /* expr: lvalue kASNOP expr  */
+#line 185 "./src/parser/newt.y"
+                                                        { (yyval.node) = NPSGenNode2(kNPSAssign, (yyvsp[-2].node), (yyvsp[0].node)); }
+#line 1518 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 16: /* expr: kMAGICPOINTER kASNOP expr  */
+#line 186 "./src/parser/newt.y"
+                                                        {	// マジックポインタの定義（独自拡張）
+											ERR_NOS2C("Assign Magic Pointer");	// NOS2 非互換
+											(yyval.node) = NPSGenNode2(kNPSAssign, (yyvsp[-2].obj), (yyvsp[0].node));
+										}
+#line 1527 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 22: /* expr: kBREAK  */
+#line 197 "./src/parser/newt.y"
+                                                                        { (yyval.node) = NPSGenNode0(kNPSBreak); }
+#line 1533 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 23: /* expr: kBREAK expr  */
+#line 198 "./src/parser/newt.y"
+                                                                { (yyval.node) = NPSGenNode1(kNPSBreak, (yyvsp[0].node)); }
+#line 1539 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 24: /* expr: kTRY expr_sequence onexcp_list  */
+#line 202 "./src/parser/newt.y"
+                                                                                { (yyval.node) = NPSGenNode2(kNPSTry, (yyvsp[-1].node), (yyvsp[0].node)); }
+#line 1545 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 26: /* expr: kCONSTANT c_init_clause_list  */
+#line 205 "./src/parser/newt.y"
+                                                { (yyval.node) = NPSGenNode1(kNPSConstant, (yyvsp[0].node)); }
+#line 1551 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 27: /* expr: kRETURN  */
+#line 208 "./src/parser/newt.y"
+                                                                        { (yyval.node) = NPSGenNode0(kNPSReturn); }
+#line 1557 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 28: /* expr: kRETURN expr  */
+#line 209 "./src/parser/newt.y"
+                                                                { (yyval.node) = NPSGenNode1(kNPSReturn, (yyvsp[0].node)); }
+#line 1563 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 29: /* lvalue: kSYMBOL  */
+#line 213 "./src/parser/newt.y"
+                                                                        { (yyval.node) = (yyvsp[0].obj); }
+#line 1569 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 32: /* simple_expr: expr kADDOP expr  */
+#line 220 "./src/parser/newt.y"
+                                        { (yyval.node) = NPSGenOP2((yyvsp[-1].op), (yyvsp[-2].node), (yyvsp[0].node)); }
+#line 1575 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 33: /* simple_expr: expr kMULOP expr  */
+#line 221 "./src/parser/newt.y"
+                                        { (yyval.node) = NPSGenOP2((yyvsp[-1].op), (yyvsp[-2].node), (yyvsp[0].node)); }
+#line 1581 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 34: /* simple_expr: expr kSFTOP expr  */
+#line 222 "./src/parser/newt.y"
+                                        { (yyval.node) = NPSGenOP2((yyvsp[-1].op), (yyvsp[-2].node), (yyvsp[0].node)); }
+#line 1587 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 35: /* simple_expr: expr kRELOP expr  */
+#line 223 "./src/parser/newt.y"
+                                        { (yyval.node) = NPSGenOP2((yyvsp[-1].op), (yyvsp[-2].node), (yyvsp[0].node)); }
+#line 1593 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 36: /* simple_expr: expr kANDOP expr  */
+#line 224 "./src/parser/newt.y"
+                                        { (yyval.node) = NPSGenNode2(kNPSAnd, (yyvsp[-2].node), (yyvsp[0].node)); }
+#line 1599 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 37: /* simple_expr: expr kOROP expr  */
+#line 225 "./src/parser/newt.y"
+                                        { (yyval.node) = NPSGenNode2(kNPSOr, (yyvsp[-2].node), (yyvsp[0].node)); }
+#line 1605 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 38: /* simple_expr: expr kSTROP expr  */
+#line 226 "./src/parser/newt.y"
+                                        { (yyval.node) = NPSGenOP2((yyvsp[-1].op), (yyvsp[-2].node), (yyvsp[0].node)); }
+#line 1611 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 39: /* simple_expr: kADDOP expr  */
+#line 230 "./src/parser/newt.y"
+                                                        {
+								if ((yyvsp[-1].op) == '-')
+								{
+									if (NewtRefIsInteger((yyvsp[0].node)))
+										(yyval.node) = NewtMakeInteger(- NewtRefToInteger((yyvsp[0].node)));
+									else
+										(yyval.node) = NPSGenOP2('-', NewtMakeInteger(0), (yyvsp[0].node));
+								}
+								else
+								{
+									(yyval.node) = (yyvsp[0].node);
+								}
+							}
+#line 1629 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 40: /* simple_expr: kNOTOP expr  */
+#line 244 "./src/parser/newt.y"
+                                        { (yyval.node) = NPSGenOP1((yyvsp[-1].op), (yyvsp[0].node)); }
+#line 1635 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 41: /* simple_expr: '(' expr ')'  */
+#line 246 "./src/parser/newt.y"
+                                        { (yyval.node) = (yyvsp[-1].node); }
+#line 1641 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 42: /* simple_expr: kSELF  */
+#line 247 "./src/parser/newt.y"
+                                                { (yyval.node) = NPSGenNode0(kNPSPushSelf); }
+#line 1647 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 43: /* compound_expr: kBEGIN expr_sequence kEND  */
+#line 251 "./src/parser/newt.y"
+                                                { (yyval.node) = (yyvsp[-1].node); }
+#line 1653 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 44: /* expr_sequence: %empty  */
+#line 255 "./src/parser/newt.y"
+                                                        { (yyval.node) = kNewtRefUnbind; }
+#line 1659 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 47: /* expr_sequence: expr_sequence ';' expr  */
+#line 260 "./src/parser/newt.y"
+                                                                        { (yyval.node) = NPSGenNode2(kNPSConstituentList, (yyvsp[-2].node), (yyvsp[0].node)); }
+#line 1665 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 48: /* expr_sequence: expr_sequence error ';'  */
+#line 261 "./src/parser/newt.y"
+                                            { yyerrok; }
+#line 1671 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 50: /* literal: kSTRING  */
+#line 266 "./src/parser/newt.y"
+                                        { (yyval.obj) = NPSGenNode1(kNPSClone, (yyvsp[0].obj)); }
+#line 1677 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 51: /* literal: binary  */
+#line 267 "./src/parser/newt.y"
+                                        {	// バイナリデータ（独自拡張）
+							ERR_NOS2C("Binary Syntax");	// NOS2 非互換
+							(yyval.obj) = NPSGenNode1(kNPSClone, (yyvsp[0].obj));
+						}
+#line 1686 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 52: /* literal: '\'' object  */
+#line 271 "./src/parser/newt.y"
+                                { (yyval.obj) = NewtPackLiteral((yyvsp[0].obj)); }
+#line 1692 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 57: /* simple_literal: kTRUE  */
+#line 280 "./src/parser/newt.y"
+                                        { (yyval.obj) = kNewtRefTRUE; }
+#line 1698 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 58: /* simple_literal: kNIL  */
+#line 281 "./src/parser/newt.y"
+                                        { (yyval.obj) = kNewtRefNIL; }
+#line 1704 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 59: /* simple_literal: kUNBIND  */
+#line 282 "./src/parser/newt.y"
+                                        {	// #UNBIND （独自拡張）
+							ERR_NOS2C("Unbind Ref");	// NOS2 非互換
+							(yyval.obj) = kNewtRefUnbind;
+						}
+#line 1713 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 66: /* object: binary  */
+#line 296 "./src/parser/newt.y"
+                                        { ERR_NOS2C("Binary Syntax"); }
+#line 1719 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 67: /* path_expr: kSYMBOL '.' kSYMBOL  */
+#line 300 "./src/parser/newt.y"
+                                                { (yyval.obj) = NPSMakePathExpr((yyvsp[-2].obj), (yyvsp[0].obj)); }
+#line 1725 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 68: /* path_expr: kSYMBOL '.' path_expr  */
+#line 301 "./src/parser/newt.y"
+                                                { (yyval.obj) = NPSInsertArraySlot((yyvsp[0].obj), 0, (yyvsp[-2].obj)); }
+#line 1731 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 69: /* array: '[' kSYMBOL ':' array_item_list ']'  */
+#line 305 "./src/parser/newt.y"
+                                                        { (yyval.obj) = NcSetClass((yyvsp[-1].obj), (yyvsp[-3].obj)); }
+#line 1737 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 70: /* array: '[' array_item_list ']'  */
+#line 306 "./src/parser/newt.y"
+                                                                        { (yyval.obj) = (yyvsp[-1].obj); }
+#line 1743 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 71: /* array_item_list: %empty  */
+#line 310 "./src/parser/newt.y"
+                                                                { (yyval.obj) = NPSMakeArray(NSSYM0(array)); }
+#line 1749 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 72: /* array_item_list: object  */
+#line 311 "./src/parser/newt.y"
+                                                                        { (yyval.obj) = NPSMakeArray((yyvsp[0].obj)); }
+#line 1755 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 74: /* array_item_list: array_item_list ',' object  */
+#line 313 "./src/parser/newt.y"
+                                                { (yyval.obj) = NPSAddArraySlot((yyvsp[-2].obj), (yyvsp[0].obj)); }
+#line 1761 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 75: /* frame: '{' frame_slot_list '}'  */
+#line 317 "./src/parser/newt.y"
+                                                        { (yyval.obj) = (yyvsp[-1].node); }
+#line 1767 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 76: /* frame_slot_list: %empty  */
+#line 321 "./src/parser/newt.y"
+                                                                { (yyval.node) = NPSMakeFrame(kNewtRefUnbind, kNewtRefUnbind); }
+#line 1773 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 77: /* frame_slot_list: kSYMBOL ':' object  */
+#line 322 "./src/parser/newt.y"
+                                                        { (yyval.node) = NPSMakeFrame((yyvsp[-2].obj), (yyvsp[0].obj)); }
+#line 1779 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 79: /* frame_slot_list: frame_slot_list ',' kSYMBOL ':' object  */
+#line 325 "./src/parser/newt.y"
+                                        { (yyval.node) = NPSSetSlot((yyvsp[-4].node), (yyvsp[-2].obj), (yyvsp[0].obj)); }
+#line 1785 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 80: /* binary: kBINBG kSYMBOL ':' binary_item_list kBINED  */
+#line 329 "./src/parser/newt.y"
+                                                                { (yyval.obj) = NcSetClass((yyvsp[-1].obj), (yyvsp[-3].obj)); }
+#line 1791 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 81: /* binary: kBINBG binary_item_list kBINED  */
+#line 330 "./src/parser/newt.y"
+                                                                                { (yyval.obj) = (yyvsp[-1].obj); }
+#line 1797 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 82: /* binary_item_list: %empty  */
+#line 334 "./src/parser/newt.y"
+                                                                { (yyval.obj) = NPSMakeBinary(kNewtRefUnbind); }
+#line 1803 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 83: /* binary_item_list: object  */
+#line 335 "./src/parser/newt.y"
+                                                                        { (yyval.obj) = NPSMakeBinary((yyvsp[0].obj)); }
+#line 1809 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 84: /* binary_item_list: binary_item_list ',' object  */
+#line 336 "./src/parser/newt.y"
+                                                { (yyval.obj) = NPSAddARef((yyvsp[-2].obj), (yyvsp[0].obj)); }
+#line 1815 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 85: /* constructor: '[' kSYMBOL ':' expr_list ']'  */
+#line 341 "./src/parser/newt.y"
+                                                        { (yyval.node) = NPSGenNode2(kNPSMakeArray, (yyvsp[-3].obj), (yyvsp[-1].node)); }
+#line 1821 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 86: /* constructor: '[' expr_list ']'  */
+#line 342 "./src/parser/newt.y"
+                                                                        { (yyval.node) = NPSGenNode2(kNPSMakeArray, NSSYM0(array), (yyvsp[-1].node)); }
+#line 1827 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 87: /* constructor: '{' frame_constructor_list '}'  */
+#line 345 "./src/parser/newt.y"
+                                                        { (yyval.node) = NPSGenNode1(kNPSMakeFrame, (yyvsp[-1].node)); }
+#line 1833 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 88: /* constructor: kFUNC func_keyword '(' formal_argument_list ')' expr  */
+#line 349 "./src/parser/newt.y"
+                        { (yyval.node) = NPSGenNode2(kNPSFunc, (yyvsp[-2].node), (yyvsp[0].node)); }
+#line 1839 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 89: /* constructor: kREGEX kSTRING  */
+#line 352 "./src/parser/newt.y"
+                                                        { (yyval.node) = NPSGenNode2(kNPSMakeRegex, (yyvsp[-1].obj), (yyvsp[0].obj)); }
+#line 1845 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 90: /* constructor: kREGEX  */
+#line 353 "./src/parser/newt.y"
+                                                                { (yyval.node) = NPSGenNode2(kNPSMakeRegex, (yyvsp[0].obj), kNewtRefNIL); }
+#line 1851 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 91: /* expr_list: %empty  */
+#line 357 "./src/parser/newt.y"
+                                                        { (yyval.node) = kNewtRefUnbind; }
+#line 1857 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 94: /* expr_list: expr_list ',' expr  */
+#line 361 "./src/parser/newt.y"
+                                                                        { (yyval.node) = NPSGenNode2(kNPSCommaList, (yyvsp[-2].node), (yyvsp[0].node)); }
+#line 1863 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 95: /* frame_constructor_list: %empty  */
+#line 365 "./src/parser/newt.y"
+                                                        { (yyval.node) = kNewtRefUnbind; }
+#line 1869 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 98: /* frame_constructor_list: frame_constructor_list ',' frame_slot_value  */
+#line 369 "./src/parser/newt.y"
+                                                                        { (yyval.node) = NPSGenNode2(kNPSCommaList, (yyvsp[-2].node), (yyvsp[0].node)); }
+#line 1875 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 99: /* frame_slot_value: kSYMBOL ':' expr  */
+#line 373 "./src/parser/newt.y"
+                                        { (yyval.node) = NPSGenNode2(kNPSSlot, (yyvsp[-2].obj), (yyvsp[0].node)); }
+#line 1881 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 102: /* formal_argument_list: %empty  */
+#line 382 "./src/parser/newt.y"
+                                                        { (yyval.node) = kNewtRefUnbind; }
+#line 1887 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 104: /* formal_argument_list: formal_argument_list2 ',' indefinite_argument  */
+#line 385 "./src/parser/newt.y"
+                                                                        { (yyval.node) = NPSGenNode2(kNPSCommaList, (yyvsp[-2].node), (yyvsp[0].node)); }
+#line 1893 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 106: /* formal_argument_list2: formal_argument_list2 ',' formal_argument  */
+#line 391 "./src/parser/newt.y"
+                                                                        { (yyval.node) = NPSGenNode2(kNPSCommaList, (yyvsp[-2].node), (yyvsp[0].node)); }
+#line 1899 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 107: /* formal_argument: kSYMBOL  */
+#line 395 "./src/parser/newt.y"
+                                                                { (yyval.node) = (yyvsp[0].obj); }
+#line 1905 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 108: /* formal_argument: type kSYMBOL  */
+#line 396 "./src/parser/newt.y"
+                                                        { (yyval.node) = NPSGenNode2(kNPSArg, (yyvsp[-1].node), (yyvsp[0].obj)); }
+#line 1911 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 109: /* indefinite_argument: kSYMBOL k3READER  */
+#line 400 "./src/parser/newt.y"
+                                                        {	// 不定長（独自拡張）
+										ERR_NOS2C("Indefinite Argument");	// NOS2 非互換
+										(yyval.node) = NPSGenNode1(kNPSIndefinite, (yyvsp[-1].obj));
+									}
+#line 1920 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 110: /* type: kSYMBOL  */
+#line 407 "./src/parser/newt.y"
+                                                                { TYPECHECK((yyvsp[0].obj)); (yyval.node) = (yyvsp[0].obj); }
+#line 1926 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 111: /* frame_accessor: expr '.' kSYMBOL  */
+#line 411 "./src/parser/newt.y"
+                                                        { (yyval.node) = NPSGenNode2(kNPSGetPath, (yyvsp[-2].node), (yyvsp[0].obj)); }
+#line 1932 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 112: /* frame_accessor: expr '.' '(' expr ')'  */
+#line 412 "./src/parser/newt.y"
+                                                { (yyval.node) = NPSGenNode2(kNPSGetPath, (yyvsp[-4].node), (yyvsp[-1].node)); }
+#line 1938 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 113: /* array_accessor: expr '[' expr ']'  */
+#line 416 "./src/parser/newt.y"
+                                                        { (yyval.node) = NPSGenNode2(kNPSAref, (yyvsp[-3].node), (yyvsp[-1].node)); }
+#line 1944 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 114: /* exists_expr: kSYMBOL kEXISTS  */
+#line 420 "./src/parser/newt.y"
+                                                        { (yyval.node) = NPSGenNode1(kNPSExists, (yyvsp[-1].obj)); }
+#line 1950 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 115: /* exists_expr: frame_accessor kEXISTS  */
+#line 421 "./src/parser/newt.y"
+                                                { (yyval.node) = NPSGenNode1(kNPSExists, (yyvsp[-1].node)); }
+#line 1956 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 116: /* exists_expr: ':' kSYMBOL kEXISTS  */
+#line 422 "./src/parser/newt.y"
+                                                { (yyval.node) = NPSGenNode2(kNPSMethodExists, kNewtRefUnbind, (yyvsp[-1].obj)); }
+#line 1962 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 117: /* exists_expr: expr ':' kSYMBOL kEXISTS  */
+#line 423 "./src/parser/newt.y"
+                                                { (yyval.node) = NPSGenNode2(kNPSMethodExists, (yyvsp[-3].node), (yyvsp[-1].obj)); }
+#line 1968 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 118: /* function_call: kSYMBOL '(' actual_argument_list ')'  */
+#line 427 "./src/parser/newt.y"
+                                                        { (yyval.node) = NPSGenNode2(kNPSCall, (yyvsp[-3].obj), (yyvsp[-1].node)); }
+#line 1974 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 119: /* function_call: kCALL expr kWITH '(' actual_argument_list ')'  */
+#line 429 "./src/parser/newt.y"
+                                                                                                { (yyval.node) = NPSGenNode2(kNPSInvoke, (yyvsp[-4].node), (yyvsp[-1].node)); }
+#line 1980 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 120: /* actual_argument_list: %empty  */
+#line 433 "./src/parser/newt.y"
+                                                                                { (yyval.node) = kNewtRefUnbind; }
+#line 1986 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 122: /* actual_argument_list: actual_argument_list ',' expr  */
+#line 435 "./src/parser/newt.y"
+                                                { (yyval.node) = NPSGenNode2(kNPSCommaList, (yyvsp[-2].node), (yyvsp[0].node)); }
+#line 1992 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 123: /* message_send: ':' kSYMBOL '(' actual_argument_list ')'  */
+#line 440 "./src/parser/newt.y"
+                                    { (yyval.node) = NPSGenSend(kNewtRefUnbind, (yyvsp[-4].op), (yyvsp[-3].obj), (yyvsp[-1].node)); }
+#line 1998 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 124: /* message_send: kSNDOP kSYMBOL '(' actual_argument_list ')'  */
+#line 442 "./src/parser/newt.y"
+                                    { (yyval.node) = NPSGenSend(kNewtRefUnbind, (yyvsp[-4].op), (yyvsp[-3].obj), (yyvsp[-1].node)); }
+#line 2004 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 125: /* message_send: expr ':' kSYMBOL '(' actual_argument_list ')'  */
+#line 445 "./src/parser/newt.y"
+                                    { (yyval.node) = NPSGenSend((yyvsp[-5].node), ':', (yyvsp[-3].obj), (yyvsp[-1].node)); }
+#line 2010 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 126: /* message_send: expr kSNDOP kSYMBOL '(' actual_argument_list ')'  */
+#line 447 "./src/parser/newt.y"
+                                    { (yyval.node) = NPSGenSend((yyvsp[-5].node), (yyvsp[-4].op), (yyvsp[-3].obj), (yyvsp[-1].node)); }
+#line 2016 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 127: /* message_send: kINHERITED ':' kSYMBOL '(' actual_argument_list ')'  */
+#line 450 "./src/parser/newt.y"
+                                    { (yyval.node) = NPSGenResend(':', (yyvsp[-3].obj), (yyvsp[-1].node)); }
+#line 2022 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 128: /* message_send: kINHERITED kSNDOP kSYMBOL '(' actual_argument_list ')'  */
+#line 452 "./src/parser/newt.y"
+                                    { (yyval.node) = NPSGenResend((yyvsp[-4].op), (yyvsp[-3].obj), (yyvsp[-1].node)); }
+#line 2028 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 129: /* if_expr: kIF expr kTHEN expr  */
+#line 456 "./src/parser/newt.y"
+                                                                        { (yyval.node) = NPSGenIfThenElse((yyvsp[-2].node), (yyvsp[0].node), kNewtRefUnbind); }
+#line 2034 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 130: /* if_expr: kIF expr kTHEN expr kELSE expr  */
+#line 457 "./src/parser/newt.y"
+                                                                { (yyval.node) = NPSGenIfThenElse((yyvsp[-4].node), (yyvsp[-2].node), (yyvsp[0].node)); }
+#line 2040 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 131: /* iteration: kLOOP expr  */
+#line 462 "./src/parser/newt.y"
+                                                                        { (yyval.node) = NPSGenNode1(kNPSLoop, (yyvsp[0].node)); }
+#line 2046 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 132: /* iteration: kFOR kSYMBOL kASNOP expr kTO expr by_expr kDO expr  */
+#line 464 "./src/parser/newt.y"
+                                                                                        { (yyval.node) = NPSGenForLoop((yyvsp[-7].obj), (yyvsp[-5].node), (yyvsp[-3].node), (yyvsp[-2].node), (yyvsp[0].node)); }
+#line 2052 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 133: /* iteration: kFOREACH kSYMBOL deeply kIN expr foreach_operator expr  */
+#line 466 "./src/parser/newt.y"
+                                                                                        { (yyval.node) = NPSGenForeach(kNewtRefUnbind, (yyvsp[-5].obj), (yyvsp[-2].node), (yyvsp[-4].obj), (yyvsp[-1].obj), (yyvsp[0].node)); }
+#line 2058 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 134: /* iteration: kFOREACH kSYMBOL ',' kSYMBOL deeply kIN expr foreach_operator expr  */
+#line 468 "./src/parser/newt.y"
+                                                                                        { (yyval.node) = NPSGenForeach((yyvsp[-7].obj), (yyvsp[-5].obj), (yyvsp[-2].node), (yyvsp[-4].obj), (yyvsp[-1].obj), (yyvsp[0].node)); }
+#line 2064 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 135: /* iteration: kWHILE expr kDO expr  */
+#line 469 "./src/parser/newt.y"
+                                                                { (yyval.node) = NPSGenNode2(kNPSWhile, (yyvsp[-2].node), (yyvsp[0].node)); }
+#line 2070 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 136: /* iteration: kREPEAT expr_sequence kUNTIL expr  */
+#line 470 "./src/parser/newt.y"
+                                                    { (yyval.node) = NPSGenNode2(kNPSRepeat, (yyvsp[-2].node), (yyvsp[0].node)); }
+#line 2076 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 137: /* by_expr: %empty  */
+#line 474 "./src/parser/newt.y"
+                                        { (yyval.node) = kNewtRefUnbind; }
+#line 2082 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 138: /* by_expr: kBY expr  */
+#line 475 "./src/parser/newt.y"
+                                                { (yyval.node) = (yyvsp[0].node); }
+#line 2088 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 139: /* foreach_operator: kDO  */
+#line 479 "./src/parser/newt.y"
+                                                { (yyval.obj) = kNewtRefNIL; }
+#line 2094 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 140: /* foreach_operator: kSYMBOL  */
+#line 480 "./src/parser/newt.y"
+                                                { SYMCHECK((yyvsp[0].obj), NSSYM0(collect)); (yyval.obj) = (yyvsp[0].obj); }
+#line 2100 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 141: /* deeply: %empty  */
+#line 484 "./src/parser/newt.y"
+                                        { (yyval.obj) = kNewtRefNIL; }
+#line 2106 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 142: /* deeply: kSYMBOL  */
+#line 485 "./src/parser/newt.y"
+                                                { SYMCHECK((yyvsp[0].obj), NSSYM0(deeply)); (yyval.obj) = kNewtRefTRUE; }
+#line 2112 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 144: /* onexcp_list: onexcp_list onexcp  */
+#line 495 "./src/parser/newt.y"
+                                                { (yyval.node) = NPSGenNode2(kNPSOnexceptionList, (yyvsp[-1].node), (yyvsp[0].node)); }
+#line 2118 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 145: /* onexcp: kONEXCEPTION kSYMBOL kDO expr  */
+#line 499 "./src/parser/newt.y"
+                                                { (yyval.node) = NPSGenNode2(kNPSOnexception, (yyvsp[-2].obj), (yyvsp[0].node)); }
+#line 2124 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 146: /* local_declaration: kLOCAL l_init_clause_list  */
+#line 503 "./src/parser/newt.y"
+                                             { (yyval.node) = NPSGenNode2(kNPSLocal, kNewtRefUnbind, (yyvsp[0].node)); }
+#line 2130 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 147: /* local_declaration: kLOCAL kSYMBOL l_init_clause_list  */
+#line 505 "./src/parser/newt.y"
+                        {
+				TYPECHECK((yyvsp[-1].obj));
+				(yyval.node) = NPSGenNode2(kNPSLocal, (yyvsp[-1].obj), (yyvsp[0].node));
+			}
+#line 2139 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 149: /* l_init_clause_list: l_init_clause_list ',' init_clause  */
+#line 520 "./src/parser/newt.y"
+                                                                        { (yyval.node) = NPSGenNode2(kNPSCommaList, (yyvsp[-2].node), (yyvsp[0].node)); }
+#line 2145 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 150: /* init_clause: kSYMBOL  */
+#line 524 "./src/parser/newt.y"
+                                                                { (yyval.node) = (yyvsp[0].obj); }
+#line 2151 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 151: /* init_clause: kSYMBOL kASNOP expr  */
+#line 525 "./src/parser/newt.y"
+                                                { (yyval.node) = NPSGenNode2(kNPSAssign, (yyvsp[-2].obj), (yyvsp[0].node)); }
+#line 2157 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 153: /* c_init_clause_list: c_init_clause_list ',' c_init_clause  */
+#line 531 "./src/parser/newt.y"
+                                                                        { (yyval.node) = NPSGenNode2(kNPSCommaList, (yyvsp[-2].node), (yyvsp[0].node)); }
+#line 2163 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 154: /* c_init_clause: kSYMBOL kASNOP expr  */
+#line 535 "./src/parser/newt.y"
+                                                { (yyval.node) = NPSGenNode2(kNPSAssign, (yyvsp[-2].obj), (yyvsp[0].node)); }
+#line 2169 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 155: /* global_declaration: kGLOBAL init_clause  */
+#line 539 "./src/parser/newt.y"
+                                                { (yyval.node) = NPSGenNode1(kNPSGlobal, (yyvsp[0].node)); }
+#line 2175 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 157: /* global_function_decl: kGLOBAL function_decl  */
+#line 544 "./src/parser/newt.y"
+                                                { (yyval.node) = (yyvsp[0].node); }
+#line 2181 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 158: /* global_function_decl: kFUNC function_decl  */
+#line 545 "./src/parser/newt.y"
+                                                { (yyval.node) = (yyvsp[0].node); }
+#line 2187 "build/obj/yytmp/y.tab.c"
+    break;
+
+  case 159: /* function_decl: kSYMBOL '(' formal_argument_list ')' expr  */
+#line 549 "./src/parser/newt.y"
+                                                            { (yyval.node) = NPSGenGlobalFn((yyvsp[-4].obj), (yyvsp[-2].node), (yyvsp[0].node)); }
+#line 2193 "build/obj/yytmp/y.tab.c"
+    break;
+
+
+#line 2197 "build/obj/yytmp/y.tab.c"
+
+      default: break;
+    }
+  /* User semantic actions sometimes alter yychar, and that requires
+     that yytoken be updated with the new translation.  We take the
+     approach of translating immediately before every use of yytoken.
+     One alternative is translating here after every semantic action,
+     but that translation would be missed if the semantic action invokes
+     YYABORT, YYACCEPT, or YYERROR immediately after altering yychar or
+     if it invokes YYBACKUP.  In the case of YYABORT or YYACCEPT, an
+     incorrect destructor might then be invoked immediately.  In the
+     case of YYERROR or YYBACKUP, subsequent parser actions might lead
+     to an incorrect destructor call or verbose syntax error message
+     before the lookahead is translated.  */
+  YY_SYMBOL_PRINT ("-> $$ =", YY_CAST (yysymbol_kind_t, yyr1[yyn]), &yyval, &yyloc);
+
+  YYPOPSTACK (yylen);
+  yylen = 0;
+
+  *++yyvsp = yyval;
+
+  /* Now 'shift' the result of the reduction.  Determine what state
+     that goes to, based on the state we popped back to and the rule
+     number reduced by.  */
+  {
+    const int yylhs = yyr1[yyn] - YYNTOKENS;
+    const int yyi = yypgoto[yylhs] + *yyssp;
+    yystate = (0 <= yyi && yyi <= YYLAST && yycheck[yyi] == *yyssp
+               ? yytable[yyi]
+               : yydefgoto[yylhs]);
+  }
+
+  goto yynewstate;
+
+
+/*--------------------------------------.
+| yyerrlab -- here on detecting error.  |
+`--------------------------------------*/
+yyerrlab:
+  /* Make sure we have latest lookahead translation.  See comments at
+     user semantic actions for why this is necessary.  */
+  yytoken = yychar == YYEMPTY ? YYSYMBOL_YYEMPTY : YYTRANSLATE (yychar);
+  /* If not already recovering from an error, report this error.  */
+  if (!yyerrstatus)
+    {
+      ++yynerrs;
+      yyerror (YY_("syntax error"));
+    }
+
+  if (yyerrstatus == 3)
+    {
+      /* If just tried and failed to reuse lookahead token after an
+         error, discard it.  */
+
+      if (yychar <= YYEOF)
+        {
+          /* Return failure if at end of input.  */
+          if (yychar == YYEOF)
+            YYABORT;
+        }
+      else
+        {
+          yydestruct ("Error: discarding",
+                      yytoken, &yylval);
+          yychar = YYEMPTY;
+        }
+    }
+
+  /* Else will try to reuse lookahead token after shifting the error
+     token.  */
+  goto yyerrlab1;
+
+
+/*---------------------------------------------------.
+| yyerrorlab -- error raised explicitly by YYERROR.  |
+`---------------------------------------------------*/
+yyerrorlab:
+  /* Pacify compilers when the user code never invokes YYERROR and the
+     label yyerrorlab therefore never appears in user code.  */
+  if (0)
+    YYERROR;
+  ++yynerrs;
+
+  /* Do not reclaim the symbols of the rule whose action triggered
+     this YYERROR.  */
+  YYPOPSTACK (yylen);
+  yylen = 0;
+  YY_STACK_PRINT (yyss, yyssp);
+  yystate = *yyssp;
+  goto yyerrlab1;
+
+
+/*-------------------------------------------------------------.
+| yyerrlab1 -- common code for both syntax error and YYERROR.  |
+`-------------------------------------------------------------*/
+yyerrlab1:
+  yyerrstatus = 3;      /* Each real token shifted decrements this.  */
+
+  /* Pop stack until we find a state that shifts the error token.  */
+  for (;;)
+    {
+      yyn = yypact[yystate];
+      if (!yypact_value_is_default (yyn))
+        {
+          yyn += YYSYMBOL_YYerror;
+          if (0 <= yyn && yyn <= YYLAST && yycheck[yyn] == YYSYMBOL_YYerror)
+            {
+              yyn = yytable[yyn];
+              if (0 < yyn)
+                break;
+            }
+        }
+
+      /* Pop the current state because it cannot handle the error token.  */
+      if (yyssp == yyss)
+        YYABORT;
+
+
+      yydestruct ("Error: popping",
+                  YY_ACCESSING_SYMBOL (yystate), yyvsp);
+      YYPOPSTACK (1);
+      yystate = *yyssp;
+      YY_STACK_PRINT (yyss, yyssp);
+    }
+
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  *++yyvsp = yylval;
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
+
+
+  /* Shift the error token.  */
+  YY_SYMBOL_PRINT ("Shifting", YY_ACCESSING_SYMBOL (yyn), yyvsp, yylsp);
+
+  yystate = yyn;
+  goto yynewstate;
+
+
+/*-------------------------------------.
+| yyacceptlab -- YYACCEPT comes here.  |
+`-------------------------------------*/
+yyacceptlab:
+  yyresult = 0;
+  goto yyreturnlab;
+
+
+/*-----------------------------------.
+| yyabortlab -- YYABORT comes here.  |
+`-----------------------------------*/
+yyabortlab:
+  yyresult = 1;
+  goto yyreturnlab;
+
+
+/*-----------------------------------------------------------.
+| yyexhaustedlab -- YYNOMEM (memory exhaustion) comes here.  |
+`-----------------------------------------------------------*/
+yyexhaustedlab:
+  yyerror (YY_("memory exhausted"));
+  yyresult = 2;
+  goto yyreturnlab;
+
+
+/*----------------------------------------------------------.
+| yyreturnlab -- parsing is finished, clean up and return.  |
+`----------------------------------------------------------*/
+yyreturnlab:
+  if (yychar != YYEMPTY)
+    {
+      /* Make sure we have latest lookahead translation.  See comments at
+         user semantic actions for why this is necessary.  */
+      yytoken = YYTRANSLATE (yychar);
+      yydestruct ("Cleanup: discarding lookahead",
+                  yytoken, &yylval);
+    }
+  /* Do not reclaim the symbols of the rule whose action triggered
+     this YYABORT or YYACCEPT.  */
+  YYPOPSTACK (yylen);
+  YY_STACK_PRINT (yyss, yyssp);
+  while (yyssp != yyss)
+    {
+      yydestruct ("Cleanup: popping",
+                  YY_ACCESSING_SYMBOL (+*yyssp), yyvsp);
+      YYPOPSTACK (1);
+    }
+#ifndef yyoverflow
+  if (yyss != yyssa)
+    YYSTACK_FREE (yyss);
+#endif
+
+  return yyresult;
+}
+
+#line 552 "./src/parser/newt.y"
+
@@ -0,0 +1,201 @@
+/* A Bison parser, made by GNU Bison 3.8.2.  */
+
+/* Bison interface for Yacc-like parsers in C
+
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
+   Inc.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
+
+/* As a special exception, you may create a larger work that contains
+   part or all of the Bison parser skeleton and distribute that work
+   under terms of your choice, so long as that work isn't itself a
+   parser generator using the skeleton or a modified version thereof
+   as a parser skeleton.  Alternatively, if you modify or redistribute
+   the parser skeleton itself, you may (at your option) remove this
+   special exception, which will cause the skeleton and the resulting
+   Bison output files to be licensed under the GNU General Public
+   License without this special exception.
+
+   This special exception was added by the Free Software Foundation in
+   version 2.2 of Bison.  */
+
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
+
+#ifndef YY_YY_BUILD_OBJ_YYTMP_Y_TAB_H_INCLUDED
+# define YY_YY_BUILD_OBJ_YYTMP_Y_TAB_H_INCLUDED
+/* Debug traces.  */
+#ifndef YYDEBUG
+# define YYDEBUG 0
+#endif
+#if YYDEBUG
+extern int yydebug;
+#endif
+
+/* Token kinds.  */
+#ifndef YYTOKENTYPE
+# define YYTOKENTYPE
+  enum yytokentype
+  {
+    YYEMPTY = -2,
+    YYEOF = 0,                     /* "end of file"  */
+    YYerror = 256,                 /* error  */
+    YYUNDEF = 257,                 /* "invalid token"  */
+    kBINBG = 258,                  /* kBINBG  */
+    kBINED = 259,                  /* kBINED  */
+    kBEGIN = 260,                  /* kBEGIN  */
+    kEND = 261,                    /* kEND  */
+    kFUNC = 262,                   /* kFUNC  */
+    kNATIVE = 263,                 /* kNATIVE  */
+    kCALL = 264,                   /* kCALL  */
+    kWITH = 265,                   /* kWITH  */
+    kFOR = 266,                    /* kFOR  */
+    kFOREACH = 267,                /* kFOREACH  */
+    kTO = 268,                     /* kTO  */
+    kBY = 269,                     /* kBY  */
+    kSELF = 270,                   /* kSELF  */
+    kINHERITED = 271,              /* kINHERITED  */
+    kIF = 272,                     /* kIF  */
+    kTRY = 273,                    /* kTRY  */
+    kONEXCEPTION = 274,            /* kONEXCEPTION  */
+    kLOOP = 275,                   /* kLOOP  */
+    kWHILE = 276,                  /* kWHILE  */
+    kREPEAT = 277,                 /* kREPEAT  */
+    kUNTIL = 278,                  /* kUNTIL  */
+    kDO = 279,                     /* kDO  */
+    kIN = 280,                     /* kIN  */
+    kGLOBAL = 281,                 /* kGLOBAL  */
+    kLOCAL = 282,                  /* kLOCAL  */
+    kCONSTANT = 283,               /* kCONSTANT  */
+    k3READER = 284,                /* k3READER  */
+    kERROR = 285,                  /* kERROR  */
+    kSYMBOL = 286,                 /* kSYMBOL  */
+    kSTRING = 287,                 /* kSTRING  */
+    kREGEX = 288,                  /* kREGEX  */
+    kINTEGER = 289,                /* kINTEGER  */
+    kREAL = 290,                   /* kREAL  */
+    kCHARACTER = 291,              /* kCHARACTER  */
+    kMAGICPOINTER = 292,           /* kMAGICPOINTER  */
+    kTRUE = 293,                   /* kTRUE  */
+    kNIL = 294,                    /* kNIL  */
+    kUNBIND = 295,                 /* kUNBIND  */
+    kEXPR2 = 296,                  /* kEXPR2  */
+    kBREAK = 297,                  /* kBREAK  */
+    kRETURN = 298,                 /* kRETURN  */
+    kTHEN = 299,                   /* kTHEN  */
+    kELSE = 300,                   /* kELSE  */
+    kASNOP = 301,                  /* kASNOP  */
+    kANDOP = 302,                  /* kANDOP  */
+    kOROP = 303,                   /* kOROP  */
+    kNOTOP = 304,                  /* kNOTOP  */
+    kRELOP = 305,                  /* kRELOP  */
+    kEXISTS = 306,                 /* kEXISTS  */
+    kSTROP = 307,                  /* kSTROP  */
+    kADDOP = 308,                  /* kADDOP  */
+    kMULOP = 309,                  /* kMULOP  */
+    kSFTOP = 310,                  /* kSFTOP  */
+    kUMINUS = 311,                 /* kUMINUS  */
+    kSNDOP = 312                   /* kSNDOP  */
+  };
+  typedef enum yytokentype yytoken_kind_t;
+#endif
+/* Token kinds.  */
+#define YYEMPTY -2
+#define YYEOF 0
+#define YYerror 256
+#define YYUNDEF 257
+#define kBINBG 258
+#define kBINED 259
+#define kBEGIN 260
+#define kEND 261
+#define kFUNC 262
+#define kNATIVE 263
+#define kCALL 264
+#define kWITH 265
+#define kFOR 266
+#define kFOREACH 267
+#define kTO 268
+#define kBY 269
+#define kSELF 270
+#define kINHERITED 271
+#define kIF 272
+#define kTRY 273
+#define kONEXCEPTION 274
+#define kLOOP 275
+#define kWHILE 276
+#define kREPEAT 277
+#define kUNTIL 278
+#define kDO 279
+#define kIN 280
+#define kGLOBAL 281
+#define kLOCAL 282
+#define kCONSTANT 283
+#define k3READER 284
+#define kERROR 285
+#define kSYMBOL 286
+#define kSTRING 287
+#define kREGEX 288
+#define kINTEGER 289
+#define kREAL 290
+#define kCHARACTER 291
+#define kMAGICPOINTER 292
+#define kTRUE 293
+#define kNIL 294
+#define kUNBIND 295
+#define kEXPR2 296
+#define kBREAK 297
+#define kRETURN 298
+#define kTHEN 299
+#define kELSE 300
+#define kASNOP 301
+#define kANDOP 302
+#define kOROP 303
+#define kNOTOP 304
+#define kRELOP 305
+#define kEXISTS 306
+#define kSTROP 307
+#define kADDOP 308
+#define kMULOP 309
+#define kSFTOP 310
+#define kUMINUS 311
+#define kSNDOP 312
+
+/* Value type.  */
+#if ! defined YYSTYPE && ! defined YYSTYPE_IS_DECLARED
+union YYSTYPE
+{
+#line 33 "./src/parser/newt.y"
+
+    newtRefVar	obj;	// オブジェクト
+    uint32_t	op;		// 演算子
+    nps_node_t	node;	// ノード
+
+#line 187 "build/obj/yytmp/y.tab.h"
+
+};
+typedef union YYSTYPE YYSTYPE;
+# define YYSTYPE_IS_TRIVIAL 1
+# define YYSTYPE_IS_DECLARED 1
+#endif
+
+
+extern YYSTYPE yylval;
+
+
+int yyparse (void);
+
+
+#endif /* !YY_YY_BUILD_OBJ_YYTMP_Y_TAB_H_INCLUDED  */
@@ -34,6 +34,14 @@ enum {
     optNone			= 0,
     optNos2,
     optNos1Functions,
+    optNoThreadedCode,
+    optNoMemPool,
+    optNoNursery,
+    optNoLazySweep,
+    optNoFastHash,
+    optNoStackLocals,
+    optJIT,
+    optTailCalls,
     optCopyright,
     optVersion,
     optStaff,
@@ -46,10 +54,18 @@ enum {
 static keyword_t	reserved_words[] = {
         // アルファベット順にソートしておくこと
         {"copyright",	optCopyright},
+        {"jit",			optJIT},
         {"newton",		optNos2},
+        {"noFastHash",	optNoFastHash},
+        {"noLazySweep",	optNoLazySweep},
+        {"noMemPool",	optNoMemPool},
+        {"noNursery",	optNoNursery},
         {"nos1Functions",	optNos1Functions},
         {"nos2",		optNos2},
+        {"noStackLocals",	optNoStackLocals},
+        {"noThreadedCode",	optNoThreadedCode},
         {"staff",		optStaff},
+        {"tailCalls",	optTailCalls},
         {"version",		optVersion},
     };
 
@@ -89,6 +105,7 @@ static void		newt_invalid_option(char c);
 static void		newt_option_switchs(const char * s);
 static void		newt_option(const char * s);
 static newtErr  newt_option_with_arg(char c, int argc, const char * argv[], int n);
+static int64_t	newt_atosize(const char * s);
 
 
 #if 0
@@ -368,6 +385,46 @@ void newt_option(const char * s)
 			NEWT_MODE_NOS1_FUNCTIONS = true;
 			break;
 
+		// スレッデッドコードを使用しない
+		case optNoThreadedCode:
+			NEWT_MODE_NOTHREADEDCODE = true;
+			break;
+
+		// メモリプールのサイズクラスを使用しない
+		case optNoMemPool:
+			NEWT_MODE_NOMEMPOOL = true;
+			break;
+
+		// 世代別 GC を使用しない
+		case optNoNursery:
+			NEWT_MODE_NONURSERY = true;
+			break;
+
+		// 全体の GC 中に全てスウィープする
+		case optNoLazySweep:
+			NEWT_MODE_NOLAZYSWEEP = true;
+			break;
+
+		// Newton OS 互換のシンボルのハッシュ関数を使用する
+		case optNoFastHash:
+			NEWT_MODE_NOFASTHASH = true;
+			break;
+
+		// 関数呼出しごとにローカルフレームを作成する
+		case optNoStackLocals:
+			NEWT_MODE_NOSTACKLOCALS = true;
+			break;
+
+		// ホットな関数をネイティブコードにコンパイルする
+		case optJIT:
+			NEWT_MODE_JIT = true;
+			break;
+
+		// 末尾位置の呼出しで活性レコードを再利用する
+		case optTailCalls:
+			NEWT_MODE_TAILCALL = true;
+			break;
+
         // コピーライト
         case optCopyright:
             newt_show_copyright();
@@ -420,6 +477,43 @@ newtErr newt_option_with_arg(char c, int argc, const char * argv[], int n)
 }
 
 
+/*------------------------------------------------------------------------*/
+/** オプションのサイズを解析する
+ *
+ * @param s			[in] サイズの文字列（k, m, g の単位を付けられる）
+ *
+ * @return			バイト数
+ */
+
+int64_t newt_atosize(const char * s)
+{
+    char *	end;
+    int64_t	size;
+
+    size = strtoll(s, &end, 10);
+
+    switch (*end)
+    {
+        case 'g':
+        case 'G':
+            size *= 1024 * 1024 * 1024;
+            break;
+
+        case 'm':
+        case 'M':
+            size *= 1024 * 1024;
+            break;
+
+        case 'k':
+        case 'K':
+            size *= 1024;
+            break;
+    }
+
+    return size;
+}
+
+
 #if 0
 #pragma mark -
 #endif
@@ -462,6 +556,37 @@ int main (int argc, const char * argv[])
 				newt_currdir = argv[i];
                 break;
 
+            case 'g':
+                i++;
+                if (i < argc)
+                {
+                    char *	end;
+                    long	n;
+
+                    n = strtol(argv[i], &end, 10);
+
+                    if (*end != '\0' || n < 1 || NEWT_GC_MAXTHREADS < n)
+                    {
+                        newt_invalid_option(*s);
+                        exit(1);
+                    }
+
+                    NEWT_MODE_GCTHREADS = n;
+                }
+                break;
+
+            case 'm':
+                i++;
+                if (i < argc)
+                    NEWT_MODE_HEAPSIZE = newt_atosize(argv[i]);
+                break;
+
+            case 'M':
+                i++;
+                if (i < argc)
+                    NEWT_MODE_HEAPLIMIT = newt_atosize(argv[i]);
+                break;
+
             case 'i':
             case 'e':
                 i++;
@@ -13,6 +13,7 @@
 /* ヘッダファイル */
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "NewtCore.h"
 #include "NewtBC.h"
@@ -33,6 +34,7 @@ struct nbc_env_t {
 	newtStack   bytecode;		///< バイトコードバッファ
 	newtStack   breakstack;		///< ブレークスタック
 	newtStack   onexcpstack;	///< 例外スタック
+	newtStack   handlers;		///< 例外ハンドラ表
 
     newtRefVar	func;			///< 関数オブジェクト
     newtRefVar	literals;		///< 関数オブジェクトのリテラルフレーム
@@ -40,9 +42,20 @@ struct nbc_env_t {
     newtRefVar	constant;		///< 定数フレーム
 
     bool		needargframe;	///< Whether function needs argFrame because of set-lex-scope or find-var
+    bool		tail;			///< 次に生成する式が末尾位置（値がそのまま関数の戻り値になる）か
 };
 
 
+/// 例外ハンドラ表の行（onexception ごとに作成する）
+typedef struct {
+    uint32_t	start;		///< TRY文の先頭
+    uint32_t	end;		///< 実行文の終わりの pop-handlers の位置
+    uint32_t	exit;		///< onexception の終わりの pop-handlers の位置（0 は未確定）
+    newtRefVar	sym;		///< 例外シンボル
+    uint32_t	pc;			///< 例外ハンドラの位置
+} nbc_handler_t;
+
+
 /// 関数命令テーブル構造体
 typedef struct {
     char *		name;		///< 関数名
@@ -61,10 +74,14 @@ typedef struct {
 #define BREAKSP					(newt_bc_env->breakstack.sp)					///< ブレークスタックのスタックポインタ
 #define	ONEXCPSTACK				((uint32_t*)newt_bc_env->onexcpstack.stackp)	///< 例外スタック
 #define ONEXCPSP				(newt_bc_env->onexcpstack.sp)					///< 例外スタックのスタックポインタ
+#define	ENV_HANDLERS(env)		((nbc_handler_t*)env->handlers.stackp)			///< 例外ハンドラ表
+#define	HANDLERS				ENV_HANDLERS(newt_bc_env)						///< 作成中の例外ハンドラ表
+#define HANDLERSP				(newt_bc_env->handlers.sp)						///< 例外ハンドラ表の行数
 #define	LITERALS				(newt_bc_env->literals)							///< 作成中関数オブジェクトのリテラル
 #define	ARGFRAME				(newt_bc_env->argFrame)							///< 作成中関数オブジェクトの引数フレーム
 #define	CONSTANT				(newt_bc_env->constant)							///< 定数フレーム
 #define NEEDARGFRAME			(newt_bc_env->needargframe)						///< Whether we need argFrame
+#define TAIL					(newt_bc_env->tail)								///< 末尾位置の式を生成中か
 
 #define NBCAddLiteral(r)		NBCAddLiteralEnv(newt_bc_env, r)				///< リテラルリストにオブジェクトを追加
 #define NBCGenCode(a, b)		NBCGenCodeEnv(newt_bc_env, a, b)				///< バイトコードを生成
@@ -105,6 +122,14 @@ static freq_func_t freq_func_tb[] =
         {NULL,				0,	0,					0}
     };
 
+/// 関数命令の引数の数（kNBCAdd 〜 kNBCClassOf）
+static const uint8_t	freq_func_args[kBCFuncsLen] =
+    {
+        2, 2, 2, 3, 2, 1, 2, 2, 2, 2,	// add 〜 div
+        2, 2, 2, 2, 2, 2, 1, 2, 1, 1,	// less-than 〜 clone
+        2, 2, 1, 2, 1					// set-class 〜 class-of
+    };
+
 
 #if 0
 #pragma mark -
@@ -132,6 +157,14 @@ static void				NBCOnexcpBackPatchs(uint32_t try_head);
 static void				NBCGenOnexcpPC(void);
 static void				NBCGenOnexcpBranch(void);
 static void				NBCOnexcpBackPatchL(uint32_t sp, int32_t pc);
+static void				NBCAddHandler(newtRefArg sym, uint32_t pc);
+static void				NBCHandlerBackPatchs(uint32_t first, uint32_t start, uint32_t end, uint32_t exit);
+
+static bool				NBCIsBranch(uint8_t a);
+static void				NBCPeephole(nbc_env_t * env);
+static bool				NBCStackEffect(uint8_t a, uint16_t b, int32_t * deltaP);
+static bool				NBCMergeDepth(int32_t * depths, uint32_t * work, uint32_t * nworkP, uint32_t len, uint32_t pc, int32_t depth);
+static newtRef			NBCMakeHandlers(nbc_env_t * env);
 
 static newtRef			NBCMakeFn(nbc_env_t * env);
 static void				NBCInitFreqFuncTable(void);
@@ -164,14 +197,15 @@ static void				NBCGenReceiver(nps_syntax_node_t * stree, nps_node_t r);
 static void				NBCGenMethodExists(nps_syntax_node_t * stree, nps_node_t receiver, nps_node_t name);
 static void				NBCGenFn(nps_syntax_node_t * stree, nps_node_t args, nps_node_t expr);
 static void				NBCGenGlobalFn(nps_syntax_node_t * stree, nps_node_t name, nps_node_t fn);
-static void				NBCGenCall(nps_syntax_node_t * stree, nps_node_t name, nps_node_t args);
-static void				NBCGenInvoke(nps_syntax_node_t * stree, nps_node_t fn, nps_node_t args);
+static void				NBCGenCall(nps_syntax_node_t * stree, nps_node_t name, nps_node_t args, bool tail);
+static void				NBCGenInvoke(nps_syntax_node_t * stree, nps_node_t fn, nps_node_t args, bool tail);
 static void				NBCGenFunc2(nps_syntax_node_t * stree, newtRefArg name, nps_node_t op1, nps_node_t op2);
-static void				NBCGenSend(nps_syntax_node_t * stree, uint32_t code, nps_node_t receiver, nps_node_t r);
-static void				NBCGenResend(nps_syntax_node_t * stree, uint32_t code, nps_node_t name, nps_node_t args);
+static void				NBCGenSend(nps_syntax_node_t * stree, uint32_t code, nps_node_t receiver, nps_node_t r, bool tail);
+static void				NBCGenResend(nps_syntax_node_t * stree, uint32_t code, nps_node_t name, nps_node_t args, bool tail);
 static void				NBCGenMakeArray(nps_syntax_node_t * stree, nps_node_t klass, nps_node_t r);
 static void				NBCGenMakeFrame(nps_syntax_node_t * stree, nps_node_t r);
 static void				NVCGenNoResult(bool ret);
+static void				NBCGenTailReturn(bool tail);
 static void				NBCGenSyntaxCode(nps_syntax_node_t * stree, nps_syntax_node_t * node, bool ret);
 static int16_t			NBCCountNumArgs(nps_syntax_node_t * stree, nps_node_t r);
 static newtRef			NBCGenMakeFrameSlots_sub(nps_syntax_node_t * stree, nps_node_t r);
@@ -792,6 +826,599 @@ void NBCOnexcpBackPatchL(uint32_t sp, int32_t pc)
 }
 
 
+/*------------------------------------------------------------------------*/
+/** 例外ハンドラ表に行を追加する
+ *
+ * @param sym		[in] 例外シンボル
+ * @param pc		[in] 例外ハンドラの位置
+ *
+ * @return			なし
+ *
+ * @note			TRY文の位置は NBCHandlerBackPatchs でバックパッチする
+ */
+
+void NBCAddHandler(newtRefArg sym, uint32_t pc)
+{
+    nbc_handler_t *	handler;
+
+    if (HANDLERS == NULL)
+		NewtStackSetup(&newt_bc_env->handlers, NEWT_POOL, sizeof(nbc_handler_t), NEWT_NUM_HANDLERTABLE);
+
+	if (! NewtStackExpand(&newt_bc_env->handlers, HANDLERSP + 1))
+		return;
+
+    handler = &HANDLERS[HANDLERSP];
+    handler->start = 0;
+    handler->end = 0;
+    handler->exit = 0;
+    handler->sym = sym;
+    handler->pc = pc;
+    HANDLERSP++;
+}
+
+
+/*------------------------------------------------------------------------*/
+/** 例外ハンドラ表の TRY文の位置をバックパッチする
+ *
+ * @param first		[in] TRY文の最初の行
+ * @param start		[in] TRY文の先頭
+ * @param end		[in] 実行文の終わりの pop-handlers の位置
+ * @param exit		[in] onexception の終わりの pop-handlers の位置
+ *
+ * @return			なし
+ *
+ * @note			onexception 内の TRY文の行は確定済みなので飛ばす
+ */
+
+void NBCHandlerBackPatchs(uint32_t first, uint32_t start, uint32_t end, uint32_t exit)
+{
+    uint32_t	i;
+
+    for (i = first; i < HANDLERSP; i++)
+    {
+        if (HANDLERS[i].exit == 0)
+        {
+            HANDLERS[i].start = start;
+            HANDLERS[i].end = end;
+            HANDLERS[i].exit = exit;
+        }
+    }
+}
+
+
+#if 0
+#pragma mark -
+#endif
+/*------------------------------------------------------------------------*/
+/** 分岐命令か？
+ *
+ * @param a			[in] 命令
+ *
+ * @retval			true	オペデータが分岐先の命令
+ * @retval			false   分岐命令でない
+ */
+
+bool NBCIsBranch(uint8_t a)
+{
+    return (a == kNBCBranch || a == kNBCBranchIfTrue ||
+            a == kNBCBranchIfFalse || a == kNBCBranchIfLoopNotDone);
+}
+
+
+/*------------------------------------------------------------------------*/
+/** バイトコードの覗き穴最適化
+ *
+ * @param env		[in] バイトコード環境
+ *
+ * @return			なし
+ *
+ * @note			生成済みのバイトコードを命令単位に分解して以下を行い、
+ *					分岐先を付け替えて詰め直す。結果は通常のバイトコードのままなので
+ *					NSOF やパッケージにそのまま出力できる。
+ *					・無条件分岐へ分岐する命令は最終的な分岐先へ直接分岐する
+ *					・push-constant nil + branch-if-false（true と branch-if-true も同様）
+ *					　へ分岐する同じ条件分岐はその先へ直接分岐する
+ *					・return へ分岐する無条件分岐は return に置き換える
+ *					・次の命令への無条件分岐、定数のプッシュ直後の pop、
+ *					　到達できない命令を削除する（NTK と同じ出力になるように、
+ *					　末尾に付け加えた return は残す）
+ *					例外ハンドラの位置は整数定数としてプッシュされ区別できないため、
+ *					new-handlers を含む関数は最適化しない。
+ */
+
+void NBCPeephole(nbc_env_t * env)
+{
+    uint8_t *	bc = ENV_BC(env);
+    uint32_t	len = ENV_CX(env);
+    uint32_t *	pcs;		// 命令の位置
+    uint16_t *	bs;			// オペデータ
+    uint8_t *	as;			// 命令
+    uint8_t *	lens;		// 命令長
+    int32_t *	index;		// 位置から命令番号への対応表（-1 は命令の途中）
+    uint32_t *	newpcs;		// 位置から最適化後の位置への対応表
+    uint8_t *	targets;	// 分岐先になっている命令
+    uint8_t *	code;
+    uint32_t	n = 0;
+    uint32_t	pc;
+    uint32_t	cx;
+    uint32_t	i;
+    uint32_t	j;
+    bool		target;
+    bool		changed;
+    int			pass;
+
+    if (len == 0)
+        return;
+
+    pcs = (uint32_t *)NewtMemCalloc(NULL, len, sizeof(uint32_t));
+    bs = (uint16_t *)NewtMemCalloc(NULL, len, sizeof(uint16_t));
+    as = (uint8_t *)NewtMemCalloc(NULL, len, sizeof(uint8_t));
+    lens = (uint8_t *)NewtMemCalloc(NULL, len, sizeof(uint8_t));
+    index = (int32_t *)NewtMemCalloc(NULL, len + 1, sizeof(int32_t));
+    newpcs = (uint32_t *)NewtMemCalloc(NULL, len + 1, sizeof(uint32_t));
+    targets = (uint8_t *)NewtMemCalloc(NULL, len, sizeof(uint8_t));
+    code = (uint8_t *)NewtMemCalloc(NULL, len * 3, sizeof(uint8_t));
+
+    if (pcs == NULL || bs == NULL || as == NULL || lens == NULL ||
+        index == NULL || newpcs == NULL || targets == NULL || code == NULL)
+        goto done;
+
+    // 命令に分解する
+    for (pc = 0; pc <= len; pc++)
+        index[pc] = -1;
+
+    for (pc = 0; pc < len; pc += lens[n++])
+    {
+        pcs[n] = pc;
+        index[pc] = n;
+        as[n] = bc[pc] & ~kNBCFieldMask;
+        bs[n] = bc[pc] & kNBCFieldMask;
+        lens[n] = 1;
+
+        if (bs[n] == kNBCFieldMask)
+        {
+            if (len < pc + 3)
+                goto done;
+
+            bs[n] = ((uint16_t)bc[pc + 1] << 8) | bc[pc + 2];
+            lens[n] = 3;
+        }
+
+        if (as[n] == kNBCNewHandlers)
+            goto done;
+    }
+
+    for (i = 0; i < n; i++)
+    {
+        if (NBCIsBranch(as[i]) && (len < bs[i] || (bs[i] < len && index[bs[i]] < 0)))
+            goto done;
+    }
+
+    // 最適化（削除した命令は lens を 0 にする）
+    for (pass = 0; pass < 8; pass++)
+    {
+        changed = false;
+
+        // 分岐先の付け替え
+        for (i = 0; i < n; i++)
+        {
+            if (lens[i] == 0 || ! NBCIsBranch(as[i]) || bs[i] == len)
+                continue;
+
+            j = index[bs[i]];
+
+            if (as[j] == kNBCBranch && bs[j] != bs[i])
+            {
+                bs[i] = bs[j];
+                changed = true;
+            }
+            else if (j + 1 < n &&
+                ((as[i] == kNBCBranchIfFalse && bs[j] == kNewtRefNIL) ||
+                 (as[i] == kNBCBranchIfTrue && bs[j] == kNewtRefTRUE)) &&
+                as[j] == kNBCPushConstant && as[j + 1] == as[i] &&
+                bs[j + 1] != bs[i])
+            {
+                bs[i] = bs[j + 1];
+                changed = true;
+            }
+            else if (as[i] == kNBCBranch && as[j] == 0 && bs[j] == kNBCReturn)
+            {
+                as[i] = 0;
+                bs[i] = kNBCReturn;
+                lens[i] = 1;
+                changed = true;
+            }
+        }
+
+        // 分岐先に印を付ける
+        memset(targets, 0, n);
+
+        for (i = 0; i < n; i++)
+        {
+            if (lens[i] != 0 && NBCIsBranch(as[i]) && bs[i] < len)
+                targets[index[bs[i]]] = true;
+        }
+
+        // 命令の削除
+        for (i = 0; i < n; i++)
+        {
+            if (lens[i] == 0)
+                continue;
+
+            // 次の命令（間の削除済み命令が分岐先なら次の命令が分岐先になる）
+            for (j = i + 1, target = false; j < n && lens[j] == 0; j++)
+                target = target || targets[j];
+
+            target = target || (j < n && targets[j]);
+
+            if (as[i] == kNBCBranch && bs[i] == (j < n ? pcs[j] : len))
+            {	// 次の命令への分岐
+                lens[i] = 0;
+                changed = true;
+            }
+            else if (j < n && ! target && as[j] == 0 && bs[j] == kNBCPop &&
+                (as[i] == kNBCPushConstant || as[i] == kNBCPush))
+            {	// 定数のプッシュと pop
+                lens[i] = 0;
+                lens[j] = 0;
+                changed = true;
+            }
+            else if ((as[i] == kNBCBranch || (as[i] == 0 && bs[i] == kNBCReturn)))
+            {	// 到達できない命令
+                for (j = i + 1; j + 1 < n && ! targets[j]; j++)
+                {
+                    if (lens[j] != 0)
+                    {
+                        lens[j] = 0;
+                        changed = true;
+                    }
+                }
+            }
+        }
+
+        if (! changed)
+            break;
+    }
+
+    // 詰め直した位置を計算する（分岐命令は常に３バイト）
+    cx = 0;
+
+    for (i = 0; i < n; i++)
+    {
+        newpcs[pcs[i]] = cx;
+
+        if (lens[i] != 0)
+            cx += NBCIsBranch(as[i]) ? 3 : lens[i];
+    }
+
+    newpcs[len] = cx;
+
+    // 削除した命令への分岐は次の命令へ
+    for (i = n; 0 < i; i--)
+    {
+        if (lens[i - 1] == 0)
+            newpcs[pcs[i - 1]] = (i < n) ? newpcs[pcs[i]] : cx;
+    }
+
+    // バイトコードを作り直す
+    cx = 0;
+
+    for (i = 0; i < n; i++)
+    {
+        if (lens[i] == 0)
+            continue;
+
+        if (NBCIsBranch(as[i]))
+        {
+            pc = newpcs[bs[i]];
+            code[cx++] = as[i] | kNBCFieldMask;
+            code[cx++] = pc >> 8;
+            code[cx++] = pc & 0xff;
+        }
+        else if (as[i] == 0 && bs[i] == kNBCReturn)
+        {	// 分岐から置き換えたものを含む
+            code[cx++] = kNBCReturn;
+        }
+        else
+        {
+            memcpy(code + cx, bc + pcs[i], lens[i]);
+            cx += lens[i];
+        }
+    }
+
+    if (cx <= len || NewtStackExpand(&env->bytecode, cx))
+    {
+        memcpy(ENV_BC(env), code, cx);
+        ENV_CX(env) = cx;
+    }
+
+done:
+    if (pcs != NULL) NewtMemFree(pcs);
+    if (bs != NULL) NewtMemFree(bs);
+    if (as != NULL) NewtMemFree(as);
+    if (lens != NULL) NewtMemFree(lens);
+    if (index != NULL) NewtMemFree(index);
+    if (newpcs != NULL) NewtMemFree(newpcs);
+    if (targets != NULL) NewtMemFree(targets);
+    if (code != NULL) NewtMemFree(code);
+}
+
+
+/*------------------------------------------------------------------------*/
+/** 命令によるスタックの深さの増減を求める
+ *
+ * @param a			[in] 命令
+ * @param b			[in] オペデータ
+ * @param deltaP	[out]スタックの深さの増減
+ *
+ * @retval			true	増減が求まった
+ * @retval			false   不明な命令
+ */
+
+bool NBCStackEffect(uint8_t a, uint16_t b, int32_t * deltaP)
+{
+    int32_t	delta;
+
+    switch (a)
+    {
+        case 0:
+            switch (b)
+            {
+                case kNBCPop:
+                case kNBCIterNext:
+                    delta = -1;
+                    break;
+
+                case kNBCDup:
+                case kNBCPushSelf:
+                    delta = 1;
+                    break;
+
+                case kNBCReturn:
+                case kNBCSetLexScope:
+                case kNBCIterDone:
+                case kNBCPopHandlers:
+                    delta = 0;
+                    break;
+
+                default:
+                    return false;
+            }
+            break;
+
+        case kNBCPush:
+        case kNBCPushConstant:
+        case kNBCFindVar:
+        case kNBCGetVar:
+        case kNBCIncrVar:
+            delta = 1;
+            break;
+
+        case kNBCCall:
+        case kNBCInvoke:
+        case kNBCResend:
+        case kNBCResendIfDefined:
+        case kNBCMakeFrame:
+            delta = - (int32_t)b;
+            break;
+
+        case kNBCSend:
+        case kNBCSendIfDefined:
+            delta = - (int32_t)b - 1;
+            break;
+
+        case kNBCBranch:
+            delta = 0;
+            break;
+
+        case kNBCBranchIfTrue:
+        case kNBCBranchIfFalse:
+        case kNBCGetPath:
+        case kNBCSetVar:
+        case kNBCFindAndSetVar:
+            delta = -1;
+            break;
+
+        case kNBCMakeArray:
+            delta = (b == 0xFFFF) ? -1 : - (int32_t)b;
+            break;
+
+        case kNBCSetPath:
+            delta = (b == 1) ? -2 : -3;
+            break;
+
+        case kNBCBranchIfLoopNotDone:
+            delta = -3;
+            break;
+
+        case kNBCFreqFunc:
+            if (kBCFuncsLen <= b)
+                return false;
+
+            delta = 1 - freq_func_args[b];
+            break;
+
+        case kNBCNewHandlers:
+            delta = -2 * (int32_t)b;
+            break;
+
+        default:
+            return false;
+    }
+
+    *deltaP = delta;
+
+    return true;
+}
+
+
+/*------------------------------------------------------------------------*/
+/** 命令位置のスタックの深さを記録する
+ *
+ * @param depths	[in] 命令位置ごとのスタックの深さ（-1 は未到達）
+ * @param work		[in] 作業リスト
+ * @param nworkP	[in] 作業リストの長さへのポインタ
+ * @param len		[in] バイトコードの長さ
+ * @param pc		[in] 命令位置
+ * @param depth		[in] スタックの深さ
+ *
+ * @retval			true	記録した（記録済みの深さと一致した）
+ * @retval			false   深さが一致しない、またはバイトコードの範囲外
+ *
+ * @note			初めて到達した命令位置は作業リストに追加する
+ */
+
+bool NBCMergeDepth(int32_t * depths, uint32_t * work, uint32_t * nworkP, uint32_t len, uint32_t pc, int32_t depth)
+{
+    if (depth < 0 || len < pc)
+        return false;
+
+    if (pc == len)
+        return true;
+
+    if (depths[pc] < 0)
+    {
+        depths[pc] = depth;
+        work[(*nworkP)++] = pc;
+        return true;
+    }
+
+    return (depths[pc] == depth);
+}
+
+
+/*------------------------------------------------------------------------*/
+/** 例外ハンドラ表を作成する
+ *
+ * @param env		[in] バイトコード環境
+ *
+ * @return			例外ハンドラ表（作成できない場合は nil）
+ *
+ * @note			最適化後のバイトコードを命令単位にたどって各命令位置のスタックの深さを求め、
+ *					TRY文の先頭の深さを例外ハンドラの開始時の深さとして記録する。
+ *					VM は表のある関数の TRY文の先頭で new-handlers までを読み飛ばし、
+ *					例外が発生したときだけ表を参照する。バイトコードは変更しないので
+ *					表を持たない関数（NSOF から読込んだ関数など）は従来どおり実行できる。
+ *					深さが一致しない場合は表を作成しない。
+ */
+
+newtRef NBCMakeHandlers(nbc_env_t * env)
+{
+    nbc_handler_t *	handlers = ENV_HANDLERS(env);
+    uint32_t	nhandlers = env->handlers.sp;
+    uint8_t *	bc = ENV_BC(env);
+    uint32_t	len = ENV_CX(env);
+    newtRefVar	r = kNewtRefNIL;
+    int32_t *	depths;		// 命令位置ごとのスタックの深さ
+    uint32_t *	work;		// 深さが決まって未処理の命令位置
+    uint32_t	nwork = 0;
+    int32_t		depth;
+    int32_t		delta;
+    uint32_t	pc;
+    uint32_t	n;
+    uint32_t	i;
+    uint16_t	b;
+    uint8_t		a;
+    uint8_t		oplen;
+
+    if (nhandlers == 0 || len == 0)
+        return kNewtRefNIL;
+
+    depths = (int32_t *)NewtMemCalloc(NULL, len, sizeof(int32_t));
+    work = (uint32_t *)NewtMemCalloc(NULL, len, sizeof(uint32_t));
+
+    if (depths == NULL || work == NULL)
+        goto done;
+
+    for (pc = 0; pc < len; pc++)
+        depths[pc] = -1;
+
+    NBCMergeDepth(depths, work, &nwork, len, 0, 0);
+
+    while (0 < nwork)
+    {
+        pc = work[--nwork];
+        depth = depths[pc];
+
+        // TRY文の先頭の深さが例外ハンドラの開始時の深さになる
+        for (i = 0; i < nhandlers; i++)
+        {
+            if (handlers[i].start == pc &&
+                ! NBCMergeDepth(depths, work, &nwork, len, handlers[i].pc, depth))
+                goto done;
+        }
+
+        a = bc[pc] & ~kNBCFieldMask;
+        b = bc[pc] & kNBCFieldMask;
+        oplen = 1;
+
+        if (b == kNBCFieldMask)
+        {
+            if (len < pc + 3)
+                goto done;
+
+            b = ((uint16_t)bc[pc + 1] << 8) | bc[pc + 2];
+            oplen = 3;
+
+            if (a == 0 && b == 0x01)
+                b = kNBCPopHandlers;
+        }
+
+        if (a == 0 && b == kNBCReturn)
+            continue;
+
+        if (! NBCStackEffect(a, b, &delta))
+            goto done;
+
+        if (NBCIsBranch(a) &&
+            ! NBCMergeDepth(depths, work, &nwork, len, b, depth + delta))
+            goto done;
+
+        if (a != kNBCBranch &&
+            ! NBCMergeDepth(depths, work, &nwork, len, pc + oplen, depth + delta))
+            goto done;
+    }
+
+    // 到達できない TRY文は除く
+    for (i = 0, n = 0; i < nhandlers; i++)
+    {
+        if (! NewtRefIsSymbol(handlers[i].sym) || len <= handlers[i].start)
+            goto done;
+
+        if (0 <= depths[handlers[i].start])
+            n++;
+    }
+
+    if (n == 0)
+        goto done;
+
+    r = NewtMakeArray(kNewtRefUnbind, n * kNBCHandlerLen);
+
+    if (NewtRefIsNIL(r))
+        goto done;
+
+    for (i = 0, n = 0; i < nhandlers; i++)
+    {
+        if (depths[handlers[i].start] < 0)
+            continue;
+
+        NewtSetArraySlot(r, n + kNBCHandlerStart, NewtMakeInteger(handlers[i].start));
+        NewtSetArraySlot(r, n + kNBCHandlerEnd, NewtMakeInteger(handlers[i].end));
+        NewtSetArraySlot(r, n + kNBCHandlerExit, NewtMakeInteger(handlers[i].exit));
+        NewtSetArraySlot(r, n + kNBCHandlerDepth, NewtMakeInteger(depths[handlers[i].start]));
+        NewtSetArraySlot(r, n + kNBCHandlerSym, handlers[i].sym);
+        NewtSetArraySlot(r, n + kNBCHandlerPC, NewtMakeInteger(handlers[i].pc));
+        n += kNBCHandlerLen;
+    }
+
+done:
+    if (depths != NULL) NewtMemFree(depths);
+    if (work != NULL) NewtMemFree(work);
+
+    return r;
+}
+
+
 #if 0
 #pragma mark -
 #endif
@@ -916,6 +1543,7 @@ void NBCEnvFree(nbc_env_t * env)
 		NewtStackFree(&env->bytecode);
 		NewtStackFree(&env->breakstack);
 		NewtStackFree(&env->onexcpstack);
+		NewtStackFree(&env->handlers);
 
         NewtMemFree(env);
     }
@@ -941,10 +1569,21 @@ newtRef NBCFnDone(nbc_env_t ** envP)
         newtRefVar	literals;
 
         NBCGenCodeEnv(env, kNBCReturn, 0);
+        NBCPeephole(env);
 
         fn = env->func;
         instr = NewtMakeBinary(NSSYM0(instructions), ENV_BC(env), ENV_CX(env), true);
         NcSetSlot(fn, NSSYM0(instructions), instr);
+
+        // 例外ハンドラ表
+        if (! NEWT_MODE_NOS1_FUNCTIONS) {
+            newtRefVar	handlers;
+
+            handlers = NBCMakeHandlers(env);
+
+            if (NewtRefIsNotNIL(handlers))
+                NcSetSlot(fn, NSSYM0(handlers), handlers);
+        }
     
         literals = NcGetSlot(fn, NSSYM0(literals));
 
@@ -1259,6 +1898,9 @@ int16_t NBCGenTryPost(nps_syntax_node_t * stree, nps_node_t r,
                 NBCOnexcpBackPatchL(*onexcpspP, CX);
                 (*onexcpspP)++;
 
+                // 例外ハンドラ表に追加
+                NBCAddHandler(node->op1, CX);
+
                 // onexception のコード生成
                 NBCGenBC_stmt(stree, node->op2, ret);
                 NBCGenOnexcpBranch();
@@ -1290,27 +1932,34 @@ int16_t NBCGenTryPost(nps_syntax_node_t * stree, nps_node_t r,
 void NBCGenTry(nps_syntax_node_t * stree, nps_node_t expr,
         nps_node_t onexception_list, bool ret)
 {
+    uint32_t	try_cx;
+    uint32_t	end_cx;
     uint32_t	onexcp_cx;
     uint32_t	branch_cx;
     uint32_t	onexcpsp;
+    uint32_t	handlersp;
     int16_t	numExcps = 0;
 
+    try_cx = CX;
     onexcpsp = ONEXCPSP;
     numExcps = NBCGenTryPre(stree, onexception_list);
     NBCGenCode(kNBCNewHandlers, numExcps);
 
     // 実行文
     NBCGenBC_stmt(stree, expr, ret);
+    end_cx = CX;
     NBCGenCode(kNBCPopHandlers, 0);
 
     branch_cx = NBCGenBranch(kNBCBranch);
 
     // onexception
     onexcp_cx = CX;
+    handlersp = HANDLERSP;
     NBCGenTryPost(stree, onexception_list, &onexcpsp, ret);
 
     // onexception の終了
     NBCOnexcpBackPatchs(onexcp_cx);	// onexception の終了をバックパッチ
+    NBCHandlerBackPatchs(handlersp, try_cx, end_cx, CX);	// 例外ハンドラ表をバックパッチ
     NBCGenCode(kNBCPopHandlers, 0);
 
     // ONEXCPSP を戻す
@@ -1338,7 +1987,9 @@ void NBCGenIfThenElse(nps_syntax_node_t * stree, nps_node_t cond,
     nps_node_t	ifthen;
     nps_node_t	ifelse = kNewtRefUnbind;
     uint32_t	cond_cx;
+    bool		tail = TAIL;
 
+    TAIL = false;
     NBCGenBC_op(stree, cond);
     cond_cx = NBCGenBranch(kNBCBranchIfFalse);
 
@@ -1353,6 +2004,7 @@ void NBCGenIfThenElse(nps_syntax_node_t * stree, nps_node_t cond,
     }
 
     // THEN 文
+    TAIL = tail;
     NBCGenBC_stmt(stree, ifthen, ret);
 
     if (ifelse == kNewtRefUnbind)
@@ -1367,6 +2019,7 @@ void NBCGenIfThenElse(nps_syntax_node_t * stree, nps_node_t cond,
         NBCBackPatch(cond_cx, CX);				// 条件文をバックパッチ
 
         // ELSE 文
+        TAIL = tail;
         NBCGenBC_stmt(stree, ifelse, ret);
 
         NBCBackPatch(then_done, CX);			// THEN 文終了のブランチをバックパッチ
@@ -1555,6 +2208,7 @@ void NBCGenFor(nps_syntax_node_t * stree, nps_node_t r, nps_node_t expr)
     NBCGenBC_stmt(stree, expr, false);
 
     // 変数に by を増分
+    // （incr-var から branch-if-loop-not-done までは VM が１つの命令にまとめる）
     {
         ssize_t	b;
 
@@ -2055,6 +2709,7 @@ void NBCGenFn(nps_syntax_node_t * stree, nps_node_t args, nps_node_t expr)
     int        funcType;
 
     (void) NBCMakeFnEnv(stree, args);
+    TAIL = NEWT_MODE_TAILCALL;		// 関数本体の値は戻り値になる
     NBCGenBC_op(stree, expr);
     fn = NBCFnDone(&newt_bc_env);
     NBCGenPUSH(fn);
@@ -2097,11 +2752,12 @@ void NBCGenGlobalFn(nps_syntax_node_t * stree, nps_node_t name, nps_node_t fn)
  * @param stree		[in] 構文木
  * @param name		[in] グローバル関数名
  * @param args		[in] 引数
+ * @param tail		[in] 末尾位置の呼出しか
  *
  * @return			なし
  */
 
-void NBCGenCall(nps_syntax_node_t * stree, nps_node_t name, nps_node_t args)
+void NBCGenCall(nps_syntax_node_t * stree, nps_node_t name, nps_node_t args, bool tail)
 {
     int16_t numArgs;
 
@@ -2109,6 +2765,7 @@ void NBCGenCall(nps_syntax_node_t * stree, nps_node_t name, nps_node_t args)
     numArgs = NBCCountNumArgs(stree, args);
 
     NBCGenCallFn(name, numArgs);
+    NBCGenTailReturn(tail);
 }
 
 
@@ -2118,11 +2775,12 @@ void NBCGenCall(nps_syntax_node_t * stree, nps_node_t name, nps_node_t args)
  * @param stree		[in] 構文木
  * @param fn		[in] 関数オブジェクト
  * @param args		[in] 引数
+ * @param tail		[in] 末尾位置の呼出しか
  *
  * @return			なし
  */
 
-void NBCGenInvoke(nps_syntax_node_t * stree, nps_node_t fn, nps_node_t args)
+void NBCGenInvoke(nps_syntax_node_t * stree, nps_node_t fn, nps_node_t args, bool tail)
 {
     int16_t numArgs;
 
@@ -2132,6 +2790,7 @@ void NBCGenInvoke(nps_syntax_node_t * stree, nps_node_t fn, nps_node_t args)
     NBCGenBC_op(stree, fn);
 //    NBCGenCode(kNBCSetLexScope, 0);
     NBCGenCode(kNBCInvoke, numArgs);
+    NBCGenTailReturn(tail);
 }
 
 
@@ -2163,12 +2822,13 @@ void NBCGenFunc2(nps_syntax_node_t * stree,
  * @param code		[in] 送信タイプ
  * @param receiver	[in] レシーバ
  * @param r			[in] メソッド名＋引数
+ * @param tail		[in] 末尾位置の呼出しか
  *
  * @return			なし
  */
 
 void NBCGenSend(nps_syntax_node_t * stree, uint32_t code,
-        nps_node_t receiver, nps_node_t r)
+        nps_node_t receiver, nps_node_t r, bool tail)
 {
     nps_syntax_node_t * node;
     int16_t numArgs;
@@ -2189,6 +2849,7 @@ void NBCGenSend(nps_syntax_node_t * stree, uint32_t code,
 
     // メッセージ呼出しの生成
     NBCGenCode(code, numArgs);
+    NBCGenTailReturn(tail);
 }
 
 
@@ -2199,12 +2860,13 @@ void NBCGenSend(nps_syntax_node_t * stree, uint32_t code,
  * @param code		[in] 送信タイプ
  * @param name		[in] メソッド名
  * @param args		[in] 引数
+ * @param tail		[in] 末尾位置の呼出しか
  *
  * @return			なし
  */
 
 void NBCGenResend(nps_syntax_node_t * stree, uint32_t code,
-        nps_node_t name, nps_node_t args)
+        nps_node_t name, nps_node_t args, bool tail)
 {
     int16_t numArgs;
 
@@ -2213,6 +2875,7 @@ void NBCGenResend(nps_syntax_node_t * stree, uint32_t code,
 
     NBCGenPUSH(name);
     NBCGenCode(code, numArgs);
+    NBCGenTailReturn(tail);
 }
 
 
@@ -2275,6 +2938,26 @@ void NVCGenNoResult(bool ret)
 }
 
 
+/*------------------------------------------------------------------------*/
+/** 末尾位置の呼出しの直後に return を生成する
+ *
+ * @param tail		[in] 末尾位置の呼出しか
+ *
+ * @return			なし
+ *
+ * @note			call/invoke/send/resend の直後の return を VM が末尾呼出しとして扱い、
+ *					呼出し元の活性レコードを再利用する。分岐先の return まで
+ *					たどらなくても済むように、ここで直接 return を置いておく。
+ *					バイトコードは通常の命令だけなので NTK 形式のまま出力できる。
+ */
+
+void NBCGenTailReturn(bool tail)
+{
+    if (tail)
+        NBCGenCode(kNBCReturn, 0);
+}
+
+
 /*------------------------------------------------------------------------*/
 /** 構文コードのバイトコードを生成する
  *
@@ -2287,16 +2970,23 @@ void NVCGenNoResult(bool ret)
 
 void NBCGenSyntaxCode(nps_syntax_node_t * stree, nps_syntax_node_t * node, bool ret)
 {
+    bool	tail = TAIL;
+
+    // 末尾位置は文の並びの最後と if 文の THEN, ELSE にだけ引き継ぐ
+    TAIL = false;
+
     switch (node->code)
     {
         case kNPSConstituentList:
             if (NewtRefIsNIL(node->op2))
             {
+                TAIL = tail;
                 NBCGenBC_stmt(stree, node->op1, ret);
             }
             else
             {
                 NBCGenBC_stmt(stree, node->op1, false);
+                TAIL = tail;
                 NBCGenBC_stmt(stree, node->op2, ret);
             }
             break;
@@ -2360,6 +3050,7 @@ void NBCGenSyntaxCode(nps_syntax_node_t * stree, nps_syntax_node_t * node, bool
             break;
 
         case kNPSIf:
+            TAIL = tail;
             NBCGenIfThenElse(stree, node->op1, node->op2, ret);
             break;
 
@@ -2582,6 +3273,7 @@ void NBCGenBC_sub(nps_syntax_node_t * stree, uint32_t n, bool ret)
 {
     nps_syntax_node_t *	node;
     bool	handled = true;
+    bool	tail;
 
     node = stree + n;
 
@@ -2591,30 +3283,33 @@ void NBCGenBC_sub(nps_syntax_node_t * stree, uint32_t n, bool ret)
         return;
     }
 
+    tail = TAIL;
+    TAIL = false;
+
     switch (node->code)
     {
         case kNPSCall:
-            NBCGenCall(stree, node->op1, node->op2);
+            NBCGenCall(stree, node->op1, node->op2, tail);
             break;
 
         case kNPSInvoke:
-            NBCGenInvoke(stree, node->op1, node->op2);
+            NBCGenInvoke(stree, node->op1, node->op2, tail);
             break;
 
         case kNPSSend:
-            NBCGenSend(stree, kNBCSend, node->op1, node->op2);
+            NBCGenSend(stree, kNBCSend, node->op1, node->op2, tail);
 			break;
 
         case kNPSSendIfDefined:
-            NBCGenSend(stree, kNBCSendIfDefined, node->op1, node->op2);
+            NBCGenSend(stree, kNBCSendIfDefined, node->op1, node->op2, tail);
             break;
 
         case kNPSResend:
-            NBCGenResend(stree, kNBCResend, node->op1, node->op2);
+            NBCGenResend(stree, kNBCResend, node->op1, node->op2, tail);
             break;
 
         case kNPSResendIfDefined:
-            NBCGenResend(stree, kNBCResendIfDefined, node->op1, node->op2);
+            NBCGenResend(stree, kNBCResendIfDefined, node->op1, node->op2, tail);
             break;
 
         case kNPSMakeArray:
@@ -2635,6 +3330,7 @@ void NBCGenBC_sub(nps_syntax_node_t * stree, uint32_t n, bool ret)
             // Optimization not present in NewtonOS compiler: we don't need a
             // pop here that would never be executed.
             handled = false;
+            TAIL = NEWT_MODE_TAILCALL;	// return する式の値は戻り値になる
             break;
 
         default:
@@ -2649,6 +3345,7 @@ void NBCGenBC_sub(nps_syntax_node_t * stree, uint32_t n, bool ret)
     else
     {
         NBCGenBC_op(stree, node->op1);
+        TAIL = false;
         NBCGenBC_op(stree, node->op2);
     
         if (node->code <= kNPSPopHandlers)
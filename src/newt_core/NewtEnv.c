@@ -25,6 +25,7 @@
 
 /* マクロ */
 #define SYM_TABLE			(newt_env.sym_table)				///< シンボルテーブル
+#define SYM_INDEX			(newt_env.sym_index)				///< シンボルテーブルのハッシュ索引
 #define ROOT				(newt_env.root)						///< ルートオブジェクト
 #define GLOBALS				(newt_env.globals)					///< グローバル変数テーブル
 #define GLOBAL_FNS			(newt_env.global_fns)				///< グローバル関数テーブル
@@ -49,6 +50,10 @@ static void		NewtInitARGV(int argc, const char * argv[], int n);
 static void		NewtInitVersInfo(void);
 static void		NewtInitEnv(int argc, const char * argv[], int n);
 
+static uint32_t	NewtSymIndexHash(newtSymDataRef sym);
+static bool		NewtSymIndexGrow(void);
+static void		NewtSymIndexInsert(newtRefArg sym);
+
 static newtRef	NcResolveNamedMP(newtRefArg r);
 static newtRef	NsDefNamedMP(newtRefArg rcvr, newtRefArg r, newtRefArg v);
 
@@ -131,6 +136,7 @@ void NewtInitSYM(void)
     INITSYM(argFrame);
     INITSYM(numArgs);
     INITSYM(indefinite);
+    INITSYM(handlers);
 
     // native function
     INITSYM(_function.native0);
@@ -223,6 +229,7 @@ void NewtInitSYM(void)
     // Compile options
     INITSYM(nosCompatible);
     INITSYM(nos1Functions);
+    INITSYM(tailCalls);
 
 	// ARGV
     INITSYM(_ARGV_);
@@ -441,6 +448,25 @@ void NewtInit(int argc, const char * argv[], int n)
 {
 	// メモリプールの確保
     NEWT_POOL = NewtPoolAlloc(NEWT_POOL_EXPANDSPACE);
+
+    if (NEWT_POOL != NULL && NEWT_MODE_NOMEMPOOL)
+        NEWT_POOL->maxclass = 0;
+
+    if (NEWT_POOL != NULL && NEWT_MODE_NONURSERY)
+        NEWT_POOL->nurseryspace = 0;
+
+    if (NEWT_POOL != NULL && NEWT_MODE_NOLAZYSWEEP)
+        NEWT_POOL->lazysweep = false;
+
+    if (NEWT_POOL != NULL && 0 < NEWT_MODE_GCTHREADS)
+        NEWT_POOL->gcthreads = NEWT_MODE_GCTHREADS;
+
+    if (NEWT_POOL != NULL && 0 < NEWT_MODE_HEAPSIZE)
+        NEWT_POOL->maxspace = NEWT_POOL->initspace = NEWT_MODE_HEAPSIZE;
+
+    if (NEWT_POOL != NULL && 0 < NEWT_MODE_HEAPLIMIT)
+        NEWT_POOL->limitspace = NEWT_MODE_HEAPLIMIT;
+
 	// 実行環境の初期化
     NewtInitEnv(argc, argv, n);
 }
@@ -460,26 +486,162 @@ void NewtCleanup(void)
     if (NEWT_POOL != NULL)
     {
         NewtPoolRelease(NEWT_POOL);
-        NewtMemFree(NEWT_POOL);
+        NewtPoolFree(NEWT_POOL);
         NEWT_POOL = NULL;
     }
+
+	// マップの索引と遷移先の解放
+    NewtMapCacheFree();
+
+	// シンボルテーブルの索引の解放
+    free(SYM_INDEX);
+    SYM_INDEX = NULL;
+    newt_env.sym_indexsize = 0;
+    newt_env.sym_nums = 0;
 }
 
 
 #if 0
 #pragma mark -
 #endif
+/*------------------------------------------------------------------------*/
+/** ハッシュ索引の位置を決めるハッシュ値を取得する
+ *
+ * @param sym		[in] シンボルデータ
+ *
+ * @return			ハッシュ値
+ *
+ * @note			Newton OS 互換のハッシュ値は文字の和なので索引の位置には使わない
+ */
+
+uint32_t NewtSymIndexHash(newtSymDataRef sym)
+{
+    if (NEWT_MODE_NOFASTHASH)
+        return NewtSymbolFastHash(sym->name);
+    else
+        return sym->hash;
+}
+
+
+/*------------------------------------------------------------------------*/
+/** シンボルテーブルのハッシュ索引を拡張する
+ *
+ * @retval			true	成功
+ * @retval			false   失敗
+ *
+ * @note			登録済みのシンボルは新しい索引に入れ直す
+ */
+
+bool NewtSymIndexGrow(void)
+{
+    newtRef *	oldindex = SYM_INDEX;
+    uint32_t	oldsize = newt_env.sym_indexsize;
+    newtRef *	newindex;
+    uint32_t	newsize;
+    uint32_t	i;
+
+    newsize = (oldsize == 0) ? NEWT_NUM_SYMINDEX : oldsize * 2;
+    newindex = (newtRef *)malloc(sizeof(newtRef) * newsize);
+
+    if (newindex == NULL)
+        return false;
+
+    for (i = 0; i < newsize; i++)
+    {
+        newindex[i] = kNewtRefUnbind;
+    }
+
+    SYM_INDEX = newindex;
+    newt_env.sym_indexsize = newsize;
+    newt_env.sym_nums = 0;
+
+    for (i = 0; i < oldsize; i++)
+    {
+        if (oldindex[i] != kNewtRefUnbind)
+            NewtSymIndexInsert(oldindex[i]);
+    }
+
+    free(oldindex);
+
+    return true;
+}
+
+
+/*------------------------------------------------------------------------*/
+/** シンボルをハッシュ索引に登録する
+ *
+ * @param sym		[in] シンボルオブジェクト
+ *
+ * @return			なし
+ *
+ * @note			索引の使用率が 1/2 を超えないように拡張する
+ */
+
+void NewtSymIndexInsert(newtRefArg sym)
+{
+    uint32_t	mask;
+    uint32_t	i;
+
+    if (newt_env.sym_indexsize < (newt_env.sym_nums + 1) * 2 && ! NewtSymIndexGrow())
+        return;
+
+    mask = newt_env.sym_indexsize - 1;
+    i = NewtSymIndexHash(NewtRefToSymbol(sym)) & mask;
+
+    while (SYM_INDEX[i] != kNewtRefUnbind)
+    {
+        i = (i + 1) & mask;
+    }
+
+    SYM_INDEX[i] = sym;
+    newt_env.sym_nums++;
+}
+
+
 /*------------------------------------------------------------------------*/
 /** シンボルテーブルからシンボルを検索する
  *
  * @param name		[in] シンボルの名前
  *
  * @return			シンボルオブジェクト
+ *
+ * @note			未登録の場合はシンボルオブジェクトを作成しシンボルテーブルに登録する。
+ *					検索はハッシュ索引で行い、シンボルテーブルの配列には登録順に追加する。
  */
 
 newtRef NewtLookupSymbolTable(const char * name)
 {
-    return NewtLookupSymbol(SYM_TABLE, name, 0, 0);
+    newtRefVar	sym;
+    uint32_t	hash;
+    uint32_t	ihash;
+
+    ihash = NewtSymbolFastHash(name);
+
+    if (NEWT_MODE_NOFASTHASH)
+        hash = NewtSymbolNewtonHash(name);
+    else
+        hash = ihash;
+
+    if (SYM_INDEX != NULL)
+    {
+        newtSymDataRef	symData;
+        uint32_t	mask = newt_env.sym_indexsize - 1;
+        uint32_t	i;
+
+        for (i = ihash & mask; SYM_INDEX[i] != kNewtRefUnbind; i = (i + 1) & mask)
+        {
+            symData = NewtRefToSymbol(SYM_INDEX[i]);
+
+            if (symData->hash == hash && strcasecmp(name, symData->name) == 0)
+                return SYM_INDEX[i];
+        }
+    }
+
+    sym = NewtMakeSymbol0(name);
+    NcAddArraySlot(SYM_TABLE, sym);
+    NewtSymIndexInsert(sym);
+
+    return sym;
 }
 
 
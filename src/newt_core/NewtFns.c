@@ -11,12 +11,15 @@
 
 
 /* ヘッダファイル */
+#include <stdlib.h>
 #include <string.h>
 #include <inttypes.h>
+#include <time.h>
 
 #include "NewtErrs.h"
 #include "NewtFns.h"
 #include "NewtEnv.h"
+#include "NewtGC.h"
 #include "NewtObj.h"
 #include "NewtVM.h"
 #include "NewtBC.h"
@@ -28,6 +31,8 @@ static newtRef		NewtRefTypeToClass(uint16_t type);
 static newtRef		NewtObjClassOf(newtRefArg r);
 static newtRef		NewtObjSetClass(newtRefArg r, newtRefArg c);
 static bool			NewtArgsIsNumber(newtRefArg r1, newtRefArg r2, bool * real);
+static int			NewtHashCompare(const void * a, const void * b);
+static newtRef		NewtHashCollisions(uint32_t * hashes, size_t len);
 
 
 #if 0
@@ -791,6 +796,7 @@ newtRef NewtObjSetClass(newtRefArg r, newtRefArg c)
 		else
 		{
             obj->as.klass = c;
+            NewtGCWriteBarrier(obj, c);
 		}
     }
 
@@ -1726,12 +1732,15 @@ newtRef NcDivide(newtRefArg r1, newtRefArg r2)
         if (int2 == 0)
             return NewtThrow(kNErrDiv0, r2);
 
-        double result = (double)int1 / (double)int2;
-        if (result == (int)result) {
-            return NewtMakeInteger(result);
+        // 割切れる場合は 30bit を超えても整数のまま
+        if (int2 == -1) {
+            return NewtMakeInteger((intptr_t)(0 - (uintptr_t)int1));
+        }
+        else if (int1 % int2 == 0) {
+            return NewtMakeInteger(int1 / int2);
         }
         else {
-            return NewtMakeReal(result);
+            return NewtMakeReal((double)int1 / (double)int2);
         }
     }
 }
@@ -2084,6 +2093,22 @@ newtRef NsExit(newtRefArg rcvr, newtRefArg r)
 }
 
 
+/*------------------------------------------------------------------------*/
+/** 経過時間をティック（1/60 秒）単位で取得する
+ *
+ * @param rcvr		[in] レシーバ
+ *
+ * @return			整数オブジェクト
+ *
+ * @note			プロセスの CPU 時間を返す。ベンチマーク用
+ */
+
+newtRef NsTicks(newtRefArg rcvr)
+{
+    return NewtMakeInteger((int64_t)clock() * 60 / CLOCKS_PER_SEC);
+}
+
+
 /*------------------------------------------------------------------------*/
 /** 標準出力に関数オブジェクトをダンプ出力
  *
@@ -2137,6 +2162,150 @@ newtRef NsDumpStacks(newtRefArg rcvr)
 }
 
 
+/*------------------------------------------------------------------------*/
+/** 呼出しスタックの深さを取得
+ *
+ * @param rcvr		[in] レシーバ
+ *
+ * @return			整数オブジェクト
+ *
+ * @note			スクリプトからの呼出し用
+ */
+
+newtRef NsCallStackDepth(newtRefArg rcvr)
+{
+    return NVMCallStackDepth();
+}
+
+
+/*------------------------------------------------------------------------*/
+/** インラインキャッシュのヒット数とミス数を取得
+ *
+ * @param rcvr		[in] レシーバ
+ *
+ * @return			フレーム
+ *
+ * @note			スクリプトからの呼出し用
+ */
+
+newtRef NsInlineCacheStats(newtRefArg rcvr)
+{
+    return NVMInlineCacheStats();
+}
+
+
+/*------------------------------------------------------------------------*/
+/** ハッシュ値を比較する（qsort 用）
+ *
+ * @param a			[in] ハッシュ値へのポインタ
+ * @param b			[in] ハッシュ値へのポインタ
+ *
+ * @retval			負		a < b
+ * @retval			0		a = b
+ * @retval			正		a > b
+ */
+
+int NewtHashCompare(const void * a, const void * b)
+{
+    uint32_t	x = *(const uint32_t *)a;
+    uint32_t	y = *(const uint32_t *)b;
+
+    return (x > y) - (x < y);
+}
+
+
+/*------------------------------------------------------------------------*/
+/** ハッシュ値の衝突を数える
+ *
+ * @param hashes	[in] ハッシュ値の配列（ソートされる）
+ * @param len		[in] 配列の長さ
+ *
+ * @return			フレーム
+ */
+
+newtRef NewtHashCollisions(uint32_t * hashes, size_t len)
+{
+    newtRefVar	result;
+    size_t	collisions = 0;
+    size_t	maxbucket = 0;
+    size_t	bucket;
+    size_t	i;
+
+    qsort(hashes, len, sizeof(uint32_t), NewtHashCompare);
+
+    for (i = 0; i < len; i += bucket)
+    {
+        for (bucket = 1; i + bucket < len && hashes[i + bucket] == hashes[i]; bucket++)
+            ;
+
+        collisions += bucket - 1;
+
+        if (maxbucket < bucket)
+            maxbucket = bucket;
+    }
+
+    result = NcMakeFrame();
+    NcSetSlot(result, NSSYM(collisions), NewtMakeInteger(collisions));
+    NcSetSlot(result, NSSYM(maxBucket), NewtMakeInteger(maxbucket));
+
+    return result;
+}
+
+
+/*------------------------------------------------------------------------*/
+/** シンボルテーブルのハッシュ値の衝突を調べる
+ *
+ * @param rcvr		[in] レシーバ
+ *
+ * @return			フレーム
+ *
+ * @note			登録済みの全シンボルについて、Newton OS 互換のハッシュ関数と
+ *					高速なハッシュ関数で同じハッシュ値になったシンボルの数を返す。
+ *					スクリプトからの呼出し用
+ */
+
+newtRef NsSymbolHashStats(newtRefArg rcvr)
+{
+    newtRefVar	symtable;
+    newtRefVar	result;
+    uint32_t *	newton;
+    uint32_t *	fast;
+    const char *	name;
+    size_t	len;
+    size_t	i;
+
+    symtable = NcGetSymTable();
+    len = NewtArrayLength(symtable);
+
+    newton = (uint32_t *)malloc(sizeof(uint32_t) * (len + 1));
+    fast = (uint32_t *)malloc(sizeof(uint32_t) * (len + 1));
+
+    if (newton == NULL || fast == NULL)
+    {
+        free(newton);
+        free(fast);
+        return NewtThrow0(kNErrOutOfObjectMemory);
+    }
+
+    for (i = 0; i < len; i++)
+    {
+        name = NewtSymbolGetName(NewtGetArraySlot(symtable, i));
+        newton[i] = NewtSymbolNewtonHash(name);
+        fast[i] = NewtSymbolFastHash(name);
+    }
+
+    result = NcMakeFrame();
+    NcSetSlot(result, NSSYM(symbols), NewtMakeInteger(len));
+    NcSetSlot(result, NSSYM(newton), NewtHashCollisions(newton, len));
+    NcSetSlot(result, NSSYM(fast), NewtHashCollisions(fast, len));
+
+    free(newton);
+    free(fast);
+
+    return result;
+}
+
+
 /*------------------------------------------------------------------------*/
 /** 標準出力に関数情報を表示
  *
@@ -2211,6 +2380,7 @@ newtRef NsGetCompileOptions(newtRefArg rcvr)
     newtRefVar result = NcMakeFrame();
     NcSetSlot(result, NSSYM0(nosCompatible), NewtMakeBoolean(NEWT_MODE_NOS2));
     NcSetSlot(result, NSSYM0(nos1Functions), NewtMakeBoolean(NEWT_MODE_NOS1_FUNCTIONS));
+    NcSetSlot(result, NSSYM0(tailCalls), NewtMakeBoolean(NEWT_MODE_TAILCALL));
 
     return result;
 }
@@ -2238,6 +2408,10 @@ newtRef NsSetCompileOptions(newtRefArg rcvr, newtRefArg r)
     if (NewtRefIsNotNIL(nos1Functions)) {
         NEWT_MODE_NOS1_FUNCTIONS = true;
     }
+    newtRefVar tailCalls = NcGetSlot(r, NSSYM0(tailCalls));
+    if (NewtRefIsNotNIL(tailCalls)) {
+        NEWT_MODE_TAILCALL = true;
+    }
 
     return NsGetCompileOptions(rcvr);
 }
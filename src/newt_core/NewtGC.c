@@ -11,6 +11,8 @@
 
 
 /* ヘッダファイル */
+#include <time.h>
+
 #ifdef HAVE_MEMORY_H
 	#include <memory.h>
 #else
@@ -20,31 +22,181 @@
 
 #include "NewtGC.h"
 #include "NewtObj.h"
+#include "NewtFns.h"
 #include "NewtMem.h"
 #include "NewtEnv.h"
 #include "NewtVM.h"
 #include "NewtIO.h"
+#include "NewtErrs.h"
 #include "NewtPrint.h"
 
+#if defined(HAVE_PTHREAD_H) && defined(__GNUC__)
+	#define NEWT_GC_PARALLEL		///< 全体の GC を複数のスレッドで行う
+	#include <pthread.h>
+#endif
+
+
+/* マクロ */
+
+/// マーク時に参照先を先読みするスロット数
+#define NEWT_GC_PREFETCH		4
+
+#ifdef __GNUC__
+	#define NewtGCPrefetch(p)	__builtin_prefetch(p)	///< メモリを先読みする
+#else
+	#define NewtGCPrefetch(p)
+#endif
+
+#define NewtGCBitTest(bits, i)		(((bits)[(i) >> 5] & (1U << ((i) & 31))) != 0)	///< ビットマップのビットが立っているか
+#define NewtGCBitSet(bits, i)		((bits)[(i) >> 5] |= (1U << ((i) & 31)))			///< ビットマップのビットを立てる
+
+
+/* 型宣言 */
+
+#ifdef NEWT_GC_PARALLEL
+
+/// 並列 GC の仕事
+enum {
+    kNewtGCJobMark		= 0,	///< マーク
+    kNewtGCJobSweep				///< アリーナのスウィープ
+};
+
+
+/// GC 用のオブジェクトのスタック
+typedef struct {
+    newtObjRef *	stackp;		///< スタック
+    uint32_t	nums;			///< オブジェクト数
+    uint32_t	size;			///< 確保済みの長さ
+} newtGCStack;
+
+
+/// GC のワーカー（スレッドごとの作業領域）
+typedef struct {
+    pthread_t	thread;			///< スレッド（先頭のワーカーは GC を呼出したスレッド）
+    newtGCStack	mark;			///< マークスタック
+    newtGCStack	cobjs;			///< マーカー関数を後で呼出す CObject
+    bool		markoverflow;	///< マークスタックからあふれたオブジェクトがある
+
+    void *		freehead[NEWT_NUM_MEMCLASS];	///< サイズクラスごとに解放したブロックのリストの先頭
+    void *		freetail[NEWT_NUM_MEMCLASS];	///< サイズクラスごとに解放したブロックのリストの末尾
+    int64_t		freesize;		///< 解放したオブジェクトの使用サイズ
+    newtObjRef	literal;		///< スウィープで見つけたリテラルのチェイン
+    newtObjRef	deferred;		///< GC を呼出したスレッドで解放するオブジェクトのチェイン
+} newtGCWorker;
+
+
+/// 並列 GC の共有状態
+typedef struct {
+    pthread_mutex_t	lock;		///< 共有状態のロック
+    pthread_cond_t	start;		///< 仕事の開始を知らせる
+    pthread_cond_t	done;		///< 仕事の終了を知らせる
+    pthread_cond_t	work;		///< 共有のマークスタックに仕事が積まれたことを知らせる
+
+    newtPool		pool;		///< メモリプール
+    newtGCWorker *	workers;	///< ワーカーの配列
+    uint32_t		size;		///< ワーカーの配列の長さ
+    uint32_t		nthreads;	///< 起動できたスレッド数（GC を呼出したスレッドを含む）
+    uint32_t		job;		///< 仕事
+    uint32_t		generation;	///< 仕事の通し番号
+    uint32_t		running;	///< 仕事中のワーカースレッド数
+    bool			quit;		///< ワーカースレッドを終了させる
+
+    newtGCStack		shared;		///< スレッド間で受渡すマークの仕事
+    uint32_t		idle;		///< マークの仕事を待っているスレッド数（ロックの外では不可分操作で読む）
+    bool			markdone;	///< マークが終わった
+    newtMemArena *	sweeparena;	///< 次にスウィープするアリーナ
+} newtGCParallel;
+
+#endif /* NEWT_GC_PARALLEL */
+
 
 /* 関数プロトタイプ */
-static void		NewtPoolSnap(const char * title, newtPool pool, int32_t usesize);
+static void		NewtPoolSnap(const char * title, newtPool pool, int64_t usesize);
 
 static void		NewtObjChain(newtObjRef * objp, newtObjRef obj);
 static void		NewtPoolChain(newtPool pool, newtObjRef obj, bool literal);
+static size_t	NewtObjUseSize(newtObjRef obj);
 static void		NewtObjFree(newtPool pool, newtObjRef obj);
 static void		NewtObjChainFree(newtPool pool, newtObjRef * objp);
+static bool		NewtGCFinalizerQueue(newtPool pool, newtCObject * objData);
+static void		NewtGCFinalize(newtPool pool);
 
 #if 0
 static void		NewtPoolMarkClean(newtPool pool);
 #endif
 
-static void		NewtPoolSweep(newtPool pool, bool mark);
-
-static void		NewtGCRefMark(newtRefArg r, bool mark);
-static void		NewtGCRegMark(vm_reg_t * reg, bool mark);
-static void		NewtGCStackMark(vm_env_t * env, bool mark);
-static void		NewtGCMark(vm_env_t * env, bool mark);
+static void		NewtPoolTenure(newtPool pool, newtObjRef obj);
+static void		NewtPoolArenaRelease(newtPool pool);
+static void		NewtPoolMarkClear(newtPool pool);
+static uint32_t	NewtPoolSweepArena(newtPool pool, newtMemArena * arena, uint32_t w);
+static void		NewtPoolSweepYoung(newtPool pool);
+static void		NewtPoolSweep(newtPool pool);
+static void		NewtPoolResize(newtPool pool);
+static bool		NewtPoolIsOverLimit(newtPool pool);
+static void		NewtPoolForget(newtPool pool);
+
+static bool		NewtGCObjIsMarked(newtObjRef obj);
+static bool		NewtGCObjSetMark(newtObjRef obj);
+static void		NewtGCMarkPush(newtPool pool, newtObjRef obj);
+static void		NewtGCObjShade(newtObjRef obj);
+static void		NewtGCRefMark(newtRefArg r);
+static void		NewtGCObjMark(newtObjRef obj);
+static void		NewtGCMarkDrain(newtPool pool);
+static void		NewtGCMarkOverflow(newtPool pool, newtObjRef objp);
+static void		NewtGCMarkOverflowArena(newtPool pool);
+static void		NewtGCMarkFinish(newtPool pool, bool minor);
+static void		NewtGCRememberedMark(newtPool pool);
+static void		NewtGCRegMark(vm_reg_t * reg);
+static void		NewtGCStackMark(vm_env_t * env);
+static void		NewtGCMark(vm_env_t * env);
+static void		NewtGCCollect(newtPool pool, bool minor);
+
+static void		NewtGCIncrementalStart(newtPool pool);
+static bool		NewtGCIncrementalMark(newtPool pool, clock_t deadline);
+static void		NewtGCIncrementalRemark(newtPool pool);
+static bool		NewtGCIncrementalSweep(newtPool pool, clock_t deadline);
+static void		NewtGCIncrementalStep(newtPool pool);
+static void		NewtGCIncrementalFinish(newtPool pool);
+static void		NewtGCLazySweep(newtPool pool);
+
+#ifdef NEWT_GC_PARALLEL
+static bool		NewtGCStackPush(newtGCStack * stack, newtObjRef obj);
+static void *	NewtGCWorkerMain(void * arg);
+static void		NewtGCWorkerRun(newtGCWorker * worker, uint32_t job);
+static void		NewtGCWorkerMark(newtGCWorker * worker);
+static void		NewtGCWorkerShare(newtGCWorker * worker);
+static bool		NewtGCWorkerTake(newtGCWorker * worker);
+static void		NewtGCWorkerSweep(newtGCWorker * worker);
+static void		NewtGCWorkerFree(newtGCWorker * worker, newtObjRef obj);
+static void		NewtGCWorkerMemFree(newtGCWorker * worker, void * ptr);
+static bool		NewtGCParallelStart(newtPool pool);
+static void		NewtGCParallelStop(void);
+static void		NewtGCParallelRun(uint32_t job);
+static void		NewtGCParallelMark(newtPool pool);
+static void		NewtGCParallelSweep(newtPool pool);
+#endif /* NEWT_GC_PARALLEL */
+
+
+/* ローカル変数 */
+
+/// マイナーGC 中か（若い世代のオブジェクトだけをマーク、スウィープする）
+static bool		newt_gc_minor = false;
+
+#ifdef NEWT_GC_PARALLEL
+
+/// 並列 GC の共有状態
+static newtGCParallel	newt_gc_par = {
+        .lock = PTHREAD_MUTEX_INITIALIZER,
+        .start = PTHREAD_COND_INITIALIZER,
+        .done = PTHREAD_COND_INITIALIZER,
+        .work = PTHREAD_COND_INITIALIZER,
+        .pool = NULL
+    };
+
+/// 実行中のスレッドのワーカー（GC の外や１スレッドの GC では NULL）
+static __thread newtGCWorker *	newt_gc_worker = NULL;
+
+#endif /* NEWT_GC_PARALLEL */
 
 
 #if 0
@@ -60,9 +212,9 @@ static void		NewtGCMark(vm_env_t * env, bool mark);
  * @return			なし
  */
 
-void NewtPoolSnap(const char * title, newtPool pool, int32_t usesize)
+void NewtPoolSnap(const char * title, newtPool pool, int64_t usesize)
 {
-    NewtDebugMsg(title, "mem = %d(%d)\n", pool->usesize, pool->usesize - usesize);
+    NewtDebugMsg(title, "mem = %lld(%lld)\n", (long long)pool->usesize, (long long)(pool->usesize - usesize));
 }
 
 
@@ -109,9 +261,59 @@ void NewtPoolChain(newtPool pool, newtObjRef obj, bool literal)
     if (obj != NULL && pool != NULL)
     {
         if (literal)
+        {
             NewtObjChain(&pool->literal, obj);
+        }
+        else if (0 < pool->nurseryspace || pool->gcphase == kNewtGCMark)
+        {
+            // 新しいオブジェクトは若い世代に置く
+            // （インクリメンタルGC のマーク中は最後にまとめてマークするため常に若い世代に置く）
+            obj->header.h |= kNewtObjYoung;
+            NewtObjChain(&pool->young, obj);
+        }
         else
-            NewtObjChain(&pool->obj, obj);
+        {
+            NewtPoolTenure(pool, obj);
+
+            // インクリメンタルGC のスウィープ中に確保したオブジェクトは解放しない
+            if (pool->gcphase == kNewtGCSweep)
+            {
+                if (NewtMemArenaOf(obj) != NULL)
+                    NewtGCObjSetMark(obj);	// まだスウィープしていない位置に置かれることがある
+                else if (pool->sweepp == &pool->obj)
+                    pool->sweepp = &obj->header.nextp;	// チェインの先頭はスウィープ済みにする
+            }
+        }
+    }
+}
+
+
+/*------------------------------------------------------------------------*/
+/** オブジェクトデータを古い世代に入れる
+ *
+ * @param pool		[in] メモリプール
+ * @param obj		[in] オブジェクトデータ
+ *
+ * @return			なし
+ *
+ * @note			アリーナのオブジェクトはビットマップに位置を記録するだけで
+ *					チェインしない。
+ */
+
+void NewtPoolTenure(newtPool pool, newtObjRef obj)
+{
+    newtMemArena *	arena;
+
+    arena = NewtMemArenaOf(obj);
+
+    if (arena != NULL)
+    {
+        NewtGCBitSet(arena->objbits, NewtMemArenaIndex(arena, obj));
+    }
+    else
+    {
+        obj->header.nextp = NULL;
+        NewtObjChain(&pool->obj, obj);
     }
 }
 
@@ -127,7 +329,17 @@ void NewtPoolChain(newtPool pool, newtObjRef obj, bool literal)
 
 void NewtCheckGC(newtPool pool, size_t size)
 {
-    if (pool->maxspace < pool->usesize + size)
+    if (0 < pool->nurseryspace)
+    {
+        // 若い世代が一杯になったか、古い世代が拡張サイズを超えた
+        // （スウィープ中の古い世代はまだゴミを含むので大きさを調べない）
+        if (pool->nurseryspace < pool->youngsize + size ||
+            (pool->gcphase != kNewtGCSweep && pool->maxspace < pool->usesize - pool->youngsize))
+        {
+            NEWT_NEEDGC = true;
+        }
+    }
+    else if (pool->maxspace < pool->usesize + size)
     {
         NEWT_NEEDGC = true;
     }
@@ -148,8 +360,38 @@ newtObjRef NewtObjChainAlloc(newtPool pool, size_t size, size_t dataSize)
 {
     newtObjRef	obj;
 
+    if (pool != NULL)
+    {
+        // GC で後回しにしたデストラクタを呼出す
+        if (0 < pool->finalnums)
+            NewtGCFinalize(pool);
+
+        // 遅延スウィープを少し進める
+        if (pool->gcphase == kNewtGCSweep && pool->sweepp == NULL)
+            NewtGCLazySweep(pool);
+    }
+
     NewtCheckGC(pool, size + dataSize);
 
+    if (0 < dataSize && NewtMemIsSmall(pool, size + dataSize))
+    {
+        // 小さなオブジェクトはヘッダとデータを同じブロックに置く
+        obj = (newtObjRef)NewtMemAlloc(pool, size + dataSize);
+        if (obj == NULL) return NULL;
+
+        memset(&obj->header, 0, sizeof(obj->header));
+        *((uint8_t **)(obj + 1)) = (uint8_t *)obj + size;
+
+        NewtPoolChain(pool, obj, false);
+        pool->usesize += size + dataSize;
+        pool->allocs++;
+
+        if (NewtObjIsYoung(obj))
+            pool->youngsize += size + dataSize;
+
+        return obj;
+    }
+
     obj = (newtObjRef)NewtMemAlloc(pool, size);
     if (obj == NULL) return NULL;
 
@@ -178,6 +420,10 @@ newtObjRef NewtObjChainAlloc(newtPool pool, size_t size, size_t dataSize)
     {
         NewtPoolChain(pool, obj, dataSize == 0);
         pool->usesize += size + dataSize;
+        pool->allocs++;
+
+        if (NewtObjIsYoung(obj))
+            pool->youngsize += size + dataSize;
     }
 
     return obj;
@@ -187,6 +433,23 @@ newtObjRef NewtObjChainAlloc(newtPool pool, size_t size, size_t dataSize)
 #if 0
 #pragma mark -
 #endif
+/*------------------------------------------------------------------------*/
+/** オブジェクトがメモリプールで使っているサイズを取得する
+ *
+ * @param obj		[in] オブジェクト
+ *
+ * @return			使用サイズ
+ */
+
+size_t NewtObjUseSize(newtObjRef obj)
+{
+    if (NewtObjIsLiteral(obj))
+        return NewtAlign(sizeof(newtObj) + NewtObjSize(obj), 4);
+    else
+        return sizeof(newtObj) + sizeof(uint8_t *) + NewtObjCalcDataSize(NewtObjSize(obj));
+}
+
+
 /*------------------------------------------------------------------------*/
 /** オブジェクトを解放する
  *
@@ -200,22 +463,22 @@ void NewtObjFree(newtPool pool, newtObjRef obj)
 {
     size_t	datasize;
 
-    if (NewtObjIsLiteral(obj))
-    {
-        datasize = NewtAlign(sizeof(newtObj) + NewtObjSize(obj), 4);
-    }
-    else
-    {
-        datasize = sizeof(newtObj) + sizeof(uint8_t *);
-        datasize += NewtObjCalcDataSize(NewtObjSize(obj));
+    if ((obj->header.h & kNewtObjMapIndexed) != 0)
+        NewtMapIndexForget(obj);
 
+    datasize = NewtObjUseSize(obj);
+
+    if (! NewtObjIsLiteral(obj))
+    {
         if (NewtObjIsIndirectBinary(obj)) {
             newtCObject* objData;
             objData = (newtCObject*) NewtObjData(obj);
-            if (objData->dtor)
+            if (objData->dtor && ! NewtGCFinalizerQueue(pool, objData))
                 objData->dtor(objData->cObj);
         }
-        NewtMemFree(NewtObjData(obj));
+
+        if (NewtObjData(obj) != NewtObjInlineData(obj))
+            NewtMemFree(NewtObjData(obj));
     }
 
     NewtMemFree(obj);
@@ -225,6 +488,67 @@ void NewtObjFree(newtPool pool, newtObjRef obj)
 }
 
 
+/*------------------------------------------------------------------------*/
+/** CObject のデストラクタをファイナライザ・キューに入れる
+ *
+ * @param pool		[in] メモリプール
+ * @param objData	[in] CObject のデータ
+ *
+ * @retval			true	キューに入れた
+ * @retval			false	キューに入れられなかった（すぐに呼出すこと）
+ *
+ * @note			CObject のデータはオブジェクトと一緒に解放されるのでコピーしておく。
+ *					キューは NewtGCFinalize で GC の外から空にする。
+ */
+
+bool NewtGCFinalizerQueue(newtPool pool, newtCObject * objData)
+{
+    if (pool == NULL)
+        return false;
+
+    if (pool->finalsize <= pool->finalnums)
+    {
+        newtCObject *	newp;
+        uint32_t		newsize;
+
+        newsize = pool->finalsize + NEWT_NUM_FINALIZERS;
+        newp = (newtCObject *)NewtMemRealloc(NULL, pool->finalizers, sizeof(newtCObject) * newsize);
+        if (newp == NULL) return false;
+
+        pool->finalizers = newp;
+        pool->finalsize = newsize;
+    }
+
+    pool->finalizers[pool->finalnums++] = *objData;
+
+    return true;
+}
+
+
+/*------------------------------------------------------------------------*/
+/** ファイナライザ・キューのデストラクタを全て呼出す
+ *
+ * @param pool		[in] メモリプール
+ *
+ * @return			なし
+ *
+ * @note			GC の停止時間に含めないように、GC の後の最初のオブジェクト確保で呼ばれる。
+ *					デストラクタの中でオブジェクトを確保してもよいように
+ *					先にキューから取出してから呼出す。
+ */
+
+void NewtGCFinalize(newtPool pool)
+{
+    newtCObject	objData;
+
+    while (0 < pool->finalnums)
+    {
+        objData = pool->finalizers[--pool->finalnums];
+        objData.dtor(objData.cObj);
+    }
+}
+
+
 /*------------------------------------------------------------------------*/
 /** オブジェクトデータにチェインされている全てのオブジェクトデータを解放する
  *
@@ -261,12 +585,23 @@ void NewtPoolRelease(newtPool pool)
 {
     if (pool != NULL)
     {
-        int32_t		usesize;
+        int64_t		usesize;
 
         usesize = pool->usesize;
 
+        NewtObjChainFree(pool, &pool->young);
         NewtObjChainFree(pool, &pool->obj);
+        NewtPoolArenaRelease(pool);
         NewtObjChainFree(pool, &pool->literal);
+        NewtGCFinalize(pool);
+
+        pool->youngsize = 0;
+        pool->remnums = 0;
+        pool->gcphase = kNewtGCIdle;
+
+#ifdef NEWT_GC_PARALLEL
+        NewtGCParallelStop();
+#endif
 
         if (NEWT_DEBUG)
             NewtPoolSnap("RELEASE", pool, usesize);
@@ -294,7 +629,7 @@ void NewtPoolMarkClean(newtPool pool)
         newtObjRef	nextp;
         newtObjRef	obj;
         newtObjRef *	prevp = &pool->obj;
-        int32_t		usesize;
+        int64_t		usesize;
 
         usesize = pool->usesize;
 
@@ -319,223 +654,1792 @@ void NewtPoolMarkClean(newtPool pool)
 #endif
 
 /*------------------------------------------------------------------------*/
-/** メモリプール内のオブジェクトをスウィープ（掃除）する
+/** アリーナの古い世代のオブジェクトを全て解放する
  *
  * @param pool		[in] メモリプール
- * @param mark		[in] マークフラグ
  *
  * @return			なし
  */
 
-void NewtPoolSweep(newtPool pool, bool mark)
+void NewtPoolArenaRelease(newtPool pool)
 {
-    if (pool != NULL)
-    {
-        newtObjRef	nextp;
-        newtObjRef	obj;
-        newtObjRef *	prevp = &pool->obj;
-        int32_t		usesize;
-
-        usesize = pool->usesize;
+    newtMemArena *	arena;
+    uint32_t	bits;
+    uint32_t	w;
+    uint32_t	b;
 
-        for (obj = pool->obj; obj != NULL; obj = nextp)
+    for (arena = pool->arenas; arena != NULL; arena = arena->next)
+    {
+        for (w = 0; w < NEWT_MEM_ARENAWORDS; w++)
         {
-            nextp = obj->header.nextp;
-
-            if (NewtObjIsLiteral(obj))
-            {
-                NewtObjChain(&pool->literal, obj);
-                *prevp = nextp;
-
-                continue;
-            }
-
-            if (NewtObjIsSweep(obj, mark))
+            for (bits = arena->objbits[w], b = 0; bits != 0; bits >>= 1, b++)
             {
-                *prevp = nextp;
-                NewtObjFree(pool, obj);
-
-                continue;
+                if ((bits & 1) != 0)
+                    NewtObjFree(pool, (newtObjRef)NewtMemArenaBlock(arena, w * 32 + b));
             }
-
-            prevp = &obj->header.nextp;
         }
 
-        if (NEWT_DEBUG)
-            NewtPoolSnap("GC", pool, usesize);
-    }
-
-    if (pool->maxspace < pool->usesize)
-    {
-        pool->maxspace = ((pool->usesize + pool->expandspace - 1) / pool->expandspace)
-                            * pool->expandspace;
+        memset(arena->objbits, 0, sizeof(arena->objbits));
+        memset(arena->markbits, 0, sizeof(arena->markbits));
     }
 }
 
 
 /*------------------------------------------------------------------------*/
-/** オブジェクトをマークする
+/** アリーナのマークを全て外す
  *
- * @param r			[in] オブジェクト
- * @param mark		[in] マークフラグ
+ * @param pool		[in] メモリプール
  *
  * @return			なし
+ *
+ * @note			全体の GC のマークを始める前に呼出す。
+ *					書込むのはビットマップだけなのでオブジェクトのページは汚さない。
  */
 
-void NewtGCRefMark(newtRefArg r, bool mark)
+void NewtPoolMarkClear(newtPool pool)
 {
-    if (NewtRefIsPointer(r))
-    {
-        newtObjRef	obj;
-    
-        obj = NewtRefToPointer(r);
-    
-        if (! NewtObjIsLiteral(obj) && NewtObjIsSweep(obj, mark))
-        {
-            if (mark)
-                obj->header.h &= ~ (uint32_t)kNewtObjSweep;
-            else
-                obj->header.h |= kNewtObjSweep;
+    newtMemArena *	arena;
 
-            if (NewtObjIsSlotted(obj))
-            {
-                newtRef *	slots;
-                size_t	  	len;
-                size_t    	i;
-    
-                len = NewtObjSlotsLength(obj);
-                slots = NewtObjToSlots(obj);
-    
-                for (i = 0; i < len; i++)
-                {
-                    NewtGCRefMark(slots[i], mark);
-                }
-                if (NewtObjIsFrame(obj))
-                    NewtGCRefMark(obj->as.map, mark);
-            } else if (NewtObjIsIndirectBinary(obj)) {
-                newtCObject* objData;
-                objData = (newtCObject*) NewtObjData(obj);
-                if (objData->marker)
-                    objData->marker(objData->cObj);
-            }
-        }
+    for (arena = pool->arenas; arena != NULL; arena = arena->next)
+    {
+        memset(arena->markbits, 0, sizeof(arena->markbits));
     }
 }
 
 
 /*------------------------------------------------------------------------*/
-/** レジスタ内のオブジェクトをマークする
+/** アリーナのビットマップの１ワード分のオブジェクトをスウィープ（掃除）する
  *
- * @param reg		[in] レジスタ
- * @param mark		[in] マークフラグ
+ * @param pool		[in] メモリプール
+ * @param arena		[in] アリーナ
+ * @param w			[in] ビットマップのワードの位置
  *
- * @return			なし
+ * @return			解放したオブジェクトの数
+ *
+ * @note			古い世代でマークされていない位置のオブジェクトだけを読む。
+ *					生き残ったオブジェクトのヘッダには触れない。
  */
 
-void NewtGCRegMark(vm_reg_t * reg, bool mark)
+uint32_t NewtPoolSweepArena(newtPool pool, newtMemArena * arena, uint32_t w)
 {
-    NewtGCRefMark(reg->func, mark);
-    NewtGCRefMark(reg->locals, mark);
-    NewtGCRefMark(reg->rcvr, mark);
-    NewtGCRefMark(reg->impl, mark);
+    newtObjRef *	literalp = &pool->literal;
+    newtObjRef	obj;
+    uint32_t	garbage;
+    uint32_t	b;
+    uint32_t	n = 0;
+
+    garbage = arena->objbits[w] & ~ arena->markbits[w];
+
+    if (garbage == 0)
+        return 0;
+
+#ifdef NEWT_GC_PARALLEL
+    if (newt_gc_worker != NULL)
+        literalp = &newt_gc_worker->literal;
+#endif
+
+    for (b = 0; garbage != 0; garbage >>= 1, b++)
+    {
+        if ((garbage & 1) == 0)
+            continue;
+
+        obj = (newtObjRef)NewtMemArenaBlock(arena, w * 32 + b);
+
+        if (NewtObjIsLiteral(obj))
+        {
+            obj->header.nextp = NULL;
+            NewtObjChain(literalp, obj);
+            continue;
+        }
+
+#ifdef NEWT_GC_PARALLEL
+        if (newt_gc_worker != NULL)
+            NewtGCWorkerFree(newt_gc_worker, obj);
+        else
+#endif
+        NewtObjFree(pool, obj);
+
+        n++;
+    }
+
+    arena->objbits[w] &= arena->markbits[w];
+
+    return n;
 }
 
 
 /*------------------------------------------------------------------------*/
-/** スタック内のオブジェクトをマークする
+/** メモリプール内の若い世代のオブジェクトをスウィープ（掃除）する
  *
- * @param env		[in] 実行環境
- * @param mark		[in] マークフラグ
+ * @param pool		[in] メモリプール
  *
  * @return			なし
+ *
+ * @note			生き残ったオブジェクトは古い世代に昇格させる。
+ *					マイナーGC では malloc で確保したオブジェクトのマークを外す
+ *					（全体の GC では古い世代と一緒にスウィープする時に外す）。
  */
 
-void NewtGCStackMark(vm_env_t * env, bool mark)
+void NewtPoolSweepYoung(newtPool pool)
 {
-    newtRef *	stack;
-    vm_reg_t *	callstack;
-    uint32_t	i;
-
-    // スタック
-    stack = (newtRef *)env->stack.stackp;
-
-    for (i = 0; i < env->reg.sp; i++)
-    {
-        NewtGCRefMark(stack[i], mark);
-    }
-
-    // 関数呼出しスタック
-    callstack = (vm_reg_t *)env->callstack.stackp;
-
-    for (i = 0; i < env->callstack.sp; i++)
-    {
-        NewtGCRegMark(&callstack[i], mark);
-    }
-
-    // 例外ハンドラ・スタック
-    NewtGCRefMark(env->currexcp, mark);
+    newtObjRef	nextp;
+    newtObjRef	obj;
 
+    for (obj = pool->young; obj != NULL; obj = nextp)
     {
-        vm_excp_t *	excpstack;
-        vm_excp_t *	excp;
+        nextp = obj->header.nextp;
+        obj->header.nextp = NULL;
+        obj->header.h &= ~ (uint32_t)kNewtObjYoung;
 
-        excpstack = (vm_excp_t *)env->excpstack.stackp;
+        if (NewtObjIsLiteral(obj))
+        {
+            NewtObjChain(&pool->literal, obj);
+            continue;
+        }
 
-        for (i = 0; i < env->excpstack.sp; i++)
+        if (! NewtGCObjIsMarked(obj))
         {
-            excp = &excpstack[i];
-            NewtGCRefMark(excp->sym, mark);
+            NewtObjFree(pool, obj);
+            continue;
         }
+
+        if (newt_gc_minor && NewtMemArenaOf(obj) == NULL)
+            obj->header.h &= ~ (uint32_t)kNewtObjMark;
+
+        NewtPoolTenure(pool, obj);
     }
+
+    pool->young = NULL;
+    pool->youngsize = 0;
 }
 
 
 /*------------------------------------------------------------------------*/
-/** 参照されているオブジェクトをマークする
+/** 記憶集合を空にする
  *
- * @param env		[in] 実行環境
- * @param mark		[in] マークフラグ
+ * @param pool		[in] メモリプール
  *
  * @return			なし
+ *
+ * @note			若い世代が全て昇格した後に呼出すこと
  */
 
-void NewtGCMark(vm_env_t * env, bool mark)
+void NewtPoolForget(newtPool pool)
 {
-    NewtGCRefMark(NcGetRoot(), mark);
-//    NewtGCRefMark(NSGetGlobals(), mark);
-//    NewtGCRefMark(NSGetGlobalFns(), mark);
-//    NewtGCRefMark(NSGetMagicPointers(), mark);
+    uint32_t	i;
 
-    // レジスタ
-    NewtGCRegMark(&env->reg, mark);
+    for (i = 0; i < pool->remnums; i++)
+    {
+        pool->remembered[i]->header.h &= ~ (uint32_t)kNewtObjRemembered;
+    }
 
-    // スタック
-    NewtGCStackMark(env, mark);
+    pool->remnums = 0;
 }
 
 
 /*------------------------------------------------------------------------*/
-/** ガベージコレクションの実行
+/** メモリプール内のオブジェクトをスウィープ（掃除）する
+ *
+ * @param pool		[in] メモリプール
  *
  * @return			なし
+ *
+ * @note			アリーナのオブジェクトはチェインをたどらずにビットマップで探す。
+ *					遅延スウィープでは malloc で確保したオブジェクトだけをスウィープして
+ *					アリーナのスウィープはオブジェクトの確保時に行う。
  */
 
-void NewtGC(void)
+void NewtPoolSweep(newtPool pool)
+{
+    if (pool != NULL)
+    {
+        newtMemArena *	arena;
+        newtObjRef	nextp;
+        newtObjRef	obj;
+        newtObjRef *	prevp = &pool->obj;
+        int64_t		usesize;
+        uint32_t	w;
+
+        usesize = pool->usesize;
+
+        for (obj = pool->obj; obj != NULL; obj = nextp)
+        {
+            nextp = obj->header.nextp;
+
+            if (NewtObjIsLiteral(obj))
+            {
+                NewtObjChain(&pool->literal, obj);
+                *prevp = nextp;
+
+                continue;
+            }
+
+            if (! NewtGCObjIsMarked(obj))
+            {
+                *prevp = nextp;
+                NewtObjFree(pool, obj);
+
+                continue;
+            }
+
+            obj->header.h &= ~ (uint32_t)kNewtObjMark;
+            prevp = &obj->header.nextp;
+        }
+
+        if (pool->lazysweep && 0 < pool->nurseryspace && ! pool->fullgc)
+        {
+            // アリーナはオブジェクトの確保時に少しずつスウィープする（NewtGCLazySweep）
+            pool->gcphase = kNewtGCSweep;
+            pool->sweepp = NULL;
+            pool->sweeparena = pool->arenas;
+            pool->sweepword = 0;
+
+            return;
+        }
+
+#ifdef NEWT_GC_PARALLEL
+        if (NewtGCParallelStart(pool))
+            NewtGCParallelSweep(pool);
+        else
+#endif
+        for (arena = pool->arenas; arena != NULL; arena = arena->next)
+        {
+            for (w = 0; w < NEWT_MEM_ARENAWORDS; w++)
+            {
+                NewtPoolSweepArena(pool, arena, w);
+            }
+        }
+
+        if (NEWT_DEBUG)
+            NewtPoolSnap("GC", pool, usesize);
+
+        NewtPoolResize(pool);
+    }
+}
+
+
+/*------------------------------------------------------------------------*/
+/** 全体の GC の後で次の全体の GC までの最大サイズを決める
+ *
+ * @param pool		[in] メモリプール
+ *
+ * @return			なし
+ *
+ * @note			生きているオブジェクトが最大サイズの NEWT_POOL_LIVERATIO ％に
+ *					なるようにするので、ヒープが大きくなっても全体の GC の回数は
+ *					確保したサイズに比例する。小さなヒープでも拡張サイズ以上の空きを作り、
+ *					初期の最大サイズより小さくせず、上限があれば上限で止める。
+ *					上限を超えた例外の後は例外ハンドラが動けるように上限で止めない。
+ */
+
+void NewtPoolResize(newtPool pool)
+{
+    int64_t	maxspace;
+
+    maxspace = pool->usesize / NEWT_POOL_LIVERATIO * 100;
+
+    if (maxspace < pool->usesize + pool->expandspace)
+        maxspace = pool->usesize + pool->expandspace;
+
+    if (maxspace < pool->initspace)
+        maxspace = pool->initspace;
+
+    if (0 < pool->limitspace && ! pool->overlimit && pool->limitspace < maxspace)
+        maxspace = pool->limitspace;
+
+    pool->maxspace = maxspace;
+}
+
+
+/*------------------------------------------------------------------------*/
+/** 使用サイズが上限を超えているか調べる
+ *
+ * @param pool		[in] メモリプール
+ *
+ * @retval			true	上限を超えている
+ * @retval			false	上限を超えていない（上限がない）
+ */
+
+bool NewtPoolIsOverLimit(newtPool pool)
+{
+    return (0 < pool->limitspace && pool->limitspace < pool->usesize);
+}
+
+
+/*------------------------------------------------------------------------*/
+/** オブジェクトデータがマークされているか調べる
+ *
+ * @param obj		[in] オブジェクトデータ
+ *
+ * @retval			true	マークされている
+ * @retval			false	マークされていない
+ *
+ * @note			アリーナのオブジェクトはビットマップ、malloc で確保した
+ *					オブジェクトはヘッダの kNewtObjMark を調べる。
+ */
+
+bool NewtGCObjIsMarked(newtObjRef obj)
+{
+    newtMemArena *	arena;
+
+    arena = NewtMemArenaOf(obj);
+
+    if (arena != NULL)
+        return NewtGCBitTest(arena->markbits, NewtMemArenaIndex(arena, obj));
+    else
+        return ((obj->header.h & kNewtObjMark) != 0);
+}
+
+
+/*------------------------------------------------------------------------*/
+/** オブジェクトデータにマークを付ける
+ *
+ * @param obj		[in] オブジェクトデータ
+ *
+ * @retval			true	新しくマークを付けた
+ * @retval			false	既にマークされていた
+ *
+ * @note			複数のスレッドでマークする時は不可分操作で付けるので
+ *					同じオブジェクトを２つのスレッドがたどることはない。
+ */
+
+bool NewtGCObjSetMark(newtObjRef obj)
+{
+    newtMemArena *	arena;
+
+    arena = NewtMemArenaOf(obj);
+
+    if (arena != NULL)
+    {
+        uint32_t	i;
+
+        i = NewtMemArenaIndex(arena, obj);
+
+#ifdef NEWT_GC_PARALLEL
+        if (newt_gc_worker != NULL)
+        {
+            uint32_t	bit = 1U << (i & 31);
+
+            if ((__atomic_load_n(&arena->markbits[i >> 5], __ATOMIC_RELAXED) & bit) != 0)
+                return false;
+
+            return ((__sync_fetch_and_or(&arena->markbits[i >> 5], bit) & bit) == 0);
+        }
+#endif
+
+        if (NewtGCBitTest(arena->markbits, i))
+            return false;
+
+        NewtGCBitSet(arena->markbits, i);
+    }
+    else
+    {
+#ifdef NEWT_GC_PARALLEL
+        if (newt_gc_worker != NULL)
+        {
+            if ((__atomic_load_n(&obj->header.h, __ATOMIC_RELAXED) & kNewtObjMark) != 0)
+                return false;
+
+            return ((__sync_fetch_and_or(&obj->header.h, (size_t)kNewtObjMark) & kNewtObjMark) == 0);
+        }
+#endif
+
+        if ((obj->header.h & kNewtObjMark) != 0)
+            return false;
+
+        obj->header.h |= kNewtObjMark;
+    }
+
+    return true;
+}
+
+
+/*------------------------------------------------------------------------*/
+/** マークスタックにオブジェクトを積む
+ *
+ * @param pool		[in] メモリプール
+ * @param obj		[in] マーク済みのオブジェクトデータ
+ *
+ * @return			なし
+ *
+ * @note			スタックを拡張できない場合はあふれたことだけを記録する。
+ *					積めなかったオブジェクトは NewtGCMarkOverflow で拾い直す。
+ */
+
+void NewtGCMarkPush(newtPool pool, newtObjRef obj)
+{
+    if (pool->marksize <= pool->marknums)
+    {
+        newtObjRef *	newp = NULL;
+        uint32_t		newsize;
+
+        newsize = pool->marksize + NEWT_NUM_MARKSTACK;
+
+        if (newsize <= NEWT_NUM_MARKSTACK_MAX)
+            newp = (newtObjRef *)NewtMemRealloc(NULL, pool->markstack, sizeof(newtObjRef) * newsize);
+
+        if (newp == NULL)
+        {
+            pool->markoverflow = true;
+            return;
+        }
+
+        pool->markstack = newp;
+        pool->marksize = newsize;
+    }
+
+    pool->markstack[pool->marknums++] = obj;
+}
+
+
+/*------------------------------------------------------------------------*/
+/** オブジェクトデータにマークを付けてマークスタックに積む
+ *
+ * @param obj		[in] オブジェクトデータ
+ *
+ * @return			なし
+ *
+ * @note			参照先は NewtGCMarkDrain でたどる。
+ *					ワーカーで実行中はワーカーのマークスタックに積む。
+ */
+
+void NewtGCObjShade(newtObjRef obj)
+{
+    if (! NewtObjIsLiteral(obj) && (! newt_gc_minor || NewtObjIsYoung(obj)) &&
+        NewtGCObjSetMark(obj))
+    {
+#ifdef NEWT_GC_PARALLEL
+        if (newt_gc_worker != NULL)
+        {
+            if (! NewtGCStackPush(&newt_gc_worker->mark, obj))
+                newt_gc_worker->markoverflow = true;
+
+            return;
+        }
+#endif
+
+        NewtGCMarkPush(NEWT_POOL, obj);
+    }
+}
+
+
+/*------------------------------------------------------------------------*/
+/** オブジェクトをマークする
+ *
+ * @param r			[in] オブジェクト
+ *
+ * @return			なし
+ */
+
+void NewtGCRefMark(newtRefArg r)
+{
+    if (NewtRefIsPointer(r))
+    {
+        newtObjRef	obj;
+    
+        obj = NewtRefToPointer(r);
+        NewtGCObjShade(obj);
+    }
+}
+
+
+/*------------------------------------------------------------------------*/
+/** オブジェクトデータから参照されているオブジェクトをマークする
+ *
+ * @param obj		[in] オブジェクトデータ
+ *
+ * @return			なし
+ *
+ * @note			数スロット先の参照先を先読みしてキャッシュミスを隠す。
+ *					CObject のマーカー関数はワーカーからは呼ばずに
+ *					GC を呼出したスレッドで後から呼ぶ（NewtGCParallelMark）。
+ */
+
+void NewtGCObjMark(newtObjRef obj)
+{
+    if (NewtObjIsSlotted(obj))
+    {
+        newtRef *	slots;
+        size_t	  	len;
+        size_t    	i;
+
+        len = NewtObjSlotsLength(obj);
+        slots = NewtObjToSlots(obj);
+
+        for (i = 0; i < len; i++)
+        {
+            if (i + NEWT_GC_PREFETCH < len && NewtRefIsPointer(slots[i + NEWT_GC_PREFETCH]))
+                NewtGCPrefetch((void *)((uintptr_t)slots[i + NEWT_GC_PREFETCH] - 1));
+
+            NewtGCRefMark(slots[i]);
+        }
+        if (NewtObjIsFrame(obj))
+            NewtGCRefMark(obj->as.map);
+    } else if (NewtObjIsIndirectBinary(obj)) {
+        newtCObject* objData;
+        objData = (newtCObject*) NewtObjData(obj);
+        if (objData->marker)
+        {
+#ifdef NEWT_GC_PARALLEL
+            if (newt_gc_worker != NULL)
+            {
+                if (! NewtGCStackPush(&newt_gc_worker->cobjs, obj))
+                    newt_gc_worker->markoverflow = true;
+
+                return;
+            }
+#endif
+
+            objData->marker(objData->cObj);
+        }
+    }
+}
+
+
+/*------------------------------------------------------------------------*/
+/** マークスタックが空になるまで参照先をたどる
+ *
+ * @param pool		[in] メモリプール
+ *
+ * @return			なし
+ */
+
+void NewtGCMarkDrain(newtPool pool)
+{
+    while (0 < pool->marknums)
+    {
+        NewtGCObjMark(pool->markstack[--pool->marknums]);
+    }
+}
+
+
+/*------------------------------------------------------------------------*/
+/** マークスタックからあふれたオブジェクトの参照先をたどり直す
+ *
+ * @param pool		[in] メモリプール
+ * @param objp		[in] オブジェクトチェイン
+ *
+ * @return			なし
+ *
+ * @note			チェイン上のマーク済みオブジェクトを全て走査し直す。
+ *					余分なメモリを使わない代わりにチェインの長さに比例して遅い。
+ */
+
+void NewtGCMarkOverflow(newtPool pool, newtObjRef objp)
+{
+    newtObjRef	obj;
+
+    for (obj = objp; obj != NULL; obj = obj->header.nextp)
+    {
+        if (NewtGCObjIsMarked(obj))
+        {
+            NewtGCObjMark(obj);
+            NewtGCMarkDrain(pool);
+        }
+    }
+}
+
+
+/*------------------------------------------------------------------------*/
+/** マークスタックからあふれたアリーナのオブジェクトの参照先をたどり直す
+ *
+ * @param pool		[in] メモリプール
+ *
+ * @return			なし
+ *
+ * @note			古い世代のマーク済みオブジェクトをビットマップで探して走査し直す。
+ */
+
+void NewtGCMarkOverflowArena(newtPool pool)
+{
+    newtMemArena *	arena;
+    uint32_t	bits;
+    uint32_t	w;
+    uint32_t	b;
+
+    for (arena = pool->arenas; arena != NULL; arena = arena->next)
+    {
+        for (w = 0; w < NEWT_MEM_ARENAWORDS; w++)
+        {
+            for (bits = arena->objbits[w] & arena->markbits[w], b = 0; bits != 0; bits >>= 1, b++)
+            {
+                if ((bits & 1) != 0)
+                {
+                    NewtGCObjMark((newtObjRef)NewtMemArenaBlock(arena, w * 32 + b));
+                    NewtGCMarkDrain(pool);
+                }
+            }
+        }
+    }
+}
+
+
+/*------------------------------------------------------------------------*/
+/** マークスタックを空にしてマークを完了する
+ *
+ * @param pool		[in] メモリプール
+ * @param minor		[in] 若い世代だけをマークしている（マイナーGC）
+ *
+ * @return			なし
+ */
+
+void NewtGCMarkFinish(newtPool pool, bool minor)
+{
+    NewtGCMarkDrain(pool);
+
+    while (pool->markoverflow)
+    {
+        pool->markoverflow = false;
+        NewtGCMarkOverflow(pool, pool->young);
+
+        if (! minor)
+        {
+            NewtGCMarkOverflow(pool, pool->obj);
+            NewtGCMarkOverflowArena(pool);
+        }
+    }
+}
+
+
+/*------------------------------------------------------------------------*/
+/** 記憶集合のオブジェクトから参照されている若い世代をマークする
+ *
+ * @param pool		[in] メモリプール
+ *
+ * @return			なし
+ */
+
+void NewtGCRememberedMark(newtPool pool)
+{
+    uint32_t	i;
+
+    for (i = 0; i < pool->remnums; i++)
+    {
+        NewtGCObjMark(pool->remembered[i]);
+    }
+}
+
+
+/*------------------------------------------------------------------------*/
+/** レジスタ内のオブジェクトをマークする
+ *
+ * @param reg		[in] レジスタ
+ *
+ * @return			なし
+ */
+
+void NewtGCRegMark(vm_reg_t * reg)
+{
+    NewtGCRefMark(reg->func);
+    NewtGCRefMark(reg->locals);
+    NewtGCRefMark(reg->rcvr);
+    NewtGCRefMark(reg->impl);
+}
+
+
+/*------------------------------------------------------------------------*/
+/** スタック内のオブジェクトをマークする
+ *
+ * @param env		[in] 実行環境
+ *
+ * @return			なし
+ */
+
+void NewtGCStackMark(vm_env_t * env)
+{
+    newtRef *	stack;
+    vm_reg_t *	callstack;
+    uint32_t	i;
+
+    // スタック
+    stack = (newtRef *)env->stack.stackp;
+
+    for (i = 0; i < env->reg.sp; i++)
+    {
+        NewtGCRefMark(stack[i]);
+    }
+
+    // 関数呼出しスタック
+    callstack = (vm_reg_t *)env->callstack.stackp;
+
+    for (i = 0; i < env->callstack.sp; i++)
+    {
+        NewtGCRegMark(&callstack[i]);
+    }
+
+    // 例外ハンドラ・スタック
+    NewtGCRefMark(env->currexcp);
+
+    {
+        vm_excp_t *	excpstack;
+        vm_excp_t *	excp;
+
+        excpstack = (vm_excp_t *)env->excpstack.stackp;
+
+        for (i = 0; i < env->excpstack.sp; i++)
+        {
+            excp = &excpstack[i];
+            NewtGCRefMark(excp->sym);
+        }
+    }
+}
+
+
+/*------------------------------------------------------------------------*/
+/** 参照されているオブジェクトをマークする
+ *
+ * @param env		[in] 実行環境
+ *
+ * @return			なし
+ */
+
+void NewtGCMark(vm_env_t * env)
+{
+    NewtGCRefMark(NcGetRoot());
+//    NewtGCRefMark(NSGetGlobals(), mark);
+//    NewtGCRefMark(NSGetGlobalFns(), mark);
+//    NewtGCRefMark(NSGetMagicPointers(), mark);
+
+    // レジスタ
+    NewtGCRegMark(&env->reg);
+
+    // スタック
+    NewtGCStackMark(env);
+}
+
+
+/*------------------------------------------------------------------------*/
+/** ガベージコレクションの実行
+ *
+ * @return			なし
+ *
+ * @note			全体の GC の後でも使用サイズが上限を超えていれば
+ *					kNErrOutOfObjectMemory 例外を発生する。
+ *					例外は GC の後で上限を下回るまで一度しか発生しない。
+ */
+
+void NewtGC(void)
 {
 //    NewtPoolMarkClean(NEWT_POOL);
+	newtPool	pool = NEWT_POOL;
+
+	if (pool->gcphase != kNewtGCIdle)
+	{
+		if (0 < pool->gcbudget && ! pool->fullgc && ! NewtPoolIsOverLimit(pool))
+		{
+			NewtGCIncrementalStep(pool);
+			return;
+		}
+
+		if (pool->gcphase == kNewtGCSweep && pool->sweepp == NULL &&
+			0 < pool->nurseryspace && ! pool->fullgc && ! NewtPoolIsOverLimit(pool))
+		{
+			// アリーナのスウィープ中でも若い世代は回収できる
+			// （生き残ったオブジェクトにはマークが付くので解放されない）
+			NewtGCCollect(pool, true);
+			NEWT_NEEDGC = false;
+			return;
+		}
+
+		// 途中のインクリメンタルGC を終わらせてから全体を GC する
+		NewtGCIncrementalFinish(pool);
+	}
+
+	if (0 < pool->nurseryspace && ! pool->fullgc)
+	{
+		// 若い世代だけを回収する
+		NewtGCCollect(pool, true);
+
+		// 昇格したオブジェクトで古い世代が拡張サイズを超えなければ終了
+		if (pool->usesize <= pool->maxspace)
+		{
+			NEWT_NEEDGC = false;
+			return;
+		}
+	}
+
+	if (0 < pool->gcbudget && ! pool->fullgc && ! NewtPoolIsOverLimit(pool))
+	{
+		// 古い世代は少しずつ回収する
+		NewtGCIncrementalStart(pool);
+		return;
+	}
+
+	NewtGCCollect(pool, false);
+
+    NEWT_NEEDGC = false;
+    pool->fullgc = false;
+
+	if (NewtPoolIsOverLimit(pool))
+	{
+		// 遅延スウィープを終わらせても上限を超えていれば例外を発生する
+		NewtGCIncrementalFinish(pool);
+
+		if (NewtPoolIsOverLimit(pool) && ! pool->overlimit)
+		{
+			// 例外ハンドラがデータを解放できるように上限を下回るまでは再び発生しない
+			pool->overlimit = true;
+			NVMThrowAsync(kNErrOutOfObjectMemory, NewtMakeInteger(pool->limitspace));
+		}
+	}
+
+	if (! NewtPoolIsOverLimit(pool))
+		pool->overlimit = false;
+}
+
+
+/*------------------------------------------------------------------------*/
+/** マークとスウィープを行う
+ *
+ * @param pool		[in] メモリプール
+ * @param minor		[in] 若い世代だけを回収する（マイナーGC）
+ *
+ * @return			なし
+ *
+ * @note			マイナーGC ではルートと記憶集合から若い世代だけをたどる。
+ *					生き残った若い世代は全て古い世代に昇格させるので
+ *					GC 後の記憶集合は空になる。
+ *					全体の GC ではアリーナのマークを外してからマークする。
+ *					pool->gcthreads が 2 以上でヒープが大きければ
+ *					全体の GC のマークとアリーナのスウィープを複数のスレッドで行う。
+ */
+
+void NewtGCCollect(newtPool pool, bool minor)
+{
 	vm_env_t *	env;
 
-	for (env = &vm_env; env; env = env->next)
-	{
-		NewtGCMark(&vm_env, NEWT_SWEEP);
-	}
+	newt_gc_minor = minor;
+
+	if (! minor)
+		NewtPoolMarkClear(pool);
+
+	for (env = &vm_env; env; env = env->next)
+	{
+		NewtGCMark(&vm_env);
+	}
+
+	if (minor)
+		NewtGCRememberedMark(pool);
+#ifdef NEWT_GC_PARALLEL
+	else if (NewtGCParallelStart(pool))
+		NewtGCParallelMark(pool);
+#endif
+
+	NewtGCMarkFinish(pool, minor);
+
+	NVMSweepCodeCache();
+	NewtPoolSweepYoung(pool);
+
+	// 記憶集合の古いオブジェクトはスウィープで解放されることがあるので先に空にする
+	NewtPoolForget(pool);
+
+	if (! minor)
+		NewtPoolSweep(pool);
+	else if (NEWT_DEBUG)
+		NewtPoolSnap("MINOR GC", pool, pool->usesize);
+
+	newt_gc_minor = false;
+}
+
+
+/*------------------------------------------------------------------------*/
+/** インクリメンタルGC を開始する
+ *
+ * @param pool		[in] メモリプール
+ *
+ * @return			なし
+ *
+ * @note			ルートだけをマークして、残りは NewtGCIncrementalStep で進める。
+ *					GC が終わるまで NEWT_NEEDGC は立てたままにする。
+ */
+
+void NewtGCIncrementalStart(newtPool pool)
+{
+	pool->gcphase = kNewtGCMark;
+	pool->gccountdown = NEWT_GC_SLICEINTERVAL;
+
+	NewtPoolMarkClear(pool);
+
+	NewtGCMark(&vm_env);
+}
+
+
+/*------------------------------------------------------------------------*/
+/** インクリメンタルGC のマークを進める
+ *
+ * @param pool		[in] メモリプール
+ * @param deadline	[in] 中断する時刻（0 なら中断しない）
+ *
+ * @retval			true	マークスタックが空になった
+ * @retval			false	時間切れで中断した
+ */
+
+bool NewtGCIncrementalMark(newtPool pool, clock_t deadline)
+{
+	uint32_t	n = 0;
+
+	while (0 < pool->marknums)
+	{
+		NewtGCObjMark(pool->markstack[--pool->marknums]);
+
+		if (++n % NEWT_GC_SLICECHECK == 0 && 0 < deadline && deadline <= clock())
+			return false;
+	}
+
+	return true;
+}
+
+
+/*------------------------------------------------------------------------*/
+/** インクリメンタルGC のマークを完了してスウィープを開始する
+ *
+ * @param pool		[in] メモリプール
+ *
+ * @return			なし
+ *
+ * @note			スタックとレジスタにはライトバリアがないのでルートをマークし直す。
+ *					マーク中に確保された若い世代は全て生きているものとしてマークする。
+ *					スウィープ中に古い世代に確保されたオブジェクトはマークして置くので
+ *					解放されない（NewtPoolChain）。
+ */
+
+void NewtGCIncrementalRemark(newtPool pool)
+{
+	newtObjRef	obj;
+
+	NewtGCMark(&vm_env);
+
+	for (obj = pool->young; obj != NULL; obj = obj->header.nextp)
+	{
+		NewtGCObjShade(obj);
+	}
+
+	NewtGCMarkFinish(pool, false);
+
+	NVMSweepCodeCache();
+	NewtPoolSweepYoung(pool);
+	NewtPoolForget(pool);
+
+	pool->gcphase = kNewtGCSweep;
+	pool->sweepp = &pool->obj;
+	pool->sweeparena = pool->arenas;
+	pool->sweepword = 0;
+}
+
+
+/*------------------------------------------------------------------------*/
+/** インクリメンタルGC のスウィープを進める
+ *
+ * @param pool		[in] メモリプール
+ * @param deadline	[in] 中断する時刻（0 なら中断しない）
+ *
+ * @retval			true	スウィープが終わった
+ * @retval			false	時間切れで中断した
+ */
+
+bool NewtGCIncrementalSweep(newtPool pool, clock_t deadline)
+{
+	newtObjRef	obj;
+	uint32_t	n = 0;
+
+	// malloc で確保したオブジェクト
+	while (pool->sweepp != NULL && (obj = *pool->sweepp) != NULL)
+	{
+		if (NewtObjIsLiteral(obj))
+		{
+			*pool->sweepp = obj->header.nextp;
+			obj->header.nextp = NULL;
+			NewtObjChain(&pool->literal, obj);
+		}
+		else if (! NewtGCObjIsMarked(obj))
+		{
+			*pool->sweepp = obj->header.nextp;
+			NewtObjFree(pool, obj);
+		}
+		else
+		{
+			obj->header.h &= ~ (uint32_t)kNewtObjMark;
+			pool->sweepp = &obj->header.nextp;
+		}
+
+		if (++n % NEWT_GC_SLICECHECK == 0 && 0 < deadline && deadline <= clock())
+			return false;
+	}
+
+	pool->sweepp = NULL;
+
+	// アリーナのオブジェクト（スウィープ中に追加されたアリーナは調べない）
+	while (pool->sweeparena != NULL)
+	{
+		n += NewtPoolSweepArena(pool, pool->sweeparena, pool->sweepword);
+
+		if (NEWT_MEM_ARENAWORDS <= ++pool->sweepword)
+		{
+			pool->sweeparena = pool->sweeparena->next;
+			pool->sweepword = 0;
+		}
+
+		if (NEWT_GC_SLICECHECK <= n)
+		{
+			n = 0;
+
+			if (0 < deadline && deadline <= clock())
+				return false;
+		}
+	}
+
+	if (NEWT_DEBUG)
+		NewtPoolSnap("INCREMENTAL GC", pool, pool->usesize);
+
+	NewtPoolResize(pool);
+
+	pool->gcphase = kNewtGCIdle;
+
+	return true;
+}
+
+
+/*------------------------------------------------------------------------*/
+/** インクリメンタルGC を停止時間の範囲で進める
+ *
+ * @param pool		[in] メモリプール
+ *
+ * @return			なし
+ *
+ * @note			VMループから命令ごとに呼ばれ、NEWT_GC_SLICEINTERVAL 命令ごとに
+ *					gcbudget マイクロ秒までマークかスウィープを行う。
+ */
+
+void NewtGCIncrementalStep(newtPool pool)
+{
+	clock_t	deadline;
+
+	if (0 < --pool->gccountdown)
+		return;
+
+	pool->gccountdown = NEWT_GC_SLICEINTERVAL;
+	deadline = clock() + (clock_t)((double)pool->gcbudget * CLOCKS_PER_SEC / 1000000);
+
+	if (deadline == 0)
+		deadline = 1;
+
+	if (pool->gcphase == kNewtGCMark)
+	{
+		if (NewtGCIncrementalMark(pool, deadline))
+			NewtGCIncrementalRemark(pool);
+	}
+	else if (NewtGCIncrementalSweep(pool, deadline))
+	{
+		NEWT_NEEDGC = false;
+	}
+}
+
+
+/*------------------------------------------------------------------------*/
+/** 途中のインクリメンタルGC を最後まで行う
+ *
+ * @param pool		[in] メモリプール
+ *
+ * @return			なし
+ */
+
+void NewtGCIncrementalFinish(newtPool pool)
+{
+	if (pool->gcphase == kNewtGCMark)
+	{
+		NewtGCIncrementalMark(pool, 0);
+		NewtGCIncrementalRemark(pool);
+	}
+
+	if (pool->gcphase == kNewtGCSweep)
+		NewtGCIncrementalSweep(pool, 0);
+}
+
+
+/*------------------------------------------------------------------------*/
+/** アリーナの遅延スウィープを少し進める
+ *
+ * @param pool		[in] メモリプール
+ *
+ * @return			なし
+ *
+ * @note			オブジェクトの確保ごとに NEWT_GC_LAZYSWEEPWORDS ワード分の
+ *					ビットマップをスウィープする。解放したブロックはそのまま
+ *					フリーリストに入るので直後の確保で再利用される。
+ *					最後のアリーナまで終わったら NewtGCIncrementalSweep で後始末をする。
+ */
+
+void NewtGCLazySweep(newtPool pool)
+{
+	uint32_t	i;
+
+	for (i = 0; i < NEWT_GC_LAZYSWEEPWORDS && pool->sweeparena != NULL; i++)
+	{
+		NewtPoolSweepArena(pool, pool->sweeparena, pool->sweepword);
+
+		if (NEWT_MEM_ARENAWORDS <= ++pool->sweepword)
+		{
+			pool->sweeparena = pool->sweeparena->next;
+			pool->sweepword = 0;
+		}
+	}
+
+	if (pool->sweeparena == NULL)
+		NewtGCIncrementalSweep(pool, 0);
+}
+
+
+/*------------------------------------------------------------------------*/
+/** 古いオブジェクトを記憶集合に登録する（ライトバリア）
+ *
+ * @param obj		[in] 値を書込まれるオブジェクトデータ
+ * @param v			[in] 書込まれる値オブジェクト
+ *
+ * @return			なし
+ *
+ * @note			v が若い世代のオブジェクトの場合だけ登録する。
+ *					通常は NewtGCWriteBarrier マクロから呼出す。
+ *					記憶集合を拡張できない場合は次の GC を全体の GC にする
+ *					（マイナーGC では記憶集合にない参照をたどれないため）。
+ */
+
+void NewtGCRemember(newtObjRef obj, newtRefArg v)
+{
+    newtPool	pool = NEWT_POOL;
+    newtObjRef	target;
+
+    // マーク済みのオブジェクトから未マークのオブジェクトを参照させない
+    if (pool->gcphase == kNewtGCMark)
+        NewtGCRefMark(v);
+
+    if ((obj->header.h & (kNewtObjYoung | kNewtObjRemembered | kNewtObjLiteral)) != 0)
+        return;
+
+    if (! NewtRefIsPointer(v))
+        return;
+
+    target = NewtRefToPointer(v);
+
+    if (! NewtObjIsYoung(target))
+        return;
+
+    if (pool->remsize <= pool->remnums)
+    {
+        newtObjRef *	newp;
+        uint32_t		newsize;
+
+        if (0 < pool->remsize)
+            newsize = pool->remsize * 2;
+        else
+            newsize = NEWT_NUM_REMEMBERED;
+
+        newp = (newtObjRef *)NewtMemRealloc(NULL, pool->remembered, sizeof(newtObjRef) * newsize);
+
+        if (newp == NULL)
+        {
+            pool->fullgc = true;
+            NEWT_NEEDGC = true;
+            return;
+        }
+
+        pool->remembered = newp;
+        pool->remsize = newsize;
+    }
+
+    obj->header.h |= kNewtObjRemembered;
+    pool->remembered[pool->remnums++] = obj;
+}
+
+
+/*------------------------------------------------------------------------*/
+/** 現在の GC でオブジェクトが解放されるか調べる
+ *
+ * @param obj		[in] オブジェクトデータ
+ *
+ * @retval			true	解放される
+ * @retval			false	解放されない
+ *
+ * @note			マーク後、スウィープ前に呼出すこと
+ */
+
+bool NewtGCIsGarbage(newtObjRef obj)
+{
+    if (NewtObjIsLiteral(obj) || NewtGCObjIsMarked(obj))
+        return false;
+
+    return (! newt_gc_minor || NewtObjIsYoung(obj));
+}
+
+
+#ifdef NEWT_GC_PARALLEL
+#if 0
+#pragma mark -
+#endif
+/*------------------------------------------------------------------------*/
+/** GC 用のスタックにオブジェクトを積む
+ *
+ * @param stack		[in] スタック
+ * @param obj		[in] オブジェクトデータ
+ *
+ * @retval			true	積んだ
+ * @retval			false	スタックを拡張できなかった
+ *
+ * @note			マークスタックと同じく NEWT_NUM_MARKSTACK_MAX まで拡張する。
+ */
+
+bool NewtGCStackPush(newtGCStack * stack, newtObjRef obj)
+{
+    if (stack->size <= stack->nums)
+    {
+        newtObjRef *	newp = NULL;
+        uint32_t		newsize;
+
+        newsize = stack->size + NEWT_NUM_MARKSTACK;
+
+        if (newsize <= NEWT_NUM_MARKSTACK_MAX)
+            newp = (newtObjRef *)NewtMemRealloc(NULL, stack->stackp, sizeof(newtObjRef) * newsize);
+
+        if (newp == NULL)
+            return false;
+
+        stack->stackp = newp;
+        stack->size = newsize;
+    }
+
+    stack->stackp[stack->nums++] = obj;
+
+    return true;
+}
+
+
+/*------------------------------------------------------------------------*/
+/** GC のワーカースレッド
+ *
+ * @param arg		[in] ワーカー
+ *
+ * @return			NULL
+ *
+ * @note			NewtGCParallelRun で仕事を知らされるまで待つ。
+ */
+
+void * NewtGCWorkerMain(void * arg)
+{
+    newtGCParallel *	par = &newt_gc_par;
+    newtGCWorker *	worker = (newtGCWorker *)arg;
+    uint32_t	generation = 0;
+
+    newt_gc_worker = worker;
+
+    pthread_mutex_lock(&par->lock);
+
+    for (;;)
+    {
+        while (! par->quit && par->generation == generation)
+            pthread_cond_wait(&par->start, &par->lock);
+
+        if (par->quit)
+            break;
+
+        generation = par->generation;
+        pthread_mutex_unlock(&par->lock);
+
+        NewtGCWorkerRun(worker, par->job);
+
+        pthread_mutex_lock(&par->lock);
+
+        if (--par->running == 0)
+            pthread_cond_signal(&par->done);
+    }
+
+    pthread_mutex_unlock(&par->lock);
+
+    return NULL;
+}
+
+
+/*------------------------------------------------------------------------*/
+/** ワーカーで仕事を行う
+ *
+ * @param worker	[in] ワーカー
+ * @param job		[in] 仕事
+ *
+ * @return			なし
+ */
+
+void NewtGCWorkerRun(newtGCWorker * worker, uint32_t job)
+{
+    switch (job)
+    {
+        case kNewtGCJobMark:
+            NewtGCWorkerMark(worker);
+            break;
+
+        case kNewtGCJobSweep:
+            NewtGCWorkerSweep(worker);
+            break;
+    }
+}
+
+
+/*------------------------------------------------------------------------*/
+/** マークの仕事がなくなるまで参照先をたどる
+ *
+ * @param worker	[in] ワーカー
+ *
+ * @return			なし
+ *
+ * @note			仕事を待っているスレッドがあれば自分のマークスタックの一部を
+ *					共有のスタックに移し、自分のスタックが空になったら共有の
+ *					スタックから受取る。
+ */
+
+void NewtGCWorkerMark(newtGCWorker * worker)
+{
+    do {
+        while (0 < worker->mark.nums)
+        {
+            NewtGCObjMark(worker->mark.stackp[--worker->mark.nums]);
+
+            if (NEWT_GC_MARKBATCH * 2 <= worker->mark.nums &&
+                0 < __atomic_load_n(&newt_gc_par.idle, __ATOMIC_RELAXED))
+                NewtGCWorkerShare(worker);
+        }
+    } while (NewtGCWorkerTake(worker));
+}
+
+
+/*------------------------------------------------------------------------*/
+/** マークスタックの一部を共有のスタックに移す
+ *
+ * @param worker	[in] ワーカー
+ *
+ * @return			なし
+ */
+
+void NewtGCWorkerShare(newtGCWorker * worker)
+{
+    newtGCParallel *	par = &newt_gc_par;
+    uint32_t	n;
+
+    pthread_mutex_lock(&par->lock);
+
+    for (n = 0; n < NEWT_GC_MARKBATCH; n++)
+    {
+        if (! NewtGCStackPush(&par->shared, worker->mark.stackp[worker->mark.nums - 1]))
+            break;
+
+        worker->mark.nums--;
+    }
+
+    pthread_cond_broadcast(&par->work);
+    pthread_mutex_unlock(&par->lock);
+}
+
+
+/*------------------------------------------------------------------------*/
+/** 共有のスタックからマークの仕事を受取る
+ *
+ * @param worker	[in] ワーカー
+ *
+ * @retval			true	仕事を受取った
+ * @retval			false	全てのスレッドの仕事がなくなった
+ *
+ * @note			全てのスレッドが仕事を待っている状態になった時にマークが終わる。
+ */
+
+bool NewtGCWorkerTake(newtGCWorker * worker)
+{
+    newtGCParallel *	par = &newt_gc_par;
+    bool	result = false;
+    uint32_t	n;
+
+    pthread_mutex_lock(&par->lock);
+
+    for (;;)
+    {
+        if (0 < par->shared.nums)
+        {
+            for (n = 0; n < NEWT_GC_MARKBATCH && 0 < par->shared.nums; n++)
+            {
+                if (! NewtGCStackPush(&worker->mark, par->shared.stackp[--par->shared.nums]))
+                    worker->markoverflow = true;
+            }
+
+            result = true;
+            break;
+        }
 
-	NewtPoolSweep(NEWT_POOL, NEWT_SWEEP);
+        if (par->markdone)
+            break;
 
-    NEWT_SWEEP = ! NEWT_SWEEP;
-    NEWT_NEEDGC = false;
+        if (__atomic_add_fetch(&par->idle, 1, __ATOMIC_RELAXED) == par->nthreads)
+        {
+            par->markdone = true;
+            pthread_cond_broadcast(&par->work);
+            break;
+        }
+
+        pthread_cond_wait(&par->work, &par->lock);
+        __atomic_sub_fetch(&par->idle, 1, __ATOMIC_RELAXED);
+    }
+
+    pthread_mutex_unlock(&par->lock);
+
+    return result;
+}
+
+
+/*------------------------------------------------------------------------*/
+/** アリーナがなくなるまでスウィープする
+ *
+ * @param worker	[in] ワーカー
+ *
+ * @return			なし
+ *
+ * @note			アリーナ単位で受取るので同じアリーナを２つのスレッドが調べることはない。
+ */
+
+void NewtGCWorkerSweep(newtGCWorker * worker)
+{
+    newtGCParallel *	par = &newt_gc_par;
+    newtMemArena *	arena;
+    uint32_t	w;
+
+    for (;;)
+    {
+        pthread_mutex_lock(&par->lock);
+        arena = par->sweeparena;
+
+        if (arena != NULL)
+            par->sweeparena = arena->next;
+
+        pthread_mutex_unlock(&par->lock);
+
+        if (arena == NULL)
+            break;
+
+        for (w = 0; w < NEWT_MEM_ARENAWORDS; w++)
+        {
+            NewtPoolSweepArena(par->pool, arena, w);
+        }
+    }
+}
+
+
+/*------------------------------------------------------------------------*/
+/** ワーカーでオブジェクトを解放する
+ *
+ * @param worker	[in] ワーカー
+ * @param obj		[in] オブジェクトデータ
+ *
+ * @return			なし
+ *
+ * @note			マップの索引を持つオブジェクトと CObject は共有の表や
+ *					デストラクタに触れるので GC を呼出したスレッドで後から解放する。
+ */
+
+void NewtGCWorkerFree(newtGCWorker * worker, newtObjRef obj)
+{
+    if ((obj->header.h & kNewtObjMapIndexed) != 0 || NewtObjIsIndirectBinary(obj))
+    {
+        obj->header.nextp = NULL;
+        NewtObjChain(&worker->deferred, obj);
+        return;
+    }
+
+    worker->freesize += NewtObjUseSize(obj);
+
+    if (NewtObjData(obj) != NewtObjInlineData(obj))
+        NewtGCWorkerMemFree(worker, NewtObjData(obj));
+
+    NewtGCWorkerMemFree(worker, obj);
+}
+
+
+/*------------------------------------------------------------------------*/
+/** ワーカーでメモリを解放する
+ *
+ * @param worker	[in] ワーカー
+ * @param ptr		[in] メモリへのポインタ
+ *
+ * @return			なし
+ *
+ * @note			サイズクラスのブロックはワーカーのリストに集めておき、
+ *					NewtGCParallelSweep でまとめてフリーリストにつなぐ。
+ */
+
+void NewtGCWorkerMemFree(newtGCWorker * worker, void * ptr)
+{
+    newtMemHeader *	header;
+    uint32_t	i;
+
+    header = (newtMemHeader *)ptr - 1;
+
+    if (header->block.sizeclass == NULL)
+    {
+        free(header);
+        return;
+    }
+
+    i = (uint32_t)(header->block.sizeclass - newt_gc_par.pool->sizeclass);
+
+    if (worker->freehead[i] == NULL)
+        worker->freetail[i] = ptr;
+
+    *((void **)ptr) = worker->freehead[i];
+    worker->freehead[i] = ptr;
+}
+
+
+/*------------------------------------------------------------------------*/
+/** 全体の GC を複数のスレッドで行う準備をする
+ *
+ * @param pool		[in] メモリプール
+ *
+ * @retval			true	複数のスレッドで行う
+ * @retval			false	GC を呼出したスレッドだけで行う
+ *
+ * @note			ワーカースレッドは最初に必要になった時に起動し、
+ *					スレッド数が変わった時だけ起動し直す。
+ */
+
+bool NewtGCParallelStart(newtPool pool)
+{
+    newtGCParallel *	par = &newt_gc_par;
+    newtMemArena *	arena;
+    uint32_t	n = 0;
+    uint32_t	i;
+
+    if (pool->gcthreads <= 1)
+    {
+        NewtGCParallelStop();
+        return false;
+    }
+
+    // 小さなヒープではスレッドを切替える方が高くつく
+    for (arena = pool->arenas; arena != NULL && n < NEWT_GC_PARALLEL_ARENAS; arena = arena->next)
+    {
+        n++;
+    }
+
+    if (n < NEWT_GC_PARALLEL_ARENAS)
+        return false;
+
+    if (par->workers != NULL && par->size == pool->gcthreads)
+        return (1 < par->nthreads);
+
+    NewtGCParallelStop();
+
+    par->workers = (newtGCWorker *)calloc(pool->gcthreads, sizeof(newtGCWorker));
+
+    if (par->workers == NULL)
+        return false;
+
+    par->pool = pool;
+    par->size = pool->gcthreads;
+    par->nthreads = 1;
+    par->generation = 0;
+    par->quit = false;
+
+    for (i = 1; i < par->size; i++)
+    {
+        if (pthread_create(&par->workers[i].thread, NULL, NewtGCWorkerMain, &par->workers[i]) != 0)
+            break;
+
+        par->nthreads++;
+    }
+
+    return (1 < par->nthreads);
+}
+
+
+/*------------------------------------------------------------------------*/
+/** ワーカースレッドを終了させる
+ *
+ * @return			なし
+ */
+
+void NewtGCParallelStop(void)
+{
+    newtGCParallel *	par = &newt_gc_par;
+    uint32_t	i;
+
+    if (par->workers == NULL)
+        return;
+
+    pthread_mutex_lock(&par->lock);
+    par->quit = true;
+    pthread_cond_broadcast(&par->start);
+    pthread_mutex_unlock(&par->lock);
+
+    for (i = 1; i < par->nthreads; i++)
+    {
+        pthread_join(par->workers[i].thread, NULL);
+    }
+
+    for (i = 0; i < par->size; i++)
+    {
+        NewtMemFree(par->workers[i].mark.stackp);
+        NewtMemFree(par->workers[i].cobjs.stackp);
+    }
+
+    NewtMemFree(par->shared.stackp);
+    memset(&par->shared, 0, sizeof(par->shared));
+
+    free(par->workers);
+    par->workers = NULL;
+    par->size = 0;
+    par->nthreads = 0;
+}
+
+
+/*------------------------------------------------------------------------*/
+/** 全てのスレッドで仕事を行い、終わるまで待つ
+ *
+ * @param job		[in] 仕事
+ *
+ * @return			なし
+ *
+ * @note			GC を呼出したスレッドも先頭のワーカーとして仕事をする。
+ */
+
+void NewtGCParallelRun(uint32_t job)
+{
+    newtGCParallel *	par = &newt_gc_par;
+
+    pthread_mutex_lock(&par->lock);
+    par->job = job;
+    par->running = par->nthreads - 1;
+    par->generation++;
+    pthread_cond_broadcast(&par->start);
+    pthread_mutex_unlock(&par->lock);
+
+    newt_gc_worker = &par->workers[0];
+    NewtGCWorkerRun(newt_gc_worker, job);
+    newt_gc_worker = NULL;
+
+    pthread_mutex_lock(&par->lock);
+
+    while (0 < par->running)
+        pthread_cond_wait(&par->done, &par->lock);
+
+    pthread_mutex_unlock(&par->lock);
+}
+
+
+/*------------------------------------------------------------------------*/
+/** ルートから積まれたオブジェクトの参照先を複数のスレッドでマークする
+ *
+ * @param pool		[in] メモリプール
+ *
+ * @return			なし
+ *
+ * @note			マーカー関数はスレッドセーフとは限らないので、ワーカーが
+ *					見つけた CObject のマーカー関数はここでまとめて呼ぶ。
+ *					残りの仕事とあふれたオブジェクトは NewtGCMarkFinish で片付ける。
+ */
+
+void NewtGCParallelMark(newtPool pool)
+{
+    newtGCParallel *	par = &newt_gc_par;
+    newtGCWorker *	worker;
+    uint32_t	i;
+    uint32_t	j;
+
+    for (i = 0; i < pool->marknums; i++)
+    {
+        if (! NewtGCStackPush(&par->shared, pool->markstack[i]))
+            pool->markoverflow = true;
+    }
+
+    pool->marknums = 0;
+    par->idle = 0;
+    par->markdone = false;
+
+    NewtGCParallelRun(kNewtGCJobMark);
+
+    for (i = 0; i < par->nthreads; i++)
+    {
+        worker = &par->workers[i];
+
+        if (worker->markoverflow)
+        {
+            worker->markoverflow = false;
+            pool->markoverflow = true;
+        }
+
+        for (j = 0; j < worker->cobjs.nums; j++)
+        {
+            NewtGCObjMark(worker->cobjs.stackp[j]);
+        }
+
+        worker->cobjs.nums = 0;
+    }
+}
+
+
+/*------------------------------------------------------------------------*/
+/** アリーナを複数のスレッドでスウィープする
+ *
+ * @param pool		[in] メモリプール
+ *
+ * @return			なし
+ *
+ * @note			ワーカーが集めたブロックとリテラルをメモリプールにつなぎ、
+ *					後回しにしたオブジェクトを解放する。
+ */
+
+void NewtGCParallelSweep(newtPool pool)
+{
+    newtGCParallel *	par = &newt_gc_par;
+    newtGCWorker *	worker;
+    newtObjRef	nextp;
+    newtObjRef	obj;
+    uint32_t	i;
+    uint32_t	j;
+
+    par->sweeparena = pool->arenas;
+
+    NewtGCParallelRun(kNewtGCJobSweep);
+
+    for (i = 0; i < par->nthreads; i++)
+    {
+        worker = &par->workers[i];
+
+        for (j = 0; j < NEWT_NUM_MEMCLASS; j++)
+        {
+            if (worker->freehead[j] != NULL)
+            {
+                *((void **)worker->freetail[j]) = pool->sizeclass[j].freelist;
+                pool->sizeclass[j].freelist = worker->freehead[j];
+                worker->freehead[j] = NULL;
+                worker->freetail[j] = NULL;
+            }
+        }
+
+        pool->usesize -= worker->freesize;
+        worker->freesize = 0;
+
+        for (obj = worker->literal; obj != NULL; obj = nextp)
+        {
+            nextp = obj->header.nextp;
+            obj->header.nextp = NULL;
+            NewtObjChain(&pool->literal, obj);
+        }
+
+        for (obj = worker->deferred; obj != NULL; obj = nextp)
+        {
+            nextp = obj->header.nextp;
+            NewtObjFree(pool, obj);
+        }
+
+        worker->literal = NULL;
+        worker->deferred = NULL;
+    }
 }
 
+#endif /* NEWT_GC_PARALLEL */
+
 
 #if 0
 #pragma mark -
@@ -553,5 +2457,130 @@ void NewtGC(void)
 newtRef	NsGC(newtRefArg rcvr)
 {
 	NEWT_NEEDGC = true;
+	NEWT_POOL->fullgc = true;
     return kNewtRefNIL;
 }
+
+
+/*------------------------------------------------------------------------*/
+/** インクリメンタルGC の1回の停止時間を設定する
+ *
+ * @param rcvr		[in] レシーバ
+ * @param usec		[in] 停止時間（マイクロ秒、0 なら一度に GC する）
+ *
+ * @return			以前の停止時間
+ *
+ * @note			スクリプトからの呼出し用
+ */
+
+newtRef	NsSetGCPauseBudget(newtRefArg rcvr, newtRefArg usec)
+{
+	newtPool	pool = NEWT_POOL;
+	newtRef		old;
+
+	if (! NewtRefIsInteger(usec) || NewtRefToInteger(usec) < 0)
+		return NewtThrow(kNErrNotAnInteger, usec);
+
+	old = NewtMakeInteger(pool->gcbudget);
+	pool->gcbudget = NewtRefToInteger(usec);
+
+	return old;
+}
+
+
+/*------------------------------------------------------------------------*/
+/** 全体の GC でマークとスウィープを行うスレッド数を設定する
+ *
+ * @param rcvr		[in] レシーバ
+ * @param n			[in] スレッド数（1 なら GC を呼出したスレッドだけで行う、上限は NEWT_GC_MAXTHREADS）
+ *
+ * @return			以前のスレッド数
+ *
+ * @note			スクリプトからの呼出し用。
+ *					スレッドを使えない環境では常に１スレッドで行う。
+ */
+
+newtRef	NsSetGCThreads(newtRefArg rcvr, newtRefArg n)
+{
+	newtPool	pool = NEWT_POOL;
+	newtRef		old;
+
+	if (! NewtRefIsInteger(n))
+		return NewtThrow(kNErrNotAnInteger, n);
+
+	if (NewtRefToInteger(n) < 1 || NEWT_GC_MAXTHREADS < NewtRefToInteger(n))
+		return NewtThrow(kNErrOutOfRange, n);
+
+	old = NewtMakeInteger(pool->gcthreads);
+	pool->gcthreads = NewtRefToInteger(n);
+
+	return old;
+}
+
+
+/*------------------------------------------------------------------------*/
+/** メモリプールの上限を設定する
+ *
+ * @param rcvr		[in] レシーバ
+ * @param size		[in] 上限（バイト数、0 なら上限なし）
+ *
+ * @return			以前の上限
+ *
+ * @note			スクリプトからの呼出し用。
+ *					全体の GC の後で上限を超えていると kNErrOutOfObjectMemory 例外を発生する。
+ */
+
+newtRef	NsSetHeapLimit(newtRefArg rcvr, newtRefArg size)
+{
+	newtPool	pool = NEWT_POOL;
+	newtRef		old;
+
+	if (! NewtRefIsInteger(size) || NewtRefToInteger(size) < 0)
+		return NewtThrow(kNErrNotAnInteger, size);
+
+	old = NewtMakeInteger(pool->limitspace);
+	pool->limitspace = NewtRefToInteger(size);
+	pool->overlimit = false;
+
+	if (0 < pool->limitspace && pool->limitspace < pool->maxspace)
+		pool->maxspace = pool->limitspace;
+
+	return old;
+}
+
+
+/*------------------------------------------------------------------------*/
+/** メモリプールの統計情報を取得する
+ *
+ * @param rcvr		[in] レシーバ
+ *
+ * @return			フレーム（allocs: 確保したオブジェクトの数、
+ *					usesize: 使用サイズ、youngsize: 若い世代の使用サイズ、
+ *					maxspace: 次に全体の GC を行う使用サイズ）
+ *
+ * @note			スクリプトからの呼出し用
+ */
+
+newtRef	NsGCStats(newtRefArg rcvr)
+{
+	newtPool	pool = NEWT_POOL;
+	newtRefVar	allocs;
+	newtRefVar	usesize;
+	newtRefVar	youngsize;
+	newtRefVar	maxspace;
+	newtRefVar	result;
+
+	// 結果のフレームを作る前の値を返す
+	allocs = NewtMakeInteger(pool->allocs);
+	usesize = NewtMakeInteger(pool->usesize);
+	youngsize = NewtMakeInteger(pool->youngsize);
+	maxspace = NewtMakeInteger(pool->maxspace);
+
+	result = NcMakeFrame();
+	NcSetSlot(result, NSSYM(allocs), allocs);
+	NcSetSlot(result, NSSYM(usesize), usesize);
+	NcSetSlot(result, NSSYM(youngsize), youngsize);
+	NcSetSlot(result, NSSYM(maxspace), maxspace);
+
+    return result;
+}
@@ -15,6 +15,128 @@
 #include "NewtMem.h"
 
 
+/* 関数プロトタイプ */
+static int		NewtMemClassIndex(size_t size);
+static void *	NewtMemLargeAlloc(size_t size);
+static void *	NewtMemClassAlloc(newtPool pool, newtMemClass * sizeclass);
+
+
+/* ローカル変数 */
+
+/// サイズクラスごとのブロックのサイズ
+static const size_t	newt_memclass_size[NEWT_NUM_MEMCLASS] =
+	{
+		16,		32,		48,		64,		80,		96,		112,	128,
+		160,	192,	224,	256,	320,	384,	448,	512
+	};
+
+
+/*------------------------------------------------------------------------*/
+/** サイズに対応するサイズクラスの位置を取得する
+ *
+ * @param size		[in] データサイズ
+ *
+ * @return			サイズクラスの位置
+ *
+ * @note			size は NEWT_MEMCLASS_MAXSIZE 以下であること
+ */
+
+int NewtMemClassIndex(size_t size)
+{
+    if (size == 0)
+        return 0;
+    else if (size <= 128)
+        return (size - 1) >> 4;
+    else if (size <= 256)
+        return 8 + ((size - 129) >> 5);
+    else
+        return 12 + ((size - 257) >> 6);
+}
+
+
+/*------------------------------------------------------------------------*/
+/** サイズクラスを使わずにメモリを確保する
+ *
+ * @param size		[in] データサイズ
+ *
+ * @return			確保したメモリへのポインタ
+ */
+
+void * NewtMemLargeAlloc(size_t size)
+{
+    newtMemHeader *	header;
+
+    header = (newtMemHeader *)malloc(sizeof(newtMemHeader) + size);
+    if (header == NULL) return NULL;
+
+    header->block.sizeclass = NULL;
+    header->block.size = size;
+
+    return header + 1;
+}
+
+
+/*------------------------------------------------------------------------*/
+/** サイズクラスのブロックを確保する
+ *
+ * @param pool		[in] メモリプール
+ * @param sizeclass	[in] サイズクラス
+ *
+ * @return			確保したメモリへのポインタ
+ *
+ * @note			解放されたブロックがなければアリーナから切り出す
+ */
+
+void * NewtMemClassAlloc(newtPool pool, newtMemClass * sizeclass)
+{
+    newtMemHeader *	header;
+    size_t		blocksize;
+    void *		ptr;
+
+    ptr = sizeclass->freelist;
+
+    if (ptr != NULL)
+    {
+        sizeclass->freelist = *((void **)ptr);
+        return ptr;
+    }
+
+    blocksize = sizeof(newtMemHeader) + sizeclass->size;
+
+    if (pool->arenap == NULL || pool->arenaend < pool->arenap + blocksize)
+    {
+        newtMemArena *	arena;
+
+        // 新しいアリーナを確保（ビットマップを持つ記述子は別に確保する）
+        arena = (newtMemArena *)calloc(1, sizeof(newtMemArena));
+        if (arena == NULL) return NULL;
+
+        arena->base = (uint8_t *)malloc(NEWT_MEM_ARENASIZE);
+
+        if (arena->base == NULL)
+        {
+            free(arena);
+            return NULL;
+        }
+
+        arena->next = pool->arenas;
+        pool->arenas = arena;
+        pool->arenap = arena->base;
+        pool->arenaend = arena->base + NEWT_MEM_ARENASIZE;
+    }
+
+    header = (newtMemHeader *)pool->arenap;
+    header->classblock.sizeclass = sizeclass;
+    header->classblock.arena = pool->arenas;
+    pool->arenap += blocksize;
+
+    return header + 1;
+}
+
+
+#if 0
+#pragma mark -
+#endif
 /*------------------------------------------------------------------------*/
 /** メモリプールの確保
  *
@@ -23,7 +145,7 @@
  * @return				メモリプール
  */
 
-newtPool NewtPoolAlloc(int32_t expandspace)
+newtPool NewtPoolAlloc(int64_t expandspace)
 {
     newtPool	pool;
 
@@ -31,13 +153,60 @@ newtPool NewtPoolAlloc(int32_t expandspace)
 
     if (pool != NULL)
     {
-        pool->maxspace = pool->expandspace = expandspace;
+        int	i;
+
+        pool->expandspace = expandspace;
+        pool->maxspace = pool->initspace = NEWT_POOL_INITSPACE;
+        pool->limitspace = NEWT_POOL_LIMITSPACE;
+        pool->nurseryspace = NEWT_POOL_NURSERYSPACE;
+        pool->gcbudget = NEWT_GC_PAUSEBUDGET;
+        pool->gcthreads = NEWT_GC_THREADS;
+        pool->lazysweep = NEWT_GC_LAZYSWEEP;
+        pool->maxclass = NEWT_MEMCLASS_MAXSIZE;
+
+        for (i = 0; i < NEWT_NUM_MEMCLASS; i++)
+        {
+            pool->sizeclass[i].size = newt_memclass_size[i];
+        }
     }
 
     return pool;
 }
 
 
+/*------------------------------------------------------------------------*/
+/** メモリプールを解放する
+ *
+ * @param pool		[in] メモリプール
+ *
+ * @return			なし
+ *
+ * @note			サイズクラスで確保したメモリは全て無効になる
+ */
+
+void NewtPoolFree(newtPool pool)
+{
+    newtMemArena *	arena;
+    newtMemArena *	next;
+
+    if (pool == NULL)
+        return;
+
+    for (arena = pool->arenas; arena != NULL; arena = next)
+    {
+        next = arena->next;
+        free(arena->base);
+        free(arena);
+    }
+
+    NewtMemFree(pool->remembered);
+    NewtMemFree(pool->markstack);
+    NewtMemFree(pool->finalizers);
+
+    free(pool);
+}
+
+
 /*------------------------------------------------------------------------*/
 /** メモリプールから指定されたサイズのメモリを確保する
  *
@@ -46,16 +215,15 @@ newtPool NewtPoolAlloc(int32_t expandspace)
  *
  * @return			確保したメモリへのポインタ
  *
- * @note			現在はまだ独自メモリ管理は行われていない
+ * @note			小さなメモリはメモリプールのサイズクラスから確保する
  */
 
 void * NewtMemAlloc(newtPool pool, size_t size)
 {
-    if (pool != NULL)
-    {
-    }
+    if (NewtMemIsSmall(pool, size))
+        return NewtMemClassAlloc(pool, &pool->sizeclass[NewtMemClassIndex(size)]);
 
-    return malloc(size);
+    return NewtMemLargeAlloc(size);
 }
 
 
@@ -67,17 +235,18 @@ void * NewtMemAlloc(newtPool pool, size_t size)
  * @param size		[in] データサイズ
  *
  * @return			確保したメモリへのポインタ
- *
- * @note			現在はまだ独自メモリ管理は行われていない
  */
 
 void * NewtMemCalloc(newtPool pool, size_t number, size_t size)
 {
-    if (pool != NULL)
-    {
-    }
+    void *	ptr;
+
+    ptr = NewtMemAlloc(pool, number * size);
 
-    return calloc(number, size);
+    if (ptr != NULL)
+        memset(ptr, 0, number * size);
+
+    return ptr;
 }
 
 
@@ -90,16 +259,39 @@ void * NewtMemCalloc(newtPool pool, size_t number, size_t size)
  *
  * @return			再確保したメモリへのポインタ
  *
- * @note			現在はまだ独自メモリ管理は行われていない
+ * @note			サイズクラスのブロックに収まる場合は同じポインタを返す
  */
 
 void * NewtMemRealloc(newtPool pool, void * ptr, size_t size)
 {
-    if (pool != NULL)
+    newtMemHeader *	header;
+    void *		newp;
+
+    if (ptr == NULL)
+        return NewtMemAlloc(pool, size);
+
+    header = (newtMemHeader *)ptr - 1;
+
+    if (header->block.sizeclass == NULL)
     {
+        header = (newtMemHeader *)realloc(header, sizeof(newtMemHeader) + size);
+        if (header == NULL) return NULL;
+
+        header->block.size = size;
+
+        return header + 1;
     }
 
-    return realloc(ptr, size);
+    if (size <= header->block.sizeclass->size)
+        return ptr;
+
+    newp = NewtMemAlloc(pool, size);
+    if (newp == NULL) return NULL;
+
+    memcpy(newp, ptr, header->block.sizeclass->size);
+    NewtMemFree(ptr);
+
+    return newp;
 }
 
 
@@ -110,12 +302,66 @@ void * NewtMemRealloc(newtPool pool, void * ptr, size_t size)
  *
  * @return			なし
  *
- * @note			現在はまだ独自メモリ管理は行われていない
+ * @note			サイズクラスのブロックはサイズクラスのフリーリストに戻す
  */
 
 void NewtMemFree(void * ptr)
 {
-    free(ptr);
+    newtMemHeader *	header;
+    newtMemClass *	sizeclass;
+
+    if (ptr == NULL)
+        return;
+
+    header = (newtMemHeader *)ptr - 1;
+    sizeclass = header->block.sizeclass;
+
+    if (sizeclass != NULL)
+    {
+        *((void **)ptr) = sizeclass->freelist;
+        sizeclass->freelist = ptr;
+    }
+    else
+    {
+        free(header);
+    }
+}
+
+
+/*------------------------------------------------------------------------*/
+/** メモリプールのサイズクラスから確保されるサイズか調べる
+ *
+ * @param pool		[in] メモリプール
+ * @param size		[in] データサイズ
+ *
+ * @retval			true	サイズクラスから確保される
+ * @retval			false   malloc で確保される
+ */
+
+bool NewtMemIsSmall(newtPool pool, size_t size)
+{
+    return (pool != NULL && size <= pool->maxclass);
+}
+
+
+/*------------------------------------------------------------------------*/
+/** 確保したメモリの使用可能なサイズを取得する
+ *
+ * @param ptr		[in] メモリへのポインタ
+ *
+ * @return			使用可能なサイズ
+ */
+
+size_t NewtMemSize(void * ptr)
+{
+    newtMemHeader *	header;
+
+    header = (newtMemHeader *)ptr - 1;
+
+    if (header->block.sizeclass != NULL)
+        return header->block.sizeclass->size;
+    else
+        return header->block.size;
 }
 
 
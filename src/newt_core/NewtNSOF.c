@@ -683,6 +683,9 @@ newtErr NewtWriteNSOF(nsof_stream_t * nsof, newtRefArg r)
 			NSOFWriteByte(nsof, kNSOFNIL);
 		else if (NewtRefIsCharacter(r))
 			NSOFWriteCharacter(nsof, r);
+		else if (NewtBoxWideInteger(r) != r)
+			// 30bit に収まらない整数はバイナリの整数として書込む
+			NewtWriteNSOF(nsof, NewtBoxWideInteger(r));
 		else
 			NSOFWriteImmediate(nsof, r);
 	}
@@ -858,6 +861,23 @@ newtRef NSOFReadBinary(nsof_stream_t * nsof, int type)
 			r= NewtMakeInteger(n);
 		}
 	}
+	else if (klass == NSSYM0(int64))
+	{
+		if (NSOFIsNOS(nsof->verno))
+		{
+			nsof->lastErr = kNErrNSOFRead;
+		}
+		else
+		{
+			uint64_t	n = 0;
+			int			i;
+
+			for (i = 0; i < 8; i++)
+				n = (n << 8) | data[i];
+
+			r= NewtMakeInteger((int64_t)n);
+		}
+	}
 	else if (klass == NSSYM0(real))
 	{
 		double	n;
@@ -1121,8 +1141,14 @@ newtRef NSOFReadNSOF(nsof_stream_t * nsof)
 
 		case kNSOFBinaryObject:
 		case kNSOFString:
-			r = NSOFReadBinary(nsof, type);
-			NcAddArraySlot(nsof->precedents, r);
+			{	// 書込み時と同じくクラスより先に出現済みオブジェクトに加える
+				uint32_t	i;
+
+				i = NewtArrayLength(nsof->precedents);
+				NcAddArraySlot(nsof->precedents, kNewtRefUnbind);
+				r = NSOFReadBinary(nsof, type);
+				NewtSetArraySlot(nsof->precedents, i, r);
+			}
 			break;
 
 		case kNSOFArray:
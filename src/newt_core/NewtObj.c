@@ -23,10 +23,11 @@
 
 
 /* 関数プロトタイプ */
-static newtRef		NewtMakeSymbol0(const char *s);
+static uint64_t		NewtSymbolUpper64(uint64_t w);
 static bool			NewtBSearchSymTable(newtRefArg r, const char * name, uint32_t hash, int32_t st, int32_t * indexP);
 static newtObjRef   NewtObjMemAlloc(newtPool pool, size_t n, bool literal);
 static newtObjRef   NewtObjRealloc(newtPool pool, newtObjRef obj, size_t n);
+static size_t		NewtObjGrowSize(size_t capacity, size_t n);
 static void			NewtGetObjData(newtRefArg r, uint8_t * data, size_t len);
 static newtObjRef   NewtObjBinarySetLength(newtObjRef obj, size_t n);
 static size_t		NewtObjSymbolLength(newtObjRef obj);
@@ -44,6 +45,10 @@ static newtRef		NewtMakeThrowSymbol(intptr_t err);
 
 static bool			NewtObjHasProto(newtObjRef obj);
 static bool			NewtMapIsSorted(newtRefArg r);
+static newtMapIndex *	NewtMapIndexGet(newtObjRef obj);
+static newtMapIndex *	NewtMapIndexBuild(newtObjRef obj);
+static ssize_t		NewtMapIndexFind(newtRefArg r, newtRefArg v);
+static newtRef		NewtMapTransition(newtRefArg map, newtRefArg slot);
 static void			NewtObjRemoveArraySlot(newtObjRef obj, size_t n);
 static void			NewtDeeplyCopyMap(newtRef * dst, size_t * pos, newtRefArg src);
 static newtRef		NewtDeeplyCloneMap(newtRefArg map, size_t len);
@@ -53,6 +58,18 @@ static bool			NewtStrIsSubclass(const char * sub, size_t sublen, const char * su
 static bool			NewtStrHasSubclass(const char * sub, size_t sublen, const char * supr, size_t suprlen);
 
 
+/* ローカル変数 */
+
+/// スロットの索引を持つマップ（マップのアドレスでハッシュ）
+static newtMapIndex *		newt_mapindex[NEWT_NUM_MAPINDEXBUCKET];
+
+/// マップの遷移先（元のマップのアドレスとスロットでハッシュ）
+static newtMapTransition *	newt_maptransition[NEWT_NUM_MAPTRANSITIONBUCKET];
+
+/// 作った遷移先のマップの数
+static uint32_t		newt_num_maptransitions;
+
+
 #if 0
 #pragma mark -
 #endif
@@ -62,9 +79,31 @@ static bool			NewtStrHasSubclass(const char * sub, size_t sublen, const char * s
  * @param name		[in] シンボル名
  *
  * @return			ハッシュ値
+ *
+ * @note			--noFastHash の場合は Newton OS と同じハッシュ値を使う
  */
 
 uint32_t NewtSymbolHashFunction(const char * name)
+{
+    if (NEWT_MODE_NOFASTHASH)
+        return NewtSymbolNewtonHash(name);
+    else
+        return NewtSymbolFastHash(name);
+}
+
+
+/*------------------------------------------------------------------------*/
+/** Newton OS 互換のシンボルのハッシュ値を計算
+ *
+ * @param name		[in] シンボル名
+ *
+ * @return			ハッシュ値
+ *
+ * @note			大文字にした文字の和なので並びが違うだけのシンボルは衝突する。
+ *					パッケージに保存するハッシュ値とソート済みマップの順序にはこの値を使う。
+ */
+
+uint32_t NewtSymbolNewtonHash(const char * name)
 {
     uint32_t result = 0;
     char c;
@@ -85,6 +124,72 @@ uint32_t NewtSymbolHashFunction(const char * name)
 }
 
 
+/*------------------------------------------------------------------------*/
+/** 8 バイトの英小文字を大文字にする
+ *
+ * @param w			[in] 8 バイトの文字列
+ *
+ * @return			大文字にした文字列
+ *
+ * @note			a〜z 以外のバイト（0x80 以上を含む）は変更しない
+ */
+
+static uint64_t NewtSymbolUpper64(uint64_t w)
+{
+    const uint64_t	ones = 0x0101010101010101ULL;
+    uint64_t	heptets;
+    uint64_t	ge_a;
+    uint64_t	gt_z;
+
+    heptets = w & (ones * 0x7F);
+    ge_a = heptets + ones * (0x80 - 'a');
+    gt_z = heptets + ones * (0x80 - 'z' - 1);
+
+    return w ^ (((ge_a & ~ gt_z & ~ w) & (ones * 0x80)) >> 2);
+}
+
+
+/*------------------------------------------------------------------------*/
+/** 大文字小文字を区別しないシンボルのハッシュ値を計算
+ *
+ * @param name		[in] シンボル名
+ *
+ * @return			ハッシュ値
+ *
+ * @note			8 バイトずつ大文字にして乗算とシフトで混ぜる
+ */
+
+uint32_t NewtSymbolFastHash(const char * name)
+{
+    const uint64_t	k = 0x9E3779B97F4A7C15ULL;
+    uint64_t	h;
+    uint64_t	w;
+    size_t		len;
+
+    len = strlen(name);
+    h = len * k;
+
+    for (; 8 <= len; len -= 8, name += 8)
+    {
+        memcpy(&w, name, 8);
+        h = (h ^ NewtSymbolUpper64(w)) * k;
+        h ^= h >> 29;
+    }
+
+    if (0 < len)
+    {
+        w = 0;
+        memcpy(&w, name, len);
+        h = (h ^ NewtSymbolUpper64(w)) * k;
+        h ^= h >> 29;
+    }
+
+    h *= k;
+
+    return (uint32_t)(h >> 32);
+}
+
+
 /*------------------------------------------------------------------------*/
 /** シンボルオブジェクトの作成
  *
@@ -134,6 +239,9 @@ newtRef NewtMakeSymbol0(const char *s)
  *
  * @retval			true	成功
  * @retval			false   失敗
+ *
+ * @note			ソート済みマップは Newton OS 互換のハッシュ値の順に並んでいる。
+ *					ハッシュ関数が違う場合は名前から互換のハッシュ値を計算して比較する。
  */
 
 bool NewtBSearchSymTable(newtRefArg r, const char * name, uint32_t hash,
@@ -145,11 +253,12 @@ bool NewtBSearchSymTable(newtRefArg r, const char * name, uint32_t hash,
     int32_t	ed;
     int32_t	md = st;
     int16_t	comp;
+    uint32_t	symhash;
 
     slots = NewtRefToSlots(r);
 
-    if (hash == 0)
-        hash = NewtSymbolHashFunction(name);
+    if (hash == 0 || ! NEWT_MODE_NOFASTHASH)
+        hash = NewtSymbolNewtonHash(name);
 
     len = NewtArrayLength(r);
     ed = (int32_t) len - 1;
@@ -160,9 +269,14 @@ bool NewtBSearchSymTable(newtRefArg r, const char * name, uint32_t hash,
 
         sym = NewtRefToSymbol(slots[md]);
 
-		if (hash < sym->hash)
+		if (NEWT_MODE_NOFASTHASH)
+			symhash = sym->hash;
+		else
+			symhash = NewtSymbolNewtonHash(sym->name);
+
+		if (hash < symhash)
 			comp = -1;
-		else if (hash > sym->hash)
+		else if (hash > symhash)
 			comp = 1;
 		else
 			comp = 0;
@@ -201,7 +315,8 @@ bool NewtBSearchSymTable(newtRefArg r, const char * name, uint32_t hash,
  *
  * @return			シンボルオブジェクト
  *
- * @note			未登録の場合はシンボルオブジェクトを作成しシンボルテーブルに登録する
+ * @note			未登録の場合はシンボルオブジェクトを作成しシンボルテーブルに登録する。
+ *					グローバルなシンボルテーブルはハッシュ索引で検索する。
  */
 
 newtRef NewtLookupSymbol(newtRefArg r, const char * name, uint32_t hash, int32_t st)
@@ -209,6 +324,9 @@ newtRef NewtLookupSymbol(newtRefArg r, const char * name, uint32_t hash, int32_t
     newtRefVar	sym;
     int32_t	index;
 
+    if (r == NcGetSymTable() && st == 0)
+        return NewtLookupSymbolTable(name);
+
     if (NewtBSearchSymTable(r, name, 0, st, &index))
         return NewtGetArraySlot(r, index);
 
@@ -440,9 +558,6 @@ newtObjRef NewtObjAlloc(newtRefArg r, size_t n, uint16_t type, bool literal)
 
     obj->header.h |= (n << 8) | type;
 
-    if (NEWT_SWEEP)
-        obj->header.h |= kNewtObjSweep;
-
     if ((type & kNewtObjFrame) != 0)
         obj->as.map = r;
     else
@@ -470,9 +585,6 @@ newtObjRef NewtObjAllocIndirectBinary(newtRefArg r, size_t n)
 
     obj->header.h |= (n << 8) | kNewtObjIndirectBin;
 
-    if (NEWT_SWEEP)
-        obj->header.h |= kNewtObjSweep;
-
     obj->as.klass = r;
 
     return obj;
@@ -600,20 +712,55 @@ newtObjRef NewtObjRealloc(newtPool pool, newtObjRef obj, size_t n)
     uint8_t *	data;
     size_t	oldSize;
     size_t	newSize;
-    size_t	addSize;
+    size_t	capacity;
 
     oldSize = NewtObjCalcDataSize(NewtObjSize(obj));
     newSize = NewtObjCalcDataSize(n);
-    addSize = newSize - oldSize;
 
-    if (0 < addSize)
-        NewtCheckGC(pool, addSize);
+    if (oldSize < newSize)
+        NewtCheckGC(pool, newSize - oldSize);
 
     datap = (uint8_t **)(obj + 1);
-    data = NewtMemRealloc(pool, *datap, newSize);
-    if (data == NULL) return NULL;
 
-    pool->usesize += addSize;
+    if (*datap == NewtObjInlineData(obj))
+    {
+        capacity = NewtMemSize(obj) - (sizeof(newtObj) + sizeof(uint8_t *));
+
+        // ヘッダと同じブロックに収まらなければデータ部を別に確保する
+        if (newSize <= capacity)
+        {
+            data = *datap;
+        }
+        else
+        {
+            data = NewtMemAlloc(pool, NewtObjGrowSize(capacity, newSize));
+            if (data == NULL) return NULL;
+
+            memcpy(data, *datap, oldSize);
+        }
+    }
+    else
+    {
+        capacity = NewtMemSize(*datap);
+
+        // 確保済みの容量に収まる間は再確保しない（大きく縮む場合は解放する）
+        if (newSize <= capacity && capacity / 4 <= newSize)
+        {
+            data = *datap;
+        }
+        else
+        {
+            if (capacity < newSize)
+                data = NewtMemRealloc(pool, *datap, NewtObjGrowSize(capacity, newSize));
+            else
+                data = NewtMemRealloc(pool, *datap, newSize);
+
+            if (data == NULL) return NULL;
+        }
+    }
+
+    pool->usesize += newSize;
+    pool->usesize -= oldSize;
 
     if (data != *datap)
         *datap = data;
@@ -624,6 +771,34 @@ newtObjRef NewtObjRealloc(newtPool pool, newtObjRef obj, size_t n)
 }
 
 
+/*------------------------------------------------------------------------*/
+/** データ部を拡張する時に確保するサイズを計算する
+ *
+ * @param capacity	[in] 現在の容量
+ * @param n			[in] 必要なサイズ
+ *
+ * @return			確保するサイズ
+ *
+ * @note			少しずつ追加する場合は容量を 1.5 倍ずつ増やして再確保の回数を抑える。
+ *					一度に大きく拡張する場合は必要なサイズだけ確保する。
+ */
+
+size_t NewtObjGrowSize(size_t capacity, size_t n)
+{
+    size_t	size;
+
+    if (capacity * 2 < n)
+        return n;
+
+    size = capacity + capacity / 2;
+
+    if (size < n)
+        size = n;
+
+    return NewtAlign(size, sizeof(newtRef));
+}
+
+
 /*------------------------------------------------------------------------*/
 /** オブジェクトデータのサイズ変更
  *
@@ -855,29 +1030,6 @@ bool NewtRefIsLiteral(newtRefArg r)
 }
 
 
-/*------------------------------------------------------------------------*/
-/** オブジェクにスウィープフラグが立っているかチェックする
- *
- * @param r			[in] オブジェクト
- * @param mark		[in] マーク
- *
- * @retval			true	スウィープフラグが立っている
- * @retval			false   スウィープフラグが立っていない
- */
-
-bool NewtRefIsSweep(newtRefArg r, bool mark)
-{
-    if (NewtRefIsPointer(r))
-    {
-        newtObjRef	obj;
-
-        obj = NewtRefToPointer(r);
-
-        return NewtObjIsSweep(obj, mark);
-    }
-
-    return true;
-}
 
 
 /*------------------------------------------------------------------------*/
@@ -1606,8 +1758,8 @@ newtRef NewtStringSetLength(newtRefArg r, size_t n)
 
 newtRef NewtMakeInteger(int64_t v)
 {
-	if (-536870912 <= v && v <= 536870911)
-	{   // 30bit 以内の場合
+	if (NewtIntIsImmediate(v))
+	{   // 即値に収まる場合（64bit 環境では 62bit 以内）
 		return NewtMakeInt30(v);
 	} else if (-2147483648 <= v && v <= 2147483647) {
 		return NewtMakeInt32((int32_t) v);
@@ -1650,6 +1802,35 @@ newtRef NewtMakeInt64(int64_t v)
 }
 
 
+/*------------------------------------------------------------------------*/
+/** 30bit に収まらない即値の整数をバイナリの整数オブジェクトにする
+ *
+ * @param r			[in] オブジェクト
+ *
+ * @return			32bit整数または64bit整数オブジェクト（それ以外は r をそのまま返す）
+ *
+ * @note			64bit 環境の即値は 62bit あるので、即値を 30bit で表す
+ *					NSOF やパッケージに書出す前に呼ぶ。
+ */
+
+newtRef NewtBoxWideInteger(newtRefArg r)
+{
+    intptr_t	v;
+
+    if (! NewtRefIsInt30(r))
+        return r;
+
+    v = NewtRefToInt30(r);
+
+    if (NewtIntIs30Bit(v))
+        return r;
+    else if (INT32_MIN <= v && v <= INT32_MAX)
+        return NewtMakeInt32((int32_t) v);
+    else
+        return NewtMakeInt64(v);
+}
+
+
 /*------------------------------------------------------------------------*/
 /** 浮動小数点オブジェクトを作成する
  *
@@ -1944,6 +2125,9 @@ newtObjRef NewtObjSlotsSetLength(newtObjRef obj, size_t n, newtRefArg v)
     size_t	size;
     size_t	len;
 
+    if ((obj->header.h & kNewtObjMapIndexed) != 0)
+        NewtMapIndexForget(obj);
+
     len = NewtObjSlotsLength(obj);
     size = sizeof(newtRef) * n;
     obj = NewtObjResize(obj, size);
@@ -1959,6 +2143,9 @@ newtObjRef NewtObjSlotsSetLength(newtObjRef obj, size_t n, newtRefArg v)
         {
             slots[i] = v;
         }
+
+        if (len < n)
+            NewtGCWriteBarrier(obj, v);
     }
 
     return obj;
@@ -2722,9 +2909,9 @@ int16_t NewtObjectCompare(newtRefArg r1, newtRefArg r2)
     switch (NewtArgsType(r1, r2))
     {
         case kNewtInt30:
-            if ((int32_t)r1 < (int32_t)r2)
+            if ((intptr_t)r1 < (intptr_t)r2)
                 r = -1;
-            else if ((int32_t)r1 > (int32_t)r2)
+            else if ((intptr_t)r1 > (intptr_t)r2)
                 r = 1;
             else
                 r = 0;
@@ -3135,6 +3322,7 @@ newtRef NewtObjSetSlot(newtObjRef obj, newtRefArg slot, newtRefArg v)
 
         slots = NewtObjToSlots(obj);
         slots[i] = v;
+        NewtGCWriteBarrier(obj, v);
     }
     else
     {
@@ -3144,18 +3332,28 @@ newtRef NewtObjSetSlot(newtObjRef obj, newtRefArg slot, newtRefArg v)
         {
             newtRefVar	map;
 
-            map = NewtMakeMap(kNewtRefNIL, 1, NULL);
+            // 同じマップから同じスロットを追加したフレームとはマップを共有する
+            map = NewtMapTransition(obj->as.map, slot);
+
+            if (NewtRefIsNIL(map))
+            {
+                map = NewtMakeMap(kNewtRefNIL, 1, NULL);
 
-            NewtSetArraySlot(map, 0, obj->as.map);
-            NewtSetArraySlot(map, 1, slot);
+                NewtSetArraySlot(map, 0, obj->as.map);
+                NewtSetArraySlot(map, 1, slot);
+            }
 
 			if (NewtObjHasProto(obj))
 				NewtSetMapFlags(map, kNewtMapProto);
 
             obj->as.map = map;
+            NewtGCWriteBarrier(obj, map);
         }
         else
         {
+            // 共有されているマップを直接変更するのでインラインキャッシュを無効にする
+            NEWT_MAPEPOCH++;
+
             if (NewtMapIsSorted(obj->as.map))
             {
                 // マップがソートされている場合...
@@ -3302,6 +3500,8 @@ void NewtObjRemoveFrameSlot(newtObjRef obj, newtRefArg slot)
     {
         size_t	mapIndex;
 
+        NEWT_MAPEPOCH++;
+
         mapIndex = NewtFindArrayIndex(obj->as.map, slot, 1);
 
         if (mapIndex == -1)
@@ -3314,6 +3514,8 @@ void NewtObjRemoveFrameSlot(newtObjRef obj, newtRefArg slot)
             obj->as.map = NcClone(obj->as.map);
         }
 
+        NewtGCWriteBarrier(obj, obj->as.map);
+
         NewtObjRemoveArraySlot(obj, i);
         NewtObjRemoveArraySlot(NewtRefToPointer(obj->as.map), mapIndex);
 
@@ -3481,7 +3683,7 @@ bool NewtFindMapIndex(newtRefArg r, newtRefArg v, size_t * indexP)
             return true;
     }
 
-    i = NewtFindArrayIndex(r, v, 1);
+    i = NewtMapIndexFind(r, v);
 
     if (0 <= i)
     {
@@ -3495,6 +3697,300 @@ bool NewtFindMapIndex(newtRefArg r, newtRefArg v, size_t * indexP)
 }
 
 
+/*------------------------------------------------------------------------*/
+/** マップのスロットの索引を取得する
+ *
+ * @param obj		[in] マップのオブジェクトデータ
+ *
+ * @return			索引（ない場合は NULL）
+ */
+
+newtMapIndex * NewtMapIndexGet(newtObjRef obj)
+{
+    newtMapIndex *	index;
+
+    index = newt_mapindex[NewtMapIndexBucket(obj, NEWT_NUM_MAPINDEXBUCKET)];
+
+    for (; index != NULL; index = index->next)
+    {
+        if (index->map == obj)
+            return index;
+    }
+
+    return NULL;
+}
+
+
+/*------------------------------------------------------------------------*/
+/** マップのスロットの索引を作成する
+ *
+ * @param obj		[in] マップのオブジェクトデータ
+ *
+ * @return			索引（作成できない場合は NULL）
+ *
+ * @note			索引はマップ自身のスロットだけを対象にする（スーパーマップは含まない）
+ */
+
+newtMapIndex * NewtMapIndexBuild(newtObjRef obj)
+{
+    newtMapIndex *	index;
+    newtRef *	slots;
+    size_t		len;
+    uint32_t	size;
+    uint32_t	bits;
+    uint32_t	bucket;
+    uint32_t	j;
+    size_t		i;
+
+    len = NewtObjSlotsLength(obj);
+
+    for (bits = 1, size = 2; size < len * 2; bits++, size *= 2)
+        ;
+
+    index = (newtMapIndex *)malloc(sizeof(newtMapIndex) + sizeof(newtMapIndexEntry) * size);
+
+    if (index == NULL)
+        return NULL;
+
+    index->map = obj;
+    index->shift = 32 - bits;
+
+    for (j = 0; j < size; j++)
+    {
+        index->entries[j].slot = kNewtRefUnbind;
+    }
+
+    slots = NewtObjToSlots(obj);
+
+    for (i = 1; i < len; i++)
+    {
+        for (j = NewtMapIndexHash(slots[i], index->shift);
+            index->entries[j].slot != kNewtRefUnbind;
+            j = (j + 1) & (size - 1))
+        {
+            if (index->entries[j].slot == slots[i])
+                break;
+        }
+
+        // 同じスロットが複数ある場合は先頭を使う
+        if (index->entries[j].slot == kNewtRefUnbind)
+        {
+            index->entries[j].slot = slots[i];
+            index->entries[j].index = (uint32_t)i;
+        }
+    }
+
+    bucket = NewtMapIndexBucket(obj, NEWT_NUM_MAPINDEXBUCKET);
+    index->next = newt_mapindex[bucket];
+    newt_mapindex[bucket] = index;
+
+    obj->header.h |= kNewtObjMapIndexed;
+
+    return index;
+}
+
+
+/*------------------------------------------------------------------------*/
+/** マップのスロットの索引を破棄する
+ *
+ * @param obj		[in] マップのオブジェクトデータ
+ *
+ * @return			なし
+ *
+ * @note			索引を持つマップを変更または解放する前に呼出すこと
+ */
+
+void NewtMapIndexForget(newtObjRef obj)
+{
+    newtMapIndex **	indexp;
+    newtMapIndex *	index;
+
+    indexp = &newt_mapindex[NewtMapIndexBucket(obj, NEWT_NUM_MAPINDEXBUCKET)];
+
+    for (; *indexp != NULL; indexp = &(*indexp)->next)
+    {
+        index = *indexp;
+
+        if (index->map == obj)
+        {
+            *indexp = index->next;
+            free(index);
+            break;
+        }
+    }
+
+    obj->header.h &= ~ (uint32_t)kNewtObjMapIndexed;
+}
+
+
+/*------------------------------------------------------------------------*/
+/** マップ自身のスロットから位置を検索する
+ *
+ * @param r			[in] マップオブジェクト
+ * @param v			[in] スロットシンボル
+ *
+ * @retval			位置		成功
+ * @retval			-1		失敗
+ *
+ * @note			NEWT_MAPINDEX_MINSLOTS を超える大きなマップは最初の検索で索引を作る
+ */
+
+ssize_t NewtMapIndexFind(newtRefArg r, newtRefArg v)
+{
+    newtMapIndex *	index = NULL;
+    newtObjRef	obj;
+    uint32_t	mask;
+    uint32_t	j;
+
+    obj = NewtRefToPointer(r);
+
+    if ((obj->header.h & kNewtObjMapIndexed) != 0)
+        index = NewtMapIndexGet(obj);
+    else if (NEWT_MAPINDEX_MINSLOTS < NewtObjSlotsLength(obj))
+        index = NewtMapIndexBuild(obj);
+
+    if (index == NULL)
+        return NewtFindArrayIndex(r, v, 1);
+
+    mask = (UINT32_C(1) << (32 - index->shift)) - 1;
+
+    for (j = NewtMapIndexHash(v, index->shift);
+        index->entries[j].slot != kNewtRefUnbind;
+        j = (j + 1) & mask)
+    {
+        if (index->entries[j].slot == v)
+            return index->entries[j].index;
+    }
+
+    return -1;
+}
+
+
+/*------------------------------------------------------------------------*/
+/** リテラルのマップにスロットを追加した遷移先のマップを取得する
+ *
+ * @param map		[in] 元のマップ（リテラル）
+ * @param slot		[in] 追加するスロットシンボル
+ *
+ * @retval			マップ		遷移先のマップ（リテラル）
+ * @retval			NIL			遷移先を作らない場合
+ *
+ * @note			同じマップに同じスロットを追加したフレームは同じマップを共有する。
+ *					遷移先のマップはリテラルなので変更されず、GC でも解放されない。
+ *					遷移で追加したスロットが NEWT_MAPTRANSITION_MAXSLOTS を超える場合や
+ *					遷移先の数が NEWT_NUM_MAPTRANSITIONS に達した場合は
+ *					今まで通りフレーム専用のマップを作る（解放されないマップが増え続けないように）。
+ */
+
+newtRef NewtMapTransition(newtRefArg map, newtRefArg slot)
+{
+    newtMapTransition *	trans;
+    newtObjRef	from;
+    newtObjRef	to;
+    newtRefVar	newMap;
+    newtRefVar	superMap;
+    newtRef *	src;
+    newtRef *	dst;
+    size_t		own = 0;
+    size_t		i;
+    uint32_t	bucket;
+
+    from = NewtRefToPointer(map);
+    bucket = NewtMapTransitionBucket(from, slot, NEWT_NUM_MAPTRANSITIONBUCKET);
+
+    for (trans = newt_maptransition[bucket]; trans != NULL; trans = trans->next)
+    {
+        if (trans->from == from && trans->slot == slot)
+            return NewtMakePointer(trans->to);
+    }
+
+    if ((from->header.h & kNewtObjMapShared) != 0)
+    {
+        // 遷移先のマップからさらに遷移する場合は元のスーパーマップの下に平らに並べる
+        own = NewtObjSlotsLength(from) - 1;
+        superMap = NewtGetArraySlot(map, 0);
+    }
+    else
+    {
+        superMap = map;
+    }
+
+    if (NEWT_MAPTRANSITION_MAXSLOTS <= own || NEWT_NUM_MAPTRANSITIONS <= newt_num_maptransitions)
+        return kNewtRefNIL;
+
+    trans = (newtMapTransition *)malloc(sizeof(newtMapTransition));
+
+    if (trans == NULL)
+        return kNewtRefNIL;
+
+    newMap = NewtMakeMap(superMap, own + 1, NULL);
+
+    src = NewtObjToSlots(from);
+    dst = NewtRefToSlots(newMap);
+
+    for (i = 1; i <= own; i++)
+    {
+        dst[i] = src[i];
+    }
+
+    dst[own + 1] = slot;
+
+    newMap = NewtPackLiteral(newMap);
+    to = NewtRefToPointer(newMap);
+    to->header.h |= kNewtObjMapShared;
+
+    trans->from = from;
+    trans->slot = slot;
+    trans->to = to;
+    trans->next = newt_maptransition[bucket];
+    newt_maptransition[bucket] = trans;
+    newt_num_maptransitions++;
+
+    return newMap;
+}
+
+
+/*------------------------------------------------------------------------*/
+/** マップの索引と遷移先のキャッシュを全て解放する
+ *
+ * @return			なし
+ *
+ * @note			メモリプールを解放する時に呼出す
+ */
+
+void NewtMapCacheFree(void)
+{
+    newtMapIndex *	index;
+    newtMapTransition *	trans;
+    void *	next;
+    int		i;
+
+    for (i = 0; i < NEWT_NUM_MAPINDEXBUCKET; i++)
+    {
+        for (index = newt_mapindex[i]; index != NULL; index = next)
+        {
+            next = index->next;
+            free(index);
+        }
+
+        newt_mapindex[i] = NULL;
+    }
+
+    for (i = 0; i < NEWT_NUM_MAPTRANSITIONBUCKET; i++)
+    {
+        for (trans = newt_maptransition[i]; trans != NULL; trans = next)
+        {
+            next = trans->next;
+            free(trans);
+        }
+
+        newt_maptransition[i] = NULL;
+    }
+
+    newt_num_maptransitions = 0;
+}
+
+
 /*------------------------------------------------------------------------*/
 /** フレームオブジェクトのマップを取得
  *
@@ -3862,11 +4358,18 @@ newtRef NewtSlotsSetSlot(newtRefArg r, size_t p, newtRefArg v)
 
     if (p < len)
     {
+        newtObjRef	obj;
         newtRef *	slots;
     
-        slots = NewtRefToSlots(r);
+        obj = NewtRefToPointer(r);
+
+        if ((obj->header.h & kNewtObjMapIndexed) != 0)
+            NewtMapIndexForget(obj);
+
+        slots = NewtObjToSlots(obj);
         NewtGCHint(r[p], -1);
         slots[p] = v;
+        NewtGCWriteBarrier(obj, v);
     }
     else
     {
@@ -3906,6 +4409,7 @@ newtRef NewtSlotsInsertSlot(newtRefArg r, size_t p, newtRefArg v)
         memmove(slots + p + 1, slots + p, (len - p) * sizeof(newtRef));
 
     slots[p] = v;
+    NewtGCWriteBarrier(obj, v);
 
     return v;
 }
@@ -4540,6 +5044,8 @@ newtRef NewtStrCat(newtRefArg r, const char * s)
  * @param slen		[in] 追加する文字列の長さ
  *
  * @return			文字列オブジェクト
+ *
+ * @note			終端の直前まで文字が詰まっている場合は strlen で長さを数えない
  */
 
 newtRef NewtStrCat2(newtRefArg r, const char * s, size_t slen)
@@ -4550,10 +5056,19 @@ newtRef NewtStrCat2(newtRefArg r, const char * s, size_t slen)
 
     if (obj != NULL)
     {
+        const char *	str;
+        size_t		size;
         size_t		tgtlen;
         size_t		dstlen;
 
-		tgtlen = NewtObjStringLength(obj);
+		str = NewtObjToString(obj);
+		size = NewtObjSize(obj);
+
+		if (1 < size && str[size - 1] == '\0' && str[size - 2] != '\0')
+			tgtlen = size - 1;
+		else
+			tgtlen = NewtObjStringLength(obj);
+
 		dstlen = tgtlen + slen;
 
 		if (NewtObjSize(obj) <= dstlen)
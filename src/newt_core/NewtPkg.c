@@ -183,7 +183,7 @@ pkgNewtRef PkgPartGetPrecedent(pkg_stream_t *pkg, newtRefArg ref)
 {
 	ssize_t ix = PkgArraySearch(pkg->precedents, ref);
 	if (ix>=0) {
-		return (pkgNewtRef) NewtGetArraySlot(pkg->instances, ix);
+		return (pkgNewtRef) NewtRefToInteger(NewtGetArraySlot(pkg->instances, ix));
 	} else {
 		return kNewtRefUnbind;
 	}
@@ -201,7 +201,8 @@ void PkgPartSetPrecedent(pkg_stream_t *pkg, newtRefArg ref, pkgNewtRef val)
 	size_t n = NewtArrayLength(pkg->instances);
 	// the code below gets horribly slow and fragments memory
 	// we should consider implementing a binary search tree at some point
-	NewtInsertArraySlot(pkg->instances, n, val);
+	// package refs are not heap objects, so keep them as integers in the array
+	NewtInsertArraySlot(pkg->instances, n, NewtMakeInteger(val));
 	NewtInsertArraySlot(pkg->precedents, n, ref);
 }
 
@@ -464,7 +465,7 @@ pkgNewtRef PkgWriteBinary(pkg_stream_t *pkg, newtRefArg obj)
 	// symbols have special handling to avoid recursion
 	if (NewtRefIsSymbol(obj)) {
 		PkgWriteU32(pkg, dst+8, kNewtSymbolClass);
-		PkgWriteU32(pkg, dst+12, NewtRefToHash(obj)); // make sure the hash has the right endianness
+		PkgWriteU32(pkg, dst+12, NewtSymbolNewtonHash(NewtSymbolGetName(obj))); // Newton OS hash, with the right endianness
 		PkgWriteData(pkg, dst+16, (uint8_t*)NewtSymbolGetName(obj), size-16);
 		return (pkgNewtRef) NewtMakePointer(dst);
 	}
@@ -476,9 +477,8 @@ pkgNewtRef PkgWriteBinary(pkg_stream_t *pkg, newtRefArg obj)
 
 	// copy the binary data over
 	if (klass==NSSYM0(int32)) {
-		uint32_t *s = (uint32_t*)data;
-		uint32_t  v = htonl(*s);
-		PkgWriteData(pkg, dst+12, &v, sizeof(v));
+		// int32 binaries are already kept in big endian (see NewtMakeInt32)
+		PkgWriteData(pkg, dst+12, data, sizeof(uint32_t));
 	} else if (klass==NSSYM0(real)) {
 		// this code fails miserably if 'double' is not an 8-byte IEEE value!
 		double *s = (double*)data;
@@ -506,6 +506,9 @@ pkgNewtRef PkgWriteObject(pkg_stream_t *pkg, newtRefArg obj)
 
 	// FIXME add handling named magic pointers here
 	if (NewtRefIsImmediate(obj)) {
+		// integers wider than 30 bits (64 bit builds) are written as binaries
+		if (NewtBoxWideInteger(obj) != obj)
+			return PkgWriteObject(pkg, NewtBoxWideInteger(obj));
 		// immediates have the same form in memory as in packages
 		// immediates include magic pointers
 		return (uint32_t) obj;
@@ -762,7 +765,7 @@ newtRef PkgReadRef(pkg_stream_t *pkg, uint32_t p_obj)
 
 	switch (ref&3) {
 	case 0: // integer
-		result = NSINT(ref>>2);
+		result = NSINT((int32_t)ref>>2);
 		break;
 	case 1: // pointer
 		result = PkgReadObject(pkg, ref&~3);
@@ -813,6 +816,10 @@ newtRef PkgReadBinaryObject(pkg_stream_t *pkg, uint32_t p_obj)
 	} else if (klass==NSSYM0(int32)) {
 		uint32_t v = PkgReadU32(pkg->data + p_obj + 12);
 		result = NewtMakeInt32(v);
+	} else if (klass==NSSYM0(int64)) {
+		uint64_t v = ((uint64_t)PkgReadU32(pkg->data + p_obj + 12) << 32)
+			| PkgReadU32(pkg->data + p_obj + 16);
+		result = NewtMakeInt64((int64_t)v);
 	} else if (klass==NSSYM0(real)) {
 		double *v = (double*)(pkg->data + p_obj + 12);
 		result = NewtMakeReal(ntohd(*v));
@@ -11,8 +11,10 @@
 
 
 /* ヘッダファイル */
+#include <stddef.h>
 #include <stdlib.h>
 #include <stdarg.h>
+#include <string.h>
 
 #include "NewtErrs.h"
 #include "NewtVM.h"
@@ -30,12 +32,253 @@
 #include "NewtPkg.h"
 
 
+// x86-64 では --jit 指定時にホットな関数をネイティブコードにコンパイルする
+#if (defined(__x86_64__) || defined(__amd64__)) && (defined(__linux__) || defined(__APPLE__)) && ! defined(__NEWT_NO_JIT__)
+	#define __NEWT_JIT__
+	#include <sys/mman.h>
+#endif
+
+
 /* 型宣言 */
 typedef void(*instruction_t)(int16_t b);			///< 命令セット
 typedef void(*simple_instruction_t)(void);			///< シンプル命令
 typedef newtRef(*nvm_func_t)();						///< ネイティブ関数
 
 
+/// 例外ハンドラ表の行（関数オブジェクトの handlers スロットから作成する）
+typedef struct {
+    uint32_t	start;					///< TRY文の先頭
+    uint32_t	body;					///< 実行文の先頭（new-handlers の次の位置）
+    uint32_t	end;					///< 実行文の終わりの pop-handlers の位置
+    uint32_t	exit;					///< onexception の終わりの pop-handlers の位置
+    uint32_t	depth;					///< 例外ハンドラの開始時のスタックの深さ
+    newtRefVar	sym;					///< 例外シンボル
+    uint32_t	pc;						///< 例外ハンドラの位置
+} vm_handler_t;
+
+
+/// 前処理済み命令キャッシュのエントリ
+typedef struct vm_code_t {
+    newtRefVar	instr;					///< instructions オブジェクト
+    uint8_t *	bc;						///< 前処理したバイトコード
+    size_t		bclen;					///< 前処理したバイトコードの長さ
+    vm_inst_t *	insts;					///< 前処理済み命令
+    uint32_t	hotness;				///< 呼出しとループの回数（JIT コンパイルの判定）
+    struct vm_jit_t *	jit;			///< JIT コンパイルしたネイティブコード
+    vm_handler_t *	handlers;			///< 例外ハンドラ表（NULL なら new-handlers を実行する）
+    uint32_t	nhandlers;				///< 例外ハンドラ表の行数
+    bool		checked;				///< 関数オブジェクトの例外ハンドラ表を調べたか
+    struct vm_code_t *	next;			///< 同じハッシュ値のエントリのチェイン
+} vm_code_t;
+
+
+/// JIT コンパイルしたネイティブコード
+typedef struct vm_jit_t {
+    uint8_t *	code;					///< ネイティブコード（先頭は入口のトランポリン）
+    size_t		size;					///< ネイティブコードの大きさ
+    void **		entry;					///< 命令位置ごとの入口（NULL なら入口なし）
+} vm_jit_t;
+
+
+#ifdef __NEWT_JIT__
+
+/// ネイティブコードの入口（トランポリンに入口のアドレスを渡して呼出す）
+typedef void(*vm_jitentry_t)(void * entry);
+
+
+/// JIT コンパイルの作業領域
+typedef struct {
+    uint8_t *	buf;					///< 出力するネイティブコード
+    size_t		len;					///< 出力した長さ
+    size_t		cap;					///< 確保した長さ
+    bool		failed;					///< メモリが確保できなかった
+    uint32_t *	offsets;				///< 命令位置ごとのネイティブコードの位置
+    bool *		starts;					///< 命令の先頭か？
+    uint32_t *	fixups;					///< 命令位置への分岐（書換える位置と分岐先の組）
+    uint32_t	nfixups;				///< 命令位置への分岐の数
+    uint32_t	exit;					///< インタプリタに戻るコードの位置
+} vm_jitbuf_t;
+
+#endif /* __NEWT_JIT__ */
+
+
+/// インラインキャッシュに記録する探索フレームの情報
+typedef struct {
+    newtRefVar	map;					///< フレームのマップ
+    int32_t		slot;					///< 探索するスロットの位置（-1 はスロットなし）
+    int32_t		link;					///< 次にたどるスロット（_proto または _nextArgFrame）の位置
+    int32_t		parent;					///< _parent スロットの位置
+} vm_icframe_t;
+
+
+/// インラインキャッシュのエントリ
+typedef struct {
+    uint32_t		epoch;				///< 記録したときのマップの変更回数
+    newtRefVar		name;				///< 検索したシンボル（get-path では実行時に変わる）
+    uint16_t		depth;				///< 記録したフレームの数（0 は未使用）
+    vm_icframe_t	frames[NEWT_NUM_ICDEPTH];	///< 探索したフレーム
+} vm_icentry_t;
+
+
+/// インラインキャッシュ（命令ごとに作成する）
+typedef struct vm_ic_t {
+    vm_icentry_t	entries[NEWT_NUM_ICENTRIES];	///< エントリ（多相）
+    uint16_t		victim;				///< 次に置換えるエントリ
+    struct vm_ic_t *	next;			///< インラインキャッシュのチェイン
+    struct vm_ic_t **	prevp;			///< チェインの前の next へのポインタ
+} vm_ic_t;
+
+
+/// インラインキャッシュの探索状態
+typedef struct {
+    vm_icentry_t *	entry;				///< 記録または検証するエントリ
+    bool			fill;				///< true なら記録、false なら検証
+    bool			failed;				///< キャッシュできない、または検証に失敗した
+    uint16_t		pos;				///< 次に記録または検証するフレームの位置
+} vm_icwalk_t;
+
+
+/* 定数 */
+
+/// 前処理済み命令コード
+enum {
+    // シンプル命令
+    kVMOpPop				= 0,	// pop
+    kVMOpDup,						// dup
+    kVMOpReturn,					// return
+    kVMOpPushSelf,					// push-self
+    kVMOpSetLexScope,				// set-lex-scope
+    kVMOpIterNext,					// iter-next
+    kVMOpIterDone,					// iter-done
+    kVMOpPopHandlers,				// pop-handlers
+
+    // 関数命令
+    kVMOpAdd,						// add
+    kVMOpSubtract,					// subtract
+    kVMOpAref,						// aref
+    kVMOpSetAref,					// set-aref
+    kVMOpEquals,					// equals
+    kVMOpNot,						// not
+    kVMOpNotEqual,					// not-equals
+    kVMOpMultiply,					// multiply
+    kVMOpDivide,					// divide
+    kVMOpDiv,						// div
+    kVMOpLessThan,					// less-than
+    kVMOpGreaterThan,				// greater-than
+    kVMOpGreaterOrEqual,			// greater-or-equal
+    kVMOpLessOrEqual,				// less-or-equal
+    kVMOpBitAnd,					// bit-and
+    kVMOpBitOr,						// bit-or
+    kVMOpBitNot,					// bit-not
+    kVMOpNewIterator,				// new-iterator
+    kVMOpLength,					// length
+    kVMOpClone,						// clone
+    kVMOpSetClass,					// set-class
+    kVMOpAddArraySlot,				// add-array-slot
+    kVMOpStringer,					// stringer
+    kVMOpHasPath,					// has-path
+    kVMOpClassOf,					// class-of
+
+    // 命令セット（is_instructions の 03x 〜 27x と同じ並び）
+    kVMOpPush,						// push
+    kVMOpPushConstant,				// push-constant
+    kVMOpCall,						// call
+    kVMOpInvoke,					// invoke
+    kVMOpSend,						// send
+    kVMOpSendIfDefined,				// send-if-defined
+    kVMOpResend,					// resend
+    kVMOpResendIfDefined,			// resend-if-defined
+    kVMOpBranch,					// branch
+    kVMOpBranchIfTrue,				// branch-if-true
+    kVMOpBranchIfFalse,				// branch-if-false
+    kVMOpFindVar,					// find-var
+    kVMOpGetVar,					// get-var
+    kVMOpMakeFrame,					// make-frame
+    kVMOpMakeArray,					// make-array
+    kVMOpGetPath,					// get-path
+    kVMOpSetPath,					// set-path
+    kVMOpSetVar,					// set-var
+    kVMOpFindAndSetVar,				// find-and-set-var
+    kVMOpIncrVar,					// incr-var
+    kVMOpBranchIfLoopNotDone,		// branch-if-loop-not-done
+    kVMOpNewHandlers,				// new-handlers
+
+    // 型特化命令（クイックニングで関数命令から書き換える）
+    kVMOpAddInt,					// add（30bit整数）
+    kVMOpSubtractInt,				// subtract（30bit整数）
+    kVMOpMultiplyInt,				// multiply（30bit整数）
+    kVMOpEqualsInt,					// equals（30bit整数）
+    kVMOpNotEqualInt,				// not-equals（30bit整数）
+    kVMOpLessThanInt,				// less-than（30bit整数）
+    kVMOpGreaterThanInt,			// greater-than（30bit整数）
+    kVMOpGreaterOrEqualInt,			// greater-or-equal（30bit整数）
+    kVMOpLessOrEqualInt,			// less-or-equal（30bit整数）
+    kVMOpAddReal,					// add（浮動小数点）
+    kVMOpSubtractReal,				// subtract（浮動小数点）
+    kVMOpMultiplyReal,				// multiply（浮動小数点）
+    kVMOpDivideReal,				// divide（浮動小数点）
+    kVMOpLessThanReal,				// less-than（浮動小数点）
+    kVMOpGreaterThanReal,			// greater-than（浮動小数点）
+    kVMOpGreaterOrEqualReal,		// greater-or-equal（浮動小数点）
+    kVMOpLessOrEqualReal,			// less-or-equal（浮動小数点）
+
+    // 複合命令（前処理で連続する命令をまとめる）
+    kVMOpGetVarGetVar,				// get-var + get-var
+    kVMOpGetVarPushConstant,		// get-var + push-constant
+    kVMOpSetVarGetVar,				// set-var + get-var
+    kVMOpIncrVarLoop,				// incr-var + get-var + branch-if-loop-not-done
+
+    // 例外ハンドラ表（表のある関数の TRY文の命令を書き換える）
+    kVMOpTryEnter,					// TRY文の先頭（new-handlers の次まで読み飛ばす）
+    kVMOpTryExit,					// pop-handlers（現在の例外をクリアする）
+
+    // その他
+    kVMOpGeneric,					// is_instructions テーブル経由で実行（不正な命令など）
+    kVMOpNop,						// 何もしない（範囲外の命令）
+
+    //
+    kVMOpLen						///< 前処理済み命令コードの数
+};
+
+
+/// 関数オブジェクトの記述子に位置を記録するスロット
+enum {
+    kVMFnClass			= 0,		///< class
+    kVMFnInstructions,				///< instructions
+    kVMFnLiterals,					///< literals
+    kVMFnArgFrame,					///< argFrame
+    kVMFnNumArgs,					///< numArgs
+    kVMFnIndefinite,				///< indefinite
+    kVMFnFuncPtr,					///< funcPtr（ネイティブ関数）
+
+    //
+    kVMFnLen						///< 記録するスロットの数
+};
+
+
+/// 関数オブジェクトの記述子（呼出しのたびに参照するスロットの位置を記録する）
+typedef struct vm_fn_t {
+    newtRefVar	fn;						///< 関数オブジェクト
+    newtRefVar	map;					///< 記録したときのマップ
+    uint32_t	epoch;					///< 記録したときのマップの変更回数
+    int32_t		slots[kVMFnLen];		///< スロットの位置（-1 はスロットなし）
+    newtRefVar	klass;					///< type を求めたときのクラス
+    int			type;					///< 関数オブジェクトのタイプ
+    struct vm_fn_t *	next;			///< 同じハッシュ値のエントリのチェイン
+} vm_fn_t;
+
+
+/// インラインキャッシュの種類
+enum {
+    kVMICSend			= 0,		///< send, send-if-defined
+    kVMICFindVar,					///< find-var
+    kVMICGetPath,					///< get-path
+
+    //
+    kVMICLen						///< インラインキャッシュの種類の数
+};
+
+
 /* グローバル変数 */
 vm_env_t	vm_env;
 
@@ -48,6 +291,8 @@ vm_env_t	vm_env;
 /* マクロ */
 
 #define START_LOCALARGS		3										///< ローカル引数の開始位置
+#define NO_BP				((uint32_t)-1)							///< 活性レコードがスタック上にない
+#define MAX_NATIVEARGS		9										///< ネイティブ関数に渡せる引数の数（rcvr と不定長引数の配列を除く）
 
 
 #define BC					(vm_env.bc)								///< バイトコード
@@ -58,6 +303,7 @@ vm_env_t	vm_env;
 #define EXCPSTACK			((vm_excp_t *)vm_env.excpstack.stackp)  ///< 例外スタック
 #define EXCPSP				(vm_env.excpstack.sp)					///< 例外スタックのスタックポインタ
 #define CURREXCP			(vm_env.currexcp)						///< 現在の例外
+#define EXCPTABLE			(vm_env.excptable)						///< 現在の例外を例外ハンドラ表で捕まえたか
 
 #define	REG					(vm_env.reg)							///< レジスタ
 #define STACK				((newtRef *)vm_env.stack.stackp)		///< スタック
@@ -66,9 +312,21 @@ vm_env_t	vm_env;
 #define	PC					((REG).pc)								///< プログラムカウンタ
 #define	SP					((REG).sp)								///< スタックポインタ
 #define	LOCALS				((REG).locals)							///< ローカルフレーム
+#define	BP					((REG).bp)								///< 活性レコードの開始位置
+#define	BASE				((REG).base)							///< 関数の実行開始時のスタックポインタ
 #define	RCVR				((REG).rcvr)							///< レシーバ
 #define	IMPL				((REG).impl)							///< インプリメンタ
 
+#define INSTS				(vm_env.insts)							///< 前処理済み命令
+#define CODE				(vm_env.code)							///< 前処理済み命令キャッシュのエントリ
+#define JIT					(vm_env.jit)							///< JIT コンパイルしたネイティブコード
+
+
+// computed goto（GCC 拡張）が使える場合はダイレクトスレッデッドコードで実行する
+#if defined(__GNUC__) && ! defined(__NEWT_NO_COMPUTED_GOTO__)
+	#define __NEWT_COMPUTED_GOTO__
+#endif
+
 
 #if 0
 #pragma mark -
@@ -81,6 +339,57 @@ static newtErr		NVMGetExceptionErrCode(newtRefArg r, bool dump);
 static newtRef		NVMMakeExceptionFrame(newtRefArg name, newtRefArg data);
 static void			NVMClearCurrException(void);
 
+static vm_inst_t *	NVMDecodeCode(uint8_t * bc, size_t len);
+static void			NVMFuseCode(vm_inst_t * insts, size_t len);
+static void			NVMFreeCode(vm_inst_t * insts, size_t len);
+static vm_code_t *	NVMLookupCode(newtRefArg instr);
+static void			NVMCleanCodeCache(void);
+static void			NVMApplyHandlers(vm_code_t * code, newtRefArg fn);
+static vm_handler_t *	vm_handler_lookup(vm_code_t * code, uint32_t pc, newtRefArg name);
+static vm_code_t *	vm_frame_code(newtRefArg fn);
+static vm_fn_t *	vm_fn_lookup(newtRefArg fn);
+static newtRef		vm_fn_get(newtRefArg fn, uint8_t kind, newtRefArg sym);
+static int			vm_fn_type(newtRefArg fn);
+static void			vm_fn_sweep(void);
+static void			vm_fn_clean(void);
+static vm_jit_t *	NVMJITHot(vm_code_t * code);
+static void			NVMJITFree(vm_code_t * code);
+#ifdef __NEWT_JIT__
+static vm_jit_t *	NVMJITCompile(vm_code_t * code);
+static void			jit_emit(vm_jitbuf_t * j, const uint8_t * p, size_t n);
+static void			jit_u32(vm_jitbuf_t * j, uint32_t v);
+static void			jit_u64(vm_jitbuf_t * j, uint64_t v);
+static void			jit_mem(vm_jitbuf_t * j, uint8_t rex, uint8_t opc, uint8_t reg, size_t disp);
+static uint32_t		jit_jcc(vm_jitbuf_t * j, uint8_t cc);
+static void			jit_jcc_to(vm_jitbuf_t * j, uint8_t cc, uint32_t off);
+static void			jit_label(vm_jitbuf_t * j, uint32_t pos);
+static void			jit_fixup(vm_jitbuf_t * j, uint8_t cc, uint32_t pc);
+static void			jit_set_pc(vm_jitbuf_t * j, uint32_t pc);
+static void			jit_goto(vm_jitbuf_t * j, uint32_t pc, size_t len);
+static void			jit_generic(vm_jitbuf_t * j, vm_inst_t * insts, uint32_t pc, uint32_t npc, uint32_t target, size_t len);
+static void			jit_freq_func(int16_t b);
+static void			jit_try_exit(int16_t b);
+static bool			jit_inline(vm_jitbuf_t * j, vm_inst_t * inst, uint32_t npc, size_t len, uint32_t * slow, uint32_t * nslow);
+#endif
+static void			vm_quicken(vm_inst_t * inst);
+static void			vm_dequicken(vm_inst_t * inst);
+static void			vm_quick_int30(vm_inst_t * inst);
+static void			vm_quick_real(vm_inst_t * inst);
+static void			vm_for_loop(vm_inst_t * inst);
+static bool			vm_real_arg(newtRefArg r, double * v);
+
+static vm_ic_t *	ic_get(void);
+static void			ic_free(vm_ic_t * ic);
+static void			ic_sweep(void);
+static int32_t		ic_slot_index(newtRefArg frame, newtRefArg slot);
+static newtRef		ic_link(newtRefArg frame, int32_t index);
+static vm_icframe_t *	ic_visit(vm_icwalk_t * w, newtRefArg frame, newtRefArg name, newtRefArg link);
+static newtRef		ic_lexical_lookup(vm_icwalk_t * w, newtRefArg start, newtRefArg name);
+static newtRef		ic_locals_lookup(vm_icwalk_t * w, newtRefArg name);
+static newtRef		ic_full_lookup_frame(vm_icwalk_t * w, newtRefArg start, newtRefArg name, int32_t * indexP);
+static bool			ic_walk(vm_icwalk_t * w, int kind, newtRefArg r, newtRefArg name, newtRefVar * implP, newtRefVar * valueP);
+static bool			ic_lookup(int kind, newtRefArg r, newtRefArg name, newtRefVar * implP, newtRefVar * valueP);
+
 static void			NVMSetFn(newtRefArg fn);
 static void			NVMNoStackFrameForReturn(void);
 
@@ -88,10 +397,11 @@ static void			reg_rewind(int32_t sp);
 static void			reg_pop(void);
 static void			reg_push(int32_t sp);
 static void			reg_save(int32_t sp);
+static bool			reg_tail(void);
+static void			reg_reuse(int16_t numArgs);
 
 static newtRef		stk_pop0(void);
 static newtRef		stk_pop(void);
-static void			stk_pop_n(int32_t n, newtRef a[]);
 static void			stk_remove(uint16_t n);
 static newtRef		stk_top(void);
 static void			stk_push(newtRefArg value);
@@ -106,21 +416,30 @@ static void			excp_pop_handlers(void);
 static newtRef		liter_get(int16_t n);
 
 static newtRef		iter_new(newtRefArg r, newtRefArg deeply);
+static newtRef		iter_slot(newtRefArg r, intptr_t pos);
 static void			iter_next(newtRefArg iter);
 static bool			iter_done(newtRefArg iter);
+static void			iter_free(newtRefArg iter);
+static void			iter_sweep(void);
 
 static newtRef		NVMMakeArgsArray(uint16_t numArgs);
 static newtRef		NVMMakeFastFunctionArgFrame(newtRefArg fn);
 static void			NVMBindArgs(uint16_t numArgs);
+static bool			NVMCanPushLocals(newtRefArg af);
+static void			NVMPushLocals(newtRefArg af, int16_t numArgs);
+static newtRef		NVMMakeLocalsFrame(void);
+static newtRef		NVMLocalsFrame(void);
+static int32_t		NVMLocalsIndex(newtRefArg name);
+static newtRef		NVMLexicalLookup(newtRefArg name);
+static bool			NVMLexicalAssignment(newtRefArg name, newtRefArg v);
 static void			NVMThrowBC(newtErr err, newtRefArg value, int16_t pop, bool push);
 static newtErr		NVMFuncCheck(newtRefArg fn, int16_t numArgs);
-static void			NVMCallNativeFn(newtRefArg fn, int16_t numArgs);
-static void			NVMCallNativeFunc(newtRefArg fn, newtRefArg rcvr, int16_t numArgs);
-static void			NVMFuncCall(newtRefArg fn, int16_t numArgs);
-static void			NVMMessageSend(newtRefArg impl, newtRefArg receiver, newtRefArg fn, int16_t numArgs);
+static void			NVMCallNative(newtRefArg fn, int type, newtRefArg rcvr, int16_t numArgs);
+static void			NVMFuncCall(newtRefArg fn, int16_t numArgs, bool tail);
+static void			NVMMessageSend(newtRefArg impl, newtRefArg receiver, newtRefArg fn, int16_t numArgs, bool tail);
 
-static newtRef		vm_send(int16_t b, newtErr * errP);
-static newtRef		vm_resend(int16_t b, newtErr * errP);
+static newtRef		vm_send(int16_t b, newtErr * errP, bool tail);
+static newtRef		vm_resend(int16_t b, newtErr * errP, bool tail);
 
 static void			si_pop(void);
 static void			si_dup(void);
@@ -130,6 +449,7 @@ static void			si_set_lex_scope(void);
 static void			si_iternext(void);
 static void			si_iterdone(void);
 static void			si_pop_handlers(void);
+static void			si_try_exit(void);
 
 static void			fn_add(void);
 static void			fn_subtract(void);
@@ -201,6 +521,9 @@ static void			NVMInitGlobalFns(void);
 
 static void			NVMInitGlobalVars(void);
 
+static void			NVMDecodeLoop(uint32_t callsp);
+static void			NVMThreadedLoop(uint32_t callsp);
+static void			NVMJITLoop(uint32_t callsp);
 static void			NVMLoop(uint32_t callsp);
 
 static newtRef		NVMInterpret2(nps_syntax_node_t * stree, uint32_t numStree, newtErr * errP);
@@ -211,6 +534,35 @@ static newtRef		NVMMessageSendWithValist(newtRefArg impl, newtRefArg receiver, n
 
 /* ローカル変数 */
 
+/// 前処理済み命令キャッシュ
+static vm_code_t *		vm_codecache[NEWT_NUM_CODECACHE];
+
+/// 関数オブジェクトの記述子キャッシュ
+static vm_fn_t *		vm_fncache[NEWT_NUM_FNCACHE];
+
+/// 最後に参照した関数オブジェクトの記述子
+static vm_fn_t *		vm_fnlast = NULL;
+
+/// 終了したイテレータオブジェクト（new-iterator で再利用する）
+static newtRefVar		vm_iterpool[NEWT_NUM_ITERPOOL];
+/// vm_iterpool に取っておいたイテレータオブジェクトの数
+static uint32_t			vm_iternums = 0;
+
+/// 前処理済み命令コードごとのハンドラのアドレス（computed goto 使用時）
+static const void **	vm_handlers = NULL;
+
+/// 実行中の命令
+static vm_inst_t *		vm_site = NULL;
+
+/// 作成したインラインキャッシュのチェイン
+static vm_ic_t *		vm_iclist = NULL;
+
+/// インラインキャッシュのヒット数
+static uint32_t			vm_ic_hits[kVMICLen];
+
+/// インラインキャッシュのミス数
+static uint32_t			vm_ic_misses[kVMICLen];
+
 /// シンプル命令テーブル
 static simple_instruction_t	simple_instructions[] =
             {
@@ -400,6 +752,17 @@ newtRef NVMCurrentImplementor(void)
 }
 
 
+/*------------------------------------------------------------------------*/
+/** 呼出しスタックの深さを取得する
+ *
+ * @return		呼出しスタックの深さ（整数オブジェクト）
+ */
+newtRef NVMCallStackDepth(void)
+{
+    return NewtMakeInteger(CALLSP);
+}
+
+
 /*------------------------------------------------------------------------*/
 /** 変数の存在チェック
  *
@@ -411,7 +774,15 @@ newtRef NVMCurrentImplementor(void)
 
 bool NVMHasVar(newtRefArg name)
 {
-    if (NewtHasLexical(LOCALS, name))
+    if (BP != NO_BP)
+    {
+        if (0 <= NVMLocalsIndex(name))
+            return true;
+
+        if (NewtHasLexical(STACK[BP], name))
+            return true;
+    }
+    else if (NewtHasLexical(LOCALS, name))
         return true;
 
     if (NewtHasVariable(RCVR, name))
@@ -488,11 +859,21 @@ newtRef NVMMakeExceptionFrame(newtRefArg name, newtRefArg data)
  * @param data	[in] 例外フレーム
  *
  * @return		stack head (to be pushed back)
+ *
+ * @note		呼出しスタックを内側の関数から順に調べる。関数ごとに new-handlers で
+ *				プッシュした例外ハンドラを調べ、次に関数の例外ハンドラ表を調べる。
+ *				呼出しスタックより深い位置でプッシュされた例外ハンドラは
+ *				関数から抜けた TRY文のものなので捨てる。
  */
 
 newtRef NVMThrowData(newtRefArg name, newtRefArg data)
 {
     vm_excp_t *	excp;
+    vm_handler_t *	h;
+    newtRefVar	fn;
+    uint32_t	pc;
+    uint32_t	k;
+    uint32_t	next_callstack_top;
     size_t		i;
     size_t		next_excpstack_top;
 
@@ -504,18 +885,56 @@ newtRef NVMThrowData(newtRefArg name, newtRefArg data)
 	// Instead, we'll rethrow on environment pop.
 	if (vm_env.next) {
 		next_excpstack_top = vm_env.next->excpstack.sp;
+		next_callstack_top = vm_env.next->callstack.sp;
 	} else {
 		next_excpstack_top = 0;
+		next_callstack_top = 0;
 	}
-    for (i = EXCPSP; next_excpstack_top < i; i--)
+
+    i = EXCPSP;
+
+    for (k = CALLSP; next_callstack_top < k; k--)
     {
-        excp = &EXCPSTACK[i - 1];
+        // new-handlers でプッシュした例外ハンドラ
+        for (; next_excpstack_top < i; i--)
+        {
+            excp = &EXCPSTACK[i - 1];
+
+            if (excp->callsp < k)
+                break;
+
+            if (excp->callsp == k && NewtHasSubclass(name, excp->sym))
+            {
+                EXCPSP = i;
+                EXCPTABLE = false;
+                reg_rewind(excp->callsp);
+                PC = excp->pc;
+                SP = excp->sp;
+                return stk_pop0();
+            }
+        }
+
+        // 例外ハンドラ表
+        if (k == CALLSP)
+        {
+            fn = FUNC;
+            pc = PC;
+        }
+        else
+        {
+            fn = CALLSTACK[k].func;
+            pc = CALLSTACK[k].pc;
+        }
+
+        h = vm_handler_lookup(vm_frame_code(fn), pc, name);
 
-        if (NewtHasSubclass(name, excp->sym))
+        if (h != NULL)
         {
-            reg_rewind(excp->callsp);
-            PC = excp->pc;
-            SP = excp->sp;
+            EXCPSP = i;
+            EXCPTABLE = true;
+            reg_rewind(k);
+            PC = h->pc;
+            SP = BASE + h->depth;
             return stk_pop0();
         }
     }
@@ -545,6 +964,28 @@ newtRef NVMThrow(newtRefArg name, newtRefArg data)
 }
 
 
+/*------------------------------------------------------------------------*/
+/** 命令の間で例外を発生させる
+ *
+ * @param err	[in] エラー番号
+ * @param value	[in] 値オブジェクト
+ *
+ * @return		なし
+ *
+ * @note		VMループが命令の間に呼出す NewtGC などから使う。
+ *				ネイティブ関数から例外を発生した時と同じくスタックの先頭を積み直す。
+ *				関数を実行していない時は何もしない。
+ */
+
+void NVMThrowAsync(newtErr err, newtRefArg value)
+{
+    if (CALLSP == 0)
+        return;
+
+    stk_push(NewtThrow(err, value));
+}
+
+
 /*------------------------------------------------------------------------*/
 /** rethrow する
  *
@@ -589,8 +1030,12 @@ void NVMClearCurrException(void)
 {
     if (NewtRefIsNotNIL(CURREXCP))
 	{
-		excp_pop_handlers();
+		// 例外ハンドラ表で捕まえた場合はプッシュした例外ハンドラがない
+		if (! EXCPTABLE)
+			excp_pop_handlers();
+
 		CURREXCP = kNewtRefUnbind;
+		EXCPTABLE = false;
 	}
 }
 
@@ -611,217 +1056,2690 @@ void NVMClearException(void)
 
 #if 0
 #pragma mark -
+#pragma mark *** 前処理済み命令
 #endif
 /*------------------------------------------------------------------------*/
-/** 関数オブジェクトを現在の実行関数にする
+/** バイトコードを前処理済み命令に変換する
  *
- * @param fn	[in] 関数オブジェクト
+ * @param bc		[in] バイトコード
+ * @param len		[in] バイトコードの長さ
  *
- * @return		なし
+ * @return			前処理済み命令の配列（bc と同じインデックスでアクセスする）
+ *
+ * @note			分岐先や例外ハンドラの位置が命令の途中でもよいように、
+ *					全てのバイト位置を命令の先頭として解釈しておく
  */
 
-void NVMSetFn(newtRefArg fn)
+vm_inst_t * NVMDecodeCode(uint8_t * bc, size_t len)
 {
-    FUNC = fn;
+    vm_inst_t *	insts;
+    vm_inst_t *	inst;
+    uint32_t	pc;
+    int16_t		b;
+    uint8_t		op;
+    uint8_t		a;
 
-    if (NewtRefIsNIL(FUNC) || ! NewtRefIsCodeBlock(FUNC))
-    {
-        BC = NULL;
-        BCLEN = 0;
-    }
-    else
+#ifdef __NEWT_COMPUTED_GOTO__
+    // ハンドラのアドレスを取得する（ループは実行されない）
+    if (vm_handlers == NULL)
+        NVMThreadedLoop((uint32_t)-1);
+#endif
+
+    insts = (vm_inst_t *)NewtMemCalloc(NULL, len, sizeof(vm_inst_t));
+    if (insts == NULL) return NULL;
+
+    for (pc = 0; pc < len; pc++)
     {
-        newtRefVar	instr;
+        inst = &insts[pc];
 
-        instr = NcGetSlot(FUNC, NSSYM0(instructions));
-        BC = NewtRefToBinary(instr);
-        BCLEN = NewtLength(instr);
+        op = bc[pc];
+        b = op & kNBCFieldMask;
+        a = (op & 0xff)>>3;
+
+        if (b == kNBCFieldMask)
+        {
+            inst->len = 3;
+
+            b = (pc + 1 < len)?(int16_t)bc[pc + 1] << 8:0;
+            b += (pc + 2 < len)?bc[pc + 2]:0;
+
+            if (a == 0)
+            {
+                if (b == 0x01)
+                    b = kNBCFieldMask;
+            }
+        }
+        else
+        {
+            inst->len = 1;
+        }
+
+        inst->a = a;
+        inst->b = b;
+
+        if (kNBCInstructionsLen <= a)
+            inst->op = kVMOpNop;
+        else if (a == 0)
+            inst->op = (0 <= b && b < kNBCSimpleInstructionsLen)?kVMOpPop + b:kVMOpGeneric;
+        else if (a == (kNBCFreqFunc >> 3))
+            inst->op = (0 <= b && b < kBCFuncsLen)?kVMOpAdd + b:kVMOpGeneric;
+        else if (a == (kNBCNewHandlers >> 3))
+            inst->op = kVMOpNewHandlers;
+        else if ((kNBCPush >> 3) <= a)
+            inst->op = kVMOpPush + (a - (kNBCPush >> 3));
+        else
+            inst->op = kVMOpGeneric;
+
+        if (vm_handlers != NULL)
+            inst->handler = vm_handlers[inst->op];
     }
+
+    NVMFuseCode(insts, len);
+
+    return insts;
 }
 
 
 /*------------------------------------------------------------------------*/
-/** 戻る関数スタックがない場合の処理
+/** 連続する前処理済み命令を複合命令にまとめる
  *
- * @return		なし
+ * @param insts		[in] 前処理済み命令の配列
+ * @param len		[in] バイトコードの長さ
+ *
+ * @return			なし
+ *
+ * @note			組合せは実行時の命令の並びの出現頻度から選んでいる。
+ *					複合命令は先頭の命令だけを書き換えるので、後続の命令へ分岐しても
+ *					そのまま単独で実行できる。後続の命令を先に書き換えないように
+ *					先頭から順に処理する。まとめるのは途中で例外や関数の切替えが
+ *					起きない命令だけで、バイトコード自体は変更しない。
  */
 
-void NVMNoStackFrameForReturn(void)
+void NVMFuseCode(vm_inst_t * insts, size_t len)
 {
-    BC = NULL;
-    BCLEN = 0;
-    // Change PC to exit other tests such as si_set_lex_scope.
-    PC = (uint32_t) -1;
-}
+    vm_inst_t *	inst;
+    vm_inst_t *	next;
+    uint32_t	pc;
+    uint8_t		op;
 
-/*------------------------------------------------------------------------*/
-/** Build a new arg frame for a fast function that does not have any.
- *
- * @return		a new arg frame
- */
-newtRef NVMMakeFastFunctionArgFrame(newtRefArg fn)
-{
-    newtRefVar numArgs;
-    uint16_t fnNumArgs;
-    uintptr_t fnNumLocals;
-    size_t argFrameSize;
-    newtRefVar argFrameMap;
-    newtRefVar result;
-    size_t argIndex;
+    for (pc = 0; pc < len; pc++)
+    {
+        inst = &insts[pc];
 
-    numArgs = NcGetSlot(fn, NSSYM0(numArgs));
-    fnNumArgs = FFNumArgsToNumArgs(numArgs);
-    if (NewtRefIsNotNIL(NcGetSlot(fn, NSSYM0(indefinite))))
-        fnNumArgs++;
-    fnNumLocals = FFNumArgsToLocals(numArgs);
-    argFrameSize = fnNumArgs + fnNumLocals + 3;
+        if (len <= pc + inst->len)
+            continue;
 
-    argFrameMap = NewtMakeSlotsObj(NewtMakeInteger(0), argFrameSize + 1, 0);
+        next = &insts[pc + inst->len];
+        op = inst->op;
 
-    NewtSlotsSetSlot(argFrameMap, 0, kNewtRefNIL);
-    NewtSlotsSetSlot(argFrameMap, 1, NSSYM0(_nextArgFrame));
-    NewtSlotsSetSlot(argFrameMap, 2, NSSYM0(_parent));
-    NewtSlotsSetSlot(argFrameMap, 3, NSSYM0(_implementor));
+        switch (inst->op)
+        {
+            case kVMOpGetVar:
+                if (next->op == kVMOpGetVar)
+                    op = kVMOpGetVarGetVar;
+                else if (next->op == kVMOpPushConstant)
+                    op = kVMOpGetVarPushConstant;
+                break;
 
-    result = NewtMakeFrame(argFrameMap, argFrameSize);
-    NewtSetFrameSlot(result, 0, kNewtRefNIL);
-    NewtSetFrameSlot(result, 1, kNewtRefNIL);
-    NewtSetFrameSlot(result, 2, kNewtRefNIL);
+            case kVMOpSetVar:
+                if (next->op == kVMOpGetVar)
+                    op = kVMOpSetVarGetVar;
+                break;
 
-    // Other elements just don't have any name and will be accessed by position.
-    for (argIndex = 0; argIndex < fnNumArgs + fnNumLocals; argIndex++) {
-         NewtSetArraySlot(argFrameMap, argIndex + 4, kNewtRefNIL);
-         NewtSetFrameSlot(result, argIndex + 3, kNewtRefNIL);
-    }
+            case kVMOpIncrVar:
+                if (next->op == kVMOpGetVar && pc + inst->len + next->len < len &&
+                    insts[pc + inst->len + next->len].op == kVMOpBranchIfLoopNotDone)
+                    op = kVMOpIncrVarLoop;
+                break;
+        }
 
-    return result;
+        if (op != inst->op)
+        {
+            inst->op = op;
+
+            if (vm_handlers != NULL)
+                inst->handler = vm_handlers[op];
+        }
+    }
 }
 
-#if 0
-#pragma mark *** 呼出しスタック
-#endif
+
 /*------------------------------------------------------------------------*/
-/** レジスタの巻き戻し
+/** 前処理済み命令を解放する
  *
- * @param sp	[in] 呼出しスタックのスタックポインタ
+ * @param insts		[in] 前処理済み命令の配列
+ * @param len		[in] バイトコードの長さ
  *
- * @return		なし
+ * @return			なし
  */
 
-void reg_rewind(int32_t sp)
+void NVMFreeCode(vm_inst_t * insts, size_t len)
 {
-    if (sp == CALLSP)
+    size_t	i;
+
+    if (insts == NULL)
         return;
 
-    if (sp < CALLSP)
-    {
-        CALLSP = sp;
-        REG = CALLSTACK[CALLSP];
-        NVMSetFn(FUNC);
-    }
-    else
+    for (i = 0; i < len; i++)
     {
-        NVMNoStackFrameForReturn();
+        if (insts[i].ic != NULL)
+            ic_free(insts[i].ic);
     }
+
+    NewtMemFree(insts);
 }
 
 
 /*------------------------------------------------------------------------*/
-/** レジスタのポップ
+/** instructions オブジェクトに対応する前処理済み命令をキャッシュから取得する
  *
- * @return			なし
+ * @param instr		[in] instructions オブジェクト
+ *
+ * @return			前処理済み命令キャッシュのエントリ
+ *
+ * @note			キャッシュにない場合やバイトコードが変更されている場合は
+ *					前処理を行ってキャッシュに登録する
  */
 
-void reg_pop(void)
+vm_code_t * NVMLookupCode(newtRefArg instr)
 {
-	reg_rewind(CALLSP - 1);
-}
+    vm_code_t **	entryp;
+    vm_code_t *		entry;
+    uint8_t *		bc;
+    size_t			bclen;
 
+    bc = NewtRefToBinary(instr);
+    bclen = NewtLength(instr);
 
-/*------------------------------------------------------------------------*/
-/** レジスタのプッシュ
- *
- * @param sp		[in] スタックポインタ
- *
- * @return			なし
- */
+    if (bc == NULL || bclen == 0)
+        return NULL;
 
-void reg_push(int32_t sp)
-{
-    if (! NewtStackExpand(&vm_env.callstack, CALLSP + 1))
-        return;
+    entryp = &vm_codecache[(instr >> 3) & (NEWT_NUM_CODECACHE - 1)];
 
-    CALLSTACK[CALLSP] = REG;
-    CALLSTACK[CALLSP].sp = sp;
-    CALLSP++;
-}
+    for (entry = *entryp; entry != NULL; entry = entry->next)
+    {
+        if (entry->instr == instr)
+        {
+            if (entry->bc == bc && entry->bclen == bclen)
+                return entry;
+
+            // バイトコードが変更されている
+            NVMFreeCode(entry->insts, entry->bclen);
+            NVMJITFree(entry);
+            NewtMemFree(entry->handlers);
+            entry->insts = NVMDecodeCode(bc, bclen);
+            entry->bc = bc;
+            entry->bclen = bclen;
+            entry->hotness = 0;
+            entry->handlers = NULL;
+            entry->nhandlers = 0;
+            entry->checked = false;
+
+            return entry;
+        }
+    }
 
+    entry = (vm_code_t *)NewtMemAlloc(NULL, sizeof(vm_code_t));
+    if (entry == NULL) return NULL;
 
-/*------------------------------------------------------------------------*/
-/** レジスタの保存
- *
- * @param sp		[in] スタックポインタ
- *
- * @return			なし
- */
+    entry->instr = instr;
+    entry->bc = bc;
+    entry->bclen = bclen;
+    entry->insts = NVMDecodeCode(bc, bclen);
+    entry->hotness = 0;
+    entry->jit = NULL;
+    entry->handlers = NULL;
+    entry->nhandlers = 0;
+    entry->checked = false;
+    entry->next = *entryp;
+    *entryp = entry;
 
-void reg_save(int32_t sp)
-{
-//    PC++;
-    reg_push(sp);
+    return entry;
 }
 
 
-#if 0
-#pragma mark *** スタック
-#endif
 /*------------------------------------------------------------------------*/
-/** スタックのポップ
+/** 解放される instructions オブジェクトのエントリをキャッシュから削除する
  *
- * @return			オブジェクト
+ * @return			なし
+ *
+ * @note			GC のマーク後、スウィープ前に呼出すこと
  */
 
-newtRef stk_pop0(void)
+void NVMSweepCodeCache(void)
 {
-    newtRefVar	x = kNewtRefUnbind;
+    vm_code_t **	entryp;
+    vm_code_t *		entry;
+    newtObjRef		obj;
+    uint32_t		i;
 
-    if (0 < SP)
+    for (i = 0; i < NEWT_NUM_CODECACHE; i++)
     {
-        SP--;
-        x = STACK[SP];
+        entryp = &vm_codecache[i];
+
+        while (*entryp != NULL)
+        {
+            entry = *entryp;
+            obj = NewtRefToPointer(entry->instr);
+
+            if (NewtGCIsGarbage(obj))
+            {
+                if (entry == CODE)
+                {
+                    CODE = NULL;
+                    JIT = NULL;
+                }
+
+                *entryp = entry->next;
+                NVMFreeCode(entry->insts, entry->bclen);
+                NVMJITFree(entry);
+                NewtMemFree(entry->handlers);
+                NewtMemFree(entry);
+                continue;
+            }
+
+            entryp = &entry->next;
+        }
     }
 
-    return x;
+    vm_fn_sweep();
+    ic_sweep();
+    iter_sweep();
 }
 
 
 /*------------------------------------------------------------------------*/
-/** スタックのポップ（マジックポインタ参照を解決）
+/** 前処理済み命令キャッシュを空にする
  *
- * @return			オブジェクト
+ * @return			なし
  */
 
-newtRef stk_pop(void)
+void NVMCleanCodeCache(void)
 {
-	return NcResolveMagicPointer(stk_pop0());
+    vm_code_t *	entry;
+    vm_code_t *	next;
+    uint32_t	i;
+
+    for (i = 0; i < NEWT_NUM_CODECACHE; i++)
+    {
+        for (entry = vm_codecache[i]; entry != NULL; entry = next)
+        {
+            next = entry->next;
+            NVMFreeCode(entry->insts, entry->bclen);
+            NVMJITFree(entry);
+            NewtMemFree(entry->handlers);
+            NewtMemFree(entry);
+        }
+
+        vm_codecache[i] = NULL;
+    }
+
+    INSTS = NULL;
+    CODE = NULL;
+    JIT = NULL;
+
+    vm_fn_clean();
+    vm_iternums = 0;
 }
 
 
 /*------------------------------------------------------------------------*/
-/** スタックを n個ポップ
+/** 関数オブジェクトの例外ハンドラ表を前処理済み命令に適用する
  *
- * @param n			[in] ポップする数
- * @param a			[out]ポップしたオブジェクトを格納する配列
+ * @param code		[in] 前処理済み命令キャッシュのエントリ
+ * @param fn		[in] 関数オブジェクト
  *
  * @return			なし
+ *
+ * @note			handlers スロットの表が前処理済み命令の TRY文と対応している場合だけ、
+ *					TRY文の先頭を new-handlers の次までの読み飛ばしに、pop-handlers を
+ *					現在の例外のクリアに書き換える。例外ハンドラのプッシュは行わず、
+ *					例外が発生したときに NVMThrowData が表を参照する。
+ *					表がない、または対応しない場合は従来どおり new-handlers を実行する。
+ *					逐次デコードで実行する場合はバイトコードをそのまま実行するので適用しない。
  */
 
-void stk_pop_n(int32_t n, newtRef a[])
+void NVMApplyHandlers(vm_code_t * code, newtRefArg fn)
 {
-    for (n--; 0 <= n; n--)
+    vm_handler_t *	handlers;
+    vm_handler_t *	h;
+    vm_inst_t *	insts = code->insts;
+    newtRefVar	table;
+    newtRefVar	v;
+    uint32_t	len = code->bclen;
+    uint32_t	n;
+    uint32_t	i;
+    uint32_t	j;
+    uint32_t	k;
+    uint32_t	pc;
+    uint32_t	field[kNBCHandlerLen];
+
+    code->checked = true;
+
+    if (insts == NULL || NEWT_TRACE || NEWT_MODE_NOTHREADEDCODE)
+        return;
+
+    table = NcGetSlot(fn, NSSYM0(handlers));
+
+    if (! NewtRefIsArray(table))
+        return;
+
+    n = NewtArrayLength(table) / kNBCHandlerLen;
+
+    if (n == 0)
+        return;
+
+    handlers = (vm_handler_t *)NewtMemCalloc(NULL, n, sizeof(vm_handler_t));
+    if (handlers == NULL) return;
+
+    // 表を読込む
+    for (i = 0; i < n; i++)
+    {
+        h = &handlers[i];
+
+        for (k = 0; k < kNBCHandlerLen; k++)
+        {
+            v = NewtGetArraySlot(table, i * kNBCHandlerLen + k);
+
+            if (k == kNBCHandlerSym)
+            {
+                if (! NewtRefIsSymbol(v))
+                    goto failed;
+
+                h->sym = v;
+            }
+            else
+            {
+                if (! NewtRefIsInteger(v) || NewtRefToInteger(v) < 0 ||
+                    len <= (uint32_t)NewtRefToInteger(v))
+                    goto failed;
+
+                field[k] = (uint32_t)NewtRefToInteger(v);
+            }
+        }
+
+        h->start = field[kNBCHandlerStart];
+        h->end = field[kNBCHandlerEnd];
+        h->exit = field[kNBCHandlerExit];
+        h->depth = field[kNBCHandlerDepth];
+        h->pc = field[kNBCHandlerPC];
+    }
+
+    // TRY文（先頭が同じ連続する行）ごとに命令と対応しているか調べる
+    for (i = 0; i < n; i = j)
+    {
+        h = &handlers[i];
+
+        for (j = i + 1; j < n && handlers[j].start == h->start; j++)
+        {
+            if (handlers[j].end != h->end || handlers[j].exit != h->exit ||
+                handlers[j].depth != h->depth)
+                goto failed;
+        }
+
+        if (insts[h->start].op != kVMOpPush)
+            goto failed;
+
+        // 例外シンボルと例外ハンドラの位置のプッシュの次が new-handlers
+        for (pc = h->start, k = 0; k < (j - i) * 2 && pc < len; k++)
+            pc += insts[pc].len;
+
+        if (len <= pc || insts[pc].op != kVMOpNewHandlers || insts[pc].b != (int16_t)(j - i))
+            goto failed;
+
+        pc += insts[pc].len;
+
+        if (0xFFFF < pc || h->end < pc || h->exit <= h->end ||
+            insts[h->end].op != kVMOpPopHandlers || insts[h->exit].op != kVMOpPopHandlers)
+            goto failed;
+
+        for (k = i; k < j; k++)
+            handlers[k].body = pc;
+    }
+
+    // 前処理済み命令を書き換える
+    for (i = 0; i < n; i++)
+    {
+        h = &handlers[i];
+
+        insts[h->start].op = kVMOpTryEnter;
+        insts[h->start].skip = (uint16_t)h->body;
+        insts[h->end].op = kVMOpTryExit;
+        insts[h->exit].op = kVMOpTryExit;
+
+        if (vm_handlers != NULL)
+        {
+            insts[h->start].handler = vm_handlers[kVMOpTryEnter];
+            insts[h->end].handler = vm_handlers[kVMOpTryExit];
+            insts[h->exit].handler = vm_handlers[kVMOpTryExit];
+        }
+    }
+
+    code->handlers = handlers;
+    code->nhandlers = n;
+
+    return;
+
+failed:
+    NewtMemFree(handlers);
+}
+
+
+/*------------------------------------------------------------------------*/
+/** 例外ハンドラ表から命令位置を囲む例外ハンドラを探す
+ *
+ * @param code		[in] 前処理済み命令キャッシュのエントリ
+ * @param pc		[in] 命令位置（実行中の命令の次の位置）
+ * @param name		[in] 例外シンボル（kNewtRefUnbind なら全ての例外ハンドラ）
+ *
+ * @return			例外ハンドラ表の行（ない場合は NULL）
+ *
+ * @note			表は内側の TRY文から順に並んでいる
+ */
+
+vm_handler_t * vm_handler_lookup(vm_code_t * code, uint32_t pc, newtRefArg name)
+{
+    vm_handler_t *	h;
+    uint32_t	i;
+
+    if (code == NULL)
+        return NULL;
+
+    for (i = 0; i < code->nhandlers; i++)
+    {
+        h = &code->handlers[i];
+
+        if (h->body < pc && pc <= h->end &&
+            (name == kNewtRefUnbind || NewtHasSubclass(name, h->sym)))
+            return h;
+    }
+
+    return NULL;
+}
+
+
+/*------------------------------------------------------------------------*/
+/** 呼出しスタック上の関数オブジェクトの前処理済み命令キャッシュのエントリを取得する
+ *
+ * @param fn		[in] 関数オブジェクト
+ *
+ * @return			前処理済み命令キャッシュのエントリ（バイトコードの関数でなければ NULL）
+ */
+
+vm_code_t * vm_frame_code(newtRefArg fn)
+{
+    vm_code_t *	code;
+    int		type;
+
+    if (NewtRefIsNIL(fn))
+        return NULL;
+
+    type = vm_fn_type(fn);
+
+    if (type != kNewtCodeBlock && type != kNewtFastFunction)
+        return NULL;
+
+    code = NVMLookupCode(vm_fn_get(fn, kVMFnInstructions, NSSYM0(instructions)));
+
+    if (code != NULL && ! code->checked)
+        NVMApplyHandlers(code, fn);
+
+    return code;
+}
+
+
+/*------------------------------------------------------------------------*/
+/** 関数命令を実行時の引数の型に特化した命令に書き換える（クイックニング）
+ *
+ * @param inst		[in] 前処理済み命令
+ *
+ * @return			なし
+ *
+ * @note			スタックに積まれた２つの引数が共に 30bit整数、または共に浮動小数点の
+ *					場合に型特化命令に書き換える。命令の実行は呼出し側で行う。
+ *					型ガードの失敗が NEWT_NUM_QUICKMISSES 回を超えた命令は書き換えない。
+ */
+
+void vm_quicken(vm_inst_t * inst)
+{
+    newtRefVar	a1;
+    newtRefVar	a2;
+    double		x1;
+    double		x2;
+    uint8_t		op = kVMOpNop;
+
+    if (NEWT_NUM_QUICKMISSES < inst->misses || SP < 2)
+        return;
+
+    a1 = STACK[SP - 2];
+    a2 = STACK[SP - 1];
+
+    if (NewtRefIsInt30(a1) && NewtRefIsInt30(a2))
+    {
+        switch (inst->op)
+        {
+            case kVMOpAdd:				op = kVMOpAddInt;				break;
+            case kVMOpSubtract:			op = kVMOpSubtractInt;			break;
+            case kVMOpMultiply:			op = kVMOpMultiplyInt;			break;
+            case kVMOpEquals:			op = kVMOpEqualsInt;			break;
+            case kVMOpNotEqual:			op = kVMOpNotEqualInt;			break;
+            case kVMOpLessThan:			op = kVMOpLessThanInt;			break;
+            case kVMOpGreaterThan:		op = kVMOpGreaterThanInt;		break;
+            case kVMOpGreaterOrEqual:	op = kVMOpGreaterOrEqualInt;	break;
+            case kVMOpLessOrEqual:		op = kVMOpLessOrEqualInt;		break;
+        }
+    }
+    else if (vm_real_arg(a1, &x1) && vm_real_arg(a2, &x2))
+    {
+        switch (inst->op)
+        {
+            case kVMOpAdd:				op = kVMOpAddReal;				break;
+            case kVMOpSubtract:			op = kVMOpSubtractReal;			break;
+            case kVMOpMultiply:			op = kVMOpMultiplyReal;			break;
+            case kVMOpDivide:			op = kVMOpDivideReal;			break;
+            case kVMOpLessThan:			op = kVMOpLessThanReal;			break;
+            case kVMOpGreaterThan:		op = kVMOpGreaterThanReal;		break;
+            case kVMOpGreaterOrEqual:	op = kVMOpGreaterOrEqualReal;	break;
+            case kVMOpLessOrEqual:		op = kVMOpLessOrEqualReal;		break;
+        }
+    }
+
+    if (op == kVMOpNop)
+        return;
+
+    inst->op = op;
+
+    if (vm_handlers != NULL)
+        inst->handler = vm_handlers[op];
+}
+
+
+/*------------------------------------------------------------------------*/
+/** 型特化命令を元の関数命令に戻して実行する
+ *
+ * @param inst		[in] 前処理済み命令
+ *
+ * @return			なし
+ *
+ * @note			型ガードに失敗したときに呼ばれる。
+ */
+
+void vm_dequicken(vm_inst_t * inst)
+{
+    inst->op = kVMOpAdd + inst->b;
+
+    if (vm_handlers != NULL)
+        inst->handler = vm_handlers[inst->op];
+
+    if (inst->misses <= NEWT_NUM_QUICKMISSES)
+        inst->misses++;
+
+    (fn_instructions[inst->b])();
+}
+
+
+/*------------------------------------------------------------------------*/
+/** 30bit整数に特化した関数命令を実行する
+ *
+ * @param inst		[in] 前処理済み命令
+ *
+ * @return			なし
+ *
+ * @note			引数が 30bit整数でなければ元の関数命令に戻す。
+ *					64bit 環境の即値は 62bit あるので、乗算は 64bit で桁あふれ
+ *					したら NcMultiply と同じく下位 64bit を残す。
+ *					即値の範囲を超える結果は NewtMakeInteger で作成する。
+ */
+
+void vm_quick_int30(vm_inst_t * inst)
+{
+    newtRefVar	r = kNewtRefNIL;
+    intptr_t	x1;
+    intptr_t	x2;
+
+    if (SP < 2 || ! NewtRefIsInt30(STACK[SP - 2]) || ! NewtRefIsInt30(STACK[SP - 1]))
+    {
+        vm_dequicken(inst);
+        return;
+    }
+
+    x1 = NewtRefToInt30(STACK[SP - 2]);
+    x2 = NewtRefToInt30(STACK[SP - 1]);
+
+    switch (inst->op)
+    {
+        case kVMOpAddInt:
+            r = NewtMakeInteger((int64_t)x1 + x2);
+            break;
+
+        case kVMOpSubtractInt:
+            r = NewtMakeInteger((int64_t)x1 - x2);
+            break;
+
+        case kVMOpMultiplyInt:
+            r = NewtMakeInteger((int64_t)((uint64_t)x1 * (uint64_t)x2));
+            break;
+
+        case kVMOpEqualsInt:
+            r = NewtMakeBoolean(x1 == x2);
+            break;
+
+        case kVMOpNotEqualInt:
+            r = NewtMakeBoolean(x1 != x2);
+            break;
+
+        case kVMOpLessThanInt:
+            r = NewtMakeBoolean(x1 < x2);
+            break;
+
+        case kVMOpGreaterThanInt:
+            r = NewtMakeBoolean(x1 > x2);
+            break;
+
+        case kVMOpGreaterOrEqualInt:
+            r = NewtMakeBoolean(x1 >= x2);
+            break;
+
+        case kVMOpLessOrEqualInt:
+            r = NewtMakeBoolean(x1 <= x2);
+            break;
+    }
+
+    SP--;
+    STACK[SP - 1] = r;
+}
+
+
+/*------------------------------------------------------------------------*/
+/** 浮動小数点に特化した関数命令を実行する
+ *
+ * @param inst		[in] 前処理済み命令
+ *
+ * @return			なし
+ *
+ * @note			引数が浮動小数点でなければ元の関数命令に戻す。
+ *					０による除算は元の関数命令で例外を発生させる。
+ */
+
+void vm_quick_real(vm_inst_t * inst)
+{
+    newtRefVar	r = kNewtRefNIL;
+    double		x1;
+    double		x2;
+
+    if (SP < 2 || ! vm_real_arg(STACK[SP - 2], &x1) || ! vm_real_arg(STACK[SP - 1], &x2))
+    {
+        vm_dequicken(inst);
+        return;
+    }
+
+    switch (inst->op)
+    {
+        case kVMOpAddReal:
+            r = NewtMakeReal(x1 + x2);
+            break;
+
+        case kVMOpSubtractReal:
+            r = NewtMakeReal(x1 - x2);
+            break;
+
+        case kVMOpMultiplyReal:
+            r = NewtMakeReal(x1 * x2);
+            break;
+
+        case kVMOpDivideReal:
+            if (x2 == 0.0)
+            {
+                vm_dequicken(inst);
+                return;
+            }
+
+            r = NewtMakeReal(x1 / x2);
+            break;
+
+        case kVMOpLessThanReal:
+            r = NewtMakeBoolean(x1 < x2);
+            break;
+
+        case kVMOpGreaterThanReal:
+            r = NewtMakeBoolean(x1 > x2);
+            break;
+
+        case kVMOpGreaterOrEqualReal:
+            r = NewtMakeBoolean(x1 >= x2);
+            break;
+
+        case kVMOpLessOrEqualReal:
+            r = NewtMakeBoolean(x1 <= x2);
+            break;
+    }
+
+    SP--;
+    STACK[SP - 1] = r;
+}
+
+
+/*------------------------------------------------------------------------*/
+/** for ループの増分と終了条件のチェックをまとめて実行する
+ *
+ * @param inst		[in] 前処理済み命令（incr-var）
+ *
+ * @return			なし
+ *
+ * @note			incr-var + get-var + branch-if-loop-not-done の複合命令。
+ *					入口の branch-if-loop-not-done で増分と上限が整数で増分が 0 で
+ *					ないことは確認済みなので、スタック上のローカル変数を
+ *					30bit整数のまま増分して符号付きで比較する。
+ *					それ以外の場合は３つの命令を順に実行する。
+ */
+
+void vm_for_loop(vm_inst_t * inst)
+{
+    vm_inst_t *	getvar = &INSTS[PC];
+    vm_inst_t *	branch = &INSTS[PC + getvar->len];
+    newtRef *	index;
+    newtRefVar	incr;
+    newtRefVar	limit;
+    int64_t		v;
+    bool		done;
+
+    if (BP != NO_BP && BP + inst->b < SP && BP + getvar->b < SP)
+    {
+        index = &STACK[BP + inst->b];
+        incr = stk_top();
+        limit = STACK[BP + getvar->b];
+
+        if (NewtRefIsInt30((*index | incr | limit)))
+        {
+            v = (int64_t)NewtRefToInt30(*index) + NewtRefToInt30(incr);
+
+            if (NewtIntIsImmediate(v))
+            {
+                *index = NewtMakeInt30(v);
+                SP--;
+
+                if (0 < NewtRefToInt30(incr))
+                    done = (NewtRefToInt30(limit) < v);
+                else
+                    done = (v < NewtRefToInt30(limit));
+
+                if (done)
+                    PC += getvar->len + branch->len;
+                else
+                    PC = branch->b;
+
+                return;
+            }
+        }
+    }
+
+    is_incr_var(inst->b);
+    vm_site = getvar;
+    PC += getvar->len;
+    is_get_var(getvar->b);
+    vm_site = branch;
+    PC += branch->len;
+    is_branch_if_loop_not_done(branch->b);
+}
+
+
+
+/*------------------------------------------------------------------------*/
+/** 浮動小数点オブジェクトの値を取り出す
+ *
+ * @param r			[in] オブジェクト
+ * @param v			[out]浮動小数点
+ *
+ * @retval			true	浮動小数点オブジェクト
+ * @retval			false   浮動小数点オブジェクトでない
+ *
+ * @note			型特化命令の型ガード用。NewtRefIsReal と違いクラスは
+ *					シンボルの同一性だけで判定する。
+ */
+
+bool vm_real_arg(newtRefArg r, double * v)
+{
+    newtObjRef	obj;
+
+    if (! NewtRefIsPointer(r))
+        return false;
+
+    obj = NewtRefToPointer(r);
+
+    if (NewtObjIsSlotted(obj) || obj->as.klass != NSSYM0(real) || NewtObjSize(obj) < sizeof(double))
+        return false;
+
+    memcpy(v, NewtObjData(obj), sizeof(double));
+
+    return true;
+}
+
+
+#if 0
+#pragma mark *** 関数オブジェクトの記述子
+#endif
+/*------------------------------------------------------------------------*/
+/** 関数オブジェクトの記述子を取得する
+ *
+ * @param fn		[in] 関数オブジェクト
+ *
+ * @return			関数オブジェクトの記述子（フレームでない場合は NULL）
+ *
+ * @note			最初の呼出しで作成し、関数オブジェクトのマップが変更されていたら
+ *					スロットの位置を記録し直す。記録するのは位置だけなので、
+ *					スロットの値を書き換えても記述子はそのまま使える。
+ */
+
+vm_fn_t * vm_fn_lookup(newtRefArg fn)
+{
+    vm_fn_t **	entryp;
+    vm_fn_t *	entry;
+    newtObjRef	obj;
+    size_t		i;
+    uint8_t		kind;
+
+    if (! NewtRefIsPointer(fn))
+        return NULL;
+
+    obj = NewtRefToPointer(fn);
+
+    if (! NewtObjIsFrame(obj))
+        return NULL;
+
+    entry = vm_fnlast;
+
+    if (entry == NULL || entry->fn != fn)
+    {
+        entryp = &vm_fncache[(fn >> 4) & (NEWT_NUM_FNCACHE - 1)];
+
+        for (entry = *entryp; entry != NULL; entry = entry->next)
+        {
+            if (entry->fn == fn)
+                break;
+        }
+
+        if (entry == NULL)
+        {
+            entry = (vm_fn_t *)NewtMemAlloc(NULL, sizeof(vm_fn_t));
+            if (entry == NULL) return NULL;
+
+            entry->fn = fn;
+            entry->map = kNewtRefUnbind;
+            entry->next = *entryp;
+            *entryp = entry;
+        }
+
+        vm_fnlast = entry;
+    }
+
+    if (entry->map != obj->as.map || entry->epoch != NEWT_MAPEPOCH)
+    {
+        for (kind = 0; kind < kVMFnLen; kind++)
+        {
+            newtRefVar	sym = kNewtRefUnbind;
+
+            switch (kind)
+            {
+                case kVMFnClass:		sym = NS_CLASS;				break;
+                case kVMFnInstructions:	sym = NSSYM0(instructions);	break;
+                case kVMFnLiterals:		sym = NSSYM0(literals);		break;
+                case kVMFnArgFrame:		sym = NSSYM0(argFrame);		break;
+                case kVMFnNumArgs:		sym = NSSYM0(numArgs);		break;
+                case kVMFnIndefinite:	sym = NSSYM0(indefinite);	break;
+                case kVMFnFuncPtr:		sym = NSSYM0(funcPtr);		break;
+            }
+
+            entry->slots[kind] = NewtFindMapIndex(obj->as.map, sym, &i)?(int32_t)i:-1;
+        }
+
+        entry->map = obj->as.map;
+        entry->epoch = NEWT_MAPEPOCH;
+        entry->klass = (0 <= entry->slots[kVMFnClass])?NewtObjToSlots(obj)[entry->slots[kVMFnClass]]:kNewtRefUnbind;
+        entry->type = NewtRefFunctionType(fn);
+    }
+
+    return entry;
+}
+
+
+/*------------------------------------------------------------------------*/
+/** 関数オブジェクトのスロットを記述子を使って取出す
+ *
+ * @param fn		[in] 関数オブジェクト
+ * @param kind		[in] 記述子に位置を記録するスロットの種類
+ * @param sym		[in] スロットシンボル
+ *
+ * @return			スロットの値（NcGetSlot と同じ）
+ */
+
+newtRef vm_fn_get(newtRefArg fn, uint8_t kind, newtRefArg sym)
+{
+    vm_fn_t *	desc;
+    newtRefVar	v;
+
+    desc = vm_fn_lookup(fn);
+
+    if (desc == NULL)
+        return NcGetSlot(fn, sym);
+
+    if (desc->slots[kind] < 0)
+        return kNewtRefUnbind;
+
+    v = NewtObjToSlots(NewtRefToPointer(fn))[desc->slots[kind]];
+
+    if (NewtRefIsMagicPointer(v))
+        v = NcResolveMagicPointer(v);
+
+    return v;
+}
+
+
+/*------------------------------------------------------------------------*/
+/** 関数オブジェクトのタイプを記述子を使って取得する
+ *
+ * @param fn		[in] オブジェクト
+ *
+ * @return			関数オブジェクトのタイプ（NewtRefFunctionType と同じ）
+ *
+ * @note			タイプはクラスだけで決まるので、クラススロットの値が
+ *					記録したときと同じなら記録したタイプを返す
+ */
+
+int vm_fn_type(newtRefArg fn)
+{
+    vm_fn_t *	desc;
+    newtRefVar	klass;
+
+    desc = vm_fn_lookup(fn);
+
+    if (desc == NULL || desc->slots[kVMFnClass] < 0)
+        return NewtRefFunctionType(fn);
+
+    klass = NewtObjToSlots(NewtRefToPointer(fn))[desc->slots[kVMFnClass]];
+
+    if (klass != desc->klass)
+    {
+        desc->klass = klass;
+        desc->type = NewtRefFunctionType(fn);
+    }
+
+    return desc->type;
+}
+
+
+/*------------------------------------------------------------------------*/
+/** 解放される関数オブジェクトの記述子をキャッシュから削除する
+ *
+ * @return			なし
+ */
+
+void vm_fn_sweep(void)
+{
+    vm_fn_t **	entryp;
+    vm_fn_t *	entry;
+    uint32_t	i;
+
+    for (i = 0; i < NEWT_NUM_FNCACHE; i++)
+    {
+        entryp = &vm_fncache[i];
+
+        while (*entryp != NULL)
+        {
+            entry = *entryp;
+
+            if (NewtGCIsGarbage(NewtRefToPointer(entry->fn)))
+            {
+                if (entry == vm_fnlast)
+                    vm_fnlast = NULL;
+
+                *entryp = entry->next;
+                NewtMemFree(entry);
+                continue;
+            }
+
+            entryp = &entry->next;
+        }
+    }
+}
+
+
+/*------------------------------------------------------------------------*/
+/** 関数オブジェクトの記述子キャッシュを空にする
+ *
+ * @return			なし
+ */
+
+void vm_fn_clean(void)
+{
+    vm_fn_t *	entry;
+    vm_fn_t *	next;
+    uint32_t	i;
+
+    for (i = 0; i < NEWT_NUM_FNCACHE; i++)
+    {
+        for (entry = vm_fncache[i]; entry != NULL; entry = next)
+        {
+            next = entry->next;
+            NewtMemFree(entry);
+        }
+
+        vm_fncache[i] = NULL;
+    }
+
+    vm_fnlast = NULL;
+}
+
+
+#if 0
+#pragma mark *** JIT コンパイル
+#endif
+/*------------------------------------------------------------------------*/
+/** 関数の呼出しやループの回数を数えて、ホットになったら JIT コンパイルする
+ *
+ * @param code		[in] 前処理済み命令キャッシュのエントリ
+ *
+ * @return			JIT コンパイルしたネイティブコード（まだコンパイルしていなければ NULL）
+ *
+ * @note			コンパイルは一度だけ試みる。失敗した場合は前処理済み命令で実行を続ける。
+ */
+
+vm_jit_t * NVMJITHot(vm_code_t * code)
+{
+#ifdef __NEWT_JIT__
+    if (code->jit == NULL && code->hotness <= NEWT_JIT_THRESHOLD)
+    {
+        code->hotness++;
+
+        if (NEWT_JIT_THRESHOLD < code->hotness)
+            code->jit = NVMJITCompile(code);
+    }
+
+    return code->jit;
+#else
+    return NULL;
+#endif
+}
+
+
+/*------------------------------------------------------------------------*/
+/** JIT コンパイルしたネイティブコードを解放する
+ *
+ * @param code		[in] 前処理済み命令キャッシュのエントリ
+ *
+ * @return			なし
+ */
+
+void NVMJITFree(vm_code_t * code)
+{
+#ifdef __NEWT_JIT__
+    vm_jit_t *	jit = code->jit;
+
+    if (jit == NULL)
+        return;
+
+    if (jit == JIT)
+        JIT = NULL;
+
+    munmap(jit->code, jit->size);
+    NewtMemFree(jit->entry);
+    NewtMemFree(jit);
+    code->jit = NULL;
+#endif
+}
+
+
+#ifdef __NEWT_JIT__
+
+/// 作業領域を拡張するときの単位
+#define JIT_CHUNK			4096
+
+/// vm_env のメンバーの位置（ネイティブコードは rbx = &vm_env でアクセスする）
+#define JIT_PC				offsetof(vm_env_t, reg.pc)
+#define JIT_SP				offsetof(vm_env_t, reg.sp)
+#define JIT_BP				offsetof(vm_env_t, reg.bp)
+#define JIT_STACKP			offsetof(vm_env_t, stack.stackp)
+#define JIT_NUMS			offsetof(vm_env_t, stack.nums)
+#define JIT_CALLSP			offsetof(vm_env_t, callstack.sp)
+#define JIT_INSTS			offsetof(vm_env_t, insts)
+
+/// 条件コード（0F 8x の下位 4bit、0 は無条件ジャンプ）
+#define JIT_JMP				0x00
+#define JIT_JO				0x80
+#define JIT_JB				0x82
+#define JIT_JAE				0x83
+#define JIT_JE				0x84
+#define JIT_JNE				0x85
+
+
+/*------------------------------------------------------------------------*/
+/** ネイティブコードを出力する
+ *
+ * @param j			[in] 作業領域
+ * @param p			[in] 出力するバイト列
+ * @param n			[in] バイト列の長さ
+ *
+ * @return			なし
+ */
+
+void jit_emit(vm_jitbuf_t * j, const uint8_t * p, size_t n)
+{
+    if (j->cap < j->len + n)
+    {
+        uint8_t *	buf;
+
+        buf = (uint8_t *)NewtMemRealloc(NULL, j->buf, j->cap + JIT_CHUNK);
+
+        if (buf == NULL)
+        {
+            j->failed = true;
+            return;
+        }
+
+        j->buf = buf;
+        j->cap += JIT_CHUNK;
+    }
+
+    memcpy(j->buf + j->len, p, n);
+    j->len += n;
+}
+
+
+/*------------------------------------------------------------------------*/
+/** 32bit の即値を出力する
+ *
+ * @param j			[in] 作業領域
+ * @param v			[in] 即値
+ *
+ * @return			なし
+ */
+
+void jit_u32(vm_jitbuf_t * j, uint32_t v)
+{
+    uint8_t	p[4] = {v, v >> 8, v >> 16, v >> 24};
+
+    jit_emit(j, p, sizeof(p));
+}
+
+
+/*------------------------------------------------------------------------*/
+/** 64bit の即値を出力する
+ *
+ * @param j			[in] 作業領域
+ * @param v			[in] 即値
+ *
+ * @return			なし
+ */
+
+void jit_u64(vm_jitbuf_t * j, uint64_t v)
+{
+    jit_u32(j, (uint32_t)v);
+    jit_u32(j, (uint32_t)(v >> 32));
+}
+
+
+/*------------------------------------------------------------------------*/
+/** vm_env のメンバーをオペランドにする命令を出力する
+ *
+ * @param j			[in] 作業領域
+ * @param rex		[in] REX プレフィックス（0 なら出力しない）
+ * @param opc		[in] オペコード
+ * @param reg		[in] ModRM の reg フィールド
+ * @param disp		[in] vm_env のメンバーの位置
+ *
+ * @return			なし
+ *
+ * @note			[rbx + disp32] の形式で出力する
+ */
+
+void jit_mem(vm_jitbuf_t * j, uint8_t rex, uint8_t opc, uint8_t reg, size_t disp)
+{
+    uint8_t	p[3];
+    size_t	n = 0;
+
+    if (rex != 0)
+        p[n++] = rex;
+
+    p[n++] = opc;
+    p[n++] = 0x80 | ((reg & 7) << 3) | 3;
+
+    jit_emit(j, p, n);
+    jit_u32(j, (uint32_t)disp);
+}
+
+
+/*------------------------------------------------------------------------*/
+/** 分岐先が未定のジャンプを出力する
+ *
+ * @param j			[in] 作業領域
+ * @param cc		[in] 条件コード
+ *
+ * @return			分岐先を書換える位置
+ */
+
+uint32_t jit_jcc(vm_jitbuf_t * j, uint8_t cc)
+{
+    uint8_t	p[2] = {0x0F, cc};
+
+    if (cc == JIT_JMP)
+        jit_emit(j, (const uint8_t *)"\xE9", 1);
+    else
+        jit_emit(j, p, 2);
+
+    jit_u32(j, 0);
+
+    return (uint32_t)j->len - 4;
+}
+
+
+/*------------------------------------------------------------------------*/
+/** 出力済みの位置へのジャンプを出力する
+ *
+ * @param j			[in] 作業領域
+ * @param cc		[in] 条件コード
+ * @param off		[in] 分岐先の位置
+ *
+ * @return			なし
+ */
+
+void jit_jcc_to(vm_jitbuf_t * j, uint8_t cc, uint32_t off)
+{
+    uint32_t	pos;
+
+    pos = jit_jcc(j, cc);
+
+    if (! j->failed)
+    {
+        uint32_t	rel = off - (pos + 4);
+
+        memcpy(j->buf + pos, &rel, sizeof(rel));
+    }
+}
+
+
+/*------------------------------------------------------------------------*/
+/** 未定のジャンプの分岐先を現在の位置にする
+ *
+ * @param j			[in] 作業領域
+ * @param pos		[in] 分岐先を書換える位置
+ *
+ * @return			なし
+ */
+
+void jit_label(vm_jitbuf_t * j, uint32_t pos)
+{
+    if (! j->failed)
+    {
+        uint32_t	rel = (uint32_t)j->len - (pos + 4);
+
+        memcpy(j->buf + pos, &rel, sizeof(rel));
+    }
+}
+
+
+/*------------------------------------------------------------------------*/
+/** 命令位置へのジャンプを出力する
+ *
+ * @param j			[in] 作業領域
+ * @param cc		[in] 条件コード
+ * @param pc		[in] 分岐先の命令位置（命令の先頭であること）
+ *
+ * @return			なし
+ *
+ * @note			分岐先はすべての命令を出力してから書換える
+ */
+
+void jit_fixup(vm_jitbuf_t * j, uint8_t cc, uint32_t pc)
+{
+    uint32_t	pos;
+
+    pos = jit_jcc(j, cc);
+
+    j->fixups[j->nfixups * 2] = pos;
+    j->fixups[j->nfixups * 2 + 1] = pc;
+    j->nfixups++;
+}
+
+
+/*------------------------------------------------------------------------*/
+/** PC に即値をセットするコードを出力する
+ *
+ * @param j			[in] 作業領域
+ * @param pc		[in] プログラムカウンタ
+ *
+ * @return			なし
+ */
+
+void jit_set_pc(vm_jitbuf_t * j, uint32_t pc)
+{
+    jit_mem(j, 0, 0xC7, 0, JIT_PC);		// mov dword [rbx + PC], pc
+    jit_u32(j, pc);
+}
+
+
+/*------------------------------------------------------------------------*/
+/** 分岐命令の分岐先へのジャンプを出力する
+ *
+ * @param j			[in] 作業領域
+ * @param pc		[in] 分岐先の命令位置
+ * @param len		[in] バイトコードの長さ
+ *
+ * @return			なし
+ *
+ * @note			命令の先頭でない位置やバイトコードの外への分岐は
+ *					PC をセットしてインタプリタに戻る
+ */
+
+void jit_goto(vm_jitbuf_t * j, uint32_t pc, size_t len)
+{
+    if (pc < len && j->starts[pc])
+    {
+        jit_fixup(j, JIT_JMP, pc);
+    }
+    else
+    {
+        jit_set_pc(j, pc);
+        jit_jcc_to(j, JIT_JMP, j->exit);
+    }
+}
+
+
+/*------------------------------------------------------------------------*/
+/** 命令ハンドラを呼出すコードを出力する
+ *
+ * @param j			[in] 作業領域
+ * @param insts		[in] 前処理済み命令の配列
+ * @param pc		[in] 命令位置
+ * @param npc		[in] 次の命令位置
+ * @param target	[in] 分岐命令の分岐先（分岐命令でなければ npc）
+ * @param len		[in] バイトコードの長さ
+ *
+ * @return			なし
+ *
+ * @note			インタプリタと同じように PC と vm_site をセットして is_instructions を呼出す。
+ *					呼出し後に関数の切替え、例外による PC の変更、GC の要求があれば
+ *					インタプリタに戻る（脱最適化）。
+ */
+
+void jit_generic(vm_jitbuf_t * j, vm_inst_t * insts, uint32_t pc, uint32_t npc, uint32_t target, size_t len)
+{
+    vm_inst_t *	inst = &insts[pc];
+    instruction_t	func = is_instructions[inst->a];
+
+    if (inst->a << 3 == kNBCFreqFunc)
+        func = jit_freq_func;
+    else if (inst->op == kVMOpTryExit)
+        func = jit_try_exit;
+
+    jit_set_pc(j, npc);
+
+    jit_emit(j, (const uint8_t *)"\x48\xB8", 2);		// mov rax, &insts[pc]
+    jit_u64(j, (uintptr_t)inst);
+    jit_emit(j, (const uint8_t *)"\x48\xB9", 2);		// mov rcx, &vm_site
+    jit_u64(j, (uintptr_t)&vm_site);
+    jit_emit(j, (const uint8_t *)"\x48\x89\x01", 3);	// mov [rcx], rax
+
+    jit_emit(j, (const uint8_t *)"\xBF", 1);			// mov edi, b
+    jit_u32(j, (uint32_t)(int32_t)inst->b);
+    jit_emit(j, (const uint8_t *)"\x48\xB8", 2);		// mov rax, func
+    jit_u64(j, (uintptr_t)func);
+    jit_emit(j, (const uint8_t *)"\xFF\xD0", 2);		// call rax
+
+    jit_mem(j, 0x44, 0x39, 4, JIT_CALLSP);				// cmp [rbx + CALLSP], r12d
+    jit_jcc_to(j, JIT_JNE, j->exit);
+    jit_emit(j, (const uint8_t *)"\x48\xB8", 2);		// mov rax, insts
+    jit_u64(j, (uintptr_t)insts);
+    jit_mem(j, 0x48, 0x39, 0, JIT_INSTS);				// cmp [rbx + INSTS], rax
+    jit_jcc_to(j, JIT_JNE, j->exit);
+    jit_emit(j, (const uint8_t *)"\x41\x80\x7D\x00\x00", 5);	// cmp byte [r13], 0 (NEWT_NEEDGC)
+    jit_jcc_to(j, JIT_JNE, j->exit);
+
+    if (target != npc && target < len && j->starts[target])
+    {
+        jit_mem(j, 0, 0x81, 7, JIT_PC);					// cmp dword [rbx + PC], target
+        jit_u32(j, target);
+        jit_fixup(j, JIT_JE, target);
+    }
+
+    jit_mem(j, 0, 0x81, 7, JIT_PC);						// cmp dword [rbx + PC], npc
+    jit_u32(j, npc);
+    jit_jcc_to(j, JIT_JNE, j->exit);
+}
+
+
+/*------------------------------------------------------------------------*/
+/** ネイティブコードから関数命令を実行する
+ *
+ * @param b		[in] オペデータ
+ *
+ * @return		なし
+ *
+ * @note		インライン展開した 30bit整数の演算に当てはまらない場合に呼ばれる。
+ *				インタプリタと同じように型特化命令に書き換えて浮動小数点の演算を速くする。
+ */
+
+void jit_freq_func(int16_t b)
+{
+    vm_inst_t *	inst = vm_site;
+
+    if (kVMOpAddInt <= inst->op && inst->op <= kVMOpLessOrEqualInt)
+    {
+        vm_quick_int30(inst);
+    }
+    else if (kVMOpAddReal <= inst->op && inst->op <= kVMOpLessOrEqualReal)
+    {
+        vm_quick_real(inst);
+    }
+    else
+    {
+        if (inst->op == kVMOpAdd + b)
+            vm_quicken(inst);
+
+        is_freq_func(b);
+    }
+}
+
+
+/*------------------------------------------------------------------------*/
+/** ネイティブコードから例外ハンドラ表のある TRY文を抜ける
+ *
+ * @param b		[in] オペデータ
+ *
+ * @return		なし
+ */
+
+void jit_try_exit(int16_t b)
+{
+    si_try_exit();
+}
+
+
+/*------------------------------------------------------------------------*/
+/** 命令をインライン展開したコードを出力する
+ *
+ * @param j			[in] 作業領域
+ * @param inst		[in] 前処理済み命令
+ * @param npc		[in] 次の命令位置
+ * @param len		[in] バイトコードの長さ
+ * @param slow		[out]命令ハンドラの呼出しへのジャンプを書換える位置
+ * @param nslow		[out]slow の数
+ *
+ * @return			インライン展開しない命令なら false
+ *
+ * @note			活性レコードがスタック上にある場合のローカル変数の読み書き、
+ *					30bit整数の算術演算と比較、定数のプッシュ、分岐を展開する。
+ *					展開したコードは PC を更新せず、前提が成り立たない場合は
+ *					何も変更せずに命令ハンドラの呼出し（slow）に進む。
+ */
+
+bool jit_inline(vm_jitbuf_t * j, vm_inst_t * inst, uint32_t npc, size_t len, uint32_t * slow, uint32_t * nslow)
+{
+    uint32_t	target = (uint32_t)(int32_t)inst->b;
+    uint32_t	isnil[2];
+    uint32_t	done;
+
+    *nslow = 0;
+
+    switch (inst->a << 3)
+    {
+        case kNBCPop:
+            if (inst->b != kNBCPop)
+                return false;
+
+            jit_mem(j, 0, 0x8B, 1, JIT_SP);					// mov ecx, [rbx + SP]
+            jit_emit(j, (const uint8_t *)"\x85\xC9", 2);	// test ecx, ecx
+            done = jit_jcc(j, JIT_JE);
+            jit_emit(j, (const uint8_t *)"\xFF\xC9", 2);	// dec ecx
+            jit_mem(j, 0, 0x89, 1, JIT_SP);					// mov [rbx + SP], ecx
+            jit_label(j, done);
+            return true;
+
+        case kNBCPushConstant:
+            {
+                newtRefVar	r = (newtRef)inst->b;
+
+                // is_push_constant と同じ値を作成する
+                if (NewtRefIsInteger(r))
+                {
+                    size_t	n = NewtRefToInteger(r);
+
+                    if (8191 < n)
+                        r = NewtMakeInt30((int32_t)(n | 0xFFFFC000));
+                }
+                else
+                {
+                    r = (r & 0xffff);
+                }
+
+                jit_mem(j, 0, 0x8B, 1, JIT_SP);				// mov ecx, [rbx + SP]
+                jit_mem(j, 0, 0x3B, 1, JIT_NUMS);			// cmp ecx, [rbx + nums]
+                slow[(*nslow)++] = jit_jcc(j, JIT_JAE);
+                jit_mem(j, 0x48, 0x8B, 2, JIT_STACKP);		// mov rdx, [rbx + STACK]
+                jit_emit(j, (const uint8_t *)"\x48\xB8", 2);	// mov rax, r
+                jit_u64(j, (uint64_t)r);
+            }
+            break;
+
+        case kNBCGetVar:
+            if (inst->b < 0)
+                return false;
+
+            jit_mem(j, 0, 0x8B, 0, JIT_BP);					// mov eax, [rbx + BP]
+            jit_emit(j, (const uint8_t *)"\x83\xF8\xFF", 3);	// cmp eax, NO_BP
+            slow[(*nslow)++] = jit_jcc(j, JIT_JE);
+            jit_mem(j, 0, 0x8B, 1, JIT_SP);					// mov ecx, [rbx + SP]
+            jit_mem(j, 0, 0x3B, 1, JIT_NUMS);				// cmp ecx, [rbx + nums]
+            slow[(*nslow)++] = jit_jcc(j, JIT_JAE);
+            jit_emit(j, (const uint8_t *)"\x05", 1);		// add eax, b
+            jit_u32(j, (uint32_t)inst->b);
+            jit_emit(j, (const uint8_t *)"\x39\xC8", 2);	// cmp eax, ecx
+            slow[(*nslow)++] = jit_jcc(j, JIT_JAE);
+            jit_mem(j, 0x48, 0x8B, 2, JIT_STACKP);			// mov rdx, [rbx + STACK]
+            jit_emit(j, (const uint8_t *)"\x48\x8B\x04\xC2", 4);	// mov rax, [rdx + rax * 8]
+            break;
+
+        case kNBCSetVar:
+            if (inst->b < 0)
+                return false;
+
+            jit_mem(j, 0, 0x8B, 0, JIT_BP);					// mov eax, [rbx + BP]
+            jit_emit(j, (const uint8_t *)"\x83\xF8\xFF", 3);	// cmp eax, NO_BP
+            slow[(*nslow)++] = jit_jcc(j, JIT_JE);
+            jit_mem(j, 0, 0x8B, 1, JIT_SP);					// mov ecx, [rbx + SP]
+            jit_emit(j, (const uint8_t *)"\x85\xC9", 2);	// test ecx, ecx
+            slow[(*nslow)++] = jit_jcc(j, JIT_JE);
+            jit_emit(j, (const uint8_t *)"\xFF\xC9", 2);	// dec ecx
+            jit_mem(j, 0, 0x89, 1, JIT_SP);					// mov [rbx + SP], ecx
+            jit_mem(j, 0x48, 0x8B, 2, JIT_STACKP);			// mov rdx, [rbx + STACK]
+            jit_emit(j, (const uint8_t *)"\x48\x8B\x34\xCA", 4);	// mov rsi, [rdx + rcx * 8]
+            jit_emit(j, (const uint8_t *)"\x05", 1);		// add eax, b
+            jit_u32(j, (uint32_t)inst->b);
+            jit_emit(j, (const uint8_t *)"\x39\xC8", 2);	// cmp eax, ecx
+            done = jit_jcc(j, JIT_JAE);
+            jit_emit(j, (const uint8_t *)"\x48\x89\x34\xC2", 4);	// mov [rdx + rax * 8], rsi
+            jit_label(j, done);
+            return true;
+
+        case kNBCBranch:
+            jit_goto(j, target, len);
+            return true;
+
+        case kNBCBranchIfTrue:
+        case kNBCBranchIfFalse:
+            jit_mem(j, 0, 0x8B, 1, JIT_SP);					// mov ecx, [rbx + SP]
+            jit_emit(j, (const uint8_t *)"\x85\xC9", 2);	// test ecx, ecx
+            slow[(*nslow)++] = jit_jcc(j, JIT_JE);
+            jit_mem(j, 0x48, 0x8B, 2, JIT_STACKP);			// mov rdx, [rbx + STACK]
+            jit_emit(j, (const uint8_t *)"\x48\x8B\x44\xCA\xF8", 5);	// mov rax, [rdx + rcx * 8 - 8]
+            jit_emit(j, (const uint8_t *)"\x89\xC6", 2);	// mov esi, eax
+            jit_emit(j, (const uint8_t *)"\x83\xE6\x03", 3);	// and esi, 3
+            jit_emit(j, (const uint8_t *)"\x83\xFE\x03", 3);	// cmp esi, 3（マジックポインタ）
+            slow[(*nslow)++] = jit_jcc(j, JIT_JE);
+            jit_emit(j, (const uint8_t *)"\xFF\xC9", 2);	// dec ecx
+            jit_mem(j, 0, 0x89, 1, JIT_SP);					// mov [rbx + SP], ecx
+            jit_emit(j, (const uint8_t *)"\x48\x83\xF8\x02", 4);	// cmp rax, kNewtRefNIL
+            isnil[0] = jit_jcc(j, JIT_JE);
+            jit_emit(j, (const uint8_t *)"\x48\x3D\xF2\xFF\x00\x00", 6);	// cmp rax, kNewtRefUnbind
+            isnil[1] = jit_jcc(j, JIT_JE);
+
+            if (inst->a << 3 == kNBCBranchIfTrue)
+            {
+                jit_goto(j, target, len);
+                jit_label(j, isnil[0]);
+                jit_label(j, isnil[1]);
+            }
+            else
+            {
+                done = jit_jcc(j, JIT_JMP);
+                jit_label(j, isnil[0]);
+                jit_label(j, isnil[1]);
+                jit_goto(j, target, len);
+                jit_label(j, done);
+            }
+
+            return true;
+
+        case kNBCFreqFunc:
+            switch (inst->b)
+            {
+                case kNBCAdd:
+                case kNBCSubtract:
+                case kNBCMultiply:
+                case kNBCEquals:
+                case kNBCNotEqual:
+                case kNBCLessThan:
+                case kNBCGreaterThan:
+                case kNBCGreaterOrEqual:
+                case kNBCLessOrEqual:
+                    break;
+
+                default:
+                    return false;
+            }
+
+            jit_mem(j, 0, 0x8B, 1, JIT_SP);					// mov ecx, [rbx + SP]
+            jit_emit(j, (const uint8_t *)"\x83\xF9\x02", 3);	// cmp ecx, 2
+            slow[(*nslow)++] = jit_jcc(j, JIT_JB);
+            jit_mem(j, 0x48, 0x8B, 2, JIT_STACKP);			// mov rdx, [rbx + STACK]
+            jit_emit(j, (const uint8_t *)"\x48\x8B\x44\xCA\xF0", 5);	// mov rax, [rdx + rcx * 8 - 16]
+            jit_emit(j, (const uint8_t *)"\x48\x8B\x74\xCA\xF8", 5);	// mov rsi, [rdx + rcx * 8 - 8]
+            jit_emit(j, (const uint8_t *)"\xA8\x03", 2);	// test al, 3
+            slow[(*nslow)++] = jit_jcc(j, JIT_JNE);
+            jit_emit(j, (const uint8_t *)"\x40\xF6\xC6\x03", 4);	// test sil, 3
+            slow[(*nslow)++] = jit_jcc(j, JIT_JNE);
+            jit_emit(j, (const uint8_t *)"\x48\xC1\xF8\x02", 4);	// sar rax, 2（NewtRefToInt30）
+            jit_emit(j, (const uint8_t *)"\x48\xC1\xFE\x02", 4);	// sar rsi, 2
+
+            switch (inst->b)
+            {
+                case kNBCAdd:
+                case kNBCSubtract:
+                case kNBCMultiply:
+                    if (inst->b == kNBCAdd)
+                        jit_emit(j, (const uint8_t *)"\x48\x01\xF0", 3);		// add rax, rsi
+                    else if (inst->b == kNBCSubtract)
+                        jit_emit(j, (const uint8_t *)"\x48\x29\xF0", 3);		// sub rax, rsi
+                    else
+                        jit_emit(j, (const uint8_t *)"\x48\x0F\xAF\xC6", 4);	// imul rax, rsi
+
+                    slow[(*nslow)++] = jit_jcc(j, JIT_JO);
+                    // 62bit の即値に収まらなければ命令ハンドラで計算する
+                    jit_emit(j, (const uint8_t *)"\x48\x89\xC7", 3);		// mov rdi, rax
+                    jit_emit(j, (const uint8_t *)"\x48\xC1\xE7\x02", 4);	// shl rdi, 2
+                    jit_emit(j, (const uint8_t *)"\x48\xC1\xFF\x02", 4);	// sar rdi, 2
+                    jit_emit(j, (const uint8_t *)"\x48\x39\xC7", 3);		// cmp rdi, rax
+                    slow[(*nslow)++] = jit_jcc(j, JIT_JNE);
+                    jit_emit(j, (const uint8_t *)"\x48\xC1\xE0\x02", 4);	// shl rax, 2（NewtMakeInt30）
+                    break;
+
+                default:
+                    {
+                        uint8_t	cmov[3] = {0x0F, 0x44, 0xC6};	// cmove eax, esi
+
+                        switch (inst->b)
+                        {
+                            case kNBCNotEqual:			cmov[1] = 0x45; break;	// cmovne
+                            case kNBCLessThan:			cmov[1] = 0x4C; break;	// cmovl
+                            case kNBCGreaterThan:		cmov[1] = 0x4F; break;	// cmovg
+                            case kNBCGreaterOrEqual:	cmov[1] = 0x4D; break;	// cmovge
+                            case kNBCLessOrEqual:		cmov[1] = 0x4E; break;	// cmovle
+                        }
+
+                        jit_emit(j, (const uint8_t *)"\x48\x39\xF0", 3);	// cmp rax, rsi
+                        jit_emit(j, (const uint8_t *)"\xB8\x02\x00\x00\x00", 5);	// mov eax, kNewtRefNIL
+                        jit_emit(j, (const uint8_t *)"\xBE\x1A\x00\x00\x00", 5);	// mov esi, kNewtRefTRUE
+                        jit_emit(j, cmov, sizeof(cmov));
+                    }
+                    break;
+            }
+
+            jit_emit(j, (const uint8_t *)"\xFF\xC9", 2);	// dec ecx
+            jit_mem(j, 0, 0x89, 1, JIT_SP);					// mov [rbx + SP], ecx
+            jit_emit(j, (const uint8_t *)"\x48\x89\x44\xCA\xF8", 5);	// mov [rdx + rcx * 8 - 8], rax
+            return true;
+
+        default:
+            return false;
+    }
+
+    // スタックにプッシュする（rax: 値、rcx: SP、rdx: STACK）
+    jit_emit(j, (const uint8_t *)"\x48\x89\x04\xCA", 4);	// mov [rdx + rcx * 8], rax
+    jit_emit(j, (const uint8_t *)"\xFF\xC1", 2);			// inc ecx
+    jit_mem(j, 0, 0x89, 1, JIT_SP);							// mov [rbx + SP], ecx
+
+    return true;
+}
+
+
+/*------------------------------------------------------------------------*/
+/** 前処理済み命令を x86-64 のネイティブコードにコンパイルする
+ *
+ * @param code		[in] 前処理済み命令キャッシュのエントリ
+ *
+ * @return			JIT コンパイルしたネイティブコード（失敗した場合は NULL）
+ *
+ * @note			命令ごとのテンプレートを並べるベースライン JIT。
+ *					先頭のトランポリンは rbx に &vm_env、r12d に呼出し時の CALLSP、
+ *					r13 に &NEWT_NEEDGC をセットして rdi の入口にジャンプする。
+ *					インタプリタとの状態はすべて vm_env で受け渡すので、
+ *					どの命令の後でもインタプリタに戻って実行を続けられる。
+ */
+
+vm_jit_t * NVMJITCompile(vm_code_t * code)
+{
+    vm_jitbuf_t	j;
+    vm_inst_t *	insts = code->insts;
+    vm_inst_t *	inst;
+    vm_jit_t *	jit = NULL;
+    size_t		len = code->bclen;
+    uint8_t *	mem;
+    uint32_t	slow[8];
+    uint32_t	nslow;
+    uint32_t	target;
+    uint32_t	done;
+    uint32_t	pc;
+    uint32_t	npc;
+    uint32_t	i;
+
+    if (insts == NULL || len == 0)
+        return NULL;
+
+    memset(&j, 0, sizeof(j));
+
+    j.offsets = (uint32_t *)NewtMemCalloc(NULL, len, sizeof(uint32_t));
+    j.starts = (bool *)NewtMemCalloc(NULL, len, sizeof(bool));
+    j.fixups = (uint32_t *)NewtMemCalloc(NULL, len * 4 + 4, sizeof(uint32_t));
+
+    if (j.offsets == NULL || j.starts == NULL || j.fixups == NULL)
+        goto cleanup;
+
+    for (pc = 0; pc < len; pc += insts[pc].len)
+    {
+        j.starts[pc] = true;
+    }
+
+    // トランポリン
+    jit_emit(&j, (const uint8_t *)"\x53\x41\x54\x41\x55", 5);	// push rbx; push r12; push r13
+    jit_emit(&j, (const uint8_t *)"\x48\xBB", 2);					// mov rbx, &vm_env
+    jit_u64(&j, (uintptr_t)&vm_env);
+    jit_mem(&j, 0x44, 0x8B, 4, JIT_CALLSP);							// mov r12d, [rbx + CALLSP]
+    jit_emit(&j, (const uint8_t *)"\x49\xBD", 2);					// mov r13, &NEWT_NEEDGC
+    jit_u64(&j, (uintptr_t)&NEWT_NEEDGC);
+    jit_emit(&j, (const uint8_t *)"\xFF\xE7", 2);					// jmp rdi
+
+    // インタプリタに戻る
+    j.exit = (uint32_t)j.len;
+    jit_emit(&j, (const uint8_t *)"\x41\x5D\x41\x5C\x5B\xC3", 6);	// pop r13; pop r12; pop rbx; ret
+
+    for (pc = 0; pc < len; pc = npc)
+    {
+        inst = &insts[pc];
+        npc = pc + inst->len;
+        j.offsets[pc] = (uint32_t)j.len;
+
+        // 範囲外の命令は何もしない
+        if (kNBCInstructionsLen <= inst->a)
+            continue;
+
+        // 例外ハンドラ表のある TRY文の先頭は new-handlers の次へジャンプする
+        if (inst->op == kVMOpTryEnter)
+        {
+            jit_goto(&j, inst->skip, len);
+            continue;
+        }
+
+        switch (inst->a << 3)
+        {
+            case kNBCBranch:
+            case kNBCBranchIfTrue:
+            case kNBCBranchIfFalse:
+            case kNBCBranchIfLoopNotDone:
+                target = (uint32_t)(int32_t)inst->b;
+                break;
+
+            default:
+                target = npc;
+                break;
+        }
+
+        if (jit_inline(&j, inst, npc, len, slow, &nslow))
+        {
+            if (nslow == 0)
+                continue;
+
+            done = jit_jcc(&j, JIT_JMP);
+
+            for (i = 0; i < nslow; i++)
+            {
+                jit_label(&j, slow[i]);
+            }
+
+            jit_generic(&j, insts, pc, npc, target, len);
+            jit_label(&j, done);
+        }
+        else
+        {
+            jit_generic(&j, insts, pc, npc, target, len);
+        }
+    }
+
+    jit_set_pc(&j, pc);
+    jit_jcc_to(&j, JIT_JMP, j.exit);
+
+    if (j.failed)
+        goto cleanup;
+
+    for (i = 0; i < j.nfixups; i++)
+    {
+        uint32_t	pos = j.fixups[i * 2];
+        uint32_t	rel = j.offsets[j.fixups[i * 2 + 1]] - (pos + 4);
+
+        memcpy(j.buf + pos, &rel, sizeof(rel));
+    }
+
+    mem = (uint8_t *)mmap(NULL, j.len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON, -1, 0);
+
+    if (mem == MAP_FAILED)
+        goto cleanup;
+
+    memcpy(mem, j.buf, j.len);
+
+    jit = (vm_jit_t *)NewtMemAlloc(NULL, sizeof(vm_jit_t));
+
+    if (jit != NULL)
+        jit->entry = (void **)NewtMemCalloc(NULL, len, sizeof(void *));
+
+    if (jit == NULL || jit->entry == NULL || mprotect(mem, j.len, PROT_READ | PROT_EXEC) != 0)
+    {
+        if (jit != NULL)
+        {
+            NewtMemFree(jit->entry);
+            NewtMemFree(jit);
+            jit = NULL;
+        }
+
+        munmap(mem, j.len);
+        goto cleanup;
+    }
+
+    jit->code = mem;
+    jit->size = j.len;
+
+    for (pc = 0; pc < len; pc++)
+    {
+        if (j.starts[pc])
+            jit->entry[pc] = mem + j.offsets[pc];
+    }
+
+    if (NEWT_DEBUG)
+        NewtDebugMsg("JIT", "%u bytes of bytecode -> %u bytes of native code\n",
+                (unsigned int)len, (unsigned int)j.len);
+
+cleanup:
+    NewtMemFree(j.buf);
+    NewtMemFree(j.offsets);
+    NewtMemFree(j.starts);
+    NewtMemFree(j.fixups);
+
+    return jit;
+}
+
+
+#undef JIT_CHUNK
+#undef JIT_PC
+#undef JIT_SP
+#undef JIT_BP
+#undef JIT_STACKP
+#undef JIT_NUMS
+#undef JIT_CALLSP
+#undef JIT_INSTS
+#undef JIT_JMP
+#undef JIT_JO
+#undef JIT_JB
+#undef JIT_JAE
+#undef JIT_JE
+#undef JIT_JNE
+
+#endif /* __NEWT_JIT__ */
+
+
+#if 0
+#pragma mark *** インラインキャッシュ
+#endif
+/*------------------------------------------------------------------------*/
+/** 実行中の命令のインラインキャッシュを取得する
+ *
+ * @return			インラインキャッシュ（作成できない場合は NULL）
+ *
+ * @note			インラインキャッシュがなければ作成する
+ */
+
+vm_ic_t * ic_get(void)
+{
+    vm_ic_t *	ic;
+
+    if (vm_site == NULL)
+        return NULL;
+
+    ic = vm_site->ic;
+
+    if (ic == NULL)
+    {
+        ic = (vm_ic_t *)NewtMemCalloc(NULL, 1, sizeof(vm_ic_t));
+        if (ic == NULL) return NULL;
+
+        ic->next = vm_iclist;
+        ic->prevp = &vm_iclist;
+
+        if (vm_iclist != NULL)
+            vm_iclist->prevp = &ic->next;
+
+        vm_iclist = ic;
+        vm_site->ic = ic;
+    }
+
+    return ic;
+}
+
+
+/*------------------------------------------------------------------------*/
+/** インラインキャッシュを解放する
+ *
+ * @param ic		[in] インラインキャッシュ
+ *
+ * @return			なし
+ */
+
+void ic_free(vm_ic_t * ic)
+{
+    *ic->prevp = ic->next;
+
+    if (ic->next != NULL)
+        ic->next->prevp = ic->prevp;
+
+    NewtMemFree(ic);
+}
+
+
+/*------------------------------------------------------------------------*/
+/** 解放されるマップを記録しているエントリを無効にする
+ *
+ * @return			なし
+ *
+ * @note			GC のマーク後、スウィープ前に呼出すこと
+ */
+
+void ic_sweep(void)
+{
+    vm_icentry_t *	entry;
+    newtObjRef		obj;
+    vm_ic_t *		ic;
+    uint16_t		i;
+    uint16_t		j;
+
+    for (ic = vm_iclist; ic != NULL; ic = ic->next)
+    {
+        for (i = 0; i < NEWT_NUM_ICENTRIES; i++)
+        {
+            entry = &ic->entries[i];
+
+            for (j = 0; j < entry->depth; j++)
+            {
+                if (! NewtRefIsPointer(entry->frames[j].map))
+                    continue;
+
+                obj = NewtRefToPointer(entry->frames[j].map);
+
+                if (NewtGCIsGarbage(obj))
+                {
+                    entry->depth = 0;
+                    break;
+                }
+            }
+        }
+    }
+}
+
+
+/*------------------------------------------------------------------------*/
+/** インラインキャッシュに記録するスロットの位置を取得する
+ *
+ * @param frame		[in] フレーム
+ * @param slot		[in] スロットシンボル
+ *
+ * @return			スロットの位置（スロットがない場合は -1）
+ */
+
+int32_t ic_slot_index(newtRefArg frame, newtRefArg slot)
+{
+    if (slot == NSSYM0(_proto) && ! NewtHasProto(frame))
+        return -1;
+
+    return (int32_t)NewtFindSlotIndex(frame, slot);
+}
+
+
+/*------------------------------------------------------------------------*/
+/** 記録した位置のスロットの値を取得する
+ *
+ * @param frame		[in] フレーム
+ * @param index		[in] スロットの位置
+ *
+ * @return			値オブジェクト（マジックポインタは解決する）
+ */
+
+newtRef ic_link(newtRefArg frame, int32_t index)
+{
+    if (index < 0)
+        return kNewtRefUnbind;
+
+    return NcResolveMagicPointer(NewtGetFrameSlot(frame, index));
+}
+
+
+/*------------------------------------------------------------------------*/
+/** 探索したフレームを記録または検証する
+ *
+ * @param w			[i/o]探索状態
+ * @param frame		[in] フレーム
+ * @param name		[in] 探索するスロットシンボル
+ * @param link		[in] 次にたどるスロットシンボル
+ *
+ * @return			フレームの情報（失敗した場合は NULL）
+ */
+
+vm_icframe_t * ic_visit(vm_icwalk_t * w, newtRefArg frame, newtRefArg name, newtRefArg link)
+{
+    vm_icframe_t *	rec;
+    newtRefVar		map;
+
+    if (! NewtRefIsFrame(frame) || NEWT_NUM_ICDEPTH <= w->pos)
+    {
+        w->failed = true;
+        return NULL;
+    }
+
+    map = NewtFrameMap(frame);
+    rec = &w->entry->frames[w->pos];
+
+    if (w->fill)
+    {
+        rec->map = map;
+        rec->slot = ic_slot_index(frame, name);
+        rec->link = ic_slot_index(frame, link);
+        rec->parent = ic_slot_index(frame, NSSYM0(_parent));
+    }
+    else if (w->entry->depth <= w->pos || rec->map != map)
+    {
+        w->failed = true;
+        return NULL;
+    }
+
+    w->pos++;
+
+    return rec;
+}
+
+
+/*------------------------------------------------------------------------*/
+/** レキシカルスコープでシンボルを検索（インラインキャッシュ用）
+ *
+ * @param w			[i/o]探索状態
+ * @param start		[in] 開始オブジェクト
+ * @param name		[in] シンボルオブジェクト
+ *
+ * @return			検索されたオブジェクト
+ *
+ * @note			NcLexicalLookup と同じ順にフレームをたどる
+ */
+
+newtRef ic_lexical_lookup(vm_icwalk_t * w, newtRefArg start, newtRefArg name)
+{
+    newtRefVar		current = start;
+    vm_icframe_t *	rec;
+
+    while (NewtRefIsNotNIL(current))
+    {
+        current = NcResolveMagicPointer(current);
+
+        if (NewtRefIsMagicPointer(current))
+            return kNewtRefUnbind;
+
+        rec = ic_visit(w, current, name, NSSYM0(_nextArgFrame));
+        if (rec == NULL) return kNewtRefUnbind;
+
+        if (0 <= rec->slot)
+            return ic_link(current, rec->slot);
+
+        current = ic_link(current, rec->link);
+    }
+
+    return kNewtRefUnbind;
+}
+
+
+/*------------------------------------------------------------------------*/
+/** 実行中の関数のローカル変数からレキシカルスコープでシンボルを検索（インラインキャッシュ用）
+ *
+ * @param w			[i/o]探索状態
+ * @param name		[in] シンボルオブジェクト
+ *
+ * @return			検索されたオブジェクト
+ *
+ * @note			活性レコードがスタック上にある場合は引数フレームのひな形のマップを
+ *					記録し、値はスタックから取出す
+ */
+
+newtRef ic_locals_lookup(vm_icwalk_t * w, newtRefArg name)
+{
+    vm_icframe_t *	rec;
+
+    if (BP == NO_BP)
+        return ic_lexical_lookup(w, LOCALS, name);
+
+    rec = ic_visit(w, LOCALS, name, NSSYM0(_nextArgFrame));
+    if (rec == NULL) return kNewtRefUnbind;
+
+    if (0 <= rec->slot)
+        return NcResolveMagicPointer(STACK[BP + rec->slot]);
+
+    if (rec->link < 0)
+        return kNewtRefUnbind;
+
+    return ic_lexical_lookup(w, STACK[BP + rec->link], name);
+}
+
+
+/*------------------------------------------------------------------------*/
+/** プロト、ペアレント継承でシンボルを検索（インラインキャッシュ用）
+ *
+ * @param w			[i/o]探索状態
+ * @param start		[in] 開始オブジェクト
+ * @param name		[in] シンボルオブジェクト
+ * @param indexP	[out]スロットの位置
+ *
+ * @return			検索されたオブジェクトを持つフレーム
+ *
+ * @note			NcFullLookupFrame と同じ順にフレームをたどる
+ */
+
+newtRef ic_full_lookup_frame(vm_icwalk_t * w, newtRefArg start, newtRefArg name, int32_t * indexP)
+{
+    vm_icframe_t *	leftrec;
+    vm_icframe_t *	rec;
+    newtRefVar		leftframe;
+    newtRefVar		current;
+    newtRefVar		left = start;
+
+    if (! NewtRefIsFrame(start))
+        return kNewtRefUnbind;
+
+    while (NewtRefIsNotNIL(left))
+    {
+        current = left;
+        leftframe = kNewtRefUnbind;
+        leftrec = NULL;
+
+        while (NewtRefIsNotNIL(current))
+        {
+            current = NcResolveMagicPointer(current);
+
+            if (NewtRefIsMagicPointer(current))
+                return kNewtRefUnbind;
+
+            rec = ic_visit(w, current, name, NSSYM0(_proto));
+            if (rec == NULL) return kNewtRefUnbind;
+
+            if (leftrec == NULL)
+            {
+                leftframe = current;
+                leftrec = rec;
+            }
+
+            if (0 <= rec->slot)
+            {
+                *indexP = rec->slot;
+                return current;
+            }
+
+            current = ic_link(current, rec->link);
+        }
+
+        left = ic_link(leftframe, leftrec->parent);
+    }
+
+    return kNewtRefUnbind;
+}
+
+
+/*------------------------------------------------------------------------*/
+/** インラインキャッシュの種類ごとの探索を行う
+ *
+ * @param w			[i/o]探索状態
+ * @param kind		[in] インラインキャッシュの種類
+ * @param r			[in] レシーバ（find-var では未使用）
+ * @param name		[in] シンボルオブジェクト
+ * @param implP		[out]スロットを持つフレーム
+ * @param valueP	[out]スロットの値
+ *
+ * @retval			true	みつかった
+ * @retval			false	みつからなかった
+ */
+
+bool ic_walk(vm_icwalk_t * w, int kind, newtRefArg r, newtRefArg name, newtRefVar * implP, newtRefVar * valueP)
+{
+    vm_icframe_t *	rec;
+    newtRefVar		impl;
+    newtRefVar		v;
+    int32_t			index;
+
+    if (kind == kVMICFindVar)
+    {
+        // is_find_var と同じ順で検索する
+        v = ic_locals_lookup(w, name);
+        if (w->failed) return false;
+
+        if (v != kNewtRefUnbind)
+        {
+            *valueP = v;
+            return true;
+        }
+
+        impl = ic_full_lookup_frame(w, RCVR, name, &index);
+        if (w->failed) return false;
+
+        if (impl != kNewtRefUnbind)
+        {
+            v = ic_link(impl, index);
+
+            if (v != kNewtRefUnbind)
+            {
+                *valueP = v;
+                return true;
+            }
+        }
+
+        rec = ic_visit(w, NcGetGlobals(), name, kNewtRefUnbind);
+        if (rec == NULL || rec->slot < 0) return false;
+
+        *valueP = ic_link(NcGetGlobals(), rec->slot);
+        return true;
+    }
+
+    impl = ic_full_lookup_frame(w, r, name, &index);
+    if (w->failed || impl == kNewtRefUnbind) return false;
+
+    *implP = impl;
+    *valueP = ic_link(impl, index);
+
+    return true;
+}
+
+
+/*------------------------------------------------------------------------*/
+/** インラインキャッシュを使ってスロットを検索する
+ *
+ * @param kind		[in] インラインキャッシュの種類
+ * @param r			[in] レシーバ（find-var では未使用）
+ * @param name		[in] シンボルオブジェクト
+ * @param implP		[out]スロットを持つフレーム
+ * @param valueP	[out]スロットの値
+ *
+ * @retval			true	みつかった
+ * @retval			false	キャッシュできなかった（通常の検索を行うこと）
+ *
+ * @note			シンボルとキャッシュしたフレームのマップが全て一致する場合はマップを
+ *					検索せずに記録したスロットの位置を使う。
+ *					ミスした場合は検索結果をエントリに記録する。
+ */
+
+bool ic_lookup(int kind, newtRefArg r, newtRefArg name, newtRefVar * implP, newtRefVar * valueP)
+{
+    vm_icentry_t	scratch;
+    vm_icentry_t *	entry;
+    vm_icwalk_t		w;
+    vm_ic_t *		ic;
+    uint16_t		i;
+
+    ic = ic_get();
+    if (ic == NULL) return false;
+
+    for (i = 0; i < NEWT_NUM_ICENTRIES; i++)
+    {
+        entry = &ic->entries[i];
+
+        if (entry->depth == 0 || entry->epoch != NEWT_MAPEPOCH || entry->name != name)
+            continue;
+
+        w.entry = entry;
+        w.fill = false;
+        w.failed = false;
+        w.pos = 0;
+
+        if (ic_walk(&w, kind, r, name, implP, valueP) && ! w.failed && w.pos == entry->depth)
+        {
+            vm_ic_hits[kind]++;
+            return true;
+        }
+    }
+
+    vm_ic_misses[kind]++;
+
+    w.entry = &scratch;
+    w.fill = true;
+    w.failed = false;
+    w.pos = 0;
+
+    if (! ic_walk(&w, kind, r, name, implP, valueP) || w.failed)
+        return false;
+
+    // 空いているエントリか古いエントリに記録する
+    for (i = 0; i < NEWT_NUM_ICENTRIES; i++)
+    {
+        entry = &ic->entries[i];
+
+        if (entry->depth == 0 || entry->epoch != NEWT_MAPEPOCH)
+            break;
+    }
+
+    if (i == NEWT_NUM_ICENTRIES)
+    {
+        i = ic->victim;
+        ic->victim = (ic->victim + 1) % NEWT_NUM_ICENTRIES;
+    }
+
+    entry = &ic->entries[i];
+    memcpy(entry->frames, scratch.frames, sizeof(vm_icframe_t) * w.pos);
+    entry->depth = w.pos;
+    entry->epoch = NEWT_MAPEPOCH;
+    entry->name = name;
+
+    return true;
+}
+
+
+/*------------------------------------------------------------------------*/
+/** インラインキャッシュのヒット数とミス数を取得する
+ *
+ * @return			フレーム（send, findVar, getPath ごとの hits, misses）
+ */
+
+newtRef NVMInlineCacheStats(void)
+{
+    newtRefVar	names[kVMICLen];
+    newtRefVar	result;
+    newtRefVar	stat;
+    int			i;
+
+    names[kVMICSend] = NSSYM(send);
+    names[kVMICFindVar] = NSSYM(findVar);
+    names[kVMICGetPath] = NSSYM(getPath);
+
+    result = NcMakeFrame();
+
+    for (i = 0; i < kVMICLen; i++)
+    {
+        stat = NcMakeFrame();
+        NcSetSlot(stat, NSSYM(hits), NewtMakeInteger(vm_ic_hits[i]));
+        NcSetSlot(stat, NSSYM(misses), NewtMakeInteger(vm_ic_misses[i]));
+        NcSetSlot(result, names[i], stat);
+    }
+
+    return result;
+}
+
+
+#if 0
+#pragma mark -
+#endif
+/*------------------------------------------------------------------------*/
+/** 関数オブジェクトを現在の実行関数にする
+ *
+ * @param fn	[in] 関数オブジェクト
+ *
+ * @return		なし
+ */
+
+void NVMSetFn(newtRefArg fn)
+{
+    int		type;
+
+    FUNC = fn;
+    type = NewtRefIsNIL(FUNC)?kNewtNotFunction:vm_fn_type(FUNC);
+
+    if (type != kNewtCodeBlock && type != kNewtFastFunction)
+    {
+        BC = NULL;
+        BCLEN = 0;
+        INSTS = NULL;
+        CODE = NULL;
+        JIT = NULL;
+    }
+    else
+    {
+        newtRefVar	instr;
+
+        instr = vm_fn_get(FUNC, kVMFnInstructions, NSSYM0(instructions));
+        BC = NewtRefToBinary(instr);
+        BCLEN = NewtLength(instr);
+        CODE = NVMLookupCode(instr);
+        INSTS = (CODE != NULL) ? CODE->insts : NULL;
+        JIT = NULL;
+
+        if (CODE != NULL && ! CODE->checked)
+            NVMApplyHandlers(CODE, FUNC);
+
+        if (CODE != NULL && NEWT_MODE_JIT)
+            JIT = NVMJITHot(CODE);
+    }
+}
+
+
+/*------------------------------------------------------------------------*/
+/** 戻る関数スタックがない場合の処理
+ *
+ * @return		なし
+ */
+
+void NVMNoStackFrameForReturn(void)
+{
+    BC = NULL;
+    BCLEN = 0;
+    INSTS = NULL;
+    CODE = NULL;
+    JIT = NULL;
+    // Change PC to exit other tests such as si_set_lex_scope.
+    PC = (uint32_t) -1;
+}
+
+/*------------------------------------------------------------------------*/
+/** Build a new arg frame for a fast function that does not have any.
+ *
+ * @return		a new arg frame
+ */
+newtRef NVMMakeFastFunctionArgFrame(newtRefArg fn)
+{
+    newtRefVar numArgs;
+    uint16_t fnNumArgs;
+    uintptr_t fnNumLocals;
+    size_t argFrameSize;
+    newtRefVar argFrameMap;
+    newtRefVar result;
+    size_t argIndex;
+
+    numArgs = vm_fn_get(fn, kVMFnNumArgs, NSSYM0(numArgs));
+    fnNumArgs = FFNumArgsToNumArgs(numArgs);
+    if (NewtRefIsNotNIL(vm_fn_get(fn, kVMFnIndefinite, NSSYM0(indefinite))))
+        fnNumArgs++;
+    fnNumLocals = FFNumArgsToLocals(numArgs);
+    argFrameSize = fnNumArgs + fnNumLocals + 3;
+
+    argFrameMap = NewtMakeSlotsObj(NewtMakeInteger(0), argFrameSize + 1, 0);
+
+    NewtSlotsSetSlot(argFrameMap, 0, kNewtRefNIL);
+    NewtSlotsSetSlot(argFrameMap, 1, NSSYM0(_nextArgFrame));
+    NewtSlotsSetSlot(argFrameMap, 2, NSSYM0(_parent));
+    NewtSlotsSetSlot(argFrameMap, 3, NSSYM0(_implementor));
+
+    result = NewtMakeFrame(argFrameMap, argFrameSize);
+    NewtSetFrameSlot(result, 0, kNewtRefNIL);
+    NewtSetFrameSlot(result, 1, kNewtRefNIL);
+    NewtSetFrameSlot(result, 2, kNewtRefNIL);
+
+    // Other elements just don't have any name and will be accessed by position.
+    for (argIndex = 0; argIndex < fnNumArgs + fnNumLocals; argIndex++) {
+         NewtSetArraySlot(argFrameMap, argIndex + 4, kNewtRefNIL);
+         NewtSetFrameSlot(result, argIndex + 3, kNewtRefNIL);
+    }
+
+    return result;
+}
+
+#if 0
+#pragma mark *** 呼出しスタック
+#endif
+/*------------------------------------------------------------------------*/
+/** レジスタの巻き戻し
+ *
+ * @param sp	[in] 呼出しスタックのスタックポインタ
+ *
+ * @return		なし
+ *
+ * @note		戻った関数が new-handlers でプッシュした例外ハンドラも取除く
+ *				（return で TRY文を抜けた場合に残らないように）。
+ */
+
+void reg_rewind(int32_t sp)
+{
+    if (sp == CALLSP)
+        return;
+
+    if (sp < CALLSP)
+    {
+        CALLSP = sp;
+        REG = CALLSTACK[CALLSP];
+        NVMSetFn(FUNC);
+
+        while (0 < EXCPSP && (int32_t)EXCPSTACK[EXCPSP - 1].callsp > sp)
+            EXCPSP--;
+    }
+    else
+    {
+        NVMNoStackFrameForReturn();
+    }
+}
+
+
+/*------------------------------------------------------------------------*/
+/** レジスタのポップ
+ *
+ * @return			なし
+ */
+
+void reg_pop(void)
+{
+	reg_rewind(CALLSP - 1);
+}
+
+
+/*------------------------------------------------------------------------*/
+/** レジスタのプッシュ
+ *
+ * @param sp		[in] スタックポインタ
+ *
+ * @return			なし
+ */
+
+void reg_push(int32_t sp)
+{
+    if (! NewtStackExpand(&vm_env.callstack, CALLSP + 1))
+        return;
+
+    CALLSTACK[CALLSP] = REG;
+    CALLSTACK[CALLSP].sp = sp;
+    CALLSP++;
+}
+
+
+/*------------------------------------------------------------------------*/
+/** レジスタの保存
+ *
+ * @param sp		[in] スタックポインタ
+ *
+ * @return			なし
+ */
+
+void reg_save(int32_t sp)
+{
+//    PC++;
+    reg_push(sp);
+}
+
+
+/*------------------------------------------------------------------------*/
+/** 実行中の呼出し命令が末尾呼出しにできるか調べる
+ *
+ * @retval			true	現在の活性レコードを再利用できる
+ * @retval			false	通常の呼出しをする
+ *
+ * @note			呼出し命令の直後（PC の位置）が return の場合だけ末尾呼出しにする。
+ *					現在の関数が作成した例外ハンドラが残っている場合は、
+ *					ハンドラが呼出し先の例外を捕まえられるように活性レコードを残す。
+ */
+
+bool reg_tail(void)
+{
+    vm_excp_t *	excp;
+
+    if (! NEWT_MODE_TAILCALL || CALLSP == 0)
+        return false;
+
+    if (BC == NULL || BCLEN <= PC || BC[PC] != kNBCReturn)
+        return false;
+
+    excp = excp_top();
+
+    if (excp != NULL && CALLSP <= excp->callsp)
+        return false;
+
+    // 例外ハンドラ表の TRY文の中
+    return (vm_handler_lookup(CODE, PC, kNewtRefUnbind) == NULL);
+}
+
+
+/*------------------------------------------------------------------------*/
+/** 末尾呼出しのために現在の活性レコードを再利用する
+ *
+ * @param numArgs	[in] 引数の数
+ *
+ * @return			なし
+ *
+ * @note			引数を現在の関数の活性レコードの先頭へ移し、呼出しスタックには
+ *					現在の関数の呼出し元のレジスタを残したままにする。
+ *					呼出し先の return はそのまま呼出し元へ戻る。
+ */
+
+void reg_reuse(int16_t numArgs)
+{
+    uint32_t	sp;
+
+    sp = CALLSTACK[CALLSP - 1].sp;
+    memmove(&STACK[sp], &STACK[SP - numArgs], numArgs * sizeof(newtRef));
+    SP = sp + numArgs;
+}
+
+
+#if 0
+#pragma mark *** スタック
+#endif
+/*------------------------------------------------------------------------*/
+/** スタックのポップ
+ *
+ * @return			オブジェクト
+ */
+
+newtRef stk_pop0(void)
+{
+    newtRefVar	x = kNewtRefUnbind;
+
+    if (0 < SP)
     {
-        a[n] = stk_pop();
+        SP--;
+        x = STACK[SP];
     }
+
+    return x;
+}
+
+
+/*------------------------------------------------------------------------*/
+/** スタックのポップ（マジックポインタ参照を解決）
+ *
+ * @return			オブジェクト
+ */
+
+newtRef stk_pop(void)
+{
+	return NcResolveMagicPointer(stk_pop0());
 }
 
 
@@ -1026,7 +3944,7 @@ newtRef liter_get(int16_t n)
 {
     newtRefVar	literals;
 
-    literals = NcGetSlot(FUNC, NSSYM0(literals));
+    literals = vm_fn_get(FUNC, kVMFnLiterals, NSSYM0(literals));
 
     if (NewtRefIsNotNIL(literals))
         return NewtGetArraySlot(literals, n);
@@ -1045,13 +3963,20 @@ newtRef liter_get(int16_t n)
  * @param deeply	[in] deeply フラグ
  *
  * @return			イテレータオブジェクト
+ *
+ * @note			終了したイテレータオブジェクトが残っていれば再利用するので、
+ *					foreach を繰り返してもイテレータオブジェクトは確保しない。
+ *					バイトコードからは aref で読むのでオブジェクトの形式は変えない。
  */
 
 newtRef iter_new(newtRefArg r, newtRefArg deeply)
 {
     newtRefVar	iter;
 
-    iter = NewtMakeArray(NSSYM0(forEachState), kIterALength);
+    if (0 < vm_iternums)
+        iter = vm_iterpool[--vm_iternums];
+    else
+        iter = NewtMakeArray(NSSYM0(forEachState), kIterALength);
 
     NewtSetArraySlot(iter, kIterObj, r);
 
@@ -1074,17 +3999,41 @@ newtRef iter_new(newtRefArg r, newtRefArg deeply)
 }
 
 
+/*------------------------------------------------------------------------*/
+/** スロットの値を取得する（イテレータ用）
+ *
+ * @param r			[in] 配列、フレームまたはマップ
+ * @param pos		[in] 位置
+ *
+ * @return			値オブジェクト
+ *
+ * @note			繰り返し中に長さが変わってもよいように範囲をチェックする
+ */
+
+newtRef iter_slot(newtRefArg r, intptr_t pos)
+{
+    if ((size_t)pos < NewtSlotsLength(r))
+        return NewtRefToSlots(r)[pos];
+    else
+        return kNewtRefUnbind;
+}
+
+
 /*------------------------------------------------------------------------*/
 /** イテレータを次に進める
  *
  * @param iter		[in] イテレータオブジェクト
  *
  * @return			なし
+ *
+ * @note			配列、フレーム、プロトをたどるフレームに分けて、
+ *					イテレータオブジェクトのスロットを直接読み書きする。
  */
 
 void iter_next(newtRefArg iter)
 {
-    newtRefVar	deeply;
+    newtObjRef	iterobj;
+    newtRef *	st;
     newtRefVar	obj;
     newtRefVar	index = kNewtRefUnbind;
     newtRefVar	value = kNewtRefUnbind;
@@ -1092,36 +4041,41 @@ void iter_next(newtRefArg iter)
     intptr_t	pos;
     intptr_t	len;
 
-    obj = NewtGetArraySlot(iter, kIterObj);
-    deeply = NewtGetArraySlot(iter, kIterDeeply);
-    pos = NewtRefToInteger(NewtGetArraySlot(iter, kIterPos));
-    len = NewtRefToInteger(NewtGetArraySlot(iter, kIterMax));
-    map = NewtGetArraySlot(iter, kIterMap);
+    if (! NewtRefIsArray(iter) || NewtArrayLength(iter) < kIterALength)
+        return;
+
+    iterobj = NewtRefToPointer(iter);
+    st = NewtRefToSlots(iter);
 
-    if (NewtRefIsNIL(deeply) || NewtRefIsNIL(map))
-    {
-        pos++;
+    obj = st[kIterObj];
+    map = st[kIterMap];
+    pos = NewtRefToInteger(st[kIterPos]) + 1;
+    len = NewtRefToInteger(st[kIterMax]);
 
+    if (NewtRefIsNIL(map))
+    {	// 配列、文字列、バイナリ
         if (pos < len)
         {
-            if (NewtRefIsNIL(map))
-            {
-                index = NewtMakeInteger(pos);
-                value = NewtARef(obj, pos);
-            }
+            index = NewtMakeInteger(pos);
+
+            if (NewtRefIsArray(obj))
+                value = iter_slot(obj, pos);
             else
-            {
-                index = NewtGetArraySlot(map, pos + 1);
-                value = NewtGetFrameSlot(obj, pos);
-            }
+                value = NewtARef(obj, pos);
+        }
+    }
+    else if (NewtRefIsNIL(st[kIterDeeply]))
+    {	// フレーム
+        if (pos < len)
+        {
+            index = iter_slot(map, pos + 1);
+            value = iter_slot(obj, pos);
         }
     }
     else
-    {
+    {	// プロトをたどるフレーム
         while (true)
         {
-            pos++;
-
             if (len <= pos)
             {
                 obj = NcGetSlot(obj, NSSYM0(_proto));
@@ -1135,27 +4089,33 @@ void iter_next(newtRefArg iter)
                 map = NewtFrameMap(obj);
                 len = NewtLength(obj);
 
-                NewtSetArraySlot(iter, kIterObj, obj);
-                NewtSetArraySlot(iter, kIterMap, map);
-                NewtSetArraySlot(iter, kIterMax, NewtMakeInteger(len));
+                st[kIterObj] = obj;
+                NewtGCWriteBarrier(iterobj, obj);
+                st[kIterMap] = map;
+                NewtGCWriteBarrier(iterobj, map);
+                st[kIterMax] = NewtMakeInteger(len);
 
-                pos = -1;
+                pos = 0;
                 continue;
             }
 
-            index = NewtGetArraySlot(map, pos + 1);
+            index = iter_slot(map, pos + 1);
 
             if (index != NSSYM0(_proto))
             {
-                value = NewtGetFrameSlot(obj, pos);
+                value = iter_slot(obj, pos);
                 break;
             }
+
+            pos++;
         }
     }
 
-    NewtSetArraySlot(iter, kIterIndex, index);
-    NewtSetArraySlot(iter, kIterPos, NewtMakeInteger(pos));
-    NewtSetArraySlot(iter, kIterValue, value);
+    st[kIterIndex] = index;
+    NewtGCWriteBarrier(iterobj, index);
+    st[kIterPos] = NewtMakeInteger(pos);
+    st[kIterValue] = value;
+    NewtGCWriteBarrier(iterobj, value);
 }
 
 
@@ -1166,78 +4126,384 @@ void iter_next(newtRefArg iter)
  *
  * @retval			true	終了
  * @retval			false	終了していない
+ *
+ * @note			終了したイテレータオブジェクトは次の new-iterator で再利用する
+ */
+
+bool iter_done(newtRefArg iter)
+{
+    newtRef *	st;
+
+    if (! NewtRefIsArray(iter) || NewtArrayLength(iter) < kIterALength)
+        return true;
+
+    st = NewtRefToSlots(iter);
+
+    if (NewtRefToInteger(st[kIterPos]) < NewtRefToInteger(st[kIterMax]))
+        return false;
+
+    if (st[kIterObj] != kNewtRefUnbind)
+        iter_free(iter);
+
+    return true;
+}
+
+
+/*------------------------------------------------------------------------*/
+/** 終了したイテレータオブジェクトを再利用するために取っておく
+ *
+ * @param iter		[in] イテレータオブジェクト
+ *
+ * @return			なし
+ *
+ * @note			繰り返していたオブジェクトを参照し続けないように、
+ *					位置と長さ以外のスロットを空にする。kIterObj が #UNBIND の
+ *					イテレータは取っておいたもの（二重に登録しない）。
+ */
+
+void iter_free(newtRefArg iter)
+{
+    newtRef *	st;
+
+    st = NewtRefToSlots(iter);
+    st[kIterIndex] = kNewtRefUnbind;
+    st[kIterValue] = kNewtRefUnbind;
+    st[kIterObj] = kNewtRefUnbind;
+    st[kIterDeeply] = kNewtRefNIL;
+    st[kIterMap] = kNewtRefNIL;
+
+    if (vm_iternums < NEWT_NUM_ITERPOOL && NewtArrayLength(iter) == kIterALength)
+        vm_iterpool[vm_iternums++] = iter;
+}
+
+
+/*------------------------------------------------------------------------*/
+/** 回収されるイテレータオブジェクトを取っておいたものから除く
+ *
+ * @return			なし
+ *
+ * @note			取っておいたイテレータオブジェクトは GC のルートにしない
+ */
+
+void iter_sweep(void)
+{
+    uint32_t	n = 0;
+    uint32_t	i;
+
+    for (i = 0; i < vm_iternums; i++)
+    {
+        if (! NewtGCIsGarbage(NewtRefToPointer(vm_iterpool[i])))
+            vm_iterpool[n++] = vm_iterpool[i];
+    }
+
+    vm_iternums = n;
+}
+
+
+#if 0
+#pragma mark -
+#endif
+/*------------------------------------------------------------------------*/
+/** 引数をスタックから取出して配列にする
+ *
+ * @param numArgs	[in] 引数の数
+ *
+ * @return			配列
+ */
+
+newtRef NVMMakeArgsArray(uint16_t numArgs)
+{
+	newtRefVar	args;
+	int16_t		i;
+
+	args = NewtMakeArray(kNewtRefUnbind, numArgs);
+
+	for (i = numArgs - 1; 0 <= i; i--)
+	{
+		NewtSetArraySlot(args, i, stk_pop());
+	}
+
+	return args;
+}
+
+
+/*------------------------------------------------------------------------*/
+/** 引数をスタックから取出してローカルフレームに束縛する
+ *
+ * @param numArgs	[in] 引数の数
+ *
+ * @return			なし
+ */
+
+void NVMBindArgs(uint16_t numArgs)
+{
+    newtRefVar	indefinite;
+	size_t		minArgs;
+	int16_t		i;
+    newtRefVar	v;
+
+	minArgs = FFNumArgsToNumArgs(vm_fn_get(FUNC, kVMFnNumArgs, NSSYM0(numArgs)));
+    indefinite = vm_fn_get(FUNC, kVMFnIndefinite, NSSYM0(indefinite));
+
+	if (NewtRefIsNotNIL(indefinite))
+	{
+		newtRefVar	args;
+
+		args = NVMMakeArgsArray(numArgs - minArgs);
+		NewtSetFrameSlot(LOCALS, START_LOCALARGS + minArgs, args);
+	}
+
+    for (i = START_LOCALARGS + minArgs - 1; START_LOCALARGS <= i; i--)
+    {
+        v = stk_pop();
+        NewtSetFrameSlot(LOCALS, i, v);
+    }
+}
+
+
+/*------------------------------------------------------------------------*/
+/** 活性レコードをスタック上に置けるか調べる
+ *
+ * @param af		[in] 引数フレーム（FUNC.argFrame）
+ *
+ * @retval			true	スタック上に置ける
+ * @retval			false	ローカルフレームを作成する
+ *
+ * @note			引数フレームの先頭が _nextArgFrame, _parent, _implementor の
+ *					順に並んでいる場合だけスタックに置く
+ */
+
+bool NVMCanPushLocals(newtRefArg af)
+{
+    newtRefVar	map;
+
+    if (NEWT_MODE_NOSTACKLOCALS)
+        return false;
+
+    if (NewtRefIsNIL(af))
+        return true;
+
+    if (! NewtRefIsFrame(af) || NewtFrameLength(af) < START_LOCALARGS)
+        return false;
+
+    map = NewtFrameMap(af);
+
+    return (NewtRefIsNIL(NewtGetArraySlot(map, 0)) &&
+            NewtGetArraySlot(map, 1) == NSSYM0(_nextArgFrame) &&
+            NewtGetArraySlot(map, 2) == NSSYM0(_parent) &&
+            NewtGetArraySlot(map, 3) == NSSYM0(_implementor));
+}
+
+
+/*------------------------------------------------------------------------*/
+/** 活性レコードをスタック上に作成して引数を束縛する
+ *
+ * @param af		[in] 引数フレーム（FUNC.argFrame）
+ * @param numArgs	[in] 引数の数
+ *
+ * @return			なし
+ *
+ * @note			スタックに積まれた引数の下に _nextArgFrame, _parent, _implementor の
+ *					３スロットを挿入し、残りのローカル変数を引数フレームの値で初期化する。
+ *					ローカル変数は BP からの位置で参照し、フレームが必要になった時に
+ *					NVMLocalsFrame で作成する。
+ */
+
+void NVMPushLocals(newtRefArg af, int16_t numArgs)
+{
+    newtRefVar	numArgsRef;
+    newtRefVar	args = kNewtRefUnbind;
+    newtRef *	slots = NULL;
+    bool		indefinite;
+    size_t		minArgs;
+    size_t		len;
+    uint32_t	base;
+    uint32_t	i;
+
+    numArgsRef = vm_fn_get(FUNC, kVMFnNumArgs, NSSYM0(numArgs));
+    minArgs = FFNumArgsToNumArgs(numArgsRef);
+    indefinite = NewtRefIsNotNIL(vm_fn_get(FUNC, kVMFnIndefinite, NSSYM0(indefinite)));
+
+    if (NewtRefIsNIL(af))
+    {
+        len = START_LOCALARGS + minArgs + FFNumArgsToLocals(numArgsRef);
+
+        if (indefinite)
+            len++;
+    }
+    else
+    {
+        len = NewtFrameLength(af);
+    }
+
+    if (indefinite)
+        args = NVMMakeArgsArray(numArgs - minArgs);
+
+    base = SP - minArgs;
+
+    if (! NewtStackExpand(&vm_env.stack, base + len))
+        return;
+
+    // 引数フレームのスロットはスタックを拡張した後に取出す（GC で移動しないが念のため）
+    if (NewtRefIsNotNIL(af))
+        slots = NewtRefToSlots(af);
+
+    memmove(&STACK[base + START_LOCALARGS], &STACK[base], minArgs * sizeof(newtRef));
+
+    for (i = 0; i < START_LOCALARGS; i++)
+    {
+        STACK[base + i] = (slots != NULL)?slots[i]:kNewtRefNIL;
+    }
+
+    i = START_LOCALARGS + minArgs;
+
+    if (indefinite && i < len)
+        STACK[base + i++] = args;
+
+    for (; i < len; i++)
+    {
+        STACK[base + i] = (slots != NULL)?slots[i]:kNewtRefNIL;
+    }
+
+    SP = base + len;
+    BP = base;
+    LOCALS = af;
+}
+
+
+/*------------------------------------------------------------------------*/
+/** スタック上の活性レコードからローカルフレームを作成する
+ *
+ * @return			ローカルフレーム
+ *
+ * @note			活性レコードはそのまま使い続ける（デバッグ出力用）
+ */
+
+newtRef NVMMakeLocalsFrame(void)
+{
+    newtRefVar	frame;
+    size_t		len;
+    size_t		i;
+
+    if (BP == NO_BP)
+        return LOCALS;
+
+    if (NewtRefIsNIL(LOCALS))
+        frame = NVMMakeFastFunctionArgFrame(FUNC);
+    else
+        frame = NcClone(LOCALS);
+
+    len = NewtFrameLength(frame);
+
+    for (i = 0; i < len && BP + i < SP; i++)
+    {
+        NewtSetFrameSlot(frame, i, STACK[BP + i]);
+    }
+
+    return frame;
+}
+
+
+/*------------------------------------------------------------------------*/
+/** ローカルフレームを取得する
+ *
+ * @return			ローカルフレーム
+ *
+ * @note			活性レコードがスタック上にある場合はフレームを作成して LOCALS にセットし、
+ *					以降はフレームを使う（クロージャや変数の追加でフレームが必要な場合）
+ */
+
+newtRef NVMLocalsFrame(void)
+{
+    if (BP != NO_BP)
+    {
+        LOCALS = NVMMakeLocalsFrame();
+        BP = NO_BP;
+    }
+
+    return LOCALS;
+}
+
+
+/*------------------------------------------------------------------------*/
+/** スタック上の活性レコードから変数の位置を検索する
+ *
+ * @param name		[in] 変数名シンボル
+ *
+ * @return			活性レコード内の位置（ない場合は -1）
  */
 
-bool iter_done(newtRefArg iter)
+int32_t NVMLocalsIndex(newtRefArg name)
 {
-    size_t	pos;
-    size_t	len;
+    if (NewtRefIsNIL(LOCALS))
+    {
+        // 引数フレームのない関数は名前付きのスロットが３つだけ
+        if (name == NSSYM0(_nextArgFrame))
+            return 0;
+
+        if (name == NSSYM0(_parent))
+            return 1;
 
-    pos = NewtRefToInteger(NewtGetArraySlot(iter, kIterPos));
-    len = NewtRefToInteger(NewtGetArraySlot(iter, kIterMax));
+        if (name == NSSYM0(_implementor))
+            return 2;
 
-    return (len <= pos);
+        return -1;
+    }
+
+    return (int32_t)NewtFindSlotIndex(LOCALS, name);
 }
 
 
-#if 0
-#pragma mark -
-#endif
 /*------------------------------------------------------------------------*/
-/** 引数をスタックから取出して配列にする
+/** ローカル変数からレキシカルスコープで変数を検索する
  *
- * @param numArgs	[in] 引数の数
+ * @param name		[in] 変数名シンボル
  *
- * @return			配列
+ * @return			値オブジェクト
  */
 
-newtRef NVMMakeArgsArray(uint16_t numArgs)
+newtRef NVMLexicalLookup(newtRefArg name)
 {
-	newtRefVar	args;
-	int16_t		i;
+    int32_t	i;
 
-	args = NewtMakeArray(kNewtRefUnbind, numArgs);
+    if (BP == NO_BP)
+        return NcLexicalLookup(LOCALS, name);
 
-	for (i = numArgs - 1; 0 <= i; i--)
-	{
-		NewtSetArraySlot(args, i, stk_pop());
-	}
+    i = NVMLocalsIndex(name);
 
-	return args;
+    if (0 <= i)
+        return NcResolveMagicPointer(STACK[BP + i]);
+
+    return NcLexicalLookup(STACK[BP], name);
 }
 
 
 /*------------------------------------------------------------------------*/
-/** 引数をスタックから取出してローカルフレームに束縛する
+/** ローカル変数からレキシカルスコープで変数に代入する
  *
- * @param numArgs	[in] 引数の数
+ * @param name		[in] 変数名シンボル
+ * @param v			[in] 値オブジェクト
  *
- * @return			なし
+ * @retval			true	代入した
+ * @retval			false	変数がない
  */
 
-void NVMBindArgs(uint16_t numArgs)
+bool NVMLexicalAssignment(newtRefArg name, newtRefArg v)
 {
-    newtRefVar	indefinite;
-	size_t		minArgs;
-	int16_t		i;
-    newtRefVar	v;
-
-	minArgs = FFNumArgsToNumArgs(NcGetSlot(FUNC, NSSYM0(numArgs)));
-    indefinite = NcGetSlot(FUNC, NSSYM0(indefinite));
+    int32_t	i;
 
-	if (NewtRefIsNotNIL(indefinite))
-	{
-		newtRefVar	args;
+    if (BP == NO_BP)
+        return NewtLexicalAssignment(LOCALS, name, v);
 
-		args = NVMMakeArgsArray(numArgs - minArgs);
-		NewtSetFrameSlot(LOCALS, START_LOCALARGS + minArgs, args);
-	}
+    i = NVMLocalsIndex(name);
 
-    for (i = START_LOCALARGS + minArgs - 1; START_LOCALARGS <= i; i--)
+    if (0 <= i)
     {
-        v = stk_pop();
-        NewtSetFrameSlot(LOCALS, i, v);
+        STACK[BP + i] = v;
+        return true;
     }
+
+    return NewtLexicalAssignment(STACK[BP], name, v);
 }
 
 
@@ -1281,8 +4547,8 @@ bool NVMFuncCheckNumArgs(newtRefArg fn, int16_t numArgs)
     newtRefVar	indefinite;
     size_t		minArgs;
 
-    minArgs = FFNumArgsToNumArgs(NcGetSlot(fn, NSSYM0(numArgs)));
-    indefinite = NcGetSlot(fn, NSSYM0(indefinite));
+    minArgs = FFNumArgsToNumArgs(vm_fn_get(fn, kVMFnNumArgs, NSSYM0(numArgs)));
+    indefinite = vm_fn_get(fn, kVMFnIndefinite, NSSYM0(indefinite));
 
 	if (NewtRefIsNIL(indefinite))
 		return (minArgs == numArgs);
@@ -1304,7 +4570,7 @@ newtErr NVMFuncCheck(newtRefArg fn, int16_t numArgs)
 {
     // 1. 関数オブジェクトでなければ例外を発生
 
-    if (! NewtRefIsFunction(fn))
+    if (vm_fn_type(fn) == kNewtNotFunction)
         return kNErrInvalidFunc;
 
     // 2. 引数の数が一致さなければ WrongNumberOfArgs 例外を発生
@@ -1317,447 +4583,122 @@ newtErr NVMFuncCheck(newtRefArg fn, int16_t numArgs)
 
 
 /*------------------------------------------------------------------------*/
-/** ネイティブ関数（rcvrなし）の呼出し
+/** ネイティブ関数の呼出し
  *
  * @param fn		[in] 関数オブジェクト
+ * @param type		[in] 関数オブジェクトのタイプ（kNewtNativeFn または kNewtNativeFunc）
+ * @param rcvr		[in] レシーバ（kNewtNativeFunc の場合に最初の引数として渡す）
  * @param numArgs	[in] 引数の数
  *
  * @return			なし
+ *
+ * @note			funcPtr, numArgs, indefinite は関数オブジェクトの記述子から取出し、
+ *					引数はスタック上の並びから直接 C の引数に積み替える。
+ *					rcvr の有無と不定長引数の配列を含めた引数の数で１回だけ分岐する。
  */
 
-void NVMCallNativeFn(newtRefArg fn, int16_t numArgs)
+void NVMCallNative(newtRefArg fn, int type, newtRefArg rcvr, int16_t numArgs)
 {
+    newtRefVar	p[MAX_NATIVEARGS + 2];
     newtRefVar	r = kNewtRefUnbind;
-    newtRefVar	indefinite;
+    newtRefVar	args = kNewtRefUnbind;
+    newtRefVar	v;
     nvm_func_t	funcPtr;
-	size_t		minArgs;
+    size_t		minArgs;
+    uint32_t	base;
+    uint16_t	n = 0;
+    uint16_t	i;
+    bool		indefinite;
 
-    funcPtr = (nvm_func_t)NewtRefToAddress(NcGetSlot(fn, NSSYM0(funcPtr)));
+    funcPtr = (nvm_func_t)NewtRefToAddress(vm_fn_get(fn, kVMFnFuncPtr, NSSYM0(funcPtr)));
 
 	if (funcPtr == NULL)
 		return;
 
-	minArgs = FFNumArgsToNumArgs(NcGetSlot(fn, NSSYM0(numArgs)));
-    indefinite = NcGetSlot(fn, NSSYM0(indefinite));
-
-	if (NewtRefIsNIL(indefinite))
-	{
-		switch (minArgs)
-		{
-			case 0:
-				r = (*funcPtr)();
-				break;
-
-			case 1:
-				{
-					newtRefVar	a;
-
-					a = stk_pop();
-					r = (*funcPtr)(a);
-				}
-				break;
-
-			case 2:
-				{
-					newtRefVar	a[2];
-
-					stk_pop_n(2, a);
-					r = (*funcPtr)(a[0], a[1]);
-				}
-				break;
-
-			case 3:
-				{
-					newtRefVar	a[3];
-
-					stk_pop_n(3, a);
-					r = (*funcPtr)(a[0], a[1], a[2]);
-				}
-				break;
-
-			case 4:
-				{
-					newtRefVar	a[4];
-
-					stk_pop_n(4, a);
-					r = (*funcPtr)(a[0], a[1], a[2], a[3]);
-				}
-				break;
-
-			case 5:
-				{
-					newtRefVar	a[5];
-
-					stk_pop_n(5, a);
-					r = (*funcPtr)(a[0], a[1], a[2], a[3], a[4]);
-				}
-				break;
-
-			case 6:
-				{
-					newtRefVar	a[6];
-
-					stk_pop_n(6, a);
-					r = (*funcPtr)(a[0], a[1], a[2], a[3], a[4], a[5]);
-				}
-				break;
-
-			case 7:
-				{
-					newtRefVar	a[7];
-
-					stk_pop_n(7, a);
-					r = (*funcPtr)(a[0], a[1], a[2], a[3], a[4], a[5], a[6]);
-				}
-				break;
-
-
-			case 8:
-				{
-					newtRefVar	a[8];
-
-					stk_pop_n(8, a);
-					r = (*funcPtr)(a[0], a[1], a[2], a[3], a[4], a[5], a[6], a[7]);
-				}
-				break;
-
-			case 9:
-				{
-					newtRefVar	a[9];
-
-					stk_pop_n(9, a);
-					r = (*funcPtr)(a[0], a[1], a[2], a[3], a[4], a[5], a[6], a[7], a[8]);
-				}
-				break;
-
-			default:
-				stk_remove(minArgs);
-				break;
-		}
-	}
-	else
-	{
-		newtRefVar	args;
+	minArgs = FFNumArgsToNumArgs(vm_fn_get(fn, kVMFnNumArgs, NSSYM0(numArgs)));
+    indefinite = NewtRefIsNotNIL(vm_fn_get(fn, kVMFnIndefinite, NSSYM0(indefinite)));
 
+    // 不定長引数は NewtonScript の配列で渡す
+	if (indefinite)
 		args = NVMMakeArgsArray(numArgs - minArgs);
 
-		switch (minArgs)
-		{
-			case 0:
-				r = (*funcPtr)(args);
-				break;
-
-			case 1:
-				{
-					newtRefVar	a;
-
-					a = stk_pop();
-					r = (*funcPtr)(a, args);
-				}
-				break;
-
-			case 2:
-				{
-					newtRefVar	a[2];
-
-					stk_pop_n(2, a);
-					r = (*funcPtr)(a[0], a[1], args);
-				}
-				break;
-
-			case 3:
-				{
-					newtRefVar	a[3];
-
-					stk_pop_n(3, a);
-					r = (*funcPtr)(a[0], a[1], a[2], args);
-				}
-				break;
-
-			case 4:
-				{
-					newtRefVar	a[4];
-
-					stk_pop_n(4, a);
-					r = (*funcPtr)(a[0], a[1], a[2], a[3], args);
-				}
-				break;
-
-			case 5:
-				{
-					newtRefVar	a[5];
-
-					stk_pop_n(5, a);
-					r = (*funcPtr)(a[0], a[1], a[2], a[3], a[4], args);
-				}
-				break;
-
-			case 6:
-				{
-					newtRefVar	a[6];
-
-					stk_pop_n(6, a);
-					r = (*funcPtr)(a[0], a[1], a[2], a[3], a[4], a[5], args);
-				}
-				break;
-
-			case 7:
-				{
-					newtRefVar	a[7];
-
-					stk_pop_n(7, a);
-					r = (*funcPtr)(a[0], a[1], a[2], a[3], a[4], a[5], a[6], args);
-				}
-				break;
-
-
-			case 8:
-				{
-					newtRefVar	a[8];
-
-					stk_pop_n(8, a);
-					r = (*funcPtr)(a[0], a[1], a[2], a[3], a[4], a[5], a[6], a[7], args);
-				}
-				break;
-
-			case 9:
-				{
-					newtRefVar	a[9];
-
-					stk_pop_n(9, a);
-					r = (*funcPtr)(a[0], a[1], a[2], a[3], a[4], a[5], a[6], a[7], a[8], args);
-				}
-				break;
-
-			default:
-				stk_remove(minArgs);
-				break;
-		}
-	}
+    if (MAX_NATIVEARGS < minArgs)
+    {
+        stk_remove(minArgs);
+        stk_push(r);
+        return;
+    }
 
-    stk_push(r);
-}
+    if (type == kNewtNativeFunc)
+        p[n++] = rcvr;
 
+    base = (minArgs <= SP)?SP - minArgs:0;
 
-/*------------------------------------------------------------------------*/
-/** ネイティブ関数（rcvrあり）の呼出し
- *
- * @param fn		[in] 関数オブジェクト
- * @param rcvr		[in] レシーバ
- * @param numArgs	[in] 引数の数
- *
- * @return			なし
- */
+    for (i = 0; i < minArgs; i++)
+    {
+        v = (base + i < SP)?STACK[base + i]:kNewtRefUnbind;
 
-void NVMCallNativeFunc(newtRefArg fn, newtRefArg rcvr, int16_t numArgs)
-{
-    newtRefVar	r = kNewtRefUnbind;
-    newtRefVar	indefinite;
-    nvm_func_t	funcPtr;
-	size_t		minArgs;
+        if (NewtRefIsMagicPointer(v))
+            v = NcResolveMagicPointer(v);
 
-    funcPtr = (nvm_func_t)NewtRefToAddress(NcGetSlot(fn, NSSYM0(funcPtr)));
+        p[n++] = v;
+    }
 
-	if (funcPtr == NULL)
-		return;
+    SP = base;
 
-	minArgs = FFNumArgsToNumArgs(NcGetSlot(fn, NSSYM0(numArgs)));
-    indefinite = NcGetSlot(fn, NSSYM0(indefinite));
+	if (indefinite)
+		p[n++] = args;
 
-	if (NewtRefIsNIL(indefinite))
-	{
-		switch (minArgs)
-		{
-			case 0:
-				r = (*funcPtr)(rcvr);
-				break;
-
-			case 1:
-				{
-					newtRefVar	a;
-
-					a = stk_pop();
-					r = (*funcPtr)(rcvr, a);
-				}
-				break;
-
-			case 2:
-				{
-					newtRefVar	a[2];
-
-					stk_pop_n(2, a);
-					r = (*funcPtr)(rcvr, a[0], a[1]);
-				}
-				break;
-
-			case 3:
-				{
-					newtRefVar	a[3];
-
-					stk_pop_n(3, a);
-					r = (*funcPtr)(rcvr, a[0], a[1], a[2]);
-				}
-				break;
-
-			case 4:
-				{
-					newtRefVar	a[4];
-
-					stk_pop_n(4, a);
-					r = (*funcPtr)(rcvr, a[0], a[1], a[2], a[3]);
-				}
-				break;
-
-			case 5:
-				{
-					newtRefVar	a[5];
-
-					stk_pop_n(5, a);
-					r = (*funcPtr)(rcvr, a[0], a[1], a[2], a[3], a[4]);
-				}
-				break;
-
-			case 6:
-				{
-					newtRefVar	a[6];
-
-					stk_pop_n(6, a);
-					r = (*funcPtr)(rcvr, a[0], a[1], a[2], a[3], a[4], a[5]);
-				}
-				break;
-
-			case 7:
-				{
-					newtRefVar	a[7];
-
-					stk_pop_n(7, a);
-					r = (*funcPtr)(rcvr, a[0], a[1], a[2], a[3], a[4], a[5], a[6]);
-				}
-				break;
-
-
-			case 8:
-				{
-					newtRefVar	a[8];
-
-					stk_pop_n(8, a);
-					r = (*funcPtr)(rcvr, a[0], a[1], a[2], a[3], a[4], a[5], a[6], a[7]);
-				}
-				break;
-
-			case 9:
-				{
-					newtRefVar	a[9];
-
-					stk_pop_n(9, a);
-					r = (*funcPtr)(rcvr, a[0], a[1], a[2], a[3], a[4], a[5], a[6], a[7], a[8]);
-				}
-				break;
-
-			default:
-				stk_remove(minArgs);
-				break;
-		}
-	}
-	else
-	{
-		newtRefVar	args;
+    switch (n)
+    {
+        case 0:
+            r = (*funcPtr)();
+            break;
 
-		args = NVMMakeArgsArray(numArgs - minArgs);
+        case 1:
+            r = (*funcPtr)(p[0]);
+            break;
 
-		switch (minArgs)
-		{
-			case 0:
-				r = (*funcPtr)(rcvr, args);
-				break;
-
-			case 1:
-				{
-					newtRefVar	a;
-
-					a = stk_pop();
-					r = (*funcPtr)(rcvr, a, args);
-				}
-				break;
-
-			case 2:
-				{
-					newtRefVar	a[2];
-
-					stk_pop_n(2, a);
-					r = (*funcPtr)(rcvr, a[0], a[1], args);
-				}
-				break;
-
-			case 3:
-				{
-					newtRefVar	a[3];
-
-					stk_pop_n(3, a);
-					r = (*funcPtr)(rcvr, a[0], a[1], a[2], args);
-				}
-				break;
-
-			case 4:
-				{
-					newtRefVar	a[4];
-
-					stk_pop_n(4, a);
-					r = (*funcPtr)(rcvr, a[0], a[1], a[2], a[3], args);
-				}
-				break;
-
-			case 5:
-				{
-					newtRefVar	a[5];
-
-					stk_pop_n(5, a);
-					r = (*funcPtr)(rcvr, a[0], a[1], a[2], a[3], a[4], args);
-				}
-				break;
-
-			case 6:
-				{
-					newtRefVar	a[6];
-
-					stk_pop_n(6, a);
-					r = (*funcPtr)(rcvr, a[0], a[1], a[2], a[3], a[4], a[5], args);
-				}
-				break;
-
-			case 7:
-				{
-					newtRefVar	a[7];
-
-					stk_pop_n(7, a);
-					r = (*funcPtr)(rcvr, a[0], a[1], a[2], a[3], a[4], a[5], a[6], args);
-				}
-				break;
-
-
-			case 8:
-				{
-					newtRefVar	a[8];
-
-					stk_pop_n(8, a);
-					r = (*funcPtr)(rcvr, a[0], a[1], a[2], a[3], a[4], a[5], a[6], a[7], args);
-				}
-				break;
-
-			case 9:
-				{
-					newtRefVar	a[9];
-
-					stk_pop_n(9, a);
-					r = (*funcPtr)(rcvr, a[0], a[1], a[2], a[3], a[4], a[5], a[6], a[7], a[8], args);
-				}
-				break;
-
-			default:
-				stk_remove(minArgs);
-				break;
-		}
-	}
+        case 2:
+            r = (*funcPtr)(p[0], p[1]);
+            break;
+
+        case 3:
+            r = (*funcPtr)(p[0], p[1], p[2]);
+            break;
+
+        case 4:
+            r = (*funcPtr)(p[0], p[1], p[2], p[3]);
+            break;
+
+        case 5:
+            r = (*funcPtr)(p[0], p[1], p[2], p[3], p[4]);
+            break;
+
+        case 6:
+            r = (*funcPtr)(p[0], p[1], p[2], p[3], p[4], p[5]);
+            break;
+
+        case 7:
+            r = (*funcPtr)(p[0], p[1], p[2], p[3], p[4], p[5], p[6]);
+            break;
+
+        case 8:
+            r = (*funcPtr)(p[0], p[1], p[2], p[3], p[4], p[5], p[6], p[7]);
+            break;
+
+        case 9:
+            r = (*funcPtr)(p[0], p[1], p[2], p[3], p[4], p[5], p[6], p[7], p[8]);
+            break;
+
+        case 10:
+            r = (*funcPtr)(p[0], p[1], p[2], p[3], p[4], p[5], p[6], p[7], p[8], p[9]);
+            break;
+
+        case 11:
+            r = (*funcPtr)(p[0], p[1], p[2], p[3], p[4], p[5], p[6], p[7], p[8], p[9], p[10]);
+            break;
+    }
 
     stk_push(r);
 }
@@ -1768,11 +4709,12 @@ void NVMCallNativeFunc(newtRefArg fn, newtRefArg rcvr, int16_t numArgs)
  *
  * @param fn		[in] 関数オブジェクト
  * @param numArgs	[in] 引数の数
+ * @param tail		[in] 末尾呼出しにするか（reg_tail の結果）
  *
  * @return			なし
  */
 
-void NVMFuncCall(newtRefArg fn, int16_t numArgs)
+void NVMFuncCall(newtRefArg fn, int16_t numArgs, bool tail)
 {
     newtErr	err;
 	int		type;
@@ -1788,7 +4730,7 @@ void NVMFuncCall(newtRefArg fn, int16_t numArgs)
         return;
     }
 
-	type = NewtRefFunctionType(fn);
+	type = vm_fn_type(fn);
 
     if (type == kNewtNativeFn || type == kNewtNativeFunc)
     {	// ネイティブ関数の呼出し
@@ -1800,18 +4742,8 @@ void NVMFuncCall(newtRefArg fn, int16_t numArgs)
 		saveCALLSP = CALLSP;
 		PC = 0;
 
-		switch (type)
-		{
-			case kNewtNativeFn:
-				// rcvrなし(old style)
-				NVMCallNativeFn(fn, numArgs);
-				break;
-
-			case kNewtNativeFunc:
-				// rcvrあり(new style)
-				NVMCallNativeFunc(fn, kNewtRefUnbind, numArgs);
-				break;
-		}
+		// rcvrなし(old style) または rcvrあり(new style)
+		NVMCallNative(fn, type, kNewtRefUnbind, numArgs);
 
         if (saveCALLSP == CALLSP && PC == 0)
         {
@@ -1820,12 +4752,31 @@ void NVMFuncCall(newtRefArg fn, int16_t numArgs)
         return;
     }
 
-    reg_save(SP - numArgs); // 3. VM レジスタを保存（PC の更新は...）
+    if (tail)
+        reg_reuse(numArgs);	// 3. 末尾呼出しなら現在の活性レコードを再利用
+    else
+        reg_save(SP - numArgs); // 3. VM レジスタを保存（PC の更新は...）
+
     NVMSetFn(fn);			// 4. FUNC に新しい関数オブジェクトをセット
     PC = 0;					// 5. PC に 0 をセット
 
+    newtRefVar af = vm_fn_get(FUNC, kVMFnArgFrame, NSSYM0(argFrame));
+
+    if (NVMCanPushLocals(af))
+    {
+        // 6. 活性レコードをスタック上に作成して引数を束縛する
+        NVMPushLocals(af, numArgs);
+
+        // 7. 活性レコードの _parent, _implementor を RCVR, IMPL にセット
+        RCVR = STACK[BP + 1];
+        IMPL = STACK[BP + 2];
+        BASE = SP;
+        return;
+    }
+
+    BP = NO_BP;
+
     // 6. ローカルフレーム（FUNC.argFrame）をクローンして LOCALS にセット
-    newtRefVar af = NcGetSlot(FUNC, NSSYM0(argFrame));
     // argFrame can be nil if function does not use any variable from
     // caller. Just create an argFrame to hold passed arguments
     if (NewtRefIsNIL(af)) {
@@ -1843,6 +4794,7 @@ void NVMFuncCall(newtRefArg fn, int16_t numArgs)
 
     // 9. LOCALS の _implementor スロットを IMPL にセット
     IMPL = NcGetSlot(LOCALS, NSSYM0(_implementor));
+    BASE = SP;
 
     // 10. 実行をリジュームする
 }
@@ -1855,11 +4807,12 @@ void NVMFuncCall(newtRefArg fn, int16_t numArgs)
  * @param receiver	[in] レシーバ
  * @param fn		[in] 関数オブジェクト
  * @param numArgs	[in] 引数の数
+ * @param tail		[in] 末尾呼出しにするか（reg_tail の結果）
  *
  * @return			なし
  */
 
-void NVMMessageSend(newtRefArg impl, newtRefArg receiver, newtRefArg fn, int16_t numArgs)
+void NVMMessageSend(newtRefArg impl, newtRefArg receiver, newtRefArg fn, int16_t numArgs, bool tail)
 {
     newtErr	err;
 	int		type;
@@ -1875,7 +4828,7 @@ void NVMMessageSend(newtRefArg impl, newtRefArg receiver, newtRefArg fn, int16_t
         return;
     }
 
-	type = NewtRefFunctionType(fn);
+	type = vm_fn_type(fn);
 
     if (type == kNewtNativeFn || type == kNewtNativeFunc)
     {	// ネイティブ関数の呼出し
@@ -1889,18 +4842,8 @@ void NVMMessageSend(newtRefArg impl, newtRefArg receiver, newtRefArg fn, int16_t
 		saveCALLSP = CALLSP;
 		PC = 0;
 
-		switch (type)
-		{
-			case kNewtNativeFn:
-				// rcvrなし(old style)
-				NVMCallNativeFn(fn, numArgs);
-				break;
-
-			case kNewtNativeFunc:
-				// rcvrあり(new style)
-				NVMCallNativeFunc(fn, receiver, numArgs);
-				break;
-		}
+		// rcvrなし(old style) または rcvrあり(new style)
+		NVMCallNative(fn, type, receiver, numArgs);
 
 		if (saveCALLSP == CALLSP && PC == 0)
 		{
@@ -1909,14 +4852,33 @@ void NVMMessageSend(newtRefArg impl, newtRefArg receiver, newtRefArg fn, int16_t
         return;
     }
 
-    reg_save(SP - numArgs); // 3. VM レジスタを保存（PC の更新は...）
+    if (tail)
+        reg_reuse(numArgs);	// 3. 末尾呼出しなら現在の活性レコードを再利用
+    else
+        reg_save(SP - numArgs); // 3. VM レジスタを保存（PC の更新は...）
+
     NVMSetFn(fn);			// 4. FUNC にメソッドをセット
     PC = 0;					// 5. PC に 0 をセット
     RCVR = receiver;		// 6. RCVR に receiver をセット
     IMPL = impl;			// 7. IMPL IMPL implementor をセット
 
+    newtRefVar af = vm_fn_get(FUNC, kVMFnArgFrame, NSSYM0(argFrame));
+
+    if (NVMCanPushLocals(af))
+    {
+        // 8. 活性レコードをスタック上に作成して引数を束縛する
+        NVMPushLocals(af, numArgs);
+
+        // 9. RCVR, IMPL を活性レコードの _parent, _implementor にセット
+        STACK[BP + 1] = RCVR;
+        STACK[BP + 2] = IMPL;
+        BASE = SP;
+        return;
+    }
+
+    BP = NO_BP;
+
     // 8. ローカルフレーム（FUNC.argFrame）をクローンして LOCALS にセット
-    newtRefVar af = NcGetSlot(FUNC, NSSYM0(argFrame));
     // argFrame can be nil if function does not use any variable from
     // caller. Just create an argFrame to hold passed arguments
     if (NewtRefIsNIL(af)) {
@@ -1934,6 +4896,7 @@ void NVMMessageSend(newtRefArg impl, newtRefArg receiver, newtRefArg fn, int16_t
     // 11. LOCALS の引数スロットにスタックにある引数をセットする
     //     引数は LOCALS の４番スロットから開始し左から右へ挿入される
     NVMBindArgs(numArgs);
+    BASE = SP;
 
     // 12. 実行をリジュームする
 }
@@ -1944,11 +4907,12 @@ void NVMMessageSend(newtRefArg impl, newtRefArg receiver, newtRefArg fn, int16_t
  *
  * @param b			[in] オペコード
  * @param errP		[out]エラー番号
+ * @param tail		[in] 末尾呼出しにするか（reg_tail の結果）
  *
  * @return			メソッド名
  */
 
-newtRef	vm_send(int16_t b, newtErr * errP)
+newtRef	vm_send(int16_t b, newtErr * errP, bool tail)
 {
 	// NewtonFormats say:
     // arg1 arg2 ... argN name receiver -- result
@@ -1979,16 +4943,23 @@ newtRef	vm_send(int16_t b, newtErr * errP)
 		return name;
 	}
 
-    impl = NcFullLookupFrame(receiver, name);
-
-    if (impl != kNewtRefUnbind)
+    if (ic_lookup(kVMICSend, receiver, name, &impl, &fn))
 	{
-		fn = NcGetSlot(impl, name);
-        NVMMessageSend(impl, receiver, fn, b);
-    }
+        NVMMessageSend(impl, receiver, fn, b, tail);
+	}
 	else
 	{
-        err = kNErrUndefinedMethod;
+		impl = NcFullLookupFrame(receiver, name);
+
+		if (impl != kNewtRefUnbind)
+		{
+			fn = NcGetSlot(impl, name);
+			NVMMessageSend(impl, receiver, fn, b, tail);
+		}
+		else
+		{
+			err = kNErrUndefinedMethod;
+		}
 	}
 
 	if (errP != NULL)
@@ -2003,11 +4974,12 @@ newtRef	vm_send(int16_t b, newtErr * errP)
  *
  * @param b			[in] オペコード
  * @param errP		[out]エラー番号
+ * @param tail		[in] 末尾呼出しにするか（reg_tail の結果）
  *
  * @return			メソッド名
  */
 
-newtRef vm_resend(int16_t b, newtErr * errP)
+newtRef vm_resend(int16_t b, newtErr * errP, bool tail)
 {
     newtRefVar	name;
     newtErr	err = kNErrNone;
@@ -2036,7 +5008,7 @@ newtRef vm_resend(int16_t b, newtErr * errP)
 		if (impl != kNewtRefUnbind)
 		{
 			fn = NcGetSlot(impl, name);
-			NVMMessageSend(impl, RCVR, fn, b);
+			NVMMessageSend(impl, RCVR, fn, b, tail);
 		}
 		else
 		{
@@ -2138,7 +5110,7 @@ void si_set_lex_scope(void)
             af = NVMMakeFastFunctionArgFrame(fn);
         } else if (NewtRefIsFrame(af)) {
             af = NcClone(af);
-            NcSetSlot(af, NSSYM0(_nextArgFrame), LOCALS);
+            NcSetSlot(af, NSSYM0(_nextArgFrame), NVMLocalsFrame());
             NcSetSlot(af, NSSYM0(_parent), RCVR);
             NcSetSlot(af, NSSYM0(_implementor), IMPL);
         } else {
@@ -2190,6 +5162,21 @@ void si_pop_handlers(void)
 }
 
 
+/*------------------------------------------------------------------------*/
+/** 例外ハンドラ表のある TRY文を抜ける
+ *
+ * @return			なし
+ *
+ * @note			例外ハンドラをプッシュしていないので現在の例外だけをクリアする
+ */
+
+void si_try_exit(void)
+{
+    CURREXCP = kNewtRefUnbind;
+    EXCPTABLE = false;
+}
+
+
 #if 0
 #pragma mark -
 #pragma mark *** Primitive functions
@@ -2712,7 +5699,7 @@ void is_push_constant(int16_t b)
 		if (8191 < n)
 		{	// 負の数
 			n |= 0xFFFFC000;
-			r = NewtMakeInt30(n);
+			r = NewtMakeInt30((int32_t)n);
 		}
 	}
 	else
@@ -2746,7 +5733,7 @@ void is_call(int16_t b)
         return;
     }
 
-    NVMFuncCall(fn, b);
+    NVMFuncCall(fn, b, reg_tail());
 }
 
 
@@ -2760,7 +5747,7 @@ void is_call(int16_t b)
 
 void is_invoke(int16_t b)
 {
-    NVMFuncCall(stk_pop(), b);
+    NVMFuncCall(stk_pop(), b, reg_tail());
 }
 
 
@@ -2777,7 +5764,7 @@ void is_send(int16_t b)
 	newtRef name;
     newtErr	err;
 
-    name = vm_send(b, &err);
+    name = vm_send(b, &err, reg_tail());
 
     if (err != kNErrNone)
         NVMThrowBC(err, name, 0, true);
@@ -2798,7 +5785,7 @@ void is_send_if_defined(int16_t b)
 {
     newtErr	err;
 
-    vm_send(b, &err);
+    vm_send(b, &err, reg_tail());
 
     if (err != kNErrNone)
         stk_push(kNewtRefNIL);
@@ -2818,7 +5805,7 @@ void is_resend(int16_t b)
 	newtRef name;
     newtErr	err;
 
-    name = vm_resend(b, &err);
+    name = vm_resend(b, &err, reg_tail());
 
     if (err != kNErrNone)
         NVMThrowBC(err, name, 0, true);
@@ -2839,7 +5826,7 @@ void is_resend_if_defined(int16_t b)
 {
     newtErr	err;
 
-    vm_resend(b, &err);
+    vm_resend(b, &err, reg_tail());
 
     if (err != kNErrNone)
         stk_push(kNewtRefNIL);
@@ -2913,7 +5900,13 @@ void is_find_var(int16_t b)
 
     name = liter_get(b);
 
-    v = NcLexicalLookup(LOCALS, name);
+    if (ic_lookup(kVMICFindVar, kNewtRefUnbind, name, NULL, &v))
+    {
+        stk_push(v);
+        return;
+    }
+
+    v = NVMLexicalLookup(name);
 
     if (v != kNewtRefUnbind)
     {
@@ -2950,6 +5943,12 @@ void is_find_var(int16_t b)
 
 void is_get_var(int16_t b)
 {
+    if (BP != NO_BP)
+    {
+        stk_push((BP + b < SP)?STACK[BP + b]:kNewtRefUnbind);
+        return;
+    }
+
     stk_push(NewtGetFrameSlot(LOCALS, b));
 }
 
@@ -3059,7 +6058,11 @@ void is_get_path(int16_t b)
 
     if (NewtRefIsNotNIL(a1))
     {
-        r = NcGetPath(a1, a2);
+        newtRefVar	impl;
+
+        if (! NewtRefIsFrame(a1) || ! NewtRefIsSymbol(a2) ||
+            ! ic_lookup(kVMICGetPath, a1, a2, &impl, &r))
+            r = NcGetPath(a1, a2);
     }
     else
     {
@@ -3111,6 +6114,15 @@ void is_set_var(int16_t b)
     newtRefVar	x;
 
     x = stk_pop0();
+
+    if (BP != NO_BP)
+    {
+        if (BP + b < SP)
+            STACK[BP + b] = x;
+
+        return;
+    }
+
     NewtSetFrameSlot(LOCALS, b, x);
 }
 
@@ -3131,7 +6143,7 @@ void is_find_and_set_var(int16_t b)
     name = liter_get(b);
     v = stk_pop0();
 
-    if (NewtLexicalAssignment(LOCALS, name, v))
+    if (NVMLexicalAssignment(name, v))
         return;
 
     if (NewtAssignment(RCVR, name, v))
@@ -3143,7 +6155,7 @@ void is_find_and_set_var(int16_t b)
         return;
     }
 
-    NcSetSlot(LOCALS, name, v);
+    NcSetSlot(NVMLocalsFrame(), name, v);
 }
 
 
@@ -3162,6 +6174,20 @@ void is_incr_var(int16_t b)
     intptr_t	v;
 
     addend = stk_top();
+
+    if (BP != NO_BP)
+    {
+        n = (BP + b < SP)?STACK[BP + b]:kNewtRefUnbind;
+        v = NewtRefToInteger(n) + NewtRefToInteger(addend);
+        n = NewtMakeInteger(v);
+
+        if (BP + b < SP)
+            STACK[BP + b] = n;
+
+        stk_push(n);
+        return;
+    }
+
     n = NewtGetFrameSlot(LOCALS, b);
     v = NewtRefToInteger(n) + NewtRefToInteger(addend);
     n = NewtMakeInteger(v);
@@ -3184,9 +6210,9 @@ void is_branch_if_loop_not_done(int16_t b)
     newtRefVar	r_incr;
     newtRefVar	r_index;
     newtRefVar	r_limit;
-    size_t	incr;
-    size_t	index;
-    size_t	limit;
+    intptr_t	incr;
+    intptr_t	index;
+    intptr_t	limit;
 
     r_limit = stk_pop();
     r_index = stk_pop();
@@ -3216,7 +6242,7 @@ void is_branch_if_loop_not_done(int16_t b)
 
     if (incr == 0)
     {
-        NewtThrow(kNErrZeroForLoopIncr, incr);
+        NewtThrow(kNErrZeroForLoopIncr, r_incr);
         return;
     }
 
@@ -3338,7 +6364,7 @@ void NVMDumpInstResult(FILE * f)
 {
     NewtFprintf(f, " ");
     NVMDumpStackTop(f, "\t");
-    NewtPrintObj(f, LOCALS);
+    NewtPrintObj(f, NVMMakeLocalsFrame());
     NewtFprintf(f, "\n");
 }
 
@@ -3582,11 +6608,16 @@ void NVMInitREG(void)
     PC = 0;
     SP = 0;
     LOCALS = kNewtRefNIL;
+    BP = NO_BP;
+    BASE = 0;
     RCVR = kNewtRefNIL;
     IMPL = kNewtRefNIL;
 
     BC = NULL;
     BCLEN = 0;
+    INSTS = NULL;
+    CODE = NULL;
+    JIT = NULL;
 }
 
 
@@ -3594,6 +6625,9 @@ void NVMInitREG(void)
 /** スタックの初期化 
  *
  * @return			なし
+ *
+ * @note			例外ハンドラへ飛ぶ時はスタックの先頭を取出して積み直すので、
+ *					ハンドラの位置でスタックが空にならないように底に１つ積んでおく。
  */
 
 void NVMInitSTACK(void)
@@ -3602,7 +6636,10 @@ void NVMInitSTACK(void)
     NewtStackSetup(&vm_env.callstack, NEWT_POOL, sizeof(vm_reg_t), NEWT_NUM_CALLSTACK);
     NewtStackSetup(&vm_env.excpstack, NEWT_POOL, sizeof(vm_excp_t), NEWT_NUM_EXCPSTACK);
 
+    stk_push(kNewtRefNIL);
+
     CURREXCP = kNewtRefUnbind;
+    EXCPTABLE = false;
 }
 
 
@@ -3696,6 +6733,10 @@ void NVMInitGlobalFns1(void)
     NewtDefGlobalFunc(NSSYM(GetRoot),		NsGetRoot,			0, "GetRoot()");
     NewtDefGlobalFunc(NSSYM(GetGlobals),	NsGetGlobals,		0, "GetGlobals()");
     NewtDefGlobalFunc(NSSYM(GC),			NsGC,				0, "GC()");
+    NewtDefGlobalFunc(NSSYM(SetGCPauseBudget),	NsSetGCPauseBudget,	1, "SetGCPauseBudget(usec)");
+    NewtDefGlobalFunc(NSSYM(SetGCThreads),	NsSetGCThreads,		1, "SetGCThreads(n)");
+    NewtDefGlobalFunc(NSSYM(SetHeapLimit),	NsSetHeapLimit,		1, "SetHeapLimit(size)");
+    NewtDefGlobalFunc(NSSYM(GCStats),		NsGCStats,			0, "GCStats()");
     NewtDefGlobalFunc(NSSYM(Compile),		NsCompile,			1, "Compile(str)");
     NewtDefGlobalFunc(NSSYM(GetCompileOptions),	NsGetCompileOptions,	0, "GetCompileOptions()");
     NewtDefGlobalFunc(NSSYM(SetCompileOptions),	NsSetCompileOptions,	1, "SetCompileOptions(opts)");
@@ -3784,6 +6825,7 @@ void NVMInitExGlobalFns(void)
     NewtDefGlobalFunc(NSSYM(Getc),		NsGetc,				0, "Getc()");
     NewtDefGlobalFunc(NSSYM(Getch),		NsGetch,			0, "Getch()");
     NewtDefGlobalFunc(NSSYM(Exit),		NsExit,			    1, "Exit(status)");
+    NewtDefGlobalFunc(NSSYM(Ticks),		NsTicks,			0, "Ticks()");
 }
 
 
@@ -3798,6 +6840,9 @@ void NVMInitDebugGlobalFns(void)
     NewtDefGlobalFunc(NSSYM(DumpFn),		NsDumpFn,			1, "DumpFn(fn)");
     NewtDefGlobalFunc(NSSYM(DumpBC),		NsDumpBC,			1, "DumpBC(instructions)");
     NewtDefGlobalFunc(NSSYM(DumpStacks),	NsDumpStacks,		0, "DumpStacks()");
+    NewtDefGlobalFunc(NSSYM(CallStackDepth),	NsCallStackDepth,	0, "CallStackDepth()");
+    NewtDefGlobalFunc(NSSYM(InlineCacheStats),	NsInlineCacheStats,	0, "InlineCacheStats()");
+    NewtDefGlobalFunc(NSSYM(SymbolHashStats),	NsSymbolHashStats,	0, "SymbolHashStats()");
 }
 
 
@@ -3872,29 +6917,27 @@ void NVMInit(void)
 void NVMClean(void)
 {
     NVMCleanSTACK();
+    NVMCleanCodeCache();
 }
 
 
 /*------------------------------------------------------------------------*/
-/**　VMループ
+/**　バイトコードを逐次デコードしながら実行する VMループ
  *
  * @param callsp	[in] 呼出しスタックのスタックポインタ
  *
  * @return			なし
+ *
+ * @note			トレースモードや --noThreadedCode 指定時に使用
  */
 
-void NVMLoop(uint32_t callsp)
+void NVMDecodeLoop(uint32_t callsp)
 {
     uint16_t	oplen;
     int16_t	b;
     uint8_t	op;
     uint8_t	a;
 
-	vm_env.level++;
-
-	if (NEWT_DEBUG)
-		NewtDebugMsg("VM", "VM Level = %d\n", vm_env.level);
-
     while (callsp < CALLSP && PC < BCLEN && BC != NULL)
     {
         op = BC[PC];
@@ -3926,6 +6969,7 @@ void NVMLoop(uint32_t callsp)
             NVMDumpInstName(stderr, a, b);
         }
 
+        vm_site = (INSTS != NULL) ? &INSTS[PC] : NULL;
         PC += oplen;
     
         if (a < kNBCInstructionsLen)
@@ -3937,6 +6981,300 @@ void NVMLoop(uint32_t callsp)
         if (NEWT_NEEDGC)
             NewtGC();
     }
+}
+
+
+/*------------------------------------------------------------------------*/
+/**　前処理済み命令（スレッデッドコード）を実行する VMループ
+ *
+ * @param callsp	[in] 呼出しスタックのスタックポインタ
+ *
+ * @return			なし
+ *
+ * @note			computed goto が使える場合は命令ハンドラのアドレスへ直接ジャンプする。
+ *					使えない場合は switch 文でディスパッチする。
+ *					命令の実行で関数が切り替わることがあるため、前処理済み命令は
+ *					毎回 vm_env から取り出す。
+ */
+
+void NVMThreadedLoop(uint32_t callsp)
+{
+    vm_inst_t *	inst;
+
+#ifdef __NEWT_COMPUTED_GOTO__
+    static const void *	handlers[kVMOpLen] =
+            {
+                &&L_kVMOpPop,				&&L_kVMOpDup,
+                &&L_kVMOpReturn,			&&L_kVMOpPushSelf,
+                &&L_kVMOpSetLexScope,		&&L_kVMOpIterNext,
+                &&L_kVMOpIterDone,			&&L_kVMOpPopHandlers,
+
+                &&L_kVMOpAdd,				&&L_kVMOpSubtract,
+                &&L_kVMOpAref,				&&L_kVMOpSetAref,
+                &&L_kVMOpEquals,			&&L_kVMOpNot,
+                &&L_kVMOpNotEqual,			&&L_kVMOpMultiply,
+                &&L_kVMOpDivide,			&&L_kVMOpDiv,
+                &&L_kVMOpLessThan,			&&L_kVMOpGreaterThan,
+                &&L_kVMOpGreaterOrEqual,	&&L_kVMOpLessOrEqual,
+                &&L_kVMOpBitAnd,			&&L_kVMOpBitOr,
+                &&L_kVMOpBitNot,			&&L_kVMOpNewIterator,
+                &&L_kVMOpLength,			&&L_kVMOpClone,
+                &&L_kVMOpSetClass,			&&L_kVMOpAddArraySlot,
+                &&L_kVMOpStringer,			&&L_kVMOpHasPath,
+                &&L_kVMOpClassOf,
+
+                &&L_kVMOpPush,				&&L_kVMOpPushConstant,
+                &&L_kVMOpCall,				&&L_kVMOpInvoke,
+                &&L_kVMOpSend,				&&L_kVMOpSendIfDefined,
+                &&L_kVMOpResend,			&&L_kVMOpResendIfDefined,
+                &&L_kVMOpBranch,			&&L_kVMOpBranchIfTrue,
+                &&L_kVMOpBranchIfFalse,		&&L_kVMOpFindVar,
+                &&L_kVMOpGetVar,			&&L_kVMOpMakeFrame,
+                &&L_kVMOpMakeArray,			&&L_kVMOpGetPath,
+                &&L_kVMOpSetPath,			&&L_kVMOpSetVar,
+                &&L_kVMOpFindAndSetVar,		&&L_kVMOpIncrVar,
+                &&L_kVMOpBranchIfLoopNotDone,	&&L_kVMOpNewHandlers,
+
+                &&L_kVMOpAddInt,			&&L_kVMOpSubtractInt,
+                &&L_kVMOpMultiplyInt,		&&L_kVMOpEqualsInt,
+                &&L_kVMOpNotEqualInt,		&&L_kVMOpLessThanInt,
+                &&L_kVMOpGreaterThanInt,	&&L_kVMOpGreaterOrEqualInt,
+                &&L_kVMOpLessOrEqualInt,
+                &&L_kVMOpAddReal,			&&L_kVMOpSubtractReal,
+                &&L_kVMOpMultiplyReal,		&&L_kVMOpDivideReal,
+                &&L_kVMOpLessThanReal,		&&L_kVMOpGreaterThanReal,
+                &&L_kVMOpGreaterOrEqualReal,	&&L_kVMOpLessOrEqualReal,
+
+                &&L_kVMOpGetVarGetVar,		&&L_kVMOpGetVarPushConstant,
+                &&L_kVMOpSetVarGetVar,		&&L_kVMOpIncrVarLoop,
+
+                &&L_kVMOpTryEnter,			&&L_kVMOpTryExit,
+
+                &&L_kVMOpGeneric,			&&L_kVMOpNop
+            };
+
+	#define VM_CASE(op)		L_##op:
+	#define VM_DISPATCH()											\
+		if (! (callsp < CALLSP && PC < BCLEN && INSTS != NULL))	\
+			goto vm_exit;											\
+		vm_site = inst = &INSTS[PC];								\
+		PC += inst->len;											\
+		goto *inst->handler
+	#define VM_NEXT()												\
+		if (NEWT_NEEDGC) NewtGC();									\
+		VM_DISPATCH()
+	#define VM_FUSE()												\
+		vm_site = inst = &INSTS[PC];								\
+		PC += inst->len
+
+    vm_handlers = handlers;
+
+    VM_DISPATCH();
+#else
+	#define VM_CASE(op)		case op:
+	#define VM_NEXT()		break
+	#define VM_FUSE()		vm_site = inst = &INSTS[PC]; PC += inst->len
+
+    while (callsp < CALLSP && PC < BCLEN && INSTS != NULL)
+    {
+        vm_site = inst = &INSTS[PC];
+        PC += inst->len;
+
+        switch (inst->op)
+        {
+#endif
+
+    // シンプル命令
+    VM_CASE(kVMOpPop)					si_pop();				VM_NEXT();
+    VM_CASE(kVMOpDup)					si_dup();				VM_NEXT();
+    VM_CASE(kVMOpReturn)				si_return();			VM_NEXT();
+    VM_CASE(kVMOpPushSelf)				si_pushself();			VM_NEXT();
+    VM_CASE(kVMOpSetLexScope)			si_set_lex_scope();		VM_NEXT();
+    VM_CASE(kVMOpIterNext)				si_iternext();			VM_NEXT();
+    VM_CASE(kVMOpIterDone)				si_iterdone();			VM_NEXT();
+    VM_CASE(kVMOpPopHandlers)			si_pop_handlers();		VM_NEXT();
+
+    // 関数命令
+    VM_CASE(kVMOpAdd)					vm_quicken(inst);	fn_add();				VM_NEXT();
+    VM_CASE(kVMOpSubtract)				vm_quicken(inst);	fn_subtract();			VM_NEXT();
+    VM_CASE(kVMOpAref)					fn_aref();				VM_NEXT();
+    VM_CASE(kVMOpSetAref)				fn_set_aref();			VM_NEXT();
+    VM_CASE(kVMOpEquals)				vm_quicken(inst);	fn_equals();			VM_NEXT();
+    VM_CASE(kVMOpNot)					fn_not();				VM_NEXT();
+    VM_CASE(kVMOpNotEqual)				vm_quicken(inst);	fn_not_equals();		VM_NEXT();
+    VM_CASE(kVMOpMultiply)				vm_quicken(inst);	fn_multiply();			VM_NEXT();
+    VM_CASE(kVMOpDivide)				vm_quicken(inst);	fn_divide();			VM_NEXT();
+    VM_CASE(kVMOpDiv)					fn_div();				VM_NEXT();
+    VM_CASE(kVMOpLessThan)				vm_quicken(inst);	fn_less_than();			VM_NEXT();
+    VM_CASE(kVMOpGreaterThan)			vm_quicken(inst);	fn_greater_than();		VM_NEXT();
+    VM_CASE(kVMOpGreaterOrEqual)		vm_quicken(inst);	fn_greater_or_equal();	VM_NEXT();
+    VM_CASE(kVMOpLessOrEqual)			vm_quicken(inst);	fn_less_or_equal();		VM_NEXT();
+    VM_CASE(kVMOpBitAnd)				fn_bit_and();			VM_NEXT();
+    VM_CASE(kVMOpBitOr)					fn_bit_or();			VM_NEXT();
+    VM_CASE(kVMOpBitNot)				fn_bit_not();			VM_NEXT();
+    VM_CASE(kVMOpNewIterator)			fn_new_iterator();		VM_NEXT();
+    VM_CASE(kVMOpLength)				fn_length();			VM_NEXT();
+    VM_CASE(kVMOpClone)					fn_clone();				VM_NEXT();
+    VM_CASE(kVMOpSetClass)				fn_set_class();			VM_NEXT();
+    VM_CASE(kVMOpAddArraySlot)			fn_add_array_slot();	VM_NEXT();
+    VM_CASE(kVMOpStringer)				fn_stringer();			VM_NEXT();
+    VM_CASE(kVMOpHasPath)				fn_has_path();			VM_NEXT();
+    VM_CASE(kVMOpClassOf)				fn_classof();			VM_NEXT();
+
+    // 命令セット
+    VM_CASE(kVMOpPush)					is_push(inst->b);					VM_NEXT();
+    VM_CASE(kVMOpPushConstant)			is_push_constant(inst->b);			VM_NEXT();
+    VM_CASE(kVMOpCall)					is_call(inst->b);					VM_NEXT();
+    VM_CASE(kVMOpInvoke)				is_invoke(inst->b);					VM_NEXT();
+    VM_CASE(kVMOpSend)					is_send(inst->b);					VM_NEXT();
+    VM_CASE(kVMOpSendIfDefined)			is_send_if_defined(inst->b);		VM_NEXT();
+    VM_CASE(kVMOpResend)				is_resend(inst->b);					VM_NEXT();
+    VM_CASE(kVMOpResendIfDefined)		is_resend_if_defined(inst->b);		VM_NEXT();
+    VM_CASE(kVMOpBranch)				PC = inst->b;						VM_NEXT();
+    VM_CASE(kVMOpBranchIfTrue)			is_branch_if_true(inst->b);			VM_NEXT();
+    VM_CASE(kVMOpBranchIfFalse)			is_branch_if_false(inst->b);		VM_NEXT();
+    VM_CASE(kVMOpFindVar)				is_find_var(inst->b);				VM_NEXT();
+    VM_CASE(kVMOpGetVar)				is_get_var(inst->b);				VM_NEXT();
+    VM_CASE(kVMOpMakeFrame)				is_make_frame(inst->b);				VM_NEXT();
+    VM_CASE(kVMOpMakeArray)				is_make_array(inst->b);				VM_NEXT();
+    VM_CASE(kVMOpGetPath)				is_get_path(inst->b);				VM_NEXT();
+    VM_CASE(kVMOpSetPath)				is_set_path(inst->b);				VM_NEXT();
+    VM_CASE(kVMOpSetVar)				is_set_var(inst->b);				VM_NEXT();
+    VM_CASE(kVMOpFindAndSetVar)			is_find_and_set_var(inst->b);		VM_NEXT();
+    VM_CASE(kVMOpIncrVar)				is_incr_var(inst->b);				VM_NEXT();
+    VM_CASE(kVMOpBranchIfLoopNotDone)	is_branch_if_loop_not_done(inst->b);	VM_NEXT();
+    VM_CASE(kVMOpNewHandlers)			is_new_handlers(inst->b);			VM_NEXT();
+
+    // 型特化命令
+    VM_CASE(kVMOpAddInt)
+    VM_CASE(kVMOpSubtractInt)
+    VM_CASE(kVMOpMultiplyInt)
+    VM_CASE(kVMOpEqualsInt)
+    VM_CASE(kVMOpNotEqualInt)
+    VM_CASE(kVMOpLessThanInt)
+    VM_CASE(kVMOpGreaterThanInt)
+    VM_CASE(kVMOpGreaterOrEqualInt)
+    VM_CASE(kVMOpLessOrEqualInt)		vm_quick_int30(inst);				VM_NEXT();
+    VM_CASE(kVMOpAddReal)
+    VM_CASE(kVMOpSubtractReal)
+    VM_CASE(kVMOpMultiplyReal)
+    VM_CASE(kVMOpDivideReal)
+    VM_CASE(kVMOpLessThanReal)
+    VM_CASE(kVMOpGreaterThanReal)
+    VM_CASE(kVMOpGreaterOrEqualReal)
+    VM_CASE(kVMOpLessOrEqualReal)		vm_quick_real(inst);				VM_NEXT();
+
+    // 複合命令
+    VM_CASE(kVMOpGetVarGetVar)			is_get_var(inst->b);	VM_FUSE();	is_get_var(inst->b);		VM_NEXT();
+    VM_CASE(kVMOpGetVarPushConstant)	is_get_var(inst->b);	VM_FUSE();	is_push_constant(inst->b);	VM_NEXT();
+    VM_CASE(kVMOpSetVarGetVar)			is_set_var(inst->b);	VM_FUSE();	is_get_var(inst->b);		VM_NEXT();
+    VM_CASE(kVMOpIncrVarLoop)			vm_for_loop(inst);					VM_NEXT();
+
+    // 例外ハンドラ表
+    VM_CASE(kVMOpTryEnter)				PC = inst->skip;					VM_NEXT();
+    VM_CASE(kVMOpTryExit)				si_try_exit();						VM_NEXT();
+
+    // その他
+    VM_CASE(kVMOpGeneric)				(is_instructions[inst->a])(inst->b);	VM_NEXT();
+    VM_CASE(kVMOpNop)														VM_NEXT();
+
+#ifdef __NEWT_COMPUTED_GOTO__
+vm_exit:
+    return;
+#else
+        }
+
+        if (NEWT_NEEDGC)
+            NewtGC();
+    }
+#endif
+
+	#undef VM_CASE
+	#undef VM_NEXT
+	#undef VM_FUSE
+#ifdef __NEWT_COMPUTED_GOTO__
+	#undef VM_DISPATCH
+#endif
+}
+
+
+/*------------------------------------------------------------------------*/
+/**　JIT コンパイルしたネイティブコードを実行する VMループ
+ *
+ * @param callsp	[in] 呼出しスタックのスタックポインタ
+ *
+ * @return			なし
+ *
+ * @note			--jit 指定時に使用。ネイティブコードに入口がある位置はネイティブコードで、
+ *					それ以外は１命令ずつ実行する。ネイティブコードは関数の切替えや
+ *					例外、GC の要求があるとここに戻る。後方への分岐はループとして
+ *					JIT コンパイルの判定に数える。
+ *					JIT を組込んでいない場合はスレッデッドコードの VMループで実行する。
+ */
+
+void NVMJITLoop(uint32_t callsp)
+{
+#ifdef __NEWT_JIT__
+    vm_inst_t *	inst;
+    uint32_t	sp;
+    uint32_t	pc;
+
+    while (callsp < CALLSP && PC < BCLEN && INSTS != NULL)
+    {
+        if (JIT != NULL && JIT->entry[PC] != NULL)
+        {
+            ((vm_jitentry_t)(uintptr_t)JIT->code)(JIT->entry[PC]);
+        }
+        else
+        {
+            sp = CALLSP;
+            pc = PC;
+
+            vm_site = inst = &INSTS[PC];
+            PC += inst->len;
+
+            // 例外ハンドラ表のある TRY文はスレッデッドコードと同じく書き換えた命令で実行する
+            if (inst->op == kVMOpTryEnter)
+                PC = inst->skip;
+            else if (inst->op == kVMOpTryExit)
+                si_try_exit();
+            else if (inst->a < kNBCInstructionsLen)
+                (is_instructions[inst->a])(inst->b);
+
+            if (PC <= pc && sp == CALLSP && CODE != NULL && JIT == NULL)
+                JIT = NVMJITHot(CODE);
+        }
+
+        if (NEWT_NEEDGC)
+            NewtGC();
+    }
+#else
+    NVMThreadedLoop(callsp);
+#endif
+}
+
+
+/*------------------------------------------------------------------------*/
+/**　VMループ
+ *
+ * @param callsp	[in] 呼出しスタックのスタックポインタ
+ *
+ * @return			なし
+ */
+
+void NVMLoop(uint32_t callsp)
+{
+	vm_env.level++;
+
+	if (NEWT_DEBUG)
+		NewtDebugMsg("VM", "VM Level = %d\n", vm_env.level);
+
+	if (NEWT_TRACE || NEWT_MODE_NOTHREADEDCODE)
+		NVMDecodeLoop(callsp);
+	else if (NEWT_MODE_JIT)
+		NVMJITLoop(callsp);
+	else
+		NVMThreadedLoop(callsp);
 
 	vm_env.level--;
 }
@@ -4180,7 +7518,7 @@ NVMMessageSendWithArgArray(
 	}
 	
 	/* Send the message */
-	NVMMessageSend(inImpl, inRcvr, inFunction, nbArgs);
+	NVMMessageSend(inImpl, inRcvr, inFunction, nbArgs, false);
 	NVMLoop(CALLSP - 1);
 	result = stk_top();
 
@@ -4213,7 +7551,7 @@ newtRef NVMFuncCallWithValist(newtRefArg fn, int argc, va_list ap)
 	stk_push_varg(argc, ap);
 
 	// Call function
-	NVMFuncCall(fn, argc);
+	NVMFuncCall(fn, argc, false);
 	NVMLoop(CALLSP - 1);
 	result = stk_top();
 
@@ -4248,7 +7586,7 @@ newtRef NVMMessageSendWithValist(newtRefArg impl, newtRefArg receiver, newtRefAr
 	stk_push_varg(argc, ap);
 
 	// Send the message
-	NVMMessageSend(impl, receiver, fn, argc);
+	NVMMessageSend(impl, receiver, fn, argc, false);
 	NVMLoop(CALLSP - 1);
 	result = stk_top();
 
@@ -98,6 +98,20 @@ enum {
 };
 
 
+/// 例外ハンドラ表（関数オブジェクトの handlers スロット）の１行の並び
+enum {
+    kNBCHandlerStart		= 0,	///< TRY文の先頭（例外ハンドラをプッシュする命令の位置）
+    kNBCHandlerEnd,					///< 実行文の終わりの pop-handlers の位置
+    kNBCHandlerExit,				///< onexception の終わりの pop-handlers の位置
+    kNBCHandlerDepth,				///< TRY文の先頭でのスタックの深さ
+    kNBCHandlerSym,					///< 例外シンボル
+    kNBCHandlerPC,					///< 例外ハンドラの位置
+
+    //
+    kNBCHandlerLen					///< １行の長さ
+};
+
+
 /* 関数プロトタイプ */
 
 #ifdef __cplusplus
@@ -0,0 +1,133 @@
+/* src/newt_core/incs/NewtConf.h.  Generated from NewtConf.h.in by configure.  */
+/*------------------------------------------------------------------------*/
+/**
+ * @file	NewtConf.h
+ * @brief   コンフィグ情報
+ *
+ * @author  M.Nukui
+ * @date	2003-11-07
+ *
+ * Copyright (C) 2003-2004 M.Nukui All rights reserved.
+ */
+
+
+#ifndef	NEWTCONF_H
+#define	NEWTCONF_H
+
+/* マクロ */
+
+/// 名前付マジックポインタを使用
+#define __NAMED_MAGIC_POINTER__ 1
+
+/* VM */
+
+/// 一度に確保するスタック長
+#define NEWT_NUM_STACK			512
+/// 一度に確保する呼出しスタック長
+#define NEWT_NUM_CALLSTACK		512
+/// 一度に確保する例外スタック長
+#define NEWT_NUM_EXCPSTACK		512
+/// 前処理済み命令キャッシュのハッシュテーブル長（2 のべき乗）
+#define NEWT_NUM_CODECACHE		256
+/// 関数オブジェクトの記述子キャッシュのハッシュテーブル長（2 のべき乗）
+#define NEWT_NUM_FNCACHE		256
+/// 再利用するために取っておくイテレータオブジェクトの数
+#define NEWT_NUM_ITERPOOL		16
+/// インラインキャッシュのエントリ数（命令ごと）
+#define NEWT_NUM_ICENTRIES		4
+/// インラインキャッシュに記録する探索フレームの最大数
+#define NEWT_NUM_ICDEPTH		8
+/// 型特化命令を元に戻す回数の上限（超えると汎用命令のまま）
+#define NEWT_NUM_QUICKMISSES	4
+/// JIT コンパイルする関数の呼出しとループの回数（--jit）
+#define NEWT_JIT_THRESHOLD		16
+
+/* Parser */
+/// 一度に確保する構文木スタック長
+#define NEWT_NUM_STREESTACK		1024
+
+/* Bytecode */
+/// 一度に確保する Bytecode のメモリ長
+#define NEWT_NUM_BYTECODE		512
+/// 一度に確保する break 文の作業用スタック長
+#define NEWT_NUM_BREAKSTACK		20
+/// 一度に確保する OnException 文の作業用スタック長
+#define NEWT_NUM_ONEXCPSTACK	20
+/// 一度に確保する例外ハンドラ表の作業用スタック長
+#define NEWT_NUM_HANDLERTABLE	8
+
+/* Symbol */
+///　　シンボルテーブルのハッシュ索引の初期長（2 のべき乗）
+#define NEWT_NUM_SYMINDEX		1024
+
+/* Map */
+///　　スロットの索引を作るマップの最小スロット数
+#define NEWT_MAPINDEX_MINSLOTS	16
+///　　マップの索引テーブルのバケット数
+#define NEWT_NUM_MAPINDEXBUCKET	256
+///　　マップの遷移テーブルのバケット数
+#define NEWT_NUM_MAPTRANSITIONBUCKET	256
+///　　共有する遷移先のマップの最大数（超えるとフレーム専用のマップを作る）
+#define NEWT_NUM_MAPTRANSITIONS	4096
+///　　遷移で共有するマップに追加できるスロット数
+#define NEWT_MAPTRANSITION_MAXSLOTS	16
+
+/* Pool */
+///　　メモリプールの拡張サイズ（GC 後に最低限空けておくサイズ）
+#define NEWT_POOL_EXPANDSPACE	(1024 * 10)
+///　　メモリプールの初期の最大サイズ（GC 後もこれより小さくしない）
+#define NEWT_POOL_INITSPACE		(1024 * 10)
+///　　メモリプールの上限（超えると例外を発生する、0 なら上限なし）
+#define NEWT_POOL_LIMITSPACE	0
+///　　GC 後に生きているオブジェクトが最大サイズに占める割合（％）
+#define NEWT_POOL_LIVERATIO		80
+///　　サイズクラスのブロックを切り出すアリーナのサイズ
+#define NEWT_MEM_ARENASIZE		(1024 * 64)
+///　　マイナーGC を行う若い世代のサイズ
+#define NEWT_POOL_NURSERYSPACE	(1024 * 32)
+///　　記憶集合の初期の長さ（足りなくなると倍に拡張する）
+#define NEWT_NUM_REMEMBERED		256
+///　　一度に確保するマークスタックの長さ
+#define NEWT_NUM_MARKSTACK		1024
+///　　マークスタックの最大の長さ（超えた分はヒープを走査し直してマークする）
+#define NEWT_NUM_MARKSTACK_MAX	(1024 * 64)
+///　　インクリメンタルGC の1回の停止時間（マイクロ秒、0 なら一度に GC する）
+#define NEWT_GC_PAUSEBUDGET		0
+///　　インクリメンタルGC を少しずつ進める間隔（命令数）
+#define NEWT_GC_SLICEINTERVAL	64
+///　　インクリメンタルGC で経過時間を調べる間隔（オブジェクト数）
+#define NEWT_GC_SLICECHECK		256
+///　　全体の GC でマークとスウィープを行うスレッド数（1 なら GC を呼出したスレッドだけで行う）
+#define NEWT_GC_THREADS			1
+///　　全体の GC で使えるスレッド数の上限
+#define NEWT_GC_MAXTHREADS		64
+///　　複数のスレッドで GC を行う最小のアリーナ数（小さなヒープは１スレッドの方が速い）
+#define NEWT_GC_PARALLEL_ARENAS	16
+///　　スレッド間でマークの仕事を受渡す単位（オブジェクト数）
+#define NEWT_GC_MARKBATCH		64
+///　　全体の GC の後でアリーナをオブジェクトの確保時に少しずつスウィープする（0 なら GC 中に全てスウィープする）
+#define NEWT_GC_LAZYSWEEP		1
+///　　遅延スウィープでオブジェクトを１つ確保するごとにスウィープするビットマップのワード数
+#define NEWT_GC_LAZYSWEEPWORDS	8
+///　　一度に確保するファイナライザ・キューの長さ
+#define NEWT_NUM_FINALIZERS		64
+
+/* IO */
+/// fgets のバッファサイズ
+#define	NEWT_FGETS_BUFFSIZE		2048
+/// snprintf, vsnprintf のバッファサイズ
+#define NEWT_SNPRINTF_BUFFSIZE	255
+
+/* lex */
+/// 字句解析の行バッファサイズ
+#define	NEWT_LEX_LINEBUFFSIZE	500
+
+/* text encoding */
+/// デフォルトエンコーディング
+#define NEWT_DEFAULT_ENCODING	"UTF-8"
+
+// for old style compatible
+//#define __USE_OBSOLETE_STYLE__
+
+
+#endif /* NEWTCONF_H */
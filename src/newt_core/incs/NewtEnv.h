@@ -27,10 +27,21 @@
 #define NEWT_DUMPBC			(newt_env._dumpBC)				///< ダンプバイトコードフラグ
 #define NEWT_INDENT			(newt_env._indent)				///< Enable indenting when printing
 #define NEWT_POOL			(newt_env.pool)					///< メモリプール
-#define NEWT_SWEEP			(newt_env.sweep)				///< SWEEPフラグ
 #define NEWT_NEEDGC			(newt_env.needgc)				///< GCフラグ
+#define NEWT_MAPEPOCH		(newt_env.mapEpoch)				///< マップの変更回数
 #define NEWT_MODE_NOS2		(newt_env.mode.nos2)			///< NOS2 コンパチブル
 #define NEWT_MODE_NOS1_FUNCTIONS	(newt_env.mode.nos1Functions)	///< As opposed to NewtonOS 2.x-only faster functions
+#define NEWT_MODE_NOTHREADEDCODE	(newt_env.mode.noThreadedCode)	///< スレッデッドコードを使用しない
+#define NEWT_MODE_NOMEMPOOL	(newt_env.mode.noMemPool)		///< メモリプールのサイズクラスを使用しない
+#define NEWT_MODE_NONURSERY	(newt_env.mode.noNursery)		///< 世代別 GC を使用しない
+#define NEWT_MODE_NOLAZYSWEEP	(newt_env.mode.noLazySweep)	///< 全体の GC 中に全てスウィープする
+#define NEWT_MODE_NOFASTHASH	(newt_env.mode.noFastHash)	///< Newton OS 互換のシンボルのハッシュ関数を使用する
+#define NEWT_MODE_NOSTACKLOCALS	(newt_env.mode.noStackLocals)	///< 関数呼出しごとにローカルフレームを作成する
+#define NEWT_MODE_JIT		(newt_env.mode.jit)				///< ホットな関数をネイティブコードにコンパイルする
+#define NEWT_MODE_TAILCALL	(newt_env.mode.tailCalls)		///< 末尾位置の呼出しで活性レコードを再利用する
+#define NEWT_MODE_GCTHREADS	(newt_env.mode.gcThreads)		///< 全体の GC を行うスレッド数
+#define NEWT_MODE_HEAPSIZE	(newt_env.mode.heapSize)		///< メモリプールの初期の最大サイズ
+#define NEWT_MODE_HEAPLIMIT	(newt_env.mode.heapLimit)		///< メモリプールの上限
 
 #define NSSTR(s)			(NewtMakeString(s, false))		///< 文字列オブジェクトの作成
 #define NSSTRCONST(s)		(NewtMakeString(s, true))		///< 文字列定数オブジェクトの作成
@@ -72,6 +83,9 @@
 /// 実行環境
 typedef struct {
     newtRefVar	sym_table;		///< シンボルテーブル
+    newtRef *	sym_index;		///< シンボルテーブルのハッシュ索引（オープンアドレス法）
+    uint32_t	sym_indexsize;	///< ハッシュ索引の長さ（2 のべき乗）
+    uint32_t	sym_nums;		///< ハッシュ索引に登録されたシンボルの数
     newtRefVar	root;			///< ルート
     newtRefVar	globals;		///< グローバル変数テーブル
     newtRefVar	global_fns;		///< グローバル関数テーブル
@@ -83,13 +97,24 @@ typedef struct {
 
 	// メモリ関係
     newtPool	pool;			///< メモリプール
-    bool		sweep;			///< 現在の sweep 状態（トグルする）
     bool		needgc;			///< GC が必要
+    uint32_t	mapEpoch;		///< 既存マップの変更回数（インラインキャッシュの無効化に使用）
 
 	/// モード
 	struct {
 		bool	nos1Functions;	///< As opposed to NewtonOS 2.x-only faster functions
 		bool	nos2;			///< NOS2 コンパチブル
+		bool	noThreadedCode;	///< スレッデッドコードを使用しない（逐次デコードで実行）
+		bool	noMemPool;		///< メモリプールのサイズクラスを使用しない（malloc で確保）
+		bool	noNursery;		///< 世代別 GC を使用しない（常に全オブジェクトを GC する）
+		bool	noLazySweep;	///< 全体の GC 中に全てスウィープする（オブジェクトの確保時に少しずつスウィープしない）
+		bool	noFastHash;		///< Newton OS 互換のシンボルのハッシュ関数を使用する
+		bool	noStackLocals;	///< 関数呼出しごとにローカルフレームを作成する（活性レコードをスタックに置かない）
+		bool	jit;			///< ホットな関数をネイティブコードにコンパイルする（x86-64 のみ）
+		bool	tailCalls;		///< 末尾位置の呼出しで活性レコードを再利用する
+		uint32_t	gcThreads;	///< 全体の GC でマークとスウィープを行うスレッド数（0 なら NEWT_GC_THREADS）
+		int64_t		heapSize;	///< メモリプールの初期の最大サイズ（0 なら NEWT_POOL_INITSPACE）
+		int64_t		heapLimit;	///< メモリプールの上限（0 なら NEWT_POOL_LIMITSPACE）
 	} mode;
 
     // デバッグ
@@ -120,6 +145,7 @@ typedef struct {
     newtRefVar	argFrame;			///< argFrame
     newtRefVar	numArgs;			///< numArgs
     newtRefVar	indefinite;			///< indefinite
+    newtRefVar	handlers;			///< handlers
 
     // native function
 
@@ -225,6 +251,7 @@ typedef struct {
 	// Compile options
     newtRefVar	nosCompatible;		///< nosCompatible
     newtRefVar	nos1Functions;		///< nos1Functions
+    newtRefVar	tailCalls;			///< tailCalls
 
 	// ARGV
     newtRefVar	_ARGV_;				///< _ARGV_
@@ -155,8 +155,12 @@ newtRef		NsInfo(newtRefArg rcvr, newtRefArg r);
 newtRef		NsDumpFn(newtRefArg rcvr, newtRefArg r);
 newtRef		NsDumpBC(newtRefArg rcvr, newtRefArg r);
 newtRef		NsDumpStacks(newtRefArg rcvr);
+newtRef		NsCallStackDepth(newtRefArg rcvr);
+newtRef		NsInlineCacheStats(newtRefArg rcvr);
+newtRef		NsSymbolHashStats(newtRefArg rcvr);
 
 newtRef		NsExit(newtRefArg rcvr, newtRefArg r);
+newtRef		NsTicks(newtRefArg rcvr);
 
 newtRef		NsCompile(newtRefArg rcvr, newtRefArg r);
 newtRef		NsGetEnv(newtRefArg rcvr, newtRefArg r);
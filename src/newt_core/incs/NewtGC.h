@@ -20,6 +20,10 @@
 /* マクロ */
 #define NewtGCHint(r, hint)									///< GC を効率良く行うためのヒントを与える
 
+/// 古いオブジェクトに若い世代への参照を書込む場合のライトバリア（インクリメンタルGC のマーク中は書込む値もマークする）
+#define NewtGCWriteBarrier(obj, v)												\
+			((((obj)->header.h & kNewtObjYoung) != 0 || ! NewtRefIsPointer(v)) ? (void)0 : NewtGCRemember(obj, v))
+
 
 /* 関数プロトタイプ */
 
@@ -32,9 +36,15 @@ void		NewtCheckGC(newtPool pool, size_t size);
 newtObjRef	NewtObjChainAlloc(newtPool pool, size_t size, size_t dataSize);
 void		NewtPoolRelease(newtPool pool);
 
+void		NewtGCRemember(newtObjRef obj, newtRefArg v);
+bool		NewtGCIsGarbage(newtObjRef obj);
 void		NewtGC(void);
 
 newtRef		NsGC(newtRefArg rcvr);
+newtRef		NsSetGCPauseBudget(newtRefArg rcvr, newtRefArg usec);
+newtRef		NsSetGCThreads(newtRefArg rcvr, newtRefArg n);
+newtRef		NsSetHeapLimit(newtRefArg rcvr, newtRefArg size);
+newtRef		NsGCStats(newtRefArg rcvr);
 
 
 #ifdef __cplusplus
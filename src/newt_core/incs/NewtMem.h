@@ -18,18 +18,106 @@
 #include "NewtType.h"
 
 
+/* マクロ */
+#define NEWT_NUM_MEMCLASS		16		///< サイズクラスの数
+#define NEWT_MEMCLASS_MAXSIZE	512		///< サイズクラスで確保する最大サイズ
+#define NEWT_MEM_ALIGN			16		///< 確保するメモリのアライン（名前付マジックポインタは 16 を前提とする）
+#define NEWT_MEM_ARENABITS		(NEWT_MEM_ARENASIZE / NEWT_MEM_ALIGN)	///< アリーナ内でブロックが始まりうる位置の数
+#define NEWT_MEM_ARENAWORDS		(NEWT_MEM_ARENABITS / 32)				///< アリーナのビットマップのワード数
+
+/// ブロックを切り出したアリーナ（malloc で確保したブロックは NULL）
+#define NewtMemArenaOf(p)			(((newtMemHeader *)(p) - 1)->block.sizeclass != NULL ? ((newtMemHeader *)(p) - 1)->classblock.arena : NULL)
+/// アリーナ内のブロックの位置（ビットマップのビット番号）
+#define NewtMemArenaIndex(a, p)		((uint32_t)(((uint8_t *)(p) - (a)->base) / NEWT_MEM_ALIGN))
+/// アリーナ内の位置にあるブロック
+#define NewtMemArenaBlock(a, i)		((void *)((a)->base + (size_t)(i) * NEWT_MEM_ALIGN))
+
+
 /* 型宣言 */
 
-/// メモリプール
-typedef struct {
-    void *		pool;			///< 実メモリプールへのポインタ
+/// サイズクラス
+typedef struct newtmemclass_t {
+    size_t		size;			///< ブロックのサイズ
+    void *		freelist;		///< 解放されたブロックのリスト
+} newtMemClass;
+
+
+/// アリーナ（サイズクラスのブロックを切り出す領域）
+typedef struct newtmemarena_t {
+    struct newtmemarena_t *	next;	///< 前に確保したアリーナ
+    uint8_t *	base;			///< アリーナの先頭
+    uint32_t	objbits[NEWT_MEM_ARENAWORDS];	///< 古い世代のオブジェクトが始まる位置（GC用）
+    uint32_t	markbits[NEWT_MEM_ARENAWORDS];	///< マーク済みのオブジェクトが始まる位置（GC用）
+} newtMemArena;
 
-    int32_t		usesize;		///< 使用サイズ
-    int32_t		maxspace;		///< 現在の最大サイズ
-    int32_t		expandspace;	///< 一度に拡張できるメモリサイズ
 
-    newtObjRef	obj;			///< 確保したオブジェクトへのチェイン（GC の対象）
+/// インクリメンタルGC の状態
+enum {
+    kNewtGCIdle			= 0,	///< GC 中でない
+    kNewtGCMark,				///< マーク中
+    kNewtGCSweep				///< スウィープ中
+};
+
+
+/// メモリブロックのヘッダ
+typedef union {
+    struct {
+        newtMemClass *	sizeclass;	///< サイズクラス（NULL の場合は malloc で確保）
+        size_t		size;		///< malloc で確保したデータサイズ
+    } block;
+    struct {
+        newtMemClass *	sizeclass;	///< サイズクラス
+        newtMemArena *	arena;		///< ブロックを切り出したアリーナ
+    } classblock;
+    uint8_t		align[NEWT_MEM_ALIGN];	///< アライン用
+} newtMemHeader;
+
+
+/// メモリプール
+typedef struct {
+    newtMemArena *	arenas;		///< アリーナのチェイン（ビットマップはアリーナとは別に確保するので GC はオブジェクトのページに書込まない）
+    uint8_t *	arenap;			///< 現在のアリーナの未使用領域
+    uint8_t *	arenaend;		///< 現在のアリーナの終端
+    size_t		maxclass;		///< サイズクラスで確保する最大サイズ（0 ならサイズクラスを使用しない）
+    newtMemClass	sizeclass[NEWT_NUM_MEMCLASS];	///< サイズクラス
+
+    int64_t		usesize;		///< 使用サイズ
+    uint32_t	allocs;			///< 確保したオブジェクトの数（統計用）
+    int64_t		maxspace;		///< 現在の最大サイズ（超えると全体の GC を行う）
+    int64_t		expandspace;	///< GC 後に最低限空けておくサイズ
+    int64_t		initspace;		///< 初期の最大サイズ（GC 後もこれより小さくしない）
+    int64_t		limitspace;		///< 使用サイズの上限（0 なら上限なし）
+    bool		overlimit;		///< 上限を超えた例外を発生済み（GC の後で上限を下回るまで再び発生しない）
+
+    newtObjRef	obj;			///< malloc で確保した古い世代のオブジェクトへのチェイン（アリーナのオブジェクトはビットマップで管理）
     newtObjRef	literal;		///< 確保したリテラルへのチェイン
+
+    newtObjRef	young;			///< 若い世代のオブジェクトへのチェイン（マイナーGC の対象）
+    int64_t		youngsize;		///< 若い世代の使用サイズ
+    int64_t		nurseryspace;	///< マイナーGC を行う若い世代のサイズ（0 なら世代別 GC を行わない）
+    bool		fullgc;			///< 次の GC を全オブジェクトを対象にして行う
+
+    newtObjRef *	remembered;	///< 若い世代を参照している古いオブジェクト（記憶集合）
+    uint32_t	remnums;		///< 記憶集合のオブジェクト数
+    uint32_t	remsize;		///< 記憶集合の確保済みの長さ
+
+    newtObjRef *	markstack;	///< マーク中のオブジェクトを積むスタック
+    uint32_t	marknums;		///< マークスタックのオブジェクト数
+    uint32_t	marksize;		///< マークスタックの確保済みの長さ
+    bool		markoverflow;	///< マークスタックからあふれたオブジェクトがある
+
+    int			gcphase;		///< インクリメンタルGC の状態
+    uint32_t	gcbudget;		///< インクリメンタルGC の1回の停止時間（マイクロ秒、0 なら一度に GC する）
+    uint32_t	gccountdown;	///< 次にインクリメンタルGC を進めるまでの命令数
+    newtObjRef *	sweepp;		///< インクリメンタルGC で次にスウィープするチェインのオブジェクトへのポインタ
+    newtMemArena *	sweeparena;	///< インクリメンタルGC で次にスウィープするアリーナ
+    uint32_t	sweepword;		///< インクリメンタルGC で次にスウィープするビットマップのワード
+    uint32_t	gcthreads;		///< 全体の GC でマークとスウィープを行うスレッド数（1 なら GC を呼出したスレッドだけで行う）
+    bool		lazysweep;		///< 全体の GC の後でアリーナをオブジェクトの確保時に少しずつスウィープする
+
+    newtCObject *	finalizers;	///< GC の外で実行する CObject のデストラクタ（ファイナライザ・キュー）
+    uint32_t	finalnums;		///< ファイナライザ・キューの長さ
+    uint32_t	finalsize;		///< ファイナライザ・キューの確保済みの長さ
 } newtpool_t;
 
 typedef newtpool_t *	newtPool;   ///< メモリプールへのポインタ
@@ -55,12 +143,15 @@ extern "C" {
 #endif
 
 
-newtPool	NewtPoolAlloc(int32_t expandspace);
+newtPool	NewtPoolAlloc(int64_t expandspace);
+void		NewtPoolFree(newtPool pool);
 
 void *		NewtMemAlloc(newtPool pool, size_t size);
 void *		NewtMemCalloc(newtPool pool, size_t number, size_t size);
 void *		NewtMemRealloc(newtPool pool, void * ptr, size_t size);
 void		NewtMemFree(void * ptr);
+bool		NewtMemIsSmall(newtPool pool, size_t size);
+size_t		NewtMemSize(void * ptr);
 
 void		NewtStackSetup(newtStack * stackinfo,
                     newtPool pool, uint32_t datasize, uint32_t blocksize);
@@ -24,10 +24,23 @@
 #define NOBJ_ADDR_SHIFT		0
 
 
-#define NewtRefIsInt30(r)			((r & 3) == 0)						///< 30bit整数オブジェクトか？
+// 64bit 環境では即値の整数（30bit整数オブジェクト）に参照の上位ビットも使い 62bit まで表す。
+// NSOF やパッケージには 30bit に収まらない値をバイナリの整数にして書出す。
+#define NewtRefIsInt30(r)			((r & 3) == 0)						///< 30bit整数オブジェクト（即値の整数）か？
+#if INTPTR_MAX == INT32_MAX
 #define	NewtRefToInt30(r)			(int32_t)((uintptr_t)r >> 2)			///< オブジェクトを 30bit整数に変換
+#else
+#define	NewtRefToInt30(r)			((intptr_t)(r) >> 2)					///< オブジェクトを 62bit整数に変換
+#endif
 #define	NewtMakeInt30(v)			(newtRef)((uintptr_t)(v) << 2)		///< 30bit整数オブジェクトを作成
 
+#define	NewtIntIs30Bit(v)			(-536870912 <= (v) && (v) <= 536870911)	///< 整数が 30bit に収まるか？
+#if INTPTR_MAX == INT32_MAX
+#define	NewtIntIsImmediate(v)		NewtIntIs30Bit(v)						///< 整数を即値で表せるか？
+#else
+#define	NewtIntIsImmediate(v)		(-((int64_t)1 << 61) <= (v) && (v) < ((int64_t)1 << 61))	///< 整数を即値で表せるか？
+#endif
+
 #define	NewtRefIsPointer(r)			((r & 3) == 1)						///< ポインタオブジェクトか？
 #define	NewtRefToPointer(r)			(newtObjRef)((uintptr_t)r - 1)		///< オブジェクト参照をポインタに変換
 #define	NewtMakePointer(v)			(newtRef)((uintptr_t)(v) + 1)		///< ポインタオブジェクトを作成
@@ -85,7 +98,7 @@
 #define	NewtObjIsFrame(v)			(NewtObjType(v) == 3)					///< オブジェクトデータがフレームか？
 #define	NewtObjIsIndirectBinary(v)	(NewtObjType(v) == kNewtObjIndirectBin)	///< Indirect binaries special value
 #define NewtObjIsLiteral(v)			((v->header.h & kNewtObjLiteral) == kNewtObjLiteral)		///< リテラルか？
-#define NewtObjIsSweep(v, mark)		(((v->header.h & kNewtObjSweep) == kNewtObjSweep) == mark)  ///< スウィープ対象か？
+#define NewtObjIsYoung(v)			((v->header.h & kNewtObjYoung) != 0)	///< 若い世代か？
 #define	NewtObjSize(v)				(v->header.h >> 8)					///< オブジェクトデータのサイズを取得
 #define NewtObjBinaryClass(v)		(v->as.klass)						///< Low-level API. Use NewtObjClassOf when needed.
 #define NewtObjArrayClass(v)		(v->as.klass)						///< Low-level API. Use NewtObjClassOf when needed.
@@ -93,6 +106,12 @@
 #define	NewtObjToSymbol(v)			((newtSymDataRef)NewtObjData(v))	///< シンボルデータ部へのポインタ
 #define	NewtObjToString(v)			((char *)NewtObjData(v))			///< 文字列データ部へのポインタ
 #define	NewtObjToSlots(v)			((newtRef *)NewtObjData(v))			///< スロットデータ部へのポインタ
+#define	NewtObjInlineData(v)		((uint8_t *)(v) + sizeof(newtObj) + sizeof(uint8_t *))	///< ヘッダと同じブロックに置いたデータ部へのポインタ
+
+//
+#define	NewtMapIndexHash(r, shift)	((uint32_t)((uint32_t)((uintptr_t)(r) >> 4) * UINT32_C(2654435761)) >> (shift))	///< マップの索引のハッシュ値
+#define	NewtMapIndexBucket(obj, n)	(((uintptr_t)(obj) >> 4) % (n))		///< マップの索引のバケット
+#define	NewtMapTransitionBucket(obj, r, n)	((((uintptr_t)(obj) >> 4) ^ ((uintptr_t)(r) >> 4)) % (n))	///< マップの遷移のバケット
 
 //
 #define NewtHasVar(name)			NVMHasVar(name)						///< 変数の存在チェック
@@ -135,6 +154,31 @@ enum {
 typedef void(*newt_install_t)(void);
 
 
+/// マップの索引のエントリ
+typedef struct {
+	newtRef		slot;		///< スロットシンボル（空きは kNewtRefUnbind）
+	uint32_t	index;		///< マップ内の位置
+} newtMapIndexEntry;
+
+
+/// マップのスロットの索引
+typedef struct newtMapIndex {
+	struct newtMapIndex *	next;		///< 同じバケットの次の索引
+	newtObjRef	map;					///< マップのオブジェクトデータ
+	uint32_t	shift;					///< ハッシュ値のシフト量（32 - 索引長のビット数）
+	newtMapIndexEntry	entries[1];		///< エントリ（索引長は 2 のべき乗）
+} newtMapIndex;
+
+
+/// マップの遷移
+typedef struct newtMapTransition {
+	struct newtMapTransition *	next;	///< 同じバケットの次の遷移
+	newtObjRef	from;					///< 元のマップ
+	newtRef		slot;					///< 追加したスロットシンボル
+	newtObjRef	to;						///< 遷移先のマップ
+} newtMapTransition;
+
+
 /* 関数プロトタイプ */
 
 #ifdef __cplusplus
@@ -143,8 +187,13 @@ extern "C" {
 
 
 uint32_t	NewtSymbolHashFunction(const char * name);
+uint32_t	NewtSymbolNewtonHash(const char * name);
+uint32_t	NewtSymbolFastHash(const char * name);
+newtRef		NewtMakeSymbol0(const char *s);
 newtRef		NewtLookupSymbol(newtRefArg r, const char * name, uint32_t hash, int32_t st);
 newtRef		NewtLookupSymbolArray(newtRefArg r, newtRefArg name, int32_t st);
+void		NewtMapIndexForget(newtObjRef obj);
+void		NewtMapCacheFree(void);
 const char*	NewtSymbolGetName(newtRefArg inSymbol);
 
 uint16_t	NewtGetRefType(newtRefArg r, bool detail);
@@ -158,7 +207,6 @@ newtRef		NewtObjClone(newtRefArg r);
 newtRef		NewtPackLiteral(newtRefArg r);
 
 bool		NewtRefIsLiteral(newtRefArg r);
-bool		NewtRefIsSweep(newtRefArg r, bool mark);
 bool		NewtRefIsNIL(newtRefArg r);
 bool		NewtRefIsSymbol(newtRefArg r);
 uint32_t	NewtRefToHash(newtRefArg r);
@@ -196,6 +244,7 @@ newtRef		NewtStringSetLength(newtRefArg r, size_t n);
 newtRef		NewtMakeInteger(int64_t v);
 newtRef		NewtMakeInt32(int32_t v);
 newtRef     NewtMakeInt64(int64_t v);
+newtRef		NewtBoxWideInteger(newtRefArg r);
 newtRef		NewtMakeReal(double v);
 newtRef		NewtMakeArray(newtRefArg klass, size_t n);
 newtRef		NewtMakeArray2(newtRefArg klass, size_t n, const newtRefVar v[]);
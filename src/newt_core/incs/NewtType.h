@@ -75,8 +75,12 @@ enum {
     // Actually, we have indirect binaries with type equal to 0x02, probably a NewtonOS 2 addition.
     kNewtObjIndirectBin	= 0x02,
 
+    kNewtObjMapIndexed	= 0x04,		///< スロットの索引を持つマップ
+    kNewtObjMapShared	= 0x08,		///< 遷移で共有するマップ
+    kNewtObjRemembered	= 0x10,		///< 記憶集合に登録済み（GC用）
+    kNewtObjYoung		= 0x20,		///< 若い世代（GC用）
     kNewtObjLiteral		= 0x40,		///< リテラル
-    kNewtObjSweep		= 0x80		///< ゴミ掃除（GC用）
+    kNewtObjMark		= 0x80		///< マーク済み（GC用、アリーナの外に確保したオブジェクトだけが使う）
 };
 
 
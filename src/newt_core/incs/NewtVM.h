@@ -86,7 +86,9 @@ typedef struct {
     newtRefVar	func;	///< FUNC   実行中の関数オブジェクト
     uint32_t  	pc;		///< PC     実行中の instructionオブジェクトのインデックス
     uint32_t	sp;		///< SP     スタックポインタ
-    newtRefVar	locals;	///< LOCALS 実行中のローカルフレーム
+    newtRefVar	locals;	///< LOCALS 実行中のローカルフレーム（BP が有効な場合は引数フレームのひな形）
+    uint32_t	bp;		///< BP     スタック上の活性レコードの開始位置
+    uint32_t	base;	///< BASE   関数の実行開始時のスタックポインタ（例外ハンドラ表の深さの基準）
     newtRefVar	rcvr;	///< RCVR   実行中のレシーバ（for メッセージ送信）
     newtRefVar	impl;	///< IMPL   実行中のインプリメンタ(for メッセージ送信)
 } vm_reg_t;
@@ -103,11 +105,27 @@ typedef struct {
 } vm_excp_t;
 
 
+/// 前処理済み命令（スレッデッドコード）
+typedef struct {
+    const void *	handler;	///< 命令ハンドラのアドレス（computed goto 使用時）
+    int16_t		b;				///< B フィールド（オペデータ）
+    uint8_t		a;				///< A フィールド
+    uint8_t		op;				///< 前処理済み命令コード
+    uint8_t		len;			///< 命令長
+    uint8_t		misses;			///< 型特化命令の型ガード失敗数
+    uint16_t	skip;			///< 読み飛ばした後の命令位置（例外ハンドラ表のある TRY文の先頭）
+    struct vm_ic_t *	ic;		///< インラインキャッシュ（send, find-var, get-path）
+} vm_inst_t;
+
+
 /// VM 実行環境
 typedef struct vm_env_t {
     // バイトコード
     uint8_t *	bc;				///< バイトコード
     size_t	    bclen;			///< バイトコードの長さ
+    vm_inst_t *	insts;			///< 前処理済み命令（bc と同じインデックスでアクセス）
+    struct vm_code_t *	code;	///< 前処理済み命令キャッシュのエントリ
+    struct vm_jit_t *	jit;	///< JIT コンパイルしたネイティブコード（NULL なら前処理済み命令を実行）
 
     // レジスタ
     vm_reg_t	reg;			///< レジスタ
@@ -119,6 +137,7 @@ typedef struct vm_env_t {
 
     // 例外
     newtRefVar	currexcp;		///< 現在の例外
+    bool		excptable;		///< 現在の例外を例外ハンドラ表で捕まえたか
 
 	// VM 管理
 	uint16_t	level;			///< VM呼出しレベル
@@ -141,10 +160,12 @@ void			NVMClean(void);
 newtRef		NVMSelf(void);
 newtRef		NVMCurrentFunction(void);
 newtRef		NVMCurrentImplementor(void);
+newtRef		NVMCallStackDepth(void);
 bool		NVMHasVar(newtRefArg name);
 newtRef		NVMThrowData(newtRefArg name, newtRefArg data);
 newtRef		NVMThrow(newtRefArg name, newtRefArg data);
 newtRef		NVMRethrow(void);
+void		NVMThrowAsync(newtErr err, newtRefArg value);
 newtRef		NVMCurrentException(void);
 void		NVMClearException(void);
 
@@ -157,6 +178,9 @@ void		NVMDumpFn(FILE * f, newtRefArg fn);
 void		NVMDumpStackTop(FILE * f, char * s);
 void		NVMDumpStacks(FILE * f);
 
+void		NVMSweepCodeCache(void);
+newtRef		NVMInlineCacheStats(void);
+
 void		NVMFnCall(newtRefArg fn, int16_t numArgs);
 newtRef		NVMInterpret(newtRefArg fn, newtErr * errP);
 newtErr		NVMInfo(const char * name);
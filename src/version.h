@@ -35,12 +35,23 @@
 						"  -s              dump syntax tree\n"			\
 						"  -b              dump byte code\n"			\
 						"  -C directory    change working directory\n"	\
+						"  -g threads      mark and sweep the heap with threads\n"	\
+						"  -m size         initial heap size (k, m or g suffix)\n"	\
+						"  -M size         maximum heap size (k, m or g suffix)\n"	\
 						"  -e 'command'    one line of script\n"		\
 						"  -i [symbols]    print function info\n"		\
 						"  -v              print version number\n"		\
 						"  -h              print this help message\n"	\
 						"  --newton,--nos2 Newton OS 2.0 compatible	\n"	\
 						"  --nos1Functions Newton OS 1.x functions\n"	\
+						"  --noThreadedCode decode byte code on each step\n"	\
+						"  --noMemPool     allocate objects with malloc\n"	\
+						"  --noNursery     collect the whole heap on every GC\n"	\
+						"  --noLazySweep   sweep the whole heap inside the GC pause\n"	\
+						"  --noFastHash    use the Newton OS symbol hash in memory\n"	\
+						"  --noStackLocals allocate a locals frame on every call\n"	\
+						"  --jit           compile hot functions to x86-64 code\n"	\
+						"  --tailCalls     compile calls in tail position as tail calls\n"	\
 						"  --copyright     print copyright\n"			\
 						"  --version       print version number\n"		\
 						"  --staff         list of developers\n"